@@ -13,6 +13,7 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qbuffer.h>
+#include <QtCore/qmutex.h>
 
 #include <QtGui/qimage.h>
 #include <QtGui/qimagereader.h>
@@ -392,6 +393,9 @@ struct OutputContext
     Type type = NodeTree;
     quint8 options = Options::None;
     quint16 scopeDepth = 0;
+    QSSGMesh::Mesh::SaveFlags meshSaveFlags = QSSGMesh::Mesh::SaveFlag::None;
+    // The meshes, textures and animations written next to the QML, if wanted
+    QStringList *generatedFiles = nullptr;
 };
 
 template<QSSGSceneDesc::Material::RuntimeType T>
@@ -583,6 +587,21 @@ Q_GLOBAL_STATIC(UniqueIdMap, g_idMap)
 // For Nodes, it is not used.
 using UniqueIdOthers = QSet<QString>;
 Q_GLOBAL_STATIC(UniqueIdOthers, g_idOthers)
+// The ids are unique across all the scenes written by the process, as the
+// meshes and textures of the scenes can share an output directory. Scenes
+// can be written from several threads at once, like balsamui does.
+Q_CONSTINIT static QBasicMutex g_idMutex;
+// The ids given to the objects of the scenes being written by writeQmlFile(),
+// for the caller to reserve them when the scene is not written again.
+using SceneIdMap = QHash<const QSSGSceneDesc::Scene *, QStringList>;
+Q_GLOBAL_STATIC(SceneIdMap, g_sceneIds)
+
+// Expects g_idMutex to be locked
+static void recordId(const QSSGSceneDesc::Scene *scene, const QString &id)
+{
+    if (const auto it = g_sceneIds->find(scene); it != g_sceneIds->end())
+        it->append(id);
+}
 
 static QString getIdForNode(const QSSGSceneDesc::Node &node)
 {
@@ -607,6 +626,7 @@ static QString getIdForNode(const QSSGSceneDesc::Node &node)
     QString sanitizedName = QSSGQmlUtilities::sanitizeQmlId(name);
 
     // Make sure we return a unique id.
+    const QMutexLocker locker(&g_idMutex);
     if (const auto it = g_nodeNameMap->constFind(&node); it != g_nodeNameMap->constEnd())
         return *it;
 
@@ -616,6 +636,7 @@ static QString getIdForNode(const QSSGSceneDesc::Node &node)
         if (const auto it = g_idMap->constFind(sanitizedName); it == g_idMap->constEnd()) {
             g_idMap->insert(sanitizedName, &node);
             g_nodeNameMap->insert(&node, sanitizedName);
+            recordId(node.scene, sanitizedName);
             return sanitizedName;
         }
 
@@ -625,17 +646,19 @@ static QString getIdForNode(const QSSGSceneDesc::Node &node)
     return sanitizedName;
 }
 
-static QString getIdForAnimation(const QByteArray &inName)
+static QString getIdForAnimation(const QByteArray &inName, const QSSGSceneDesc::Scene &scene)
 {
     QString name = !inName.isEmpty() ? QString::fromUtf8(inName + "_timeline") : "timeline0"_L1;
     QString sanitizedName = QSSGQmlUtilities::sanitizeQmlId(name);
 
     int attempts = 1000;
     quint16 id = 0;
+    const QMutexLocker locker(&g_idMutex);
     do {
         if (const auto it = g_idMap->constFind(sanitizedName); it == g_idMap->constEnd()) {
             if (const auto oIt = g_idOthers->constFind(sanitizedName); oIt == g_idOthers->constEnd()) {
                 g_idOthers->insert(sanitizedName);
+                recordId(&scene, sanitizedName);
                 return sanitizedName;
             }
         }
@@ -803,10 +826,11 @@ QString asString(QSSGSceneDesc::Animation::Channel::TargetProperty prop)
     return QStringLiteral("unknown");
 }
 
-static std::pair<QString, QString> meshAssetName(const QSSGSceneDesc::Scene &scene, const QSSGSceneDesc::Mesh &meshNode, const QDir &outdir)
+static std::pair<QString, QString> meshAssetName(const QSSGSceneDesc::Scene &scene, const QSSGSceneDesc::Mesh &meshNode, OutputContext &output)
 {
     // Returns {name, notValidReason}
 
+    const QDir &outdir = output.outdir;
     const auto meshFolder = getMeshFolder();
     const auto meshId = QSSGQmlUtilities::getIdForNode(meshNode);
     const auto meshSourceName = QSSGQmlUtilities::getMeshSourceName(meshId);
@@ -825,10 +849,12 @@ static std::pair<QString, QString> meshAssetName(const QSSGSceneDesc::Scene &sce
         return {QString(), QStringLiteral("Failed to find mesh at ") + path};
     }
 
-    if (mesh.save(&file) == 0) {
+    if (mesh.save(&file, 0, output.meshSaveFlags) == 0) {
         return {};
     }
 
+    if (output.generatedFiles)
+        output.generatedFiles->append(outdir.absoluteFilePath(meshSourceName));
     return {meshSourceName, QString()};
 };
 
@@ -861,6 +887,8 @@ static std::pair<QString, QString> copyTextureAsset(const QUrl &texturePath, Out
         return {};
     }
 
+    if (output.generatedFiles)
+        output.generatedFiles->append(output.outdir.absoluteFilePath(relpath));
     return {relpath, QString()};
 };
 
@@ -1060,7 +1088,7 @@ static ValueToQmlResult valueToQml(const QSSGSceneDesc::Node &target, const QSSG
             Q_ASSERT(meshNode->nodeType == QSSGSceneDesc::Node::Type::Mesh);
             Q_ASSERT(meshNode->scene);
             const auto &scene = *meshNode->scene;
-            const auto& [meshSourceName, notValidReason] = meshAssetName(scene, *meshNode, output.outdir);
+            const auto& [meshSourceName, notValidReason] = meshAssetName(scene, *meshNode, output);
             result.notValidReason = notValidReason;
             if (!meshSourceName.isEmpty()) {
                 result.value = toQuotedString(meshSourceName);
@@ -1241,8 +1269,9 @@ QString getTextureSourceName(const QString &name, const QString &fmt)
     return QString(textureFolder + sanitizedName + ext);
 }
 
-static QString outputTextureAsset(const QSSGSceneDesc::TextureData &textureData, const QDir &outdir)
+static QString outputTextureAsset(const QSSGSceneDesc::TextureData &textureData, OutputContext &output)
 {
+    const QDir &outdir = output.outdir;
     if (textureData.data.isEmpty())
         return QString();
 
@@ -1272,6 +1301,8 @@ static QString outputTextureAsset(const QSSGSceneDesc::TextureData &textureData,
             return QString();
     }
 
+    if (output.generatedFiles)
+        output.generatedFiles->append(outdir.absoluteFilePath(textureSourceName));
     return textureSourceName;
 }
 
@@ -1280,7 +1311,7 @@ static void writeQml(const QSSGSceneDesc::TextureData &textureData, OutputContex
     using namespace QSSGSceneDesc;
     Q_ASSERT(textureData.nodeType == Node::Type::Texture && textureData.runtimeType == Node::RuntimeType::TextureData);
 
-    QString textureSourcePath = outputTextureAsset(textureData, output.outdir);
+    QString textureSourcePath = outputTextureAsset(textureData, output);
 
     static const auto writeProperty = [](const QString &type, const QString &name, const QString &value) {
         return QString::fromLatin1("property %1 %2: %3").arg(type, name, value);
@@ -1483,7 +1514,7 @@ static void generateKeyframeData(const QSSGSceneDesc::Animation::Channel &channe
 #endif // QT_QUICK3D_ENABLE_RT_ANIMATIONS
 }
 
-QPair<QString, QString> writeQmlForAnimation(const QSSGSceneDesc::Animation &anim, qsizetype index, OutputContext &output, bool useBinaryKeyframes = true, bool generateTimelineAnimations = true)
+QPair<QString, QString> writeQmlForAnimation(const QSSGSceneDesc::Scene &scene, const QSSGSceneDesc::Animation &anim, qsizetype index, OutputContext &output, bool useBinaryKeyframes = true, bool generateTimelineAnimations = true)
 {
     indent(output) << "Timeline {\n";
 
@@ -1491,7 +1522,7 @@ QPair<QString, QString> writeQmlForAnimation(const QSSGSceneDesc::Animation &ani
     // The duration property of the TimelineAnimation is an int...
     const int duration = qCeil(anim.length);
     // Use the same name for objectName and id
-    const QString animationId = getIdForAnimation(anim.name);
+    const QString animationId = getIdForAnimation(anim.name, scene);
     indent(output) << "id: " << animationId << "\n";
     QString animationName = animationId;
     if (!anim.name.isEmpty())
@@ -1544,6 +1575,8 @@ QPair<QString, QString> writeQmlForAnimation(const QSSGSceneDesc::Animation &ani
                 generateKeyframeData(*channel, keyframeData);
                 file.write(keyframeData);
                 file.close();
+                if (output.generatedFiles)
+                    output.generatedFiles->append(output.outdir.absoluteFilePath(animSourceName));
                 indent(output) << "keyframeSource: " << toQuotedString(animSourceName) << "\n";
             } else {
                 Q_ASSERT(!channel->keys.isEmpty());
@@ -1563,7 +1596,7 @@ QPair<QString, QString> writeQmlForAnimation(const QSSGSceneDesc::Animation &ani
     return {animationName, animationId};
 }
 
-void writeQml(const QSSGSceneDesc::Scene &scene, QTextStream &stream, const QDir &outdir, const QJsonObject &optionsObject)
+static void writeQmlImp(const QSSGSceneDesc::Scene &scene, QTextStream &stream, const QDir &outdir, const QJsonObject &optionsObject, QStringList *generatedFiles)
 {
     static const auto checkBooleanOption = [](const QLatin1String &optionName, const QJsonObject &options, bool defaultValue = false) {
         const auto it = options.constFind(optionName);
@@ -1598,6 +1631,13 @@ void writeQml(const QSSGSceneDesc::Scene &scene, QTextStream &stream, const QDir
     const bool generateTimelineAnimations = !checkBooleanOption("manualAnimations"_L1, options);
 
     OutputContext output { stream, outdir, scene.sourceDir, 0, OutputContext::Header, outputOptions };
+    output.generatedFiles = generatedFiles;
+
+    if (checkBooleanOption("compressMeshes"_L1, options)) {
+        output.meshSaveFlags |= QSSGMesh::Mesh::SaveFlag::Compress;
+        if (checkBooleanOption("quantizeMeshAttributes"_L1, options))
+            output.meshSaveFlags |= QSSGMesh::Mesh::SaveFlag::QuantizeAttributes;
+    }
 
     writeImportHeader(output, scene.animations.count() > 0);
 
@@ -1620,7 +1660,7 @@ void writeQml(const QSSGSceneDesc::Scene &scene, QTextStream &stream, const QDir
     QList<QPair<QString, QString>> animationMap;
     for (const auto &cld : scene.animations) {
         QSSGQmlScopedIndent scopedIndent(output);
-        auto mapValues = writeQmlForAnimation(*cld, animId++, output, useBinaryKeyframes, generateTimelineAnimations);
+        auto mapValues = writeQmlForAnimation(scene, *cld, animId++, output, useBinaryKeyframes, generateTimelineAnimations);
         animationMap.append(mapValues);
         indent(output) << blockEnd(output);
     }
@@ -1643,6 +1683,55 @@ void writeQml(const QSSGSceneDesc::Scene &scene, QTextStream &stream, const QDir
     indent(output) << blockEnd(output);
 }
 
+void writeQml(const QSSGSceneDesc::Scene &scene, QTextStream &stream, const QDir &outdir, const QJsonObject &optionsObject)
+{
+    writeQmlImp(scene, stream, outdir, optionsObject, nullptr);
+}
+
+QString writeQmlFile(const QSSGSceneDesc::Scene &scene,
+                     const QString &sourceFile,
+                     const QDir &outdir,
+                     const QJsonObject &optionsObject,
+                     QStringList *generatedFiles,
+                     QStringList *ids)
+{
+    const QString targetFileName = outdir.absolutePath() + QDir::separator()
+            + qmlComponentName(QFileInfo(sourceFile).completeBaseName()) + QStringLiteral(".qml");
+    QFile targetFile(targetFileName);
+    if (!targetFile.open(QIODevice::WriteOnly))
+        return QStringLiteral("Could not write to file: ") + targetFileName;
+
+    if (ids) {
+        const QMutexLocker locker(&g_idMutex);
+        g_sceneIds->insert(&scene, QStringList());
+    }
+
+    QStringList resourceFiles;
+    QTextStream output(&targetFile);
+    writeQmlImp(scene, output, outdir, optionsObject, &resourceFiles);
+
+    if (ids) {
+        const QMutexLocker locker(&g_idMutex);
+        *ids += g_sceneIds->take(&scene);
+    }
+    if (generatedFiles) {
+        // Meshes and textures used by several objects are listed once
+        resourceFiles.removeDuplicates();
+        generatedFiles->append(targetFileName);
+        generatedFiles->append(resourceFiles);
+    }
+    return QString();
+}
+
+void reserveIds(const QStringList &ids)
+{
+    const QMutexLocker locker(&g_idMutex);
+    for (const QString &id : ids) {
+        if (!g_idMap->contains(id))
+            g_idMap->insert(id, nullptr);
+    }
+}
+
 void createTimelineAnimation(const QSSGSceneDesc::Animation &anim, QObject *parent, bool isEnabled, bool useBinaryKeyframes)
 {
 #ifdef QT_QUICK3D_ENABLE_RT_ANIMATIONS
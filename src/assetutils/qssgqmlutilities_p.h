@@ -18,6 +18,7 @@
 #include <QtQuick3DAssetUtils/private/qtquick3dassetutilsglobal_p.h>
 
 #include <QString>
+#include <QStringList>
 #include <QColor>
 #include <QVariant>
 #include <QHash>
@@ -48,6 +49,19 @@ QString Q_QUICK3DASSETUTILS_EXPORT sanitizeQmlSourcePath(const QString &source,
 QString Q_QUICK3DASSETUTILS_EXPORT stripParentDirectory(const QString &filePath);
 
 void Q_QUICK3DASSETUTILS_EXPORT writeQml(const QSSGSceneDesc::Scene &scene, QTextStream &stream, const QDir &outdir, const QJsonObject &optionsObject = QJsonObject());
+// Writes the scene as a component named after sourceFile to outdir, together
+// with its meshes, textures and animations. The paths of all the written files
+// are added to generatedFiles, the ids given to the objects of the scene to
+// ids. Returns an error message, empty on success.
+QString Q_QUICK3DASSETUTILS_EXPORT writeQmlFile(const QSSGSceneDesc::Scene &scene,
+                                                const QString &sourceFile,
+                                                const QDir &outdir,
+                                                const QJsonObject &optionsObject = QJsonObject(),
+                                                QStringList *generatedFiles = nullptr,
+                                                QStringList *ids = nullptr);
+// Keeps the ids from being given to the objects of the scenes written later,
+// e.g. the ids used by the files of an earlier conversion that are kept.
+void Q_QUICK3DASSETUTILS_EXPORT reserveIds(const QStringList &ids);
 void Q_QUICK3DASSETUTILS_EXPORT writeQmlComponent(const QSSGSceneDesc::Node &node, QTextStream &stream, const QDir &outDir);
 
 Q_REQUIRED_RESULT QString Q_QUICK3DASSETUTILS_EXPORT getMeshSourceName(const QByteArrayView &name);
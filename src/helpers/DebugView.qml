@@ -127,10 +127,20 @@ Pane {
                             text: root.source.renderStats.drawVertexCount + " vertices"
                             visible: root.resourceDetailsVisible
                         }
+                        Label {
+                            text: "Culled: " + root.source.renderStats.frustumCulledObjectCount + " outside of view, "
+                                  + root.source.renderStats.occlusionCulledObjectCount + " occluded"
+                            visible: root.resourceDetailsVisible
+                        }
                         Label {
                             text: "Image assets: " + (root.source.renderStats.imageDataSize / 1024).toFixed(2) + " KB"
                             visible: root.resourceDetailsVisible
                         }
+                        Label {
+                            text: "Streamed images: " + (root.source.renderStats.streamedTextureResidentSize / 1024).toFixed(2)
+                                  + " / " + (root.source.renderStats.streamedTextureRequestedSize / 1024).toFixed(2) + " KB"
+                            visible: root.resourceDetailsVisible && root.source.renderStats.streamedTextureRequestedSize > 0
+                        }
                         Label {
                             text: "Mesh assets: " + (root.source.renderStats.meshDataSize / 1024).toFixed(2) + " KB"
                             visible: root.resourceDetailsVisible
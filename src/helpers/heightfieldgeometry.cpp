@@ -3,6 +3,8 @@
 
 #include "heightfieldgeometry_p.h"
 
+#include <QtCore/qfileinfo.h>
+
 /*!
     \qmltype HeightFieldGeometry
     \inqmlmodule QtQuick3D.Helpers
@@ -102,6 +104,39 @@ void HeightFieldGeometry::setExtents(const QVector3D &newExtents)
     emit extentsChanged();
 }
 
+HeightMap HeightMap::load(const QString &fileName)
+{
+    HeightMap heightMap;
+    QImage image(fileName);
+    if (image.isNull())
+        return heightMap;
+
+    heightMap.width = image.width();
+    heightMap.height = image.height();
+    heightMap.samples.resize(qsizetype(heightMap.width) * heightMap.height);
+    quint16 *dst = heightMap.samples.data();
+
+    // 16-bit height maps keep their precision
+    if (image.format() == QImage::Format_Grayscale16) {
+        for (int y = 0; y < heightMap.height; ++y) {
+            const auto *src = reinterpret_cast<const quint16 *>(image.constScanLine(y));
+            std::copy(src, src + heightMap.width, dst);
+            dst += heightMap.width;
+        }
+        return heightMap;
+    }
+
+    // The height is the value of the color, the largest of its components,
+    // like QColor::valueF(). For gray images this is the gray level.
+    image.convertTo(QImage::Format_RGBA64);
+    for (int y = 0; y < heightMap.height; ++y) {
+        const auto *src = reinterpret_cast<const QRgba64 *>(image.constScanLine(y));
+        for (int x = 0; x < heightMap.width; ++x)
+            *dst++ = qMax(src[x].red(), qMax(src[x].green(), src[x].blue()));
+    }
+    return heightMap;
+}
+
 struct HeightFieldVertex
 {
     QVector3D position;
@@ -118,11 +153,19 @@ void HeightFieldGeometry::updateData()
         return;
 
     clear();
-    const auto qmlSource = QQmlFile::urlToLocalFileOrQrc(resolvedUrl);
 
-    QImage heightMap(qmlSource);
-    int numRows = heightMap.height();
-    int numCols = heightMap.width();
+    // Only read the image again when it is another one, or the file changed
+    const QString fileName = QQmlFile::urlToLocalFileOrQrc(resolvedUrl);
+    const QDateTime lastModified = QFileInfo(fileName).lastModified();
+    if (resolvedUrl != m_loadedUrl || lastModified != m_loadedLastModified) {
+        m_heightMap = HeightMap::load(fileName);
+        m_loadedUrl = resolvedUrl;
+        m_loadedLastModified = lastModified;
+    }
+
+    const HeightMap &heightMap = m_heightMap;
+    int numRows = heightMap.height;
+    int numCols = heightMap.width;
 
     if (numRows < 2 || numCols < 2)
         return;
@@ -154,7 +197,7 @@ void HeightFieldGeometry::updateData()
     const float colOffs = -m_extents.x() / 2;
     for (int x = 0; x < numCols; x++) {
         for (int y = 0; y < numRows; y++) {
-            float f = heightMap.pixelColor(x, y).valueF() - 0.5;
+            float f = heightMap.valueAt(x, y);
             HeightFieldVertex vertex;
             vertex.position = QVector3D(x * colF + colOffs, f * m_extents.y(), y * rowF + rowOffs);
             vertex.normal = QVector3D(0, 0, 0);
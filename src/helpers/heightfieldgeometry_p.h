@@ -17,11 +17,29 @@
 
 #include <QtQuick3D/private/qquick3dgeometry_p.h>
 
+#include <QtCore/qdatetime.h>
+
 // Workaround for QTBUG-94099, ensures qml_register_types...() is exported
 #include "qtquick3dhelpersglobal_p.h"
 
 QT_BEGIN_NAMESPACE
 
+// Heights of a height map image, normalized to 16 bits. The height of a pixel
+// is the value of its color, that is the gray level of grayscale images.
+struct HeightMap
+{
+    int width = 0;
+    int height = 0;
+    QVector<quint16> samples; // row by row
+
+    static HeightMap load(const QString &fileName);
+
+    bool isValid() const { return width >= 2 && height >= 2; }
+    quint16 at(int x, int y) const { return samples.at(y * width + x); }
+    // In the range [-0.5, 0.5]
+    float valueAt(int x, int y) const { return at(x, y) / 65535.0f - 0.5f; }
+};
+
 class HeightFieldGeometry : public QQuick3DGeometry
 {
     Q_OBJECT
@@ -49,6 +67,9 @@ private:
     void updateData();
     QVector3D m_extents = { 100, 100, 100 };
     QUrl m_heightMapSource;
+    QUrl m_loadedUrl;
+    QDateTime m_loadedLastModified;
+    HeightMap m_heightMap;
     bool m_smoothShading = true;
     bool m_extentsSetExplicitly = false;
 
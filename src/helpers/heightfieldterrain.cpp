@@ -0,0 +1,834 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "heightfieldterrain_p.h"
+#include "heightfieldgeometry_p.h"
+
+#include <QtQuick3D/private/qquick3dobject_p.h>
+#include <QtQuick3D/private/qquick3dmodel_p.h>
+#include <QtQuick3D/private/qquick3dperspectivecamera_p.h>
+#include <QtQuick3D/private/qquick3dscenemanager_p.h>
+#include <QtQuick3D/qquick3dgeometry.h>
+
+#include <QtQml/qqmlcontext.h>
+#include <QtQml/qqmlfile.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtCore/qmath.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthreadpool.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype HeightFieldTerrain
+    \inqmlmodule QtQuick3D.Helpers
+    \inherits Node
+    \since 6.8
+    \brief A height field terrain with levels of detail.
+
+    This helper shows a surface built from a grayscale image, like
+    \l HeightFieldGeometry, but splits it into chunks that are organized in a
+    quadtree. Each chunk is a separate model with its own bounds, so chunks
+    outside the view are culled when \l Camera::frustumCullingEnabled is set.
+    Chunks far from the \l camera use fewer vertices: for every chunk, the
+    largest vertical error of its coarser version is projected on screen, and
+    the chunk is split into its four finer children while this error exceeds
+    \l maximumScreenError pixels.
+
+    The height map is read and the chunks are generated in background threads,
+    and only the chunks that are shown, and a limited number of recently shown
+    ones, are kept in memory. This allows using height maps that would be far
+    too large for a single \l HeightFieldGeometry. 16-bit grayscale images are
+    used with their full precision.
+
+    Neighboring chunks of different detail do not share all their vertices. To
+    hide the cracks that this would show, the chunks have skirts: strips of
+    triangles hanging down from their inner edges.
+
+    \qml
+    HeightFieldTerrain {
+        source: "heightmap.png"
+        extents: Qt.vector3d(4000, 400, 4000)
+        camera: mainCamera
+        materials: PrincipledMaterial {
+            baseColorMap: Texture { source: "terrain_color.png" }
+        }
+    }
+    \endqml
+
+    \note The terrain is shown with its lowest detail when no \l camera is set.
+*/
+
+/*!
+    \qmlproperty url HeightFieldTerrain::source
+    This property defines the URL of the height map image.
+*/
+
+/*!
+    \qmlproperty vector3d HeightFieldTerrain::extents
+    This property defines the extents of the terrain, that is the dimensions of
+    a box large enough to always contain it. The default value is
+    (100, 100, 100) when the image is square.
+*/
+
+/*!
+    \qmlproperty int HeightFieldTerrain::chunkResolution
+    This property defines the number of squares along each side of a chunk.
+    Larger chunks mean fewer draw calls, smaller chunks follow the required
+    detail more closely and are culled more precisely.
+
+    The default value is \c 64.
+*/
+
+/*!
+    \qmlproperty real HeightFieldTerrain::maximumScreenError
+    This property defines the largest error, in pixels, that a chunk may have
+    on screen before it is replaced by its finer children.
+
+    The default value is \c 2.0.
+*/
+
+/*!
+    \qmlproperty Camera HeightFieldTerrain::camera
+    This property defines the camera used to choose the detail of the chunks.
+    The screen size is taken from the window, and the field of view from the
+    camera when it is a \l PerspectiveCamera.
+*/
+
+/*!
+    \qmlproperty List<QtQuick3D::Material> HeightFieldTerrain::materials
+    This property defines the materials of the terrain chunks.
+*/
+
+/*!
+    \qmlproperty bool HeightFieldTerrain::loading
+    \readonly
+    This property is \c true while the height map is being read or chunks are
+    being generated in the background.
+*/
+
+// The band around maximumScreenError in which a chunk keeps its current detail
+static constexpr float selectionHysteresis = 0.1f;
+// Chunks that are not shown anymore, kept in case they are needed again soon
+static constexpr int maxCachedChunks = 64;
+
+struct HeightFieldTerrain::Guard
+{
+    QMutex mutex;
+    HeightFieldTerrain *terrain = nullptr;
+};
+
+// The quadtree of the chunks. Each level has 4^level nodes, the chunks of the
+// leaves use every sample of the height map, the ones above every other
+// sample of the level below.
+struct HeightFieldTerrain::Tree
+{
+    struct Node {
+        float minHeight = 0.0f;
+        float maxHeight = 0.0f;
+        float error = 0.0f; // largest height difference to the full resolution
+        bool empty = true;
+    };
+
+    HeightMap heightMap;
+    int chunkResolution = 64;
+    int depth = 0;
+    QVector<int> levelOffsets;
+    QVector<Node> nodes;
+
+    int stride(int level) const { return 1 << (depth - level); }
+    int index(int level, int x, int y) const { return levelOffsets.at(level) + y * (1 << level) + x; }
+    QRect sampleRect(int level, int x, int y) const
+    {
+        const int span = chunkResolution * stride(level);
+        const int x0 = x * span;
+        const int y0 = y * span;
+        return QRect(QPoint(x0, y0), QPoint(qMin(x0 + span, heightMap.width - 1), qMin(y0 + span, heightMap.height - 1)));
+    }
+
+    static std::shared_ptr<const Tree> build(HeightMap heightMap, int chunkResolution);
+    float deviation(const QRect &rect, int stride) const;
+};
+
+struct HeightFieldTerrain::ChunkMesh
+{
+    QByteArray vertexData;
+    QByteArray indexData;
+    bool shortIndices = false;
+    QVector3D boundsMin;
+    QVector3D boundsMax;
+};
+
+// Calls f for the samples from first to last, every step, always including last
+template<typename F>
+static void forEachSample(int first, int last, int step, F f)
+{
+    for (int i = first; ; i = qMin(i + step, last)) {
+        f(i);
+        if (i == last)
+            break;
+    }
+}
+
+// The largest difference between the samples a grid with half the stride
+// uses, and the surface of the grid with the given stride
+float HeightFieldTerrain::Tree::deviation(const QRect &rect, int stride) const
+{
+    const int half = stride / 2;
+    const int x0 = rect.left();
+    const int y0 = rect.top();
+    const int x1 = rect.right();
+    const int y1 = rect.bottom();
+    float result = 0.0f;
+    forEachSample(y0, y1, half, [&](int y) {
+        const int gy0 = y0 + (y - y0) / stride * stride;
+        const int gy1 = qMin(gy0 + stride, y1);
+        const float ty = gy1 > gy0 ? float(y - gy0) / float(gy1 - gy0) : 0.0f;
+        forEachSample(x0, x1, half, [&](int x) {
+            const int gx0 = x0 + (x - x0) / stride * stride;
+            const int gx1 = qMin(gx0 + stride, x1);
+            if (x == gx0 && y == gy0)
+                return;
+            const float tx = gx1 > gx0 ? float(x - gx0) / float(gx1 - gx0) : 0.0f;
+            const float top = heightMap.at(gx0, gy0) * (1.0f - tx) + heightMap.at(gx1, gy0) * tx;
+            const float bottom = heightMap.at(gx0, gy1) * (1.0f - tx) + heightMap.at(gx1, gy1) * tx;
+            const float interpolated = top * (1.0f - ty) + bottom * ty;
+            result = qMax(result, qAbs(heightMap.at(x, y) - interpolated));
+        });
+    });
+    return result / 65535.0f;
+}
+
+std::shared_ptr<const HeightFieldTerrain::Tree> HeightFieldTerrain::Tree::build(HeightMap heightMap, int chunkResolution)
+{
+    auto tree = std::make_shared<Tree>();
+    if (!heightMap.isValid())
+        return tree;
+
+    tree->heightMap = std::move(heightMap);
+    tree->chunkResolution = chunkResolution;
+    const int size = qMax(tree->heightMap.width, tree->heightMap.height) - 1;
+    while ((chunkResolution << tree->depth) < size)
+        ++tree->depth;
+
+    int count = 0;
+    for (int level = 0; level <= tree->depth; ++level) {
+        tree->levelOffsets.append(count);
+        count += 1 << (2 * level);
+    }
+    tree->nodes.resize(count);
+
+    // Bottom up, the bounds and errors of a node include the ones of its children
+    for (int level = tree->depth; level >= 0; --level) {
+        const int nodesAcross = 1 << level;
+        for (int y = 0; y < nodesAcross; ++y) {
+            for (int x = 0; x < nodesAcross; ++x) {
+                const QRect rect = tree->sampleRect(level, x, y);
+                if (rect.left() >= tree->heightMap.width - 1 || rect.top() >= tree->heightMap.height - 1)
+                    continue;
+
+                Node &node = tree->nodes[tree->index(level, x, y)];
+                node.empty = false;
+                if (level == tree->depth) {
+                    quint16 minHeight = std::numeric_limits<quint16>::max();
+                    quint16 maxHeight = 0;
+                    for (int sy = rect.top(); sy <= rect.bottom(); ++sy) {
+                        for (int sx = rect.left(); sx <= rect.right(); ++sx) {
+                            const quint16 h = tree->heightMap.at(sx, sy);
+                            minHeight = qMin(minHeight, h);
+                            maxHeight = qMax(maxHeight, h);
+                        }
+                    }
+                    node.minHeight = minHeight / 65535.0f - 0.5f;
+                    node.maxHeight = maxHeight / 65535.0f - 0.5f;
+                    continue;
+                }
+
+                node.minHeight = std::numeric_limits<float>::max();
+                node.maxHeight = -std::numeric_limits<float>::max();
+                float childError = 0.0f;
+                for (int i = 0; i < 4; ++i) {
+                    const Node &child = tree->nodes.at(tree->index(level + 1, 2 * x + (i & 1), 2 * y + (i >> 1)));
+                    if (child.empty)
+                        continue;
+                    node.minHeight = qMin(node.minHeight, child.minHeight);
+                    node.maxHeight = qMax(node.maxHeight, child.maxHeight);
+                    childError = qMax(childError, child.error);
+                }
+                node.error = childError + tree->deviation(rect, tree->stride(level));
+            }
+        }
+    }
+
+    return tree;
+}
+
+struct TerrainVertex
+{
+    QVector3D position;
+    QVector3D normal;
+    QVector2D uv;
+};
+
+static HeightFieldTerrain::ChunkMesh generateChunk(const HeightFieldTerrain::Tree &tree,
+                                                   int level, int x, int y,
+                                                   const QVector3D &extents)
+{
+    const HeightMap &heightMap = tree.heightMap;
+    const int stride = tree.stride(level);
+    const QRect rect = tree.sampleRect(level, x, y);
+
+    // Same layout as HeightFieldGeometry
+    const float rowF = extents.z() / (heightMap.height - 1);
+    const float rowOffs = -extents.z() / 2;
+    const float colF = extents.x() / (heightMap.width - 1);
+    const float colOffs = -extents.x() / 2;
+
+    const auto vertexAt = [&](int sx, int sy) {
+        // Normals from the full resolution, so that they match between levels
+        const int xl = qMax(sx - 1, 0);
+        const int xr = qMin(sx + 1, heightMap.width - 1);
+        const int yt = qMax(sy - 1, 0);
+        const int yb = qMin(sy + 1, heightMap.height - 1);
+        const float dx = (heightMap.valueAt(xr, sy) - heightMap.valueAt(xl, sy)) * extents.y() / ((xr - xl) * colF);
+        const float dz = (heightMap.valueAt(sx, yb) - heightMap.valueAt(sx, yt)) * extents.y() / ((yb - yt) * rowF);
+        TerrainVertex vertex;
+        vertex.position = QVector3D(sx * colF + colOffs, heightMap.valueAt(sx, sy) * extents.y(), sy * rowF + rowOffs);
+        vertex.normal = QVector3D(-dx, 1.0f, -dz).normalized();
+        vertex.uv = QVector2D(float(sx) / (heightMap.width - 1), 1.f - float(sy) / (heightMap.height - 1));
+        return vertex;
+    };
+
+    QVector<int> columns;
+    QVector<int> rows;
+    forEachSample(rect.left(), rect.right(), stride, [&](int i) { columns.append(i); });
+    forEachSample(rect.top(), rect.bottom(), stride, [&](int i) { rows.append(i); });
+    const int numCols = columns.size();
+    const int numRows = rows.size();
+
+    QVector<TerrainVertex> vertices;
+    vertices.reserve(numCols * numRows + 2 * (numCols + numRows));
+    for (int sy : std::as_const(rows)) {
+        for (int sx : std::as_const(columns))
+            vertices.append(vertexAt(sx, sy));
+    }
+
+    QVector<quint32> indices;
+    indices.reserve((numCols - 1) * (numRows - 1) * 6 + 4 * (numCols + numRows) * 6);
+    for (int iy = 0; iy < numRows - 1; ++iy) {
+        for (int ix = 0; ix < numCols - 1; ++ix) {
+            const quint32 idx = iy * numCols + ix;
+            indices << idx + numCols + 1 << idx + 1 << idx;
+            indices << idx + numCols << idx + numCols + 1 << idx;
+        }
+    }
+
+    // Skirts along the edges shared with other chunks, deep enough to cover
+    // the cracks to neighbors of any detail. No neighbor across an edge is
+    // coarser than the largest node with that edge on its border, or that node
+    // would be selected instead of this chunk. The errors only grow towards the
+    // root, so no crack is deeper than the error of this chunk and of that node.
+    const float ownError = tree.nodes.at(tree.index(level, x, y)).error;
+    const auto skirtDepth = [&](int dx, int dy) {
+        const int edge = dx < 0 ? x : dx > 0 ? x + 1 : dy < 0 ? y : y + 1;
+        int coarsest = level;
+        while (coarsest > 0 && (edge & ((1 << (level - coarsest + 1)) - 1)) == 0)
+            --coarsest;
+        const int nx = (x >> (level - coarsest)) + dx;
+        const int ny = (y >> (level - coarsest)) + dy;
+        float neighborError = 0.0f;
+        if (nx >= 0 && ny >= 0 && nx < (1 << coarsest) && ny < (1 << coarsest)) {
+            const HeightFieldTerrain::Tree::Node &neighbor = tree.nodes.at(tree.index(coarsest, nx, ny));
+            if (!neighbor.empty)
+                neighborError = neighbor.error;
+        }
+        return (ownError + neighborError) * extents.y() + stride * qMin(colF, rowF) * 0.5f;
+    };
+    const auto addSkirt = [&](int first, int count, int step, float depth) {
+        const quint32 skirtStart = vertices.size();
+        for (int i = 0; i < count; ++i) {
+            TerrainVertex vertex = vertices.at(first + i * step);
+            vertex.position.setY(vertex.position.y() - depth);
+            vertices.append(vertex);
+        }
+        for (int i = 0; i < count - 1; ++i) {
+            const quint32 a = first + i * step;
+            const quint32 b = first + (i + 1) * step;
+            const quint32 as = skirtStart + i;
+            const quint32 bs = skirtStart + i + 1;
+            // Both sides, the skirts are seen from either one through the cracks
+            indices << a << as << b << b << as << bs;
+            indices << a << b << as << b << bs << as;
+        }
+    };
+    if (rect.top() > 0)
+        addSkirt(0, numCols, 1, skirtDepth(0, -1));
+    if (rect.bottom() < heightMap.height - 1)
+        addSkirt((numRows - 1) * numCols, numCols, 1, skirtDepth(0, 1));
+    if (rect.left() > 0)
+        addSkirt(0, numRows, numCols, skirtDepth(-1, 0));
+    if (rect.right() < heightMap.width - 1)
+        addSkirt(numCols - 1, numRows, numCols, skirtDepth(1, 0));
+
+    HeightFieldTerrain::ChunkMesh mesh;
+    mesh.boundsMin = vertices.first().position;
+    mesh.boundsMax = mesh.boundsMin;
+    for (const auto &vertex : std::as_const(vertices)) {
+        const auto &p = vertex.position;
+        mesh.boundsMin = QVector3D(qMin(mesh.boundsMin.x(), p.x()), qMin(mesh.boundsMin.y(), p.y()), qMin(mesh.boundsMin.z(), p.z()));
+        mesh.boundsMax = QVector3D(qMax(mesh.boundsMax.x(), p.x()), qMax(mesh.boundsMax.y(), p.y()), qMax(mesh.boundsMax.z(), p.z()));
+    }
+
+    mesh.vertexData = QByteArray(reinterpret_cast<const char *>(vertices.constData()), vertices.size() * sizeof(TerrainVertex));
+    mesh.shortIndices = vertices.size() <= std::numeric_limits<quint16>::max();
+    if (mesh.shortIndices) {
+        mesh.indexData.resize(indices.size() * sizeof(quint16));
+        auto *dst = reinterpret_cast<quint16 *>(mesh.indexData.data());
+        for (quint32 index : std::as_const(indices))
+            *dst++ = quint16(index);
+    } else {
+        mesh.indexData = QByteArray(reinterpret_cast<const char *>(indices.constData()), indices.size() * sizeof(quint32));
+    }
+    return mesh;
+}
+
+HeightFieldTerrain::HeightFieldTerrain(QQuick3DNode *parent)
+    : QQuick3DNode(parent)
+    , m_guard(std::make_shared<Guard>())
+{
+    m_guard->terrain = this;
+    connect(this, &QQuick3DNode::sceneTransformChanged, this, &HeightFieldTerrain::scheduleSelection);
+}
+
+HeightFieldTerrain::~HeightFieldTerrain()
+{
+    // Results of the jobs still running are dropped from here on
+    QMutexLocker locker(&m_guard->mutex);
+    m_guard->terrain = nullptr;
+}
+
+const QUrl &HeightFieldTerrain::source() const
+{
+    return m_source;
+}
+
+void HeightFieldTerrain::setSource(const QUrl &newSource)
+{
+    if (m_source == newSource)
+        return;
+    m_source = newSource;
+    if (isComponentComplete())
+        load();
+    emit sourceChanged();
+}
+
+const QVector3D &HeightFieldTerrain::extents() const
+{
+    return m_extents;
+}
+
+void HeightFieldTerrain::setExtents(const QVector3D &newExtents)
+{
+    m_extentsSetExplicitly = true;
+    if (m_extents == newExtents)
+        return;
+    m_extents = newExtents;
+
+    // The tree does not depend on the extents, only the chunks do, a tree
+    // that is still loading is kept
+    releaseChunks();
+    ++m_chunkGeneration;
+    scheduleSelection();
+    emit extentsChanged();
+}
+
+int HeightFieldTerrain::chunkResolution() const
+{
+    return m_chunkResolution;
+}
+
+void HeightFieldTerrain::setChunkResolution(int chunkResolution)
+{
+    chunkResolution = qBound(2, chunkResolution, 1024);
+    if (m_chunkResolution == chunkResolution)
+        return;
+    m_chunkResolution = chunkResolution;
+    if (isComponentComplete())
+        load();
+    emit chunkResolutionChanged();
+}
+
+float HeightFieldTerrain::maximumScreenError() const
+{
+    return m_maximumScreenError;
+}
+
+void HeightFieldTerrain::setMaximumScreenError(float maximumScreenError)
+{
+    maximumScreenError = qMax(0.0f, maximumScreenError);
+    if (qFuzzyCompare(m_maximumScreenError, maximumScreenError))
+        return;
+    m_maximumScreenError = maximumScreenError;
+    scheduleSelection();
+    emit maximumScreenErrorChanged();
+}
+
+QQuick3DCamera *HeightFieldTerrain::camera() const
+{
+    return m_camera;
+}
+
+void HeightFieldTerrain::setCamera(QQuick3DCamera *camera)
+{
+    if (m_camera == camera)
+        return;
+
+    for (const auto &connection : std::as_const(m_cameraConnections))
+        disconnect(connection);
+    m_cameraConnections.clear();
+
+    m_camera = camera;
+    if (m_camera) {
+        m_cameraConnections.append(connect(m_camera, &QQuick3DNode::sceneTransformChanged,
+                                           this, &HeightFieldTerrain::scheduleSelection));
+        m_cameraConnections.append(connect(m_camera, &QObject::destroyed, this, [this] { setCamera(nullptr); }));
+        if (auto *perspectiveCamera = qobject_cast<QQuick3DPerspectiveCamera *>(m_camera)) {
+            m_cameraConnections.append(connect(perspectiveCamera, &QQuick3DPerspectiveCamera::fieldOfViewChanged,
+                                               this, &HeightFieldTerrain::scheduleSelection));
+        }
+    }
+    scheduleSelection();
+    emit cameraChanged();
+}
+
+QQmlListProperty<QQuick3DMaterial> HeightFieldTerrain::materials()
+{
+    return QQmlListProperty<QQuick3DMaterial>(this,
+                                              nullptr,
+                                              HeightFieldTerrain::qmlAppendMaterial,
+                                              HeightFieldTerrain::qmlMaterialsCount,
+                                              HeightFieldTerrain::qmlMaterialAt,
+                                              HeightFieldTerrain::qmlClearMaterials);
+}
+
+bool HeightFieldTerrain::isLoading() const
+{
+    return m_loading;
+}
+
+void HeightFieldTerrain::componentComplete()
+{
+    QQuick3DNode::componentComplete();
+    load();
+}
+
+void HeightFieldTerrain::load()
+{
+    releaseChunks();
+    m_tree.reset();
+    m_chunks.clear();
+    ++m_chunkGeneration;
+    const quint32 generation = ++m_treeGeneration;
+
+    const QQmlContext *context = qmlContext(this);
+    const auto resolvedUrl = context ? context->resolvedUrl(m_source) : m_source;
+    m_treeLoading = resolvedUrl.isValid();
+    updateLoading();
+    if (!m_treeLoading)
+        return;
+
+    const QString fileName = QQmlFile::urlToLocalFileOrQrc(resolvedUrl);
+    QThreadPool::globalInstance()->start([guard = m_guard, fileName, chunkResolution = m_chunkResolution, generation] {
+        const std::shared_ptr<const Tree> tree = Tree::build(HeightMap::load(fileName), chunkResolution);
+        QMutexLocker locker(&guard->mutex);
+        if (HeightFieldTerrain *terrain = guard->terrain) {
+            QMetaObject::invokeMethod(terrain, [terrain, generation, tree] {
+                terrain->treeLoaded(generation, tree);
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+void HeightFieldTerrain::treeLoaded(quint32 generation, const std::shared_ptr<const Tree> &tree)
+{
+    if (generation != m_treeGeneration)
+        return;
+
+    m_treeLoading = false;
+    if (tree->nodes.isEmpty()) {
+        qWarning("HeightFieldTerrain: Failed to load height map %s", qPrintable(m_source.toString()));
+        updateLoading();
+        return;
+    }
+
+    m_tree = tree;
+    m_chunks.resize(tree->nodes.size());
+
+    if (!m_extentsSetExplicitly) {
+        const int numCols = tree->heightMap.width;
+        const int numRows = tree->heightMap.height;
+        const QVector3D prevExt = m_extents;
+        if (numRows == numCols)
+            m_extents = { 100, 100, 100 };
+        else if (numRows < numCols)
+            m_extents = { 100.f, 100.f, 100.f * float(numRows) / float(numCols) };
+        else
+            m_extents = { 100.f * float(numCols) / float(numRows), 100.f, 100.f };
+        if (m_extents != prevExt)
+            emit extentsChanged();
+    }
+
+    scheduleSelection();
+    updateLoading();
+}
+
+void HeightFieldTerrain::releaseChunks()
+{
+    for (Chunk &chunk : m_chunks) {
+        delete chunk.model;
+        chunk = Chunk();
+    }
+    m_pendingChunks = 0;
+    updateLoading();
+}
+
+void HeightFieldTerrain::requestChunk(int level, int x, int y)
+{
+    // Not more than the threads can take, the rest is requested again once
+    // these are done, by when the camera may have moved on.
+    if (m_pendingChunks >= QThreadPool::globalInstance()->maxThreadCount())
+        return;
+
+    const int index = m_tree->index(level, x, y);
+    m_chunks[index].pending = true;
+    ++m_pendingChunks;
+    QThreadPool::globalInstance()->start([guard = m_guard, tree = m_tree, level, x, y, index,
+                                          extents = m_extents, generation = m_chunkGeneration] {
+        const ChunkMesh mesh = generateChunk(*tree, level, x, y, extents);
+        QMutexLocker locker(&guard->mutex);
+        if (HeightFieldTerrain *terrain = guard->terrain) {
+            QMetaObject::invokeMethod(terrain, [terrain, generation, index, mesh] {
+                terrain->chunkGenerated(generation, index, mesh);
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+void HeightFieldTerrain::chunkGenerated(quint32 generation, int index, const ChunkMesh &mesh)
+{
+    if (generation != m_chunkGeneration)
+        return;
+
+    Chunk &chunk = m_chunks[index];
+    chunk.pending = false;
+    --m_pendingChunks;
+
+    auto *geometry = new QQuick3DGeometry;
+    geometry->addAttribute(QQuick3DGeometry::Attribute::PositionSemantic, 0, QQuick3DGeometry::Attribute::F32Type);
+    geometry->addAttribute(QQuick3DGeometry::Attribute::NormalSemantic, sizeof(QVector3D), QQuick3DGeometry::Attribute::F32Type);
+    geometry->addAttribute(QQuick3DGeometry::Attribute::TexCoord0Semantic, sizeof(QVector3D) * 2, QQuick3DGeometry::Attribute::F32Type);
+    geometry->addAttribute(QQuick3DGeometry::Attribute::IndexSemantic, 0,
+                           mesh.shortIndices ? QQuick3DGeometry::Attribute::U16Type : QQuick3DGeometry::Attribute::U32Type);
+    geometry->setStride(sizeof(TerrainVertex));
+    geometry->setPrimitiveType(QQuick3DGeometry::PrimitiveType::Triangles);
+    geometry->setVertexData(mesh.vertexData);
+    geometry->setIndexData(mesh.indexData);
+    geometry->setBounds(mesh.boundsMin, mesh.boundsMax);
+
+    auto *model = new QQuick3DModel;
+    model->setParent(this);
+    model->setParentItem(this);
+    geometry->setParent(model);
+    model->setGeometry(geometry);
+    applyMaterials(model);
+    model->setVisible(false);
+    chunk.model = model;
+
+    scheduleSelection();
+    updateLoading();
+}
+
+void HeightFieldTerrain::scheduleSelection()
+{
+    if (m_selectionPending)
+        return;
+    m_selectionPending = true;
+    QMetaObject::invokeMethod(this, &HeightFieldTerrain::updateSelection, Qt::QueuedConnection);
+}
+
+void HeightFieldTerrain::updateSelection()
+{
+    m_selectionPending = false;
+    if (!m_tree)
+        return;
+    ++m_serial;
+
+    // Pixels per scene unit at a distance of one
+    QVector3D cameraPosition;
+    float pixelScale = 0.0f;
+    if (m_camera) {
+        cameraPosition = mapPositionFromScene(m_camera->scenePosition());
+        float fieldOfView = 60.0f;
+        if (auto *perspectiveCamera = qobject_cast<QQuick3DPerspectiveCamera *>(m_camera))
+            fieldOfView = perspectiveCamera->fieldOfView();
+        float screenHeight = 1080.0f;
+        const auto &sceneManager = QQuick3DObjectPrivate::get(this)->sceneManager;
+        if (sceneManager && sceneManager->window())
+            screenHeight = sceneManager->window()->height();
+        pixelScale = screenHeight / (2.0f * qTan(qDegreesToRadians(fieldOfView) * 0.5f));
+    }
+
+    selectNode(0, 0, 0, cameraPosition, pixelScale);
+
+    QVector<std::pair<quint32, int>> unused;
+    for (int i = 0; i < m_chunks.size(); ++i) {
+        Chunk &chunk = m_chunks[i];
+        if (!chunk.model)
+            continue;
+        chunk.model->setVisible(chunk.selected == m_serial);
+        if (chunk.lastUsed != m_serial)
+            unused.append({ chunk.lastUsed, i });
+    }
+
+    // Least recently used first
+    if (unused.size() > maxCachedChunks) {
+        std::sort(unused.begin(), unused.end());
+        for (qsizetype i = 0; i < unused.size() - maxCachedChunks; ++i) {
+            Chunk &chunk = m_chunks[unused.at(i).second];
+            delete chunk.model;
+            chunk.model = nullptr;
+            chunk.refined = false;
+        }
+    }
+}
+
+void HeightFieldTerrain::selectNode(int level, int x, int y, const QVector3D &cameraPosition, float pixelScale)
+{
+    const Tree &tree = *m_tree;
+    const int index = tree.index(level, x, y);
+    const Tree::Node &node = tree.nodes.at(index);
+    if (node.empty)
+        return;
+
+    Chunk &chunk = m_chunks[index];
+    chunk.lastUsed = m_serial;
+    if (!chunk.model && !chunk.pending)
+        requestChunk(level, x, y);
+
+    bool refine = false;
+    if (level < tree.depth && pixelScale > 0.0f) {
+        const float distance = qMax(distanceToNode(level, x, y, cameraPosition), std::numeric_limits<float>::epsilon());
+        const float screenError = node.error * m_extents.y() * pixelScale / distance;
+        const float threshold = chunk.refined ? m_maximumScreenError * (1.0f - selectionHysteresis)
+                                              : m_maximumScreenError;
+        refine = screenError > threshold;
+    }
+
+    // Coarsening to a chunk that is not generated yet, or was evicted, would
+    // leave a hole until it is ready. The children stay meanwhile.
+    const bool keepChildren = !refine && chunk.refined && !chunk.model;
+
+    if (refine || keepChildren) {
+        // All children are needed, otherwise the area would have holes
+        bool childrenReady = true;
+        for (int i = 0; i < 4; ++i) {
+            const int cx = 2 * x + (i & 1);
+            const int cy = 2 * y + (i >> 1);
+            const int childIndex = tree.index(level + 1, cx, cy);
+            if (tree.nodes.at(childIndex).empty)
+                continue;
+            Chunk &child = m_chunks[childIndex];
+            child.lastUsed = m_serial;
+            if (!child.model) {
+                childrenReady = false;
+                if (refine && !child.pending)
+                    requestChunk(level + 1, cx, cy);
+            }
+        }
+        if (childrenReady) {
+            chunk.refined = true;
+            for (int i = 0; i < 4; ++i)
+                selectNode(level + 1, 2 * x + (i & 1), 2 * y + (i >> 1), cameraPosition, pixelScale);
+            return;
+        }
+    }
+
+    chunk.refined = false;
+    chunk.selected = m_serial;
+}
+
+float HeightFieldTerrain::distanceToNode(int level, int x, int y, const QVector3D &position) const
+{
+    const Tree &tree = *m_tree;
+    const Tree::Node &node = tree.nodes.at(tree.index(level, x, y));
+    const QRect rect = tree.sampleRect(level, x, y);
+    const float rowF = m_extents.z() / (tree.heightMap.height - 1);
+    const float colF = m_extents.x() / (tree.heightMap.width - 1);
+    const QVector3D boundsMin(rect.left() * colF - m_extents.x() / 2, node.minHeight * m_extents.y(), rect.top() * rowF - m_extents.z() / 2);
+    const QVector3D boundsMax(rect.right() * colF - m_extents.x() / 2, node.maxHeight * m_extents.y(), rect.bottom() * rowF - m_extents.z() / 2);
+    QVector3D d;
+    for (int i = 0; i < 3; ++i)
+        d[i] = qMax(0.0f, qMax(boundsMin[i] - position[i], position[i] - boundsMax[i]));
+    return d.length();
+}
+
+void HeightFieldTerrain::applyMaterials(QQuick3DModel *model) const
+{
+    QQmlListProperty<QQuick3DMaterial> list = model->materials();
+    list.clear(&list);
+    for (QQuick3DMaterial *material : m_materials)
+        list.append(&list, material);
+}
+
+void HeightFieldTerrain::updateMaterials()
+{
+    for (const Chunk &chunk : std::as_const(m_chunks)) {
+        if (chunk.model)
+            applyMaterials(chunk.model);
+    }
+}
+
+void HeightFieldTerrain::updateLoading()
+{
+    const bool loading = m_treeLoading || m_pendingChunks > 0;
+    if (m_loading == loading)
+        return;
+    m_loading = loading;
+    emit loadingChanged();
+}
+
+void HeightFieldTerrain::qmlAppendMaterial(QQmlListProperty<QQuick3DMaterial> *list, QQuick3DMaterial *material)
+{
+    if (material == nullptr)
+        return;
+    HeightFieldTerrain *self = static_cast<HeightFieldTerrain *>(list->object);
+    self->m_materials.append(material);
+    connect(material, &QObject::destroyed, self, [self, material] {
+        self->m_materials.removeAll(material);
+        self->updateMaterials();
+    });
+    self->updateMaterials();
+}
+
+QQuick3DMaterial *HeightFieldTerrain::qmlMaterialAt(QQmlListProperty<QQuick3DMaterial> *list, qsizetype index)
+{
+    HeightFieldTerrain *self = static_cast<HeightFieldTerrain *>(list->object);
+    return self->m_materials.at(index);
+}
+
+qsizetype HeightFieldTerrain::qmlMaterialsCount(QQmlListProperty<QQuick3DMaterial> *list)
+{
+    HeightFieldTerrain *self = static_cast<HeightFieldTerrain *>(list->object);
+    return self->m_materials.size();
+}
+
+void HeightFieldTerrain::qmlClearMaterials(QQmlListProperty<QQuick3DMaterial> *list)
+{
+    HeightFieldTerrain *self = static_cast<HeightFieldTerrain *>(list->object);
+    for (QQuick3DMaterial *material : std::as_const(self->m_materials))
+        disconnect(material, &QObject::destroyed, self, nullptr);
+    self->m_materials.clear();
+    self->updateMaterials();
+}
+
+QT_END_NAMESPACE
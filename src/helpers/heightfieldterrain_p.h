@@ -0,0 +1,127 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#ifndef HEIGHTFIELDTERRAIN_P_H
+#define HEIGHTFIELDTERRAIN_P_H
+
+#include <QtQuick3D/private/qquick3dnode_p.h>
+#include <QtQuick3D/private/qquick3dmaterial_p.h>
+#include <QtQml/qqmllist.h>
+
+#include <memory>
+
+// Workaround for QTBUG-94099, ensures qml_register_types...() is exported
+#include "qtquick3dhelpersglobal_p.h"
+
+QT_BEGIN_NAMESPACE
+
+class QQuick3DCamera;
+class QQuick3DModel;
+
+class HeightFieldTerrain : public QQuick3DNode
+{
+    Q_OBJECT
+    Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(QVector3D extents READ extents WRITE setExtents NOTIFY extentsChanged)
+    Q_PROPERTY(int chunkResolution READ chunkResolution WRITE setChunkResolution NOTIFY chunkResolutionChanged)
+    Q_PROPERTY(float maximumScreenError READ maximumScreenError WRITE setMaximumScreenError NOTIFY maximumScreenErrorChanged)
+    Q_PROPERTY(QQuick3DCamera *camera READ camera WRITE setCamera NOTIFY cameraChanged)
+    Q_PROPERTY(QQmlListProperty<QQuick3DMaterial> materials READ materials)
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+    QML_NAMED_ELEMENT(HeightFieldTerrain)
+    QML_ADDED_IN_VERSION(6, 8)
+
+public:
+    explicit HeightFieldTerrain(QQuick3DNode *parent = nullptr);
+    ~HeightFieldTerrain() override;
+
+    const QUrl &source() const;
+    void setSource(const QUrl &newSource);
+    const QVector3D &extents() const;
+    void setExtents(const QVector3D &newExtents);
+    int chunkResolution() const;
+    void setChunkResolution(int chunkResolution);
+    float maximumScreenError() const;
+    void setMaximumScreenError(float maximumScreenError);
+    QQuick3DCamera *camera() const;
+    void setCamera(QQuick3DCamera *camera);
+    QQmlListProperty<QQuick3DMaterial> materials();
+    bool isLoading() const;
+
+    struct Tree;
+    struct ChunkMesh;
+
+Q_SIGNALS:
+    void sourceChanged();
+    void extentsChanged();
+    void chunkResolutionChanged();
+    void maximumScreenErrorChanged();
+    void cameraChanged();
+    void loadingChanged();
+
+protected:
+    void componentComplete() override;
+
+private:
+    struct Chunk {
+        QQuick3DModel *model = nullptr;
+        quint32 lastUsed = 0;
+        quint32 selected = 0;
+        bool pending = false;
+        bool refined = false;
+    };
+    struct Guard;
+
+    void load();
+    void treeLoaded(quint32 generation, const std::shared_ptr<const Tree> &tree);
+    void releaseChunks();
+    void requestChunk(int level, int x, int y);
+    void chunkGenerated(quint32 generation, int index, const ChunkMesh &mesh);
+    void scheduleSelection();
+    void updateSelection();
+    void selectNode(int level, int x, int y, const QVector3D &cameraPosition, float pixelScale);
+    float distanceToNode(int level, int x, int y, const QVector3D &position) const;
+    void applyMaterials(QQuick3DModel *model) const;
+    void updateMaterials();
+    void updateLoading();
+
+    static void qmlAppendMaterial(QQmlListProperty<QQuick3DMaterial> *list, QQuick3DMaterial *material);
+    static QQuick3DMaterial *qmlMaterialAt(QQmlListProperty<QQuick3DMaterial> *list, qsizetype index);
+    static qsizetype qmlMaterialsCount(QQmlListProperty<QQuick3DMaterial> *list);
+    static void qmlClearMaterials(QQmlListProperty<QQuick3DMaterial> *list);
+
+    QUrl m_source;
+    QVector3D m_extents = { 100, 100, 100 };
+    int m_chunkResolution = 64;
+    float m_maximumScreenError = 2.0f;
+    QQuick3DCamera *m_camera = nullptr;
+    QVector<QMetaObject::Connection> m_cameraConnections;
+    QVector<QQuick3DMaterial *> m_materials;
+    bool m_extentsSetExplicitly = false;
+    bool m_loading = false;
+    bool m_treeLoading = false;
+    bool m_selectionPending = false;
+
+    std::shared_ptr<Guard> m_guard;
+    std::shared_ptr<const Tree> m_tree;
+    QVector<Chunk> m_chunks;
+    quint32 m_treeGeneration = 0;
+    quint32 m_chunkGeneration = 0; // bumped when the chunks are released
+    quint32 m_serial = 0;
+    int m_pendingChunks = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // HEIGHTFIELDTERRAIN_P_H
@@ -6,6 +6,9 @@
 #include <assimputils.h>
 
 #include <QtCore/qurl.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthreadpool.h>
 #include <QtCore/qbytearrayalgorithms.h>
 #include <QtGui/QQuaternion>
 
@@ -133,6 +136,8 @@ struct SceneInfo
         bool generateMeshLODs = false;
         float lodNormalMergeAngle = 60.0;
         float lodNormalSplitAngle = 25.0;
+
+        bool generateMeshlets = false;
     };
 
     using MaterialMap = QVarLengthArray<QPair<const aiMaterial *, QSSGSceneDesc::Material *>>;
@@ -147,6 +152,9 @@ struct SceneInfo
     };
     using SkinMap = QVarLengthArray<skinData>;
     using Mesh2SkinMap = QVarLengthArray<qint16>;
+    // The meshes to generate for the mesh storage of the target scene, as
+    // pairs of the source meshes and the index in the storage.
+    using MeshJobs = QVector<QPair<AssimpUtils::MeshList, qsizetype>>;
 
     const aiScene &scene;
     MaterialMap &materialMap;
@@ -155,6 +163,7 @@ struct SceneInfo
     TextureMap &textureMap;
     SkinMap &skinMap;
     Mesh2SkinMap &mesh2skin;
+    MeshJobs &meshJobs;
     QDir workingDir;
     Options opt;
 };
@@ -1117,8 +1126,6 @@ static void setModelProperties(QSSGSceneDesc::Model &target, const aiNode &sourc
     QVarLengthArray<QSSGSceneDesc::Material *> materials;
     materials.reserve(source.mNumMeshes); // Assumig there's max one material per mesh.
 
-    QString errorString;
-
     const auto ensureMaterial = [&](qsizetype materialIndex) {
         // Get the material for the mesh
         auto &material = materialMap[materialIndex];
@@ -1168,16 +1175,12 @@ static void setModelProperties(QSSGSceneDesc::Model &target, const aiNode &sourc
     };
 
     const auto createMeshNode = [&](const aiString &name) {
-        auto meshData = AssimpUtils::generateMeshData(srcScene,
-                                                      meshes,
-                                                      sceneInfo.opt.useFloatJointIndices,
-                                                      sceneInfo.opt.generateMeshLODs,
-                                                      sceneInfo.opt.lodNormalMergeAngle,
-                                                      sceneInfo.opt.lodNormalSplitAngle,
-                                                      errorString);
-        meshStorage.push_back(std::move(meshData));
+        // The mesh data is generated later, together with the other meshes
+        // of the scene, see generateMeshes().
+        meshStorage.push_back(QSSGMesh::Mesh());
 
         const auto idx = meshStorage.size() - 1;
+        sceneInfo.meshJobs.push_back({ meshes, idx });
         // For multimeshes we'll use the model name, but for single meshes we'll use the mesh name.
         return new QSSGSceneDesc::Mesh(fromAiString(name), idx);
     };
@@ -1550,9 +1553,47 @@ static SceneInfo::Options processSceneOptions(const QJsonObject &optionsObject)
             sceneOptions.lodNormalSplitAngle = 0.0;
         }
     }
+
+    sceneOptions.generateMeshlets = checkBooleanOption(QStringLiteral("generateMeshlets"), options);
     return sceneOptions;
 }
 
+// Generates the mesh data, including the levels of detail and meshlets, of the
+// meshes created by processNode(). The meshes are independent of each other, so
+// they are generated in parallel when there is more than one, with the calling
+// thread taking part so that only the threads that are idle right now are used.
+static void generateMeshes(const SceneInfo &sceneInfo, QSSGSceneDesc::Scene &targetScene)
+{
+    const auto &jobs = sceneInfo.meshJobs;
+    QSSGMesh::Mesh *meshStorage = targetScene.meshStorage.data();
+
+    QAtomicInt nextJob = 0;
+    const auto generate = [&]() {
+        for (int i = nextJob.fetchAndAddRelaxed(1); i < jobs.size(); i = nextJob.fetchAndAddRelaxed(1)) {
+            const auto &job = jobs.at(i);
+            QString errorString;
+            meshStorage[job.second] = AssimpUtils::generateMeshData(sceneInfo.scene,
+                                                                    job.first,
+                                                                    sceneInfo.opt.useFloatJointIndices,
+                                                                    sceneInfo.opt.generateMeshLODs,
+                                                                    sceneInfo.opt.lodNormalMergeAngle,
+                                                                    sceneInfo.opt.lodNormalSplitAngle,
+                                                                    errorString);
+            if (sceneInfo.opt.generateMeshlets)
+                meshStorage[job.second].createMeshlets();
+        }
+    };
+
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    const int maxHelpers = qMin(threadPool->maxThreadCount(), int(jobs.size()) - 1);
+    QSemaphore done;
+    int helpers = 0;
+    while (helpers < maxHelpers && threadPool->tryStart([&generate, &done] { generate(); done.release(); }))
+        ++helpers;
+    generate();
+    done.acquire(helpers);
+}
+
 static QString importImp(const QUrl &url, const QJsonObject &options, QSSGSceneDesc::Scene &targetScene)
 {
     auto filePath = url.path();
@@ -1712,8 +1753,10 @@ static QString importImp(const QUrl &url, const QJsonObject &options, QSSGSceneD
     else if (extension == QStringLiteral("fbx"))
         opt.fbxMode = true;
 
+    SceneInfo::MeshJobs meshJobs;
+
     SceneInfo sceneInfo { *sourceScene, materials, meshes, embeddedTextures,
-                          textureMap, skins, mesh2skin, sourceFile.dir(), opt };
+                          textureMap, skins, mesh2skin, meshJobs, sourceFile.dir(), opt };
 
     if (!qFuzzyCompare(opt.globalScaleValue, 1.0f) && !qFuzzyCompare(opt.globalScaleValue, 0.0f)) {
         const auto gscale = opt.globalScaleValue;
@@ -1723,6 +1766,8 @@ static QString importImp(const QUrl &url, const QJsonObject &options, QSSGSceneD
     // Now lets go through the scene
     if (sourceScene->mRootNode)
         processNode(sceneInfo, *sourceScene->mRootNode, *targetScene.root, nodeMap, animatingNodes);
+    generateMeshes(sceneInfo, targetScene);
+
     // skins
     for (It i = 0, endI = skins.size(); i != endI; ++i) {
         const auto &skin = skins[i];
@@ -1980,20 +2025,7 @@ QString AssimpImporter::import(const QString &sourceFile, const QDir &savePath,
         return errorString;
 
     // Write out QML + Resources
-    QFileInfo sourceFileInfo(sourceFile);
-
-    QString targetFileName = savePath.absolutePath() + QDir::separator() +
-            QSSGQmlUtilities::qmlComponentName(sourceFileInfo.completeBaseName()) +
-            QStringLiteral(".qml");
-    QFile targetFile(targetFileName);
-    if (!targetFile.open(QIODevice::WriteOnly)) {
-        errorString += QString("Could not write to file: ") + targetFileName;
-    } else {
-        QTextStream output(&targetFile);
-        QSSGQmlUtilities::writeQml(scene, output, savePath, options);
-        if (generatedFiles)
-            generatedFiles->append(targetFileName);
-    }
+    errorString = QSSGQmlUtilities::writeQmlFile(scene, sourceFile, savePath, options, generatedFiles);
     scene.cleanup();
 
     return errorString;
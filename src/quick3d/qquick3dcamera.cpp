@@ -80,6 +80,9 @@ QQuick3DCamera::QQuick3DCamera(QQuick3DNodePrivate &dd, QQuick3DNode *parent)
     most objects are inside the camera frustum, frustum culling is an unnecessary performance overhead.
     But for complex scenes where large parts are located outside the camera's view, enabling frustum
     culling may improve performance.
+
+    Qt Quick items placed in the scene are culled as well, using the bounds of
+    the items and their children.
 */
 bool QQuick3DCamera::frustumCullingEnabled() const
 {
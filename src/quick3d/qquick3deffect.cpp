@@ -12,6 +12,7 @@
 #include <QtQuick3D/private/qquick3dscenemanager_p.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qurl.h>
+#include <QtCore/qregularexpression.h>
 
 
 QT_BEGIN_NAMESPACE
@@ -545,6 +546,86 @@ static const char *default_effect_fragment_shader =
         "    FRAGCOLOR = texture(INPUT, INPUT_UV);\n"
         "}\n";
 
+static QString stripShaderComments(const QByteArray &code)
+{
+    static const QRegularExpression commentRe(QStringLiteral("//[^\\n]*|/\\*.*?\\*/"),
+                                              QRegularExpression::DotMatchesEverythingOption);
+    return QString::fromLatin1(code).remove(commentRe);
+}
+
+// True when every use of INPUT is a texture(INPUT, INPUT_UV) lookup, i.e. the
+// shader only depends on the input at the pixel it is run for.
+bool QQuick3DEffect::samplesInputOnlyAtInputUV(const QByteArray &code)
+{
+    static const QRegularExpression inputRe(QStringLiteral("\\bINPUT\\b"));
+    static const QRegularExpression lookupRe(QStringLiteral("\\btexture\\s*\\(\\s*INPUT\\s*,\\s*INPUT_UV\\s*\\)"));
+    static const QRegularExpression varyingRe(QStringLiteral("\\bVARYING\\b"));
+    const QString source = stripShaderComments(code);
+    if (source.contains(varyingRe))
+        return false;
+    return source.count(inputRe) == source.count(lookupRe);
+}
+
+// Collects the names declared at the top level of a shader snippet: macros,
+// and identifiers that follow their type, or a comma in a list of
+// declarations, outside of any block or argument list, such as functions,
+// constants and structs. Good enough to tell whether two snippets can be
+// pasted into the same shader.
+QByteArrayList QQuick3DEffect::shaderGlobalNames(const QByteArray &code)
+{
+    QByteArrayList names;
+    const QString source = stripShaderComments(code);
+
+    static const QRegularExpression defineRe(QStringLiteral("^\\s*#\\s*define\\s+(\\w+)"),
+                                             QRegularExpression::MultilineOption);
+    for (auto it = defineRe.globalMatch(source); it.hasNext(); )
+        names.append(it.next().captured(1).toLatin1());
+
+    static const QRegularExpression tokenRe(QStringLiteral("#[^\\n]*|[A-Za-z_]\\w*|\\S"));
+    int braceDepth = 0;
+    int parenDepth = 0;
+    bool afterIdentifier = false;
+    bool declaring = false; // a name was declared in the current statement
+    bool expectName = false; // after the comma of a list of declarations
+    QString candidate;
+    for (auto it = tokenRe.globalMatch(source); it.hasNext(); ) {
+        const QString token = it.next().captured();
+        const QChar c = token.at(0);
+        const bool atTopLevel = (braceDepth == 0 && parenDepth == 0);
+        if (c == u'#') { // preprocessor line
+            afterIdentifier = false;
+            expectName = false;
+            candidate.clear();
+            continue;
+        }
+        if (c.isLetter() || c == u'_') {
+            candidate = ((afterIdentifier || expectName) && atTopLevel) ? token : QString();
+            afterIdentifier = true;
+            expectName = false;
+            continue;
+        }
+        if (!candidate.isEmpty() && QStringView(u"(=;[,{").contains(c) && candidate != u"MAIN") {
+            names.append(candidate.toLatin1());
+            declaring = true;
+        }
+        candidate.clear();
+        afterIdentifier = false;
+        expectName = (declaring && atTopLevel && c == u',');
+        if (atTopLevel && (c == u';' || c == u'{'))
+            declaring = false;
+        if (c == u'{')
+            ++braceDepth;
+        else if (c == u'}')
+            --braceDepth;
+        else if (c == u'(')
+            ++parenDepth;
+        else if (c == u')')
+            --parenDepth;
+    }
+
+    return names;
+}
+
 static inline void insertVertexMainArgs(QByteArray &snippet)
 {
     static const char *argKey =  "/*%QT_ARGS_MAIN%*/";
@@ -743,6 +824,8 @@ QSSGRenderGraphObject *QQuick3DEffect::updateSpatialNode(QSSGRenderGraphObject *
         if (!m_passes.isEmpty()) {
             const QQmlContext *context = qmlContext(this);
             effectNode->resetCommands();
+            effectNode->isPixelLocal = false;
+            effectNode->shaderGlobalNames.clear();
             for (QQuick3DShaderUtilsRenderPass *pass : std::as_const(m_passes)) {
                 // Have a key composed more or less of the vertex and fragment filenames.
                 // The shaderLibraryManager uses stage+shaderPathKey as the key.
@@ -752,6 +835,8 @@ QSSGRenderGraphObject *QQuick3DEffect::updateSpatialNode(QSSGRenderGraphObject *
                 // But that's the effect system's problem.
                 QByteArray shaderPathKey("effect pipeline--");
                 QSSGRenderEffect::ShaderPrepPassData passData;
+                bool hasVertexShader = false;
+                QByteArray fragmentCode;
                 for (QQuick3DShaderUtilsShader::Stage stage : { QQuick3DShaderUtilsShader::Stage::Vertex, QQuick3DShaderUtilsShader::Stage::Fragment }) {
                     QQuick3DShaderUtilsShader *shader = nullptr;
                     for (QQuick3DShaderUtilsShader *s : pass->m_shaders) {
@@ -788,6 +873,8 @@ QSSGRenderGraphObject *QQuick3DEffect::updateSpatialNode(QSSGRenderGraphObject *
                     QByteArray code;
                     if (shader) {
                         code = QSSGShaderUtils::resolveShader(shader->shader, context, shaderPathKey); // appends to shaderPathKey
+                        if (type == QSSGShaderCache::ShaderType::Vertex)
+                            hasVertexShader = true;
                     } else {
                         if (!shaderPathKey.isEmpty())
                             shaderPathKey.append('>');
@@ -798,6 +885,9 @@ QSSGRenderGraphObject *QQuick3DEffect::updateSpatialNode(QSSGRenderGraphObject *
                             code = default_effect_fragment_shader;
                     }
 
+                    if (type == QSSGShaderCache::ShaderType::Fragment)
+                        fragmentCode = code;
+
                     QByteArray shaderCodeMeta;
                     QSSGShaderCustomMaterialAdapter::ShaderCodeAndMetaData result;
                     if (type == QSSGShaderCache::ShaderType::Vertex) {
@@ -824,6 +914,14 @@ QSSGRenderGraphObject *QQuick3DEffect::updateSpatialNode(QSSGRenderGraphObject *
                     }
                 }
 
+                // Effects that only recolor the pixel they are run for can be
+                // fused with their neighbours into a single pass.
+                if (m_passes.size() == 1 && !hasVertexShader && !pass->outputBuffer && pass->m_commands.isEmpty()
+                        && samplesInputOnlyAtInputUV(fragmentCode)) {
+                    effectNode->isPixelLocal = true;
+                    effectNode->shaderGlobalNames = shaderGlobalNames(fragmentCode);
+                }
+
                 effectNode->commands.push_back({ nullptr, true }); // will be changed to QSSGBindShader in finalizeShaders
                 passData.bindShaderCmdIndex = effectNode->commands.size() - 1;
 
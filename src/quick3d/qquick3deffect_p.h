@@ -50,6 +50,11 @@ public:
 
     void effectChainDirty();
 
+    // Tell whether the fragment shader of an effect can be fused with others,
+    // see QSSGRhiEffectSystem.
+    static bool samplesInputOnlyAtInputUV(const QByteArray &code);
+    static QByteArrayList shaderGlobalNames(const QByteArray &code);
+
 protected:
     QSSGRenderGraphObject *updateSpatialNode(QSSGRenderGraphObject *node) override;
     void itemChange(QQuick3DObject::ItemChange , const QQuick3DObject::ItemChangeData &) override;
@@ -15,6 +15,10 @@
 
 QT_BEGIN_NAMESPACE
 
+// The changes in the tree of 2D items that affect the bounds of the content
+static constexpr QQuickItemPrivate::ChangeTypes boundsChangeTypes = QQuickItemPrivate::Geometry
+        | QQuickItemPrivate::Visibility | QQuickItemPrivate::Rotation | QQuickItemPrivate::Children;
+
 /*
 internal
 */
@@ -34,6 +38,8 @@ QQuick3DItem2D::QQuick3DItem2D(QQuickItem *item, QQuick3DNode *parent)
 
 QQuick3DItem2D::~QQuick3DItem2D()
 {
+    for (QQuickItem *item : std::as_const(m_sourceItems))
+        untrackBounds(item);
     delete m_contentItem;
 
     // This is sketchy. Similarly to the problems QQuick3DTexture has with its
@@ -63,13 +69,17 @@ void QQuick3DItem2D::addChildItem(QQuickItem *item)
     connect(item, &QQuickItem::enabledChanged, this, &QQuick3DItem2D::updatePicking);
     connect(item, &QQuickItem::visibleChanged, this, &QQuick3DItem2D::updatePicking);
     m_sourceItems.append(item);
-    update();
+    trackBounds(item);
+    markBoundsDirty();
 }
 void QQuick3DItem2D::removeChildItem(QQuickItem *item)
 {
     m_sourceItems.removeOne(item);
-    if (item)
+    if (item) {
         QQuickItemPrivate::get(item)->removeItemChangeListener(this, QQuickItemPrivate::ChangeType::Destroyed);
+        untrackBounds(item);
+    }
+    m_boundsDirty = true;
     if (m_sourceItems.isEmpty())
         emit allChildrenRemoved();
     else
@@ -86,6 +96,58 @@ void QQuick3DItem2D::itemDestroyed(QQuickItem *item)
     removeChildItem(item);
 }
 
+void QQuick3DItem2D::itemGeometryChanged(QQuickItem *, QQuickGeometryChange, const QRectF &)
+{
+    markBoundsDirty();
+}
+
+void QQuick3DItem2D::itemVisibilityChanged(QQuickItem *)
+{
+    markBoundsDirty();
+}
+
+void QQuick3DItem2D::itemRotationChanged(QQuickItem *)
+{
+    markBoundsDirty();
+}
+
+void QQuick3DItem2D::itemChildAdded(QQuickItem *, QQuickItem *child)
+{
+    trackBounds(child);
+    markBoundsDirty();
+}
+
+void QQuick3DItem2D::itemChildRemoved(QQuickItem *, QQuickItem *child)
+{
+    untrackBounds(child);
+    markBoundsDirty();
+}
+
+// Listens to the changes of the items in the tree, so that the bounds are
+// only computed again when they may have changed, and in the same sync as
+// the change.
+void QQuick3DItem2D::trackBounds(QQuickItem *item)
+{
+    QQuickItemPrivate::get(item)->addItemChangeListener(this, boundsChangeTypes);
+    const auto childItems = item->childItems();
+    for (QQuickItem *child : childItems)
+        trackBounds(child);
+}
+
+void QQuick3DItem2D::untrackBounds(QQuickItem *item)
+{
+    QQuickItemPrivate::get(item)->removeItemChangeListener(this, boundsChangeTypes);
+    const auto childItems = item->childItems();
+    for (QQuickItem *child : childItems)
+        untrackBounds(child);
+}
+
+void QQuick3DItem2D::markBoundsDirty()
+{
+    m_boundsDirty = true;
+    update();
+}
+
 void QQuick3DItem2D::invalidated()
 {
     // clean up the renderer
@@ -93,6 +155,7 @@ void QQuick3DItem2D::invalidated()
         delete m_renderer;
         m_renderer = nullptr;
     }
+    m_contentDirty = true;
 }
 
 void QQuick3DItem2D::updatePicking()
@@ -101,6 +164,26 @@ void QQuick3DItem2D::updatePicking()
     update();
 }
 
+void QQuick3DItem2D::contentChanged()
+{
+    // Only read and reset on the render thread, in updateSpatialNode()
+    m_contentDirty = true;
+}
+
+// The bounding rectangle of the visible items in the tree, in the coordinates
+// of contentItem. Items that clip cut off their children.
+static void uniteItemBounds(QQuickItem *item, QQuickItem *contentItem, QRectF &bounds)
+{
+    if (!item->isVisible())
+        return;
+    bounds |= item->mapRectToItem(contentItem, item->boundingRect());
+    if (item->clip())
+        return;
+    const auto childItems = item->childItems();
+    for (QQuickItem *child : childItems)
+        uniteItemBounds(child, contentItem, bounds);
+}
+
 QSSGRenderGraphObject *QQuick3DItem2D::updateSpatialNode(QSSGRenderGraphObject *node)
 {
     auto *sourceItemPrivate = QQuickItemPrivate::get(m_contentItem);
@@ -130,6 +213,8 @@ QSSGRenderGraphObject *QQuick3DItem2D::updateSpatialNode(QSSGRenderGraphObject *
         m_renderer = rc->createRenderer(QSGRendererInterface::RenderMode3D);
         connect(window, &QQuickWindow::sceneGraphInvalidated, this, &QQuick3DItem2D::invalidated, Qt::DirectConnection);
         connect(m_renderer, &QSGAbstractRenderer::sceneGraphChanged, this, &QQuick3DObject::update);
+        // Emitted on the render thread, possibly during the same sync
+        connect(m_renderer, &QSGAbstractRenderer::sceneGraphChanged, this, &QQuick3DItem2D::contentChanged, Qt::DirectConnection);
 
         // item2D rendernode has its own render pass descriptor and it should
         // be removed before deleting rhi context.
@@ -145,6 +230,7 @@ QSSGRenderGraphObject *QQuick3DItem2D::updateSpatialNode(QSSGRenderGraphObject *
                             itemNode->m_rp->deleteLater();
                             itemNode->m_rp = nullptr;
                         }
+                        itemNode->releaseCachedTexture();
                     }
                 },
                 Qt::DirectConnection);
@@ -173,6 +259,19 @@ QSSGRenderGraphObject *QQuick3DItem2D::updateSpatialNode(QSSGRenderGraphObject *
         itemNode->setState(QSSGRenderNode::LocalState::Pickable, isPickable);
     }
 
+    if (m_boundsDirty) {
+        m_boundsDirty = false;
+        QRectF bounds;
+        for (auto item : std::as_const(m_sourceItems))
+            uniteItemBounds(item, m_contentItem, bounds);
+        itemNode->bounds = bounds;
+    }
+
+    if (m_contentDirty) {
+        m_contentDirty = false;
+        itemNode->contentDirty = true;
+    }
+
     itemNode->m_renderer = m_renderer;
 
     return node;
@@ -180,6 +279,7 @@ QSSGRenderGraphObject *QQuick3DItem2D::updateSpatialNode(QSSGRenderGraphObject *
 
 void QQuick3DItem2D::markAllDirty()
 {
+    m_boundsDirty = true;
     QQuick3DNode::markAllDirty();
 }
 
@@ -39,11 +39,17 @@ public:
     void removeChildItem(QQuickItem *item);
     QQuickItem *contentItem() const;
     void itemDestroyed(QQuickItem *item) override;
+    void itemGeometryChanged(QQuickItem *item, QQuickGeometryChange change, const QRectF &oldGeometry) override;
+    void itemVisibilityChanged(QQuickItem *item) override;
+    void itemRotationChanged(QQuickItem *item) override;
+    void itemChildAdded(QQuickItem *item, QQuickItem *child) override;
+    void itemChildRemoved(QQuickItem *item, QQuickItem *child) override;
 
 private Q_SLOTS:
     void invalidated();
     void updatePicking();
     void derefWindow(QObject *win);
+    void contentChanged();
 
 Q_SIGNALS:
     void allChildrenRemoved();
@@ -55,12 +61,18 @@ private:
     QSSGRenderGraphObject *updateSpatialNode(QSSGRenderGraphObject *node) override;
     void markAllDirty() override;
 
+    void trackBounds(QQuickItem *item);
+    void untrackBounds(QQuickItem *item);
+    void markBoundsDirty();
+
     QVector<QQuickItem *> m_sourceItems;
     QSGRenderer *m_renderer = nullptr;
     QSGRootNode *m_rootNode = nullptr;
     QQuickWindow *m_window = nullptr;
     QQuickItem *m_contentItem = nullptr;
     bool m_pickingDirty = true;
+    bool m_contentDirty = true;
+    bool m_boundsDirty = true;
     QPointer<QQuick3DSceneManager> m_sceneManagerForLayer;
 };
 
@@ -91,12 +91,14 @@ QT_BEGIN_NAMESPACE
 /*!
     \qmlproperty int Lightmapper::indirectLightWorkgroupSize
 
-    The size of the sample workgroups. These workgroups are attempted to be
-    executed in parallel. (the exact behavior depends on the number of CPU
-    cores and the QThreadPool configuration)
-
-    The default value is 32. With the default sample count of 256 this means
-    attempting to run 8 groups in parallel per model.
+    The size of the texel tiles, in texels along each edge, the indirect
+    lighting computation is split into. The tiles of all lightmaps are
+    attempted to be executed in parallel. (the exact behavior depends on the
+    number of CPU cores and the QThreadPool configuration)
+
+    The default value is 32, meaning tiles of 32x32 texels. Smaller tiles
+    distribute the work more evenly between the threads, larger tiles have
+    less scheduling overhead.
  */
 
 /*!
@@ -123,6 +125,53 @@ QT_BEGIN_NAMESPACE
     The default value is 1.
  */
 
+/*!
+    \qmlproperty int Lightmapper::passes
+    \since 6.8
+
+    The number of progressive passes the indirect light \l samples are
+    divided into. After each pass, except the last one, the lightmaps
+    accumulated so far are post-processed and written out, so that the
+    intermediate results can be previewed while baking continues. When
+    \l incrementalBakingEnabled is true, an interrupted bake also resumes from
+    the last completed pass.
+
+    The default value is 1, meaning all samples are computed before anything
+    is written out.
+ */
+
+/*!
+    \qmlproperty bool Lightmapper::incrementalBakingEnabled
+    \since 6.8
+
+    When enabled, the lightmapper stores the accumulated indirect lighting of
+    each model, together with a signature of the model's geometry,
+    transform, material and lightmap size, the lights and the baking
+    settings, next to the lightmap. On the next bake, models whose
+    signature is unchanged reuse the stored indirect lighting instead of
+    tracing it again, and models for which a previous bake was interrupted
+    continue from the samples already computed.
+
+    Direct lighting is always recomputed for all models. Changes to other
+    models only affect the indirect lighting of a model when that model is
+    re-baked.
+
+    The default value is false.
+ */
+
+/*!
+    \qmlproperty bool Lightmapper::denoiseEnabled
+    \since 6.8
+
+    When enabled, the indirect lighting is filtered with an edge-aware
+    denoiser before post-processing. The filter uses the world space
+    positions and normals of the lightmap texels to avoid blurring across
+    geometric edges, which allows using a considerably lower \l samples
+    count for an acceptable result.
+
+    The default value is false.
+ */
+
 float QQuick3DLightmapper::opacityThreshold() const
 {
     return m_opacityThreshold;
@@ -163,6 +212,21 @@ float QQuick3DLightmapper::indirectLightFactor() const
     return m_indirectFactor;
 }
 
+int QQuick3DLightmapper::passes() const
+{
+    return m_passes;
+}
+
+bool QQuick3DLightmapper::isIncrementalBakingEnabled() const
+{
+    return m_incrementalBaking;
+}
+
+bool QQuick3DLightmapper::isDenoiseEnabled() const
+{
+    return m_denoise;
+}
+
 void QQuick3DLightmapper::setOpacityThreshold(float opacity)
 {
     if (m_opacityThreshold == opacity)
@@ -243,4 +307,34 @@ void QQuick3DLightmapper::setIndirectLightFactor(float factor)
     emit changed();
 }
 
+void QQuick3DLightmapper::setPasses(int count)
+{
+    if (m_passes == count)
+        return;
+
+    m_passes = count;
+    emit passesChanged();
+    emit changed();
+}
+
+void QQuick3DLightmapper::setIncrementalBakingEnabled(bool enabled)
+{
+    if (m_incrementalBaking == enabled)
+        return;
+
+    m_incrementalBaking = enabled;
+    emit incrementalBakingEnabledChanged();
+    emit changed();
+}
+
+void QQuick3DLightmapper::setDenoiseEnabled(bool enabled)
+{
+    if (m_denoise == enabled)
+        return;
+
+    m_denoise = enabled;
+    emit denoiseEnabledChanged();
+    emit changed();
+}
+
 QT_END_NAMESPACE
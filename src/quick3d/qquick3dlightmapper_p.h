@@ -30,6 +30,9 @@ class Q_QUICK3D_EXPORT QQuick3DLightmapper : public QObject
     Q_PROPERTY(int indirectLightWorkgroupSize READ indirectLightWorkgroupSize WRITE setIndirectLightWorkgroupSize NOTIFY indirectLightWorkgroupSizeChanged)
     Q_PROPERTY(int bounces READ bounces WRITE setBounces NOTIFY bouncesChanged)
     Q_PROPERTY(float indirectLightFactor READ indirectLightFactor WRITE setIndirectLightFactor NOTIFY indirectLightFactorChanged)
+    Q_PROPERTY(int passes READ passes WRITE setPasses NOTIFY passesChanged REVISION(6, 8))
+    Q_PROPERTY(bool incrementalBakingEnabled READ isIncrementalBakingEnabled WRITE setIncrementalBakingEnabled NOTIFY incrementalBakingEnabledChanged REVISION(6, 8))
+    Q_PROPERTY(bool denoiseEnabled READ isDenoiseEnabled WRITE setDenoiseEnabled NOTIFY denoiseEnabledChanged REVISION(6, 8))
 
     QML_NAMED_ELEMENT(Lightmapper)
 
@@ -42,6 +45,9 @@ public:
     int indirectLightWorkgroupSize() const;
     int bounces() const;
     float indirectLightFactor() const;
+    Q_REVISION(6, 8) int passes() const;
+    Q_REVISION(6, 8) bool isIncrementalBakingEnabled() const;
+    Q_REVISION(6, 8) bool isDenoiseEnabled() const;
 
 public Q_SLOTS:
     void setOpacityThreshold(float opacity);
@@ -52,6 +58,9 @@ public Q_SLOTS:
     void setIndirectLightWorkgroupSize(int size);
     void setBounces(int count);
     void setIndirectLightFactor(float factor);
+    Q_REVISION(6, 8) void setPasses(int count);
+    Q_REVISION(6, 8) void setIncrementalBakingEnabled(bool enabled);
+    Q_REVISION(6, 8) void setDenoiseEnabled(bool enabled);
 
 Q_SIGNALS:
     void changed();
@@ -63,6 +72,9 @@ Q_SIGNALS:
     void indirectLightWorkgroupSizeChanged();
     void bouncesChanged();
     void indirectLightFactorChanged();
+    Q_REVISION(6, 8) void passesChanged();
+    Q_REVISION(6, 8) void incrementalBakingEnabledChanged();
+    Q_REVISION(6, 8) void denoiseEnabledChanged();
 
 private:
     // keep the defaults in sync with the default values in QSSGLightmapperOptions
@@ -74,6 +86,9 @@ private:
     int m_workgroupSize = 32;
     int m_bounces = 3;
     float m_indirectFactor = 1.0f;
+    int m_passes = 1;
+    bool m_incrementalBaking = false;
+    bool m_denoise = false;
 };
 
 QT_END_NAMESPACE
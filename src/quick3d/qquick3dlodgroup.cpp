@@ -0,0 +1,201 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "qquick3dlodgroup_p.h"
+#include "qquick3dnode_p_p.h"
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderlodgroup_p.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype LodGroup
+    \inherits Node
+    \inqmlmodule QtQuick3D
+    \brief Switches between levels of detail based on their error on screen.
+    \since 6.8
+
+    A LodGroup treats each of its direct children as one level of detail, the
+    first child being the most detailed one. For every frame, the group picks
+    the coarsest level whose error, projected on screen, does not exceed
+    \l maximumScreenError pixels. Only the models of the picked level are
+    rendered.
+
+    The error of each level is given in \l levelErrors, in scene units. It is
+    the largest distance between the surface of the level and the surface of
+    the most detailed level, as reported by most mesh simplification tools.
+    The error is projected at the position of the group, using the field of
+    view of the camera and the height of the \l View3D, so the selection
+    does not depend on the size of the bounding box of the levels.
+
+    \qml
+    LodGroup {
+        levelErrors: [0, 0.5, 4]
+        maximumScreenError: 2
+        crossFade: true
+        Model { source: "statue_lod0.mesh"; materials: statueMaterial }
+        Model { source: "statue_lod1.mesh"; materials: statueMaterial }
+        Model { source: "statue_lod2.mesh"; materials: statueMaterial }
+    }
+    \endqml
+
+    \l Camera::levelOfDetailBias scales \l maximumScreenError, so the same
+    setting that affects the automatic levels of detail of meshes also
+    affects the groups.
+
+    \note Only the models of a level are switched. Other nodes, such as lights,
+    are not hidden with the level they are in.
+
+    \sa Camera::levelOfDetailBias, {Qt Quick 3D - Level of Detail Helper Example}
+*/
+
+QQuick3DLodGroup::QQuick3DLodGroup(QQuick3DNode *parent)
+    : QQuick3DNode(*(new QQuick3DNodePrivate(QQuick3DNodePrivate::Type::LodGroup)), parent)
+{
+}
+
+QQuick3DLodGroup::~QQuick3DLodGroup()
+{
+}
+
+/*!
+    \qmlproperty list<real> LodGroup::levelErrors
+
+    This property holds the geometric error of each level, in scene units. The
+    first value is for the first child, the second for the second child, and
+    so on. The errors are expected to be in ascending order; the first level
+    usually has an error of \c 0.
+
+    Children without a matching error are never rendered.
+*/
+QList<float> QQuick3DLodGroup::levelErrors() const
+{
+    return m_levelErrors;
+}
+
+/*!
+    \qmlproperty real LodGroup::maximumScreenError
+
+    This property holds the largest error, in pixels, that a level may have on
+    screen to be picked. Lower values switch to the coarser levels later.
+
+    The default value is \c 1.0.
+*/
+float QQuick3DLodGroup::maximumScreenError() const
+{
+    return m_maximumScreenError;
+}
+
+/*!
+    \qmlproperty real LodGroup::hysteresis
+
+    This property holds the width of the band around \l maximumScreenError,
+    as a fraction of it, in which the current level is kept. This avoids
+    switching levels back and forth when the error stays close to the
+    threshold, for instance with a slowly moving camera.
+
+    The value is clamped to the range [0, 1). The default value is \c 0.1.
+*/
+float QQuick3DLodGroup::hysteresis() const
+{
+    return m_hysteresis;
+}
+
+/*!
+    \qmlproperty bool LodGroup::crossFade
+
+    When this property is \c true, the two levels on each side of the switch
+    are both rendered while the error is within the \l hysteresis band and
+    are blended with a screen-door dither, hiding the pop of the switch. This
+    costs drawing both levels in the band and an additional shader variant
+    for the materials of the levels.
+
+    The default value is \c false.
+*/
+bool QQuick3DLodGroup::crossFade() const
+{
+    return m_crossFade;
+}
+
+void QQuick3DLodGroup::setLevelErrors(const QList<float> &levelErrors)
+{
+    if (m_levelErrors == levelErrors)
+        return;
+
+    m_levelErrors = levelErrors;
+    m_dirtyFlags.setFlag(DirtyFlag::LevelErrorsDirty);
+    emit levelErrorsChanged();
+    update();
+}
+
+void QQuick3DLodGroup::setMaximumScreenError(float maximumScreenError)
+{
+    maximumScreenError = qMax(0.0f, maximumScreenError);
+    if (qFuzzyCompare(m_maximumScreenError, maximumScreenError))
+        return;
+
+    m_maximumScreenError = maximumScreenError;
+    m_dirtyFlags.setFlag(DirtyFlag::SelectionDirty);
+    emit maximumScreenErrorChanged();
+    update();
+}
+
+void QQuick3DLodGroup::setHysteresis(float hysteresis)
+{
+    hysteresis = qBound(0.0f, hysteresis, 0.99f);
+    if (qFuzzyCompare(m_hysteresis, hysteresis))
+        return;
+
+    m_hysteresis = hysteresis;
+    m_dirtyFlags.setFlag(DirtyFlag::SelectionDirty);
+    emit hysteresisChanged();
+    update();
+}
+
+void QQuick3DLodGroup::setCrossFade(bool crossFade)
+{
+    if (m_crossFade == crossFade)
+        return;
+
+    m_crossFade = crossFade;
+    m_dirtyFlags.setFlag(DirtyFlag::SelectionDirty);
+    emit crossFadeChanged();
+    update();
+}
+
+QSSGRenderGraphObject *QQuick3DLodGroup::updateSpatialNode(QSSGRenderGraphObject *node)
+{
+    if (!node) {
+        markAllDirty();
+        node = new QSSGRenderLodGroup();
+    }
+
+    QQuick3DNode::updateSpatialNode(node);
+
+    QSSGRenderLodGroup *lodGroup = static_cast<QSSGRenderLodGroup *>(node);
+
+    if (m_dirtyFlags.testFlag(DirtyFlag::LevelErrorsDirty)) {
+        m_dirtyFlags.setFlag(DirtyFlag::LevelErrorsDirty, false);
+        lodGroup->levelErrors = m_levelErrors;
+        // The levels may mean something else now, start over
+        lodGroup->currentLevel = -1;
+    }
+
+    if (m_dirtyFlags.testFlag(DirtyFlag::SelectionDirty)) {
+        m_dirtyFlags.setFlag(DirtyFlag::SelectionDirty, false);
+        lodGroup->maximumScreenError = m_maximumScreenError;
+        lodGroup->hysteresis = m_hysteresis;
+        lodGroup->crossFade = m_crossFade;
+    }
+
+    return node;
+}
+
+void QQuick3DLodGroup::markAllDirty()
+{
+    m_dirtyFlags = DirtyFlags(DirtyFlag::LevelErrorsDirty)
+            | DirtyFlags(DirtyFlag::SelectionDirty);
+    QQuick3DNode::markAllDirty();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,75 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef QQUICK3DLODGROUP_P_H
+#define QQUICK3DLODGROUP_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3D/private/qquick3dnode_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_QUICK3D_EXPORT QQuick3DLodGroup : public QQuick3DNode
+{
+    Q_OBJECT
+    Q_PROPERTY(QList<float> levelErrors READ levelErrors WRITE setLevelErrors NOTIFY levelErrorsChanged)
+    Q_PROPERTY(float maximumScreenError READ maximumScreenError WRITE setMaximumScreenError NOTIFY maximumScreenErrorChanged)
+    Q_PROPERTY(float hysteresis READ hysteresis WRITE setHysteresis NOTIFY hysteresisChanged)
+    Q_PROPERTY(bool crossFade READ crossFade WRITE setCrossFade NOTIFY crossFadeChanged)
+    QML_NAMED_ELEMENT(LodGroup)
+    QML_ADDED_IN_VERSION(6, 8)
+
+public:
+    explicit QQuick3DLodGroup(QQuick3DNode *parent = nullptr);
+    ~QQuick3DLodGroup() override;
+
+    QList<float> levelErrors() const;
+    float maximumScreenError() const;
+    float hysteresis() const;
+    bool crossFade() const;
+
+public Q_SLOTS:
+    void setLevelErrors(const QList<float> &levelErrors);
+    void setMaximumScreenError(float maximumScreenError);
+    void setHysteresis(float hysteresis);
+    void setCrossFade(bool crossFade);
+
+Q_SIGNALS:
+    void levelErrorsChanged();
+    void maximumScreenErrorChanged();
+    void hysteresisChanged();
+    void crossFadeChanged();
+
+protected:
+    QSSGRenderGraphObject *updateSpatialNode(QSSGRenderGraphObject *node) override;
+    void markAllDirty() override;
+
+private:
+    enum class DirtyFlag {
+        LevelErrorsDirty = (1 << 0),
+        SelectionDirty = (1 << 1)
+    };
+    Q_DECLARE_FLAGS(DirtyFlags, DirtyFlag)
+
+    DirtyFlags m_dirtyFlags = DirtyFlags(DirtyFlag::LevelErrorsDirty)
+                              | DirtyFlags(DirtyFlag::SelectionDirty);
+
+    QList<float> m_levelErrors;
+    float m_maximumScreenError = 1.0f;
+    float m_hysteresis = 0.1f;
+    bool m_crossFade = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICK3DLODGROUP_P_H
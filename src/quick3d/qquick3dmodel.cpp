@@ -905,6 +905,7 @@ QSSGRenderGraphObject *QQuick3DModel::updateSpatialNode(QSSGRenderGraphObject *n
             modelNode->lightmapLoadPath.clear();
         }
         modelNode->levelOfDetailBias = m_levelOfDetailBias;
+        modelNode->occluder = m_occluder;
     }
 
     if (m_dirtyAttributes & ReflectionDirty) {
@@ -1166,4 +1167,45 @@ void QQuick3DModel::setLevelOfDetailBias(float newLevelOfDetailBias)
     markDirty(QQuick3DModel::PropertyDirty);
 }
 
+/*!
+    \qmlproperty bool Model::occluder
+    \since 6.8
+
+    When this property is set to \c true, the model hides other models from
+    the camera of the View3D: models that are completely behind it, or behind
+    several occluders together, are not rendered at all. This saves their draw
+    calls and vertex processing, which pays off for large, simple models, like
+    the walls and buildings of a scene, in front of many detailed ones.
+
+    The occluders are rasterized on the CPU at a low resolution every frame, so
+    they should have few triangles, and should be closed. Only models that are
+    drawn opaque are used as occluders: a model with an opacity below 1, or
+    with a material that is blended, transmissive or does not write depth, is
+    ignored. Instanced, skinned and morphed models are not used as occluders
+    either, and instanced or skinned models are never hidden by them.
+
+    Like the models outside of the view, the hidden models do not cast shadows
+    either. Occlusion culling requires depth testing to be enabled for the
+    View3D. Setting the environment variable \c QT_QUICK3D_DISABLE_OCCLUSION_CULLING
+    to \c 1 turns it off.
+
+    The default value is \c false.
+
+    \sa RenderStats::occlusionCulledObjectCount
+*/
+
+bool QQuick3DModel::isOccluder() const
+{
+    return m_occluder;
+}
+
+void QQuick3DModel::setOccluder(bool occluder)
+{
+    if (m_occluder == occluder)
+        return;
+    m_occluder = occluder;
+    emit occluderChanged();
+    markDirty(QQuick3DModel::PropertyDirty);
+}
+
 QT_END_NAMESPACE
@@ -82,6 +82,7 @@ class Q_QUICK3D_EXPORT QQuick3DModel : public QQuick3DNode
     Q_PROPERTY(float instancingLodMin READ instancingLodMin WRITE setInstancingLodMin NOTIFY instancingLodMinChanged REVISION(6, 5))
     Q_PROPERTY(float instancingLodMax READ instancingLodMax WRITE setInstancingLodMax NOTIFY instancingLodMaxChanged REVISION(6, 5))
     Q_PROPERTY(float levelOfDetailBias READ levelOfDetailBias WRITE setLevelOfDetailBias NOTIFY levelOfDetailBiasChanged REVISION(6, 5))
+    Q_PROPERTY(bool occluder READ isOccluder WRITE setOccluder NOTIFY occluderChanged REVISION(6, 8))
 
     QML_NAMED_ELEMENT(Model)
 
@@ -119,6 +120,8 @@ public:
     Q_REVISION(6, 5) float instancingLodMax() const;
     Q_REVISION(6, 5) float levelOfDetailBias() const;
 
+    Q_REVISION(6, 8) bool isOccluder() const;
+
 public Q_SLOTS:
     void setSource(const QUrl &source);
     void setCastsShadows(bool castsShadows);
@@ -142,6 +145,8 @@ public Q_SLOTS:
     Q_REVISION(6, 5) void setInstancingLodMax(float maxDistance);
     Q_REVISION(6, 5) void setLevelOfDetailBias(float newLevelOfDetailBias);
 
+    Q_REVISION(6, 8) void setOccluder(bool occluder);
+
 Q_SIGNALS:
     void sourceChanged();
     void castsShadowsChanged();
@@ -166,6 +171,8 @@ Q_SIGNALS:
     Q_REVISION(6, 5) void instancingLodMaxChanged();
     Q_REVISION(6, 5) void levelOfDetailBiasChanged();
 
+    Q_REVISION(6, 8) void occluderChanged();
+
 protected:
     QSSGRenderGraphObject *updateSpatialNode(QSSGRenderGraphObject *node) override;
     void markAllDirty() override;
@@ -238,6 +245,7 @@ private:
     float m_instancingLodMin = -1;
     float m_instancingLodMax = -1;
     float m_levelOfDetailBias = 1.0f;
+    bool m_occluder = false;
 };
 
 QT_END_NAMESPACE
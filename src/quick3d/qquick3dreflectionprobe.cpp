@@ -7,6 +7,9 @@
 #include <QtQuick3DRuntimeRender/private/qssgrenderreflectionprobe_p.h>
 #include <QtQuick3DUtils/private/qssgutils_p.h>
 
+#include <QtQml/QQmlFile>
+#include <QtQml/qqmlcontext.h>
+
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -82,6 +85,16 @@ QColor QQuick3DReflectionProbe::clearColor() const
 
     The default value is \c ReflectionProbe.EveryFrame
     \note Use \c ReflectionProbe.FirstFrame for improved performance.
+
+    With many probes, the number of cube map faces rendered per frame, over all
+    probes of a View3D, can be limited by setting the
+    \c QT_QUICK3D_REFLECTION_FACE_BUDGET environment variable. The faces to
+    update are then spread over the following frames. Probes that have not been
+    rendered completely yet, that are close to the camera or in its view, and
+    probes with objects that moved within their box since their last update
+    are rendered first.
+
+    \sa bakeToFile()
 */
 QQuick3DReflectionProbe::ReflectionRefreshMode QQuick3DReflectionProbe::refreshMode() const
 {
@@ -203,6 +216,37 @@ void QQuick3DReflectionProbe::scheduleUpdate()
     update();
 }
 
+/*!
+    \qmlmethod ReflectionProbe::bakeToFile(url fileUrl)
+    \since 6.8
+
+    Writes the reflection map of the probe to the KTX file \a fileUrl, once the
+    probe has been rendered completely. The file contains the prefiltered cube
+    map in the same format as the one produced by \l {Balsam Asset Import Tool}{Balsam} for light probes.
+
+    Probes for parts of the scene that do not change can be baked once, and
+    then use the file as their \l texture, for example with
+    \c {texture: CubeMapTexture { source: "probe.ktx" }}. Such probes do not
+    render the scene at all, which saves six passes per probe at startup, and
+    every frame with \c ReflectionProbe.EveryFrame.
+
+    The file is written asynchronously, after the readback from the GPU has
+    completed.
+*/
+void QQuick3DReflectionProbe::bakeToFile(const QUrl &fileUrl)
+{
+    const QQmlContext *context = qmlContext(this);
+    const QUrl resolvedUrl = context ? context->resolvedUrl(fileUrl) : fileUrl;
+    const QString fileName = QQmlFile::urlToLocalFileOrQrc(resolvedUrl);
+    if (fileName.isEmpty() || fileName.startsWith(QLatin1Char(':'))) {
+        qWarning("ReflectionProbe: Can only bake to local files, not %s", qPrintable(fileUrl.toString()));
+        return;
+    }
+    m_bakeFileName = fileName;
+    m_dirtyFlags.setFlag(DirtyFlag::BakeDirty);
+    update();
+}
+
 void QQuick3DReflectionProbe::setQuality(QQuick3DReflectionProbe::ReflectionQuality reflectionQuality)
 {
     if (m_quality == reflectionQuality)
@@ -367,6 +411,11 @@ QSSGRenderGraphObject *QQuick3DReflectionProbe::updateSpatialNode(QSSGRenderGrap
             probe->texture = nullptr;
     }
 
+    if (m_dirtyFlags.testFlag(DirtyFlag::BakeDirty)) {
+        m_dirtyFlags.setFlag(DirtyFlag::BakeDirty, false);
+        probe->bakeFileName = std::exchange(m_bakeFileName, QString());
+    }
+
     return node;
 }
 
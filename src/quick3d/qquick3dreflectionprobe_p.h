@@ -76,6 +76,7 @@ public:
     Q_REVISION(6, 4) QVector3D boxOffset() const;
 
     Q_REVISION(6, 4) Q_INVOKABLE void scheduleUpdate();
+    Q_REVISION(6, 8) Q_INVOKABLE void bakeToFile(const QUrl &fileUrl);
     Q_REVISION(6, 5) QQuick3DCubeMapTexture *texture() const;
 
 public Q_SLOTS:
@@ -113,7 +114,8 @@ protected:
         ParallaxCorrectionDirty = (1 << 3),
         BoxDirty = (1 << 4),
         TimeSlicingDirty = (1 << 5),
-        TextureDirty = (1 << 6)
+        TextureDirty = (1 << 6),
+        BakeDirty = (1 << 7)
     };
     Q_DECLARE_FLAGS(DirtyFlags, DirtyFlag)
 
@@ -145,6 +147,7 @@ private:
     QVector3D m_boxOffset;
     QQuick3DViewport* m_sceneView = nullptr;
     QQuick3DCubeMapTexture *m_texture = nullptr;
+    QString m_bakeFileName;
 };
 
 QT_END_NAMESPACE
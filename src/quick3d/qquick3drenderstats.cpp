@@ -172,8 +172,11 @@ void QQuick3DRenderStats::onFrameSwapped()
                 QRhiCommandBuffer *cb = sc->currentFrameCommandBuffer();
                 if (cb) {
                     const float msecs = float(cb->lastCompletedGpuTime() * 1000.0);
-                    if (!qFuzzyIsNull(msecs))
+                    if (!qFuzzyIsNull(msecs)) {
                         m_results.lastCompletedGpuTime = msecs;
+                        if (m_contextStats)
+                            m_contextStats->traceGpuFrameTime(msecs);
+                    }
                 }
             }
         }
@@ -430,7 +433,7 @@ void QQuick3DRenderStats::processRhiContextStats()
     const QSSGRhiContextStats::GlobalInfo globalData = m_contextStats->globalInfo;
     const auto textures = rhiCtxD->m_textures;
     const auto meshes = rhiCtxD->m_meshes;
-    const auto pipelines = rhiCtxD->m_pipelines;
+    const int pipelineCount = int(rhiCtxD->m_pipelines.size());
 
     m_results.drawCallCount = 0;
     m_results.drawVertexCount = 0;
@@ -443,6 +446,13 @@ void QQuick3DRenderStats::processRhiContextStats()
 
     m_results.imageDataSize = globalData.imageDataSize;
     m_results.meshDataSize = globalData.meshDataSize;
+    m_results.streamedTextureResidentSize = globalData.streamedTextureResidentSize;
+    m_results.streamedTextureRequestedSize = globalData.streamedTextureRequestedSize;
+
+    m_results.frustumCulledObjectCount = data.opaqueCulling.frustumCulledCount
+            + data.transparentCulling.frustumCulledCount;
+    m_results.occlusionCulledObjectCount = data.opaqueCulling.occlusionCulledCount
+            + data.transparentCulling.occlusionCulledCount;
 
     m_results.renderPassCount = data.renderPasses.size()
             + (data.externalRenderPass.pixelSize.isEmpty() ? 0 : 1);
@@ -461,6 +471,19 @@ void QQuick3DRenderStats::processRhiContextStats()
     renderPassDetails += QString::asprintf("\nGenerated from QSSGRenderLayer %p", m_layer);
     m_results.renderPassDetails = renderPassDetails;
 
+    QVariantList renderPassTimings;
+    renderPassTimings.reserve(data.passTimings.size());
+    for (const auto &timing : data.passTimings) {
+        renderPassTimings.append(QVariantMap {
+            { QStringLiteral("name"), QString::fromLatin1(timing.name) },
+            { QStringLiteral("prepareTime"), float(timing.prepareTime / 1000000.0) },
+            { QStringLiteral("renderTime"), float(timing.renderTime / 1000000.0) },
+            { QStringLiteral("drawCallCount"), timing.draws.callCount },
+            { QStringLiteral("drawVertexCount"), timing.draws.vertexOrIndexCount }
+        });
+    }
+    m_results.renderPassTimings = renderPassTimings;
+
     if (m_results.activeTextures != textures) {
         m_results.activeTextures = textures;
         QString texDetails = QLatin1String(R"(
@@ -530,7 +553,7 @@ void QQuick3DRenderStats::processRhiContextStats()
         m_results.meshDetails = meshDetails;
     }
 
-    m_results.pipelineCount = pipelines.count();
+    m_results.pipelineCount = pipelineCount;
 
     m_results.materialGenerationTime = m_contextStats->globalInfo.materialGenerationTime;
     m_results.effectGenerationTime = m_contextStats->globalInfo.effectGenerationTime;
@@ -563,6 +586,26 @@ void QQuick3DRenderStats::notifyRhiContextStats()
         emit meshDataSizeChanged();
     }
 
+    if (m_results.streamedTextureResidentSize != m_notifiedResults.streamedTextureResidentSize) {
+        m_notifiedResults.streamedTextureResidentSize = m_results.streamedTextureResidentSize;
+        emit streamedTextureResidentSizeChanged();
+    }
+
+    if (m_results.streamedTextureRequestedSize != m_notifiedResults.streamedTextureRequestedSize) {
+        m_notifiedResults.streamedTextureRequestedSize = m_results.streamedTextureRequestedSize;
+        emit streamedTextureRequestedSizeChanged();
+    }
+
+    if (m_results.frustumCulledObjectCount != m_notifiedResults.frustumCulledObjectCount) {
+        m_notifiedResults.frustumCulledObjectCount = m_results.frustumCulledObjectCount;
+        emit frustumCulledObjectCountChanged();
+    }
+
+    if (m_results.occlusionCulledObjectCount != m_notifiedResults.occlusionCulledObjectCount) {
+        m_notifiedResults.occlusionCulledObjectCount = m_results.occlusionCulledObjectCount;
+        emit occlusionCulledObjectCountChanged();
+    }
+
     if (m_results.renderPassCount != m_notifiedResults.renderPassCount) {
         m_notifiedResults.renderPassCount = m_results.renderPassCount;
         emit renderPassCountChanged();
@@ -573,6 +616,11 @@ void QQuick3DRenderStats::notifyRhiContextStats()
         emit renderPassDetailsChanged();
     }
 
+    if (m_results.renderPassTimings != m_notifiedResults.renderPassTimings) {
+        m_notifiedResults.renderPassTimings = m_results.renderPassTimings;
+        emit renderPassTimingsChanged();
+    }
+
     if (m_results.textureDetails != m_notifiedResults.textureDetails) {
         m_notifiedResults.textureDetails = m_results.textureDetails;
         emit textureDetailsChanged();
@@ -696,6 +744,96 @@ quint64 QQuick3DRenderStats::meshDataSize() const
     return m_results.meshDataSize;
 }
 
+/*!
+    \qmlproperty quint64 QtQuick3D::RenderStats::streamedTextureResidentSize
+    \readonly
+
+    This property holds the approximate size in bytes of the streamed textures
+    as they are currently uploaded. Textures are streamed only when a texture
+    memory budget is set with \l {View3D::textureMemoryBudget}, or with the
+    \c QT_QUICK3D_TEXTURE_MEMORY_BUDGET environment variable, in megabytes.
+    Streamed textures are loaded with a reduced resolution first, and their
+    higher resolution levels are loaded when the models using them are large
+    enough on screen, as long as the textures fit in the budget.
+
+    The value is also included in \l imageDataSize.
+
+    The value is updated only when extendedDataCollectionEnabled is enabled.
+
+    \note The value is reported on a per-QQuickWindow basis. If there are
+    multiple View3D instances within the same window, the DebugView shows the
+    same value for all those View3Ds.
+
+    \sa streamedTextureRequestedSize
+    \since 6.8
+*/
+quint64 QQuick3DRenderStats::streamedTextureResidentSize() const
+{
+    return m_results.streamedTextureResidentSize;
+}
+
+/*!
+    \qmlproperty quint64 QtQuick3D::RenderStats::streamedTextureRequestedSize
+    \readonly
+
+    This property holds the approximate size in bytes the streamed textures
+    would have with the resolution requested for them in the last frame. When
+    this is larger than \l streamedTextureResidentSize, the texture memory
+    budget does not allow loading all the requested detail and some textures
+    are shown with a lower resolution than wanted.
+
+    The value is updated only when extendedDataCollectionEnabled is enabled.
+
+    \note The value is reported on a per-QQuickWindow basis. If there are
+    multiple View3D instances within the same window, the DebugView shows the
+    same value for all those View3Ds.
+
+    \sa streamedTextureResidentSize
+    \since 6.8
+*/
+quint64 QQuick3DRenderStats::streamedTextureRequestedSize() const
+{
+    return m_results.streamedTextureRequestedSize;
+}
+
+/*!
+    \qmlproperty quint32 QtQuick3D::RenderStats::frustumCulledObjectCount
+    \readonly
+
+    This property holds the number of renderable objects, such as the subsets
+    of the models, that were not rendered by the camera in the last frame
+    because they were outside of its view. Objects are only culled this way
+    when \l Camera::frustumCullingEnabled is set.
+
+    The value is updated only when extendedDataCollectionEnabled is enabled.
+
+    \sa occlusionCulledObjectCount
+    \since 6.8
+*/
+quint32 QQuick3DRenderStats::frustumCulledObjectCount() const
+{
+    return m_results.frustumCulledObjectCount;
+}
+
+/*!
+    \qmlproperty quint32 QtQuick3D::RenderStats::occlusionCulledObjectCount
+    \readonly
+
+    This property holds the number of renderable objects, such as the subsets
+    of the models, that were inside the view of the camera in the last frame,
+    but were not rendered because they were hidden behind the models marked
+    as \l{Model::occluder}{occluders}.
+
+    The value is updated only when extendedDataCollectionEnabled is enabled.
+
+    \sa frustumCulledObjectCount
+    \since 6.8
+*/
+quint32 QQuick3DRenderStats::occlusionCulledObjectCount() const
+{
+    return m_results.occlusionCulledObjectCount;
+}
+
 /*!
     \qmlproperty int QtQuick3D::RenderStats::renderPassCount
     \readonly
@@ -943,6 +1081,41 @@ float QQuick3DRenderStats::lastCompletedGpuTime() const
     return m_results.lastCompletedGpuTime;
 }
 
+/*!
+    \qmlproperty list<var> QtQuick3D::RenderStats::renderPassTimings
+    \readonly
+
+    This property holds one entry for each render pass of the \l View3D in
+    the last frame, in execution order. It can be used as the model of a
+    Repeater or ListView. Each entry has the following properties:
+
+    \table
+    \header \li Name \li Description
+    \row \li name \li The name of the pass, for example \c shadow_map or \c opaque_pass.
+    \row \li prepareTime \li CPU time spent preparing the pass, in milliseconds.
+    \row \li renderTime \li CPU time spent recording the commands of the pass, in milliseconds.
+    \row \li drawCallCount \li The number of draw calls issued by the pass.
+    \row \li drawVertexCount \li The number of vertices or indices drawn by the pass.
+    \endtable
+
+    The value is updated only when extendedDataCollectionEnabled is enabled.
+
+    \note The graphics APIs give no per-pass GPU timings through Qt Quick,
+    see lastCompletedGpuTime for the GPU time of the whole frame.
+
+    Setting the \c QT_QUICK3D_TRACE_FILE environment variable to a file path
+    additionally writes every pass of every frame to that file in the Chrome
+    trace event format, which can be opened in Perfetto or chrome://tracing.
+    This works without a DebugView and without the QML profiler, and is meant
+    for capturing profiles of headless and long running applications.
+
+    \since 6.8
+*/
+QVariantList QQuick3DRenderStats::renderPassTimings() const
+{
+    return m_results.renderPassTimings;
+}
+
 /*!
     \internal
  */
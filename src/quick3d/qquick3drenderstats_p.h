@@ -17,6 +17,7 @@
 
 #include <QtQuick3D/qtquick3dglobal.h>
 #include <QtCore/qobject.h>
+#include <QtCore/qvariant.h>
 #include <ssg/qssgrendercontextcore.h>
 #include <QtQuick3DRuntimeRender/private/qssgrhicontext_p.h>
 
@@ -40,6 +41,10 @@ class Q_QUICK3D_EXPORT QQuick3DRenderStats : public QObject
     Q_PROPERTY(quint64 drawVertexCount READ drawVertexCount NOTIFY drawVertexCountChanged)
     Q_PROPERTY(quint64 imageDataSize READ imageDataSize NOTIFY imageDataSizeChanged)
     Q_PROPERTY(quint64 meshDataSize READ meshDataSize NOTIFY meshDataSizeChanged)
+    Q_PROPERTY(quint64 streamedTextureResidentSize READ streamedTextureResidentSize NOTIFY streamedTextureResidentSizeChanged)
+    Q_PROPERTY(quint64 streamedTextureRequestedSize READ streamedTextureRequestedSize NOTIFY streamedTextureRequestedSizeChanged)
+    Q_PROPERTY(quint32 frustumCulledObjectCount READ frustumCulledObjectCount NOTIFY frustumCulledObjectCountChanged)
+    Q_PROPERTY(quint32 occlusionCulledObjectCount READ occlusionCulledObjectCount NOTIFY occlusionCulledObjectCountChanged)
     Q_PROPERTY(int renderPassCount READ renderPassCount NOTIFY renderPassCountChanged)
     Q_PROPERTY(QString renderPassDetails READ renderPassDetails NOTIFY renderPassDetailsChanged)
     Q_PROPERTY(QString textureDetails READ textureDetails NOTIFY textureDetailsChanged)
@@ -52,6 +57,7 @@ class Q_QUICK3D_EXPORT QQuick3DRenderStats : public QObject
     Q_PROPERTY(quint64 vmemUsedBytes READ vmemUsedBytes NOTIFY vmemUsedBytesChanged)
     Q_PROPERTY(QString graphicsApiName READ graphicsApiName NOTIFY graphicsApiNameChanged)
     Q_PROPERTY(float lastCompletedGpuTime READ lastCompletedGpuTime NOTIFY lastCompletedGpuTimeChanged)
+    Q_PROPERTY(QVariantList renderPassTimings READ renderPassTimings NOTIFY renderPassTimingsChanged)
 
 public:
     QQuick3DRenderStats(QObject *parent = nullptr);
@@ -80,6 +86,10 @@ public:
     quint64 drawVertexCount() const;
     quint64 imageDataSize() const;
     quint64 meshDataSize() const;
+    quint64 streamedTextureResidentSize() const;
+    quint64 streamedTextureRequestedSize() const;
+    quint32 frustumCulledObjectCount() const;
+    quint32 occlusionCulledObjectCount() const;
     int renderPassCount() const;
     QString renderPassDetails() const;
     QString textureDetails() const;
@@ -92,6 +102,7 @@ public:
     quint64 vmemUsedBytes() const;
     QString graphicsApiName() const;
     float lastCompletedGpuTime() const;
+    QVariantList renderPassTimings() const;
 
     Q_INVOKABLE void releaseCachedResources();
 
@@ -108,6 +119,10 @@ Q_SIGNALS:
     void drawVertexCountChanged();
     void imageDataSizeChanged();
     void meshDataSizeChanged();
+    void streamedTextureResidentSizeChanged();
+    void streamedTextureRequestedSizeChanged();
+    void frustumCulledObjectCountChanged();
+    void occlusionCulledObjectCountChanged();
     void renderPassCountChanged();
     void renderPassDetailsChanged();
     void textureDetailsChanged();
@@ -120,6 +135,7 @@ Q_SIGNALS:
     void vmemUsedBytesChanged();
     void graphicsApiNameChanged();
     void lastCompletedGpuTimeChanged();
+    void renderPassTimingsChanged();
 
 private Q_SLOTS:
     void onFrameSwapped();
@@ -152,8 +168,13 @@ private:
         quint64 drawVertexCount = 0;
         quint64 imageDataSize = 0;
         quint64 meshDataSize = 0;
+        quint64 streamedTextureResidentSize = 0;
+        quint64 streamedTextureRequestedSize = 0;
+        quint32 frustumCulledObjectCount = 0;
+        quint32 occlusionCulledObjectCount = 0;
         int renderPassCount = 0;
         QString renderPassDetails;
+        QVariantList renderPassTimings;
         QString textureDetails;
         QString meshDetails;
         QSet<QRhiTexture *> activeTextures;
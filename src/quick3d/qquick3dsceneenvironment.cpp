@@ -1551,4 +1551,41 @@ void QQuick3DSceneEnvironment::setFog(QQuick3DFog *fog)
     update();
 }
 
+/*!
+    \qmlproperty bool QtQuick3D::SceneEnvironment::item2DCachingEnabled
+    \since 6.8
+
+    When this property is enabled, Qt Quick items placed in the 3D scene are
+    rendered into a texture only when their content changes, and that texture
+    is drawn as a quad in every frame. This saves re-rendering static 2D
+    content, such as dashboards and labels, in each frame. Items that change in
+    every frame, for example animations, cost an additional render pass.
+
+    The texture has the size of the items times the device pixel ratio, and is
+    mipmapped so that distant items are not aliased. Items that are scaled up
+    in the 3D scene therefore look blurrier than when rendered directly; make
+    the items larger and scale their parent node down instead. Content that is
+    drawn outside of the bounds of the items, like shadows, is cut off.
+
+    The default value is \c false.
+
+    \note Regardless of this property, the items are skipped when they are
+    outside of the view of a camera that has \l {Camera::frustumCullingEnabled}
+    {frustum culling} enabled.
+*/
+bool QQuick3DSceneEnvironment::item2DCachingEnabled() const
+{
+    return m_item2DCachingEnabled;
+}
+
+void QQuick3DSceneEnvironment::setItem2DCachingEnabled(bool enabled)
+{
+    if (m_item2DCachingEnabled == enabled)
+        return;
+
+    m_item2DCachingEnabled = enabled;
+    emit item2DCachingEnabledChanged();
+    update();
+}
+
 QT_END_NAMESPACE
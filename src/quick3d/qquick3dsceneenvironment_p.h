@@ -75,6 +75,8 @@ class Q_QUICK3D_EXPORT QQuick3DSceneEnvironment : public QQuick3DObject
 
     Q_PROPERTY(QQuick3DFog *fog READ fog WRITE setFog NOTIFY fogChanged REVISION(6, 5))
 
+    Q_PROPERTY(bool item2DCachingEnabled READ item2DCachingEnabled WRITE setItem2DCachingEnabled NOTIFY item2DCachingEnabledChanged REVISION(6, 8))
+
     QML_NAMED_ELEMENT(SceneEnvironment)
 
 public:
@@ -154,6 +156,8 @@ public:
 
     Q_REVISION(6, 5) QQuick3DFog *fog() const;
 
+    Q_REVISION(6, 8) bool item2DCachingEnabled() const;
+
     bool gridEnabled() const;
     void setGridEnabled(bool newGridEnabled);
 
@@ -200,6 +204,8 @@ public Q_SLOTS:
 
     Q_REVISION(6, 5) void setFog(QQuick3DFog *fog);
 
+    Q_REVISION(6, 8) void setItem2DCachingEnabled(bool enabled);
+
 Q_SIGNALS:
     void antialiasingModeChanged();
     void antialiasingQualityChanged();
@@ -237,6 +243,8 @@ Q_SIGNALS:
 
     Q_REVISION(6, 5) void fogChanged();
 
+    Q_REVISION(6, 8) void item2DCachingEnabledChanged();
+
 protected:
     QSSGRenderGraphObject *updateSpatialNode(QSSGRenderGraphObject *node) override;
     void itemChange(ItemChange, const ItemChangeData &) override;
@@ -262,6 +270,7 @@ private:
     bool m_temporalAAEnabled = false;
     float m_temporalAAStrength = 0.3f;
     bool m_specularAAEnabled = false;
+    bool m_item2DCachingEnabled = false;
 
     QQuick3DEnvironmentBackgroundTypes m_backgroundMode = Transparent;
     QColor m_clearColor = Qt::black;
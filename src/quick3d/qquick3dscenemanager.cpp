@@ -488,6 +488,9 @@ void QQuick3DWindowAttachment::cleanupResources()
     if (!m_rci)
         return;
 
+    // All View3Ds in the window asked for the texture detail they need
+    m_rci->bufferManager()->endStreamingFrame();
+
     // Check if there's orphaned resources that needs to be
     // cleaned out first.
     if (resourceCleanupQueue.size() != 0)
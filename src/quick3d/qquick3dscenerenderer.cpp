@@ -404,7 +404,7 @@ QRhiTexture *QQuick3DSceneRenderer::renderToRhiTexture(QQuickWindow *qw)
                     bindings.addTexture(1, QRhiShaderResourceBinding::FragmentStage, currentTexture, sampler);
                     bindings.addTexture(2, QRhiShaderResourceBinding::FragmentStage, m_prevTempAATexture, sampler);
 
-                    QRhiShaderResourceBindings *srb = rhiCtxD->srb(bindings);
+                    QRhiShaderResourceBindings *srb = rhiCtxD->srb(dcd, bindings);
 
                     QSSGRhiGraphicsPipelineState ps;
                     const QSize textureSize = currentTexture->pixelSize();
@@ -590,6 +590,23 @@ void QQuick3DSceneRenderer::synchronize(QQuick3DViewport *view3D, const QSize &s
     Q_QUICK3D_PROFILE_START(QQuick3DProfiler::Quick3DSynchronizeFrame);
 
     m_sgContext->renderer()->setDpr(dpr);
+    m_sgContext->bufferManager()->requestTextureMemoryBudget(quint64(view3D->textureMemoryBudget()) * 1024 * 1024);
+
+    // The GUI thread is blocked, so the view is alive while the collections
+    // are loaded, and the queued signals are dropped if it goes away later.
+    if (!view3D->m_pendingShaderWarmUps.isEmpty()) {
+        const QStringList collections = std::exchange(view3D->m_pendingShaderWarmUps, {});
+        for (const QString &collection : collections) {
+            const qsizetype count = m_sgContext->shaderCache()->warmUp(collection, [view3D](qsizetype done, qsizetype total) {
+                QMetaObject::invokeMethod(view3D, [view3D, done, total] {
+                    emit view3D->shaderWarmUpProgress(int(done), int(total));
+                }, Qt::QueuedConnection);
+            });
+            QMetaObject::invokeMethod(view3D, [view3D, count] {
+                emit view3D->shaderWarmUpFinished(int(count));
+            }, Qt::QueuedConnection);
+        }
+    }
     bool layerSizeIsDirty = m_surfaceSize != size;
     m_surfaceSize = size;
 
@@ -1131,6 +1148,8 @@ void QQuick3DRenderLayerHelpers::updateLayerNodeHelper(const QQuick3DViewport &v
 
     layerNode.specularAAEnabled = environment->specularAAEnabled();
 
+    layerNode.item2DCachingEnabled = environment->item2DCachingEnabled();
+
     layerNode.background = QSSGRenderLayer::Background(environment->backgroundMode());
     layerNode.clearColor = QVector3D(float(environment->clearColor().redF()),
                                       float(environment->clearColor().greenF()),
@@ -1191,6 +1210,9 @@ void QQuick3DRenderLayerHelpers::updateLayerNodeHelper(const QQuick3DViewport &v
         layerNode.lmOptions.indirectLightWorkgroupSize = lightmapper->indirectLightWorkgroupSize();
         layerNode.lmOptions.indirectLightBounces = lightmapper->bounces();
         layerNode.lmOptions.indirectLightFactor = lightmapper->indirectLightFactor();
+        layerNode.lmOptions.indirectLightPasses = lightmapper->passes();
+        layerNode.lmOptions.incrementalBaking = lightmapper->isIncrementalBakingEnabled();
+        layerNode.lmOptions.denoise = lightmapper->isDenoiseEnabled();
     } else {
         layerNode.lmOptions = {};
     }
@@ -1237,6 +1259,19 @@ void QQuick3DSceneRenderer::updateLayerNode(QQuick3DViewport *view3D, const QLis
         extraFramesToRender = (m_aaIsDirty || temporalIsDirty) ? QSSGLayerRenderData::MAX_TEMPORAL_AA_LEVELS : 1;
     }
 
+    // A GPU pick query is read back asynchronously, keep rendering until
+    // the result has made it back to the layer. The View3D gets the latest
+    // result here, the GUI thread being blocked.
+    view3D->m_gpuPickResult = layerNode->gpuPick.result;
+    if (view3D->m_gpuPickPending) {
+        view3D->m_gpuPickPending = false;
+        layerNode->gpuPick.position = view3D->m_gpuPickPosition;
+        layerNode->gpuPick.requested = true;
+        const int framesInFlight = m_sgContext->rhiContext()->rhi()->resourceLimit(QRhi::FramesInFlight);
+        // One more for the sync that hands the result over
+        extraFramesToRender = qMax(extraFramesToRender, framesInFlight + 2);
+    }
+
     requestedFramesCount = extraFramesToRender;
     // Effects need to be rendered in reverse order as described in the file.
     layerNode->firstEffect = nullptr; // We reset the linked list
@@ -423,6 +423,51 @@ static QSSGRenderTextureFormat::Format convertToBackendFormat(QQuick3DTextureDat
     }
 }
 
+/*!
+    \since 6.8
+
+    Replaces the pixels within \a rect with \a data. The contents of \a data
+    must be the rows of the region in the current \l format, tightly packed.
+
+    Unlike setTextureData(), this only uploads the changed region to the
+    existing texture, which makes it suitable for frequent, partial updates,
+    such as streaming video frames or painting into a texture. The \l size and
+    \l format must already be set, and \a rect must lie within the size.
+
+    \note This is only supported for uncompressed 2D texture data.
+*/
+void QQuick3DTextureData::updateRegion(const QRect &rect, const QByteArray &data)
+{
+    Q_D(QQuick3DTextureData);
+    const QSSGRenderTextureFormat format = convertToBackendFormat(d->format);
+    if (format.isCompressedTextureFormat() || d->depth > 0) {
+        qWarning("QQuick3DTextureData::updateRegion: Only supported for uncompressed 2D texture data");
+        return;
+    }
+    if (rect.isEmpty() || !QRect(QPoint(0, 0), d->size).contains(rect)) {
+        qWarning("QQuick3DTextureData::updateRegion: Region is outside of the texture");
+        return;
+    }
+
+    const qsizetype bytesPerPixel = format.getSizeofFormat();
+    const qsizetype rowSize = rect.width() * bytesPerPixel;
+    // rows of the texture data are 4 byte aligned
+    const qsizetype pitch = (d->size.width() * bytesPerPixel + 3) & ~3;
+    if (data.size() < rowSize * rect.height() || d->textureData.size() < pitch * d->size.height()) {
+        qWarning("QQuick3DTextureData::updateRegion: Not enough data");
+        return;
+    }
+
+    char *dst = d->textureData.data();
+    for (int y = 0; y < rect.height(); ++y)
+        memcpy(dst + (rect.y() + y) * pitch + rect.x() * bytesPerPixel, data.constData() + y * rowSize, rowSize);
+
+    // a pending full update covers the region as well
+    if (!d->textureDataDirty)
+        d->dirtyRegions.append(rect);
+    update();
+}
+
 /*!
     \internal
 */
@@ -441,8 +486,13 @@ QSSGRenderGraphObject *QQuick3DTextureData::updateSpatialNode(QSSGRenderGraphObj
     // Use a dirty flag so we don't compare large buffer values
     if (d->textureDataDirty) {
         d->textureDataDirty = false;
+        d->dirtyRegions.clear();
         textureData->setTextureData(d->textureData);
         changed = true;
+    } else if (!d->dirtyRegions.isEmpty()) {
+        textureData->updateTextureData(d->textureData, d->dirtyRegions);
+        d->dirtyRegions.clear();
+        changed = true;
     }
 
     // Can't use qUpdateIfNeeded unfortunately
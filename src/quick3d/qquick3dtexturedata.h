@@ -5,6 +5,7 @@
 #define QQUICK3DTEXTUREDATA_H
 
 #include <QtQuick3D/qquick3dobject.h>
+#include <QtCore/qrect.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -65,6 +66,7 @@ public:
 
     const QByteArray textureData() const;
     void setTextureData(const QByteArray &data);
+    void updateRegion(const QRect &rect, const QByteArray &data);
 
     QSize size() const;
     void setSize(const QSize &size);
@@ -17,6 +17,7 @@
 //
 
 #include <QtCore/QSize>
+#include <QtCore/QRect>
 
 #include <QtQuick3D/QQuick3DTextureData>
 #include <QtQuick3D/private/qquick3dobject_p.h>
@@ -34,6 +35,7 @@ public:
     QQuick3DTextureData::Format format = QQuick3DTextureData::RGBA8;
     bool hasTransparency = false;
     bool textureDataDirty = false;
+    QVector<QRect> dirtyRegions;
 };
 
 QT_END_NAMESPACE
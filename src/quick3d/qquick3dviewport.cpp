@@ -870,6 +870,79 @@ QSize QQuick3DViewport::effectiveTextureSize() const
     return m_effectiveTextureSize;
 }
 
+/*!
+    \qmlproperty enumeration QtQuick3D::View3D::pickingMode
+    \since 6.8
+
+    This property determines how \l pick(float x, float y) finds the object
+    under a view position.
+
+    \value View3D.CpuPicking
+        A ray is intersected with the meshes on the CPU. The result is
+        available immediately and includes the UV coordinates and the face
+        normal of the hit. This is the default.
+    \value View3D.GpuPicking
+        The visible models are rendered into a single pixel pass that records
+        which object and instance covers the queried position. Since the result
+        has to be read back from the GPU, it becomes available one or more
+        frames after the request: \c pick() returns the result of the most
+        recently completed query and schedules a new one. The hit matches what
+        is rendered, including skinning, morphing and custom vertex shaders,
+        and the cost does not depend on the triangle count. Item2D hits, UV
+        coordinates and the face normal are not reported.
+
+    Only \l pick(float x, float y) is affected, the other picking methods
+    always use the CPU.
+*/
+QQuick3DViewport::PickingMode QQuick3DViewport::pickingMode() const
+{
+    return m_pickingMode;
+}
+
+void QQuick3DViewport::setPickingMode(QQuick3DViewport::PickingMode mode)
+{
+    if (m_pickingMode == mode)
+        return;
+
+    m_pickingMode = mode;
+    emit pickingModeChanged();
+}
+
+/*!
+    \qmlproperty int QtQuick3D::View3D::textureMemoryBudget
+    \since 6.8
+
+    This property holds the GPU memory, in megabytes, that the textures loaded
+    from image files may take up. With a budget, these textures are streamed:
+    they are uploaded with a reduced resolution first, and their full
+    resolution is only loaded, in the background, when the models using them
+    are large enough on screen. When the budget is exceeded, the resolution of
+    the textures that have not needed it for the longest time is reduced again.
+
+    The textures are shared by all the View3Ds in a window, and so is the
+    budget. When several of them set one, the largest applies.
+
+    The default value is \c 0, meaning no budget, unless one is set with the
+    \c QT_QUICK3D_TEXTURE_MEMORY_BUDGET environment variable.
+
+    \sa RenderStats::streamedTextureResidentSize, RenderStats::streamedTextureRequestedSize
+*/
+int QQuick3DViewport::textureMemoryBudget() const
+{
+    return m_textureMemoryBudget;
+}
+
+void QQuick3DViewport::setTextureMemoryBudget(int megabytes)
+{
+    megabytes = qMax(0, megabytes);
+    if (m_textureMemoryBudget == megabytes)
+        return;
+
+    m_textureMemoryBudget = megabytes;
+    emit textureMemoryBudgetChanged();
+    update();
+}
+
 
 /*!
     \qmlmethod vector3d View3D::mapFrom3DScene(vector3d scenePos)
@@ -943,6 +1016,9 @@ QVector3D QQuick3DViewport::mapTo3DScene(const QVector3D &viewPos) const
     and return information about the nearest intersection with an object in the scene.
 
     This can, for instance, be called with mouse coordinates to find the object under the mouse cursor.
+
+    When \l pickingMode is \c View3D.GpuPicking, the returned result is the
+    one of the most recently completed GPU query, see \l pickingMode.
 */
 QQuick3DPickResult QQuick3DViewport::pick(float x, float y) const
 {
@@ -952,6 +1028,14 @@ QQuick3DPickResult QQuick3DViewport::pick(float x, float y) const
 
     const QPointF position(qreal(x) * window()->effectiveDevicePixelRatio() * m_widthMultiplier,
                            qreal(y) * window()->effectiveDevicePixelRatio() * m_heightMultiplier);
+
+    if (m_pickingMode == GpuPicking) {
+        m_gpuPickPosition = position;
+        m_gpuPickPending = true;
+        const_cast<QQuick3DViewport *>(this)->update();
+        return processPickResult(m_gpuPickResult);
+    }
+
     std::optional<QSSGRenderRay> rayResult = renderer->getRayFromViewportPos(position);
     if (!rayResult.has_value())
         return QQuick3DPickResult();
@@ -1191,6 +1275,56 @@ void QQuick3DViewport::bakeLightmap()
     lightmapBaker()->bake();
 }
 
+/*!
+    \qmlmethod void View3D::warmUpShaders(url collection)
+    \since 6.8
+
+    Loads the shaders of \a collection, a \c .qsbc file recorded by running
+    the application with the \c QT_QUICK3D_SHADER_RECORD_FILE environment
+    variable set, or generated from such recordings with \l shadergen. The
+    materials and effects that need one of these shaders later on no longer
+    wait for it to be generated and compiled.
+
+    The shaders are loaded on the render thread before the next frame is
+    rendered. The shaderWarmUpProgress() signal is emitted for every shader of
+    the collection, and the shaderWarmUpFinished() signal once they are all
+    available. Calling this function before the first frame, for example in
+    \c{Component.onCompleted}, makes the shaders available to that frame.
+
+    \sa {Recording shaders at run-time}
+*/
+void QQuick3DViewport::warmUpShaders(const QUrl &collection)
+{
+    const QQmlContext *context = qmlContext(this);
+    const QUrl resolvedUrl = context ? context->resolvedUrl(collection) : collection;
+    const QString fileName = QQmlFile::urlToLocalFileOrQrc(resolvedUrl);
+    if (fileName.isEmpty()) {
+        qWarning("View3D: Cannot warm up shaders from %s, only local files and resources are supported",
+                 qPrintable(collection.toString()));
+        return;
+    }
+
+    m_pendingShaderWarmUps.append(fileName);
+    update();
+}
+
+/*!
+    \qmlsignal View3D::shaderWarmUpProgress(int done, int total)
+    \since 6.8
+
+    This signal is emitted while warmUpShaders() loads a collection, after
+    \a done of its \a total shaders were processed.
+*/
+
+/*!
+    \qmlsignal View3D::shaderWarmUpFinished(int count)
+    \since 6.8
+
+    This signal is emitted when warmUpShaders() has loaded a collection.
+    \a count is the number of shaders added, which excludes the ones that were
+    already available and the ones that failed to load.
+*/
+
 void QQuick3DViewport::setGlobalPickingEnabled(bool isEnabled)
 {
     QQuick3DSceneRenderer *renderer = getRenderer();
@@ -58,6 +58,8 @@ class Q_QUICK3D_EXPORT QQuick3DViewport : public QQuickItem
     Q_PROPERTY(int explicitTextureWidth READ explicitTextureWidth WRITE setExplicitTextureWidth NOTIFY explicitTextureWidthChanged FINAL REVISION(6, 7))
     Q_PROPERTY(int explicitTextureHeight READ explicitTextureHeight WRITE setExplicitTextureHeight NOTIFY explicitTextureHeightChanged FINAL REVISION(6, 7))
     Q_PROPERTY(QSize effectiveTextureSize READ effectiveTextureSize NOTIFY effectiveTextureSizeChanged FINAL REVISION(6, 7))
+    Q_PROPERTY(PickingMode pickingMode READ pickingMode WRITE setPickingMode NOTIFY pickingModeChanged FINAL REVISION(6, 8))
+    Q_PROPERTY(int textureMemoryBudget READ textureMemoryBudget WRITE setTextureMemoryBudget NOTIFY textureMemoryBudgetChanged FINAL REVISION(6, 8))
     Q_CLASSINFO("DefaultProperty", "data")
 
     QML_NAMED_ELEMENT(View3D)
@@ -71,6 +73,12 @@ public:
     };
     Q_ENUM(RenderMode)
 
+    enum PickingMode {
+        CpuPicking,
+        GpuPicking
+    };
+    Q_ENUM(PickingMode)
+
     explicit QQuick3DViewport(QQuickItem *parent = nullptr);
     ~QQuick3DViewport() override;
 
@@ -106,6 +114,7 @@ public:
     QQuick3DLightmapBaker *lightmapBaker();
 
     Q_INVOKABLE void bakeLightmap();
+    Q_REVISION(6, 8) Q_INVOKABLE void warmUpShaders(const QUrl &collection);
 
     QQmlListProperty<QQuick3DObject> extensions();
 
@@ -113,6 +122,9 @@ public:
     Q_REVISION(6, 7) int explicitTextureHeight() const;
     Q_REVISION(6, 7) QSize effectiveTextureSize() const;
 
+    Q_REVISION(6, 8) PickingMode pickingMode() const;
+    Q_REVISION(6, 8) int textureMemoryBudget() const;
+
     // Private helpers
     [[nodiscard]] bool extensionListDirty() const { return m_extensionListDirty; }
     [[nodiscard]] const QList<QQuick3DObject *> &extensionList() const { return m_extensions; }
@@ -136,6 +148,8 @@ public Q_SLOTS:
     Q_REVISION(6, 4) void setRenderFormat(QQuickShaderEffectSource::Format format);
     Q_REVISION(6, 7) void setExplicitTextureWidth(int width);
     Q_REVISION(6, 7) void setExplicitTextureHeight(int height);
+    Q_REVISION(6, 8) void setPickingMode(QQuick3DViewport::PickingMode mode);
+    Q_REVISION(6, 8) void setTextureMemoryBudget(int megabytes);
     void cleanupDirectRenderer();
 
     // Setting this true enables picking for all the models, regardless of
@@ -157,9 +171,14 @@ Q_SIGNALS:
     Q_REVISION(6, 7) void explicitTextureWidthChanged();
     Q_REVISION(6, 7) void explicitTextureHeightChanged();
     Q_REVISION(6, 7) void effectiveTextureSizeChanged();
+    Q_REVISION(6, 8) void pickingModeChanged();
+    Q_REVISION(6, 8) void textureMemoryBudgetChanged();
+    Q_REVISION(6, 8) void shaderWarmUpProgress(int done, int total);
+    Q_REVISION(6, 8) void shaderWarmUpFinished(int count);
 
 private:
     friend class QQuick3DExtensionListHelper;
+    friend class QQuick3DSceneRenderer;
 
     Q_DISABLE_COPY(QQuick3DViewport)
     struct SubsceneInfo {
@@ -199,6 +218,15 @@ private:
     bool m_renderModeDirty = false;
     RenderMode m_renderMode = Offscreen;
     QQuickShaderEffectSource::Format m_renderFormat = QQuickShaderEffectSource::RGBA8;
+    PickingMode m_pickingMode = CpuPicking;
+    int m_textureMemoryBudget = 0;
+    // The GPU pick request and the latest result, exchanged with the renderer
+    // in its synchronize(), while the GUI thread is blocked
+    mutable QPointF m_gpuPickPosition;
+    mutable bool m_gpuPickPending = false;
+    QSSGRenderPickResult m_gpuPickResult;
+    // Shader collections to load by the renderer in its next synchronize()
+    QStringList m_pendingShaderWarmUps;
     int m_explicitTextureWidth = 0;
     int m_explicitTextureHeight = 0;
     QSize m_effectiveTextureSize;
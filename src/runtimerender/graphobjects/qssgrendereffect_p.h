@@ -91,6 +91,13 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderEffect : public QSSGRenderGraphOb
     FlagT flags = FlagT(Flags::Dirty);
     bool requiresDepthTexture = false;
     bool incompleteBuildTimeObject = false; // Used by the shadergen tool
+    // A single pass with the default vertex shader and output that samples
+    // INPUT only at INPUT_UV. Runs of such effects are rendered in one pass,
+    // see QSSGRhiEffectSystem.
+    bool isPixelLocal = false;
+    // Functions, globals and macros the fragment shader of a pixel local
+    // effect declares. Effects declaring the same name are not fused.
+    QByteArrayList shaderGlobalNames;
     QSSGRenderTextureFormat::Format outputFormat = QSSGRenderTextureFormat::Unknown;
 
     struct ShaderPrepPassData
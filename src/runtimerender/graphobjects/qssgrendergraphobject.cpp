@@ -19,6 +19,7 @@ static const char *asString(QSSGRenderGraphObject::Type type)
         RETURN_AS_STRING(Type::Skeleton)
         RETURN_AS_STRING(Type::ImportScene)
         RETURN_AS_STRING(Type::ReflectionProbe)
+        RETURN_AS_STRING(Type::LodGroup)
         RETURN_AS_STRING(Type::DirectionalLight)
         RETURN_AS_STRING(Type::PointLight)
         RETURN_AS_STRING(Type::SpotLight)
@@ -63,6 +63,7 @@ public:
         Skeleton, // Node (A resource to the model node)
         ImportScene, // Node
         ReflectionProbe,
+        LodGroup, // Node
         // Light nodes
         DirectionalLight = BaseType::Light | BaseType::Node,
         PointLight,
@@ -5,6 +5,7 @@
 #include <QtQuick3DRuntimeRender/private/qssgrenderitem2d_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderbuffermanager_p.h>
 #include <QtQuick/QSGTexture>
+#include <QtGui/rhi/qrhi.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -20,6 +21,20 @@ QSSGRenderItem2D::~QSSGRenderItem2D()
     // But if this backend node may suddenly be deleted,
     // it is safe to remain this deletion here.
     delete m_rp;
+    releaseCachedTexture();
+}
+
+void QSSGRenderItem2D::releaseCachedTexture()
+{
+    delete m_textureRt;
+    m_textureRt = nullptr;
+    delete m_textureRp;
+    m_textureRp = nullptr;
+    delete m_textureDepthStencil;
+    m_textureDepthStencil = nullptr;
+    delete m_texture;
+    m_texture = nullptr;
+    contentDirty = true;
 }
 
 QT_END_NAMESPACE
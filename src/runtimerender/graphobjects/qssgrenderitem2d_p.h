@@ -20,12 +20,16 @@
 #include <QtQuick3DRuntimeRender/private/qssgrenderimage_p.h>
 
 #include <QtCore/qpointer.h>
+#include <QtCore/qrect.h>
 
 QT_BEGIN_NAMESPACE
 
 class QSGNode;
 class QSGRenderer;
 class QRhiRenderPassDescriptor;
+class QRhiTexture;
+class QRhiRenderBuffer;
+class QRhiTextureRenderTarget;
 
 struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderItem2D : public QSSGRenderNode
 {
@@ -35,11 +39,27 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderItem2D : public QSSGRenderNode
     float combinedOpacity = 1.0;
     float zOrder = 0;
 
+    // Bounding rectangle of the 2D content in the coordinates of the item,
+    // used for culling and as the area of the cached texture. Not culled when
+    // empty.
+    QRectF bounds;
+
     QPointer<QSGRenderer> m_renderer;
     QRhiRenderPassDescriptor *m_rp = nullptr;
 
+    // Cached rendering, see QSSGRenderLayer::item2DCachingEnabled. The content
+    // is rendered into m_texture when contentDirty is set, which happens when
+    // the 2D scene graph changes.
+    bool contentDirty = true;
+    QRhiTexture *m_texture = nullptr;
+    QRhiRenderBuffer *m_textureDepthStencil = nullptr;
+    QRhiTextureRenderTarget *m_textureRt = nullptr;
+    QRhiRenderPassDescriptor *m_textureRp = nullptr;
+
     QSSGRenderItem2D();
     ~QSSGRenderItem2D();
+
+    void releaseCachedTexture();
 };
 QT_END_NAMESPACE
 
@@ -25,6 +25,8 @@ QSSGRenderLayer::QSSGRenderLayer()
     , tonemapMode(TonemapMode::Linear)
 {
     flags = { FlagT(LocalState::Active) | FlagT(GlobalState::Active) }; // The layer node is alway active and not dirty.
+    static const bool skinningPrePass = (qEnvironmentVariableIntValue("QT_QUICK3D_SKINNING_PREPASS") != 0);
+    skinningPrePassEnabled = skinningPrePass;
 }
 
 QSSGRenderLayer::~QSSGRenderLayer()
@@ -75,13 +77,16 @@ void QSSGRenderLayer::setImportScene(QSSGRenderNode &rootNode)
     Q_ASSERT(importChildren.isEmpty());
     // We don't want the list to modify our node, so we set the tail and head manually.
     importChildren.m_head = importChildren.m_tail = &rootNode;
+    markStructureChanged();
 }
 
 void QSSGRenderLayer::removeImportScene(QSSGRenderNode &rootNode)
 {
     if (importSceneNode && !importSceneNode->children.isEmpty()) {
-        if (&importSceneNode->children.back() == &rootNode)
+        if (&importSceneNode->children.back() == &rootNode) {
             importSceneNode->children.clear();
+            markStructureChanged();
+        }
     }
 }
 
@@ -20,6 +20,7 @@
 #include <QtCore/qvarlengtharray.h>
 #include <QtCore/qlist.h>
 #include <ssg/qssglightmapper.h>
+#include <ssg/qssgrenderpickresult.h>
 
 QT_BEGIN_NAMESPACE
 class QSSGRenderContextInterface;
@@ -214,12 +215,31 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderLayer : public QSSGRenderNode
         float transmitCurve = 1.0f;
     } fog;
 
+    // GPU picking. The position is in layer pixels (top-left origin). The
+    // result is written when the readback of the query completes, which is
+    // at least one frame after the request.
+    struct GpuPickState {
+        QPointF position;
+        bool requested = false;
+        quint32 resultSerial = 0;
+        QSSGRenderPickResult result;
+    } gpuPick;
+
     QVector<QSSGRenderGraphObject *> resourceLoaders;
 
     MaterialDebugMode debugMode = MaterialDebugMode::None;
 
     bool wireframeMode = false;
 
+    // Skin and morph models once per frame in a compute pre-pass, instead of
+    // in the vertex shader of every pass that draws them. Needs QRhi::Compute,
+    // defaults to the QT_QUICK3D_SKINNING_PREPASS environment variable.
+    bool skinningPrePassEnabled = false;
+
+    // Render the content of each Item2D into a texture only when its scene
+    // graph changes, and draw that texture as a quad every frame.
+    bool item2DCachingEnabled = false;
+
     QSSGRenderLayer();
     ~QSSGRenderLayer();
 
@@ -0,0 +1,60 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderlodgroup_p.h>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+QSSGRenderLodGroup::QSSGRenderLodGroup()
+    : QSSGRenderNode(QSSGRenderGraphObject::Type::LodGroup)
+{
+}
+
+QSSGRenderLodGroup::Selection QSSGRenderLodGroup::selectLevel(qsizetype levelCount, float pixelsPerUnit, float pixelThreshold)
+{
+    Selection selection;
+    levelCount = qMin(levelCount, levelErrors.size());
+    if (levelCount <= 0)
+        return selection;
+
+    const float maximumError = maximumScreenError * pixelThreshold;
+    const float lowerBound = maximumError * (1.0f - hysteresis);
+    const float upperBound = maximumError * (1.0f + hysteresis);
+
+    // The coarsest level below the lower and the upper bound of the
+    // hysteresis band, any level in between is acceptable.
+    qsizetype minLevel = 0;
+    qsizetype maxLevel = 0;
+    for (qsizetype i = 1; i < levelCount; ++i) {
+        const float error = levelErrors.at(i) * pixelsPerUnit;
+        if (error > upperBound)
+            break;
+        maxLevel = i;
+        if (error <= lowerBound)
+            minLevel = i;
+    }
+
+    selection.level = maxLevel;
+    if (crossFade) {
+        // Within the band the two neighbouring levels are dithered into
+        // each other, instead of sticking to the current one. Outside of
+        // it the level is drawn as is, without the dithering.
+        selection.level = minLevel;
+        if (minLevel < maxLevel) {
+            selection.fadeLevel = minLevel + 1;
+            const float error = levelErrors.at(selection.fadeLevel) * pixelsPerUnit;
+            selection.crossFade = qBound(std::numeric_limits<float>::epsilon(),
+                                         (error - lowerBound) / (upperBound - lowerBound),
+                                         1.0f - std::numeric_limits<float>::epsilon());
+        }
+    } else if (currentLevel >= 0) {
+        selection.level = qBound(minLevel, currentLevel, maxLevel);
+    }
+    currentLevel = (selection.fadeLevel >= 0 && selection.crossFade < 0.5f) ? selection.fadeLevel : selection.level;
+
+    return selection;
+}
+
+QT_END_NAMESPACE
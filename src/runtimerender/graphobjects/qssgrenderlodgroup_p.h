@@ -0,0 +1,65 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef QSSG_RENDER_LOD_GROUP_H
+#define QSSG_RENDER_LOD_GROUP_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRuntimeRender/private/qssgrendernode_p.h>
+
+#include <QtCore/qvarlengtharray.h>
+
+QT_BEGIN_NAMESPACE
+
+// Each child of the group is one level of detail, the first one being the most
+// detailed. The level is picked in QSSGLayerRenderData::prepareForRender() from
+// the screen-space error of the levels, only the models of the picked level(s)
+// are rendered.
+struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderLodGroup : public QSSGRenderNode
+{
+    // Geometric error of each level in scene units, expected to be ascending
+    QVector<float> levelErrors;
+    float maximumScreenError = 1.0f; // In pixels
+    float hysteresis = 0.1f; // Fraction of maximumScreenError
+    bool crossFade = false;
+
+    // The level picked last, so that the hysteresis band has something to
+    // stick to. -1 until the group is first rendered.
+    qsizetype currentLevel = -1;
+
+    // Range [first, last) of each level in the layer's renderable models,
+    // filled while collecting the nodes for a frame.
+    QVarLengthArray<std::pair<int, int>, 4> levelModelRanges;
+
+    struct Selection
+    {
+        qsizetype level = -1;
+        // With crossFade, the next coarser level while within the hysteresis
+        // band, -1 otherwise.
+        qsizetype fadeLevel = -1;
+        // 0 when the level is drawn as is, otherwise the fraction of the
+        // level that is kept, the fade level gets the complement.
+        float crossFade = 0.0f;
+    };
+
+    explicit QSSGRenderLodGroup();
+
+    // Picks the level(s) to draw among the first levelCount ones, given how
+    // many pixels one scene unit covers at the position of the group, and
+    // updates currentLevel.
+    Selection selectLevel(qsizetype levelCount, float pixelsPerUnit, float pixelThreshold);
+};
+
+QT_END_NAMESPACE
+
+#endif
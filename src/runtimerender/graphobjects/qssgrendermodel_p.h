@@ -25,6 +25,7 @@
 
 #include <QtQuick3DUtils/private/qssgbounds3_p.h>
 #include <QtCore/QVector>
+#include <QtCore/qvarlengtharray.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -61,6 +62,8 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderModel : public QSSGRenderNode
 
     bool receivesReflections = false;
     bool castsReflections = true;
+    // Hides the models behind it from the main camera, see QSSGOcclusionCuller
+    bool occluder = false;
     bool usedInBakedLighting = false;
     QString lightmapKey;
     QString lightmapLoadPath;
@@ -69,6 +72,8 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderModel : public QSSGRenderNode
     bool usesBoneTexture() const { return ((skin != nullptr) || (skeleton != nullptr)); }
 
     float levelOfDetailBias = 1.0f; // values < 1.0 will decrease usage of LODs, values > 1.0 will increase usage of LODs
+    // The level of detail picked last for each subset, for the hysteresis.
+    mutable QVarLengthArray<quint32, 4> subsetLevelsOfDetail;
 
     QSSGRenderModel();
 };
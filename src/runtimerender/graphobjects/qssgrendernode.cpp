@@ -13,8 +13,13 @@
 
 #include <QtQuick3DUtils/private/qssgplane_p.h>
 
+#include <QtCore/qatomic.h>
+
 QT_BEGIN_NAMESPACE
 
+static QAtomicInteger<quint32> qssgRenderNodeStructureVersion = 0;
+static QAtomicInteger<quint32> qssgRenderNodeActiveStateVersion = 0;
+
 QSSGRenderNode::QSSGRenderNode()
     : QSSGRenderNode(Type::Node)
 {
@@ -29,14 +34,31 @@ QSSGRenderNode::QSSGRenderNode(Type type)
 QSSGRenderNode::~QSSGRenderNode()
     = default;
 
+static void markDirtyRecursive(QSSGRenderNode &node, QSSGRenderNode::FlagT dirtyFlag)
+{
+    if ((node.flags & dirtyFlag) == 0) { // If not already marked
+        node.flags |= dirtyFlag;
+        if (!node.children.isEmpty()) {
+            node.flags |= QSSGRenderNode::FlagT(QSSGRenderNode::DirtyFlag::ChildDirty);
+            for (auto &cld : node.children)
+                markDirtyRecursive(cld, dirtyFlag);
+        }
+    }
+}
+
 void QSSGRenderNode::markDirty(DirtyFlag dirtyFlag)
 {
     if ((flags & FlagT(dirtyFlag)) == 0) { // If not already marked
-        flags |= FlagT(dirtyFlag);
         const bool markSubtreeDirty = ((FlagT(dirtyFlag) & FlagT(DirtyFlag::GlobalValuesDirty)) != 0);
         if (markSubtreeDirty) {
-            for (auto &cld : children)
-                cld.markDirty(dirtyFlag);
+            markDirtyRecursive(*this, FlagT(dirtyFlag));
+            // Let the ancestors know, so that the update of the global values
+            // can skip the subtrees that have nothing dirty in them, see
+            // QSSGTransformHierarchy. Stops at the first ancestor that already knows.
+            for (auto *p = parent; p && !p->isDirty(DirtyFlag::ChildDirty); p = p->parent)
+                p->flags |= FlagT(DirtyFlag::ChildDirty);
+        } else {
+            flags |= FlagT(dirtyFlag);
         }
     }
 }
@@ -56,6 +78,7 @@ void QSSGRenderNode::setState(LocalState state, bool on)
         switch (state) {
         case QSSGRenderNode::LocalState::Active:
             markDirty(DirtyFlag::ActiveDirty);
+            qssgRenderNodeActiveStateVersion.fetchAndAddRelease(1);
             break;
         case QSSGRenderNode::LocalState::Pickable:
             markDirty(DirtyFlag::PickableDirty);
@@ -172,6 +195,7 @@ void QSSGRenderNode::addChild(QSSGRenderNode &inChild)
     }
     children.push_back(inChild);
     inChild.markDirty(DirtyFlag::GlobalValuesDirty);
+    markStructureChanged();
 }
 
 void QSSGRenderNode::removeChild(QSSGRenderNode &inChild)
@@ -184,6 +208,7 @@ void QSSGRenderNode::removeChild(QSSGRenderNode &inChild)
     inChild.parent = nullptr;
     children.remove(inChild);
     inChild.markDirty(DirtyFlag::GlobalValuesDirty);
+    markStructureChanged();
 }
 
 void QSSGRenderNode::removeFromGraph()
@@ -197,6 +222,22 @@ void QSSGRenderNode::removeFromGraph()
         children.remove(removedChild);
         removedChild.parent = nullptr;
     }
+    markStructureChanged();
+}
+
+quint32 QSSGRenderNode::structureVersion()
+{
+    return qssgRenderNodeStructureVersion.loadAcquire();
+}
+
+void QSSGRenderNode::markStructureChanged()
+{
+    qssgRenderNodeStructureVersion.fetchAndAddRelease(1);
+}
+
+quint32 QSSGRenderNode::activeStateVersion()
+{
+    return qssgRenderNodeActiveStateVersion.loadAcquire();
 }
 
 QSSGBounds3 QSSGRenderNode::getBounds(QSSGBufferManager &inManager,
@@ -54,6 +54,7 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderNode : public QSSGRenderGraphObje
         ActiveDirty = 1 << 6,
         PickableDirty = 1 << 7,
         SubNodeDirty = 1 << 8, // Sub-nodes should set/unest this if they "extend" the dirty flags provided by the node
+        ChildDirty = 1 << 9, // Set when a descendant might have dirty global values, not part of the DirtyMask
 
         GlobalValuesDirty = TransformDirty | OpacityDirty | ActiveDirty | PickableDirty,
         DirtyMask = GlobalValuesDirty | SubNodeDirty
@@ -99,7 +100,8 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderNode : public QSSGRenderGraphObje
     ~QSSGRenderNode() override;
 
     // Sets this object dirty and walks down the graph setting all
-    // children who are not dirty to be dirty.
+    // children who are not dirty to be dirty. For the global values,
+    // the ancestors are marked with ChildDirty.
     void markDirty(DirtyFlag dirtyFlag);
     void clearDirty(DirtyFlag dirtyFlag);
     [[nodiscard]] inline constexpr bool isDirty(DirtyFlag dirtyFlag = DirtyFlag::DirtyMask) const { return ((flags & FlagT(dirtyFlag)) != 0); }
@@ -116,6 +118,14 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderNode : public QSSGRenderGraphObje
     // finally they are no longer siblings of each other.
     void removeFromGraph();
 
+    // Changes whenever a node is added to or removed from any node, so that
+    // flattened copies of the graph know when to rebuild themselves.
+    [[nodiscard]] static quint32 structureVersion();
+    static void markStructureChanged();
+    // Changes whenever the local active state of any node changes, which
+    // changes the set of nodes that get rendered.
+    [[nodiscard]] static quint32 activeStateVersion();
+
     // Calculate global transform and opacity
     // Walks up the graph ensure all parents are not dirty so they have
     // valid global transforms.
@@ -47,6 +47,7 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRenderReflectionProbe : public QSSGRend
     QVector3D boxOffset { 0.0, 0.0, 0.0 };
     bool hasScheduledUpdate = false;
     QSSGRenderImage *texture = nullptr;
+    QString bakeFileName; // Taken over by the renderer, which writes the map there once rendered
 
     explicit QSSGRenderReflectionProbe();
 };
@@ -30,7 +30,26 @@ const QByteArray &QSSGRenderTextureData::textureData() const
 void QSSGRenderTextureData::setTextureData(const QByteArray &data)
 {
     m_textureData = data;
-    markDirty();
+    m_generationId++;
+    m_contentsGenerationId = m_generationId;
+    m_dirtyRegions.clear();
+}
+
+void QSSGRenderTextureData::updateTextureData(const QByteArray &data, const QVector<QRect> &dirtyRegions)
+{
+    // Past this many pending regions uploading everything is likely cheaper
+    // than many small uploads.
+    static const qsizetype MAX_DIRTY_REGIONS = 32;
+
+    m_textureData = data;
+    m_generationId++;
+    if (m_dirtyRegions.size() + dirtyRegions.size() > MAX_DIRTY_REGIONS) {
+        m_contentsGenerationId = m_generationId;
+        m_dirtyRegions.clear();
+        return;
+    }
+    for (const QRect &rect : dirtyRegions)
+        m_dirtyRegions.append({ m_generationId, rect });
 }
 
 QSize QSSGRenderTextureData::size() const
@@ -92,12 +111,33 @@ uint32_t QSSGRenderTextureData::generationId() const
     return m_generationId;
 }
 
+uint32_t QSSGRenderTextureData::layoutGenerationId() const
+{
+    return m_layoutGenerationId;
+}
+
+bool QSSGRenderTextureData::dirtyRegionsSince(uint32_t sinceGenerationId, QVector<QRect> *regions) const
+{
+    if (sinceGenerationId < m_contentsGenerationId)
+        return false;
+    for (const auto &region : m_dirtyRegions) {
+        if (region.first > sinceGenerationId)
+            regions->append(region.second);
+    }
+    return true;
+}
+
 void QSSGRenderTextureData::markDirty()
 {
     // The generation ID changes every time a property of this texture
     // changes so that the buffer manager can compare the generation it
-    // holds vs the current generation.
+    // holds vs the current generation. Changes to the data alone do not
+    // touch the layout generation, which allows keeping the texture and
+    // just uploading the new contents.
     m_generationId++;
+    m_layoutGenerationId = m_generationId;
+    m_contentsGenerationId = m_generationId;
+    m_dirtyRegions.clear();
 }
 
 QT_END_NAMESPACE
@@ -20,7 +20,9 @@
 #include <QtQuick3DRuntimeRender/private/qssgrenderbuffermanager_p.h>
 #include <QtQuick3DUtils/private/qssgrenderbasetypes_p.h>
 #include <QtCore/qsize.h>
+#include <QtCore/qrect.h>
 #include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -34,6 +36,9 @@ public:
 
     const QByteArray &textureData() const;
     void setTextureData(const QByteArray &data);
+    // Like setTextureData(), but only the pixels within dirtyRegions changed.
+    // Size and format are expected to stay the same.
+    void updateTextureData(const QByteArray &data, const QVector<QRect> &dirtyRegions);
 
     QSize size() const;
     void setSize(const QSize &size);
@@ -48,6 +53,12 @@ public:
     void setHasTransparency(bool hasTransparency);
 
     uint32_t generationId() const;
+    // Changes only when the texture has to be recreated (size, format, ...)
+    uint32_t layoutGenerationId() const;
+
+    // Collects the regions changed after generation sinceGenerationId.
+    // Returns false when that is not known and everything must be uploaded.
+    bool dirtyRegionsSince(uint32_t sinceGenerationId, QVector<QRect> *regions) const;
 
     QString debugObjectName;
 
@@ -62,6 +73,9 @@ protected:
     QSSGRenderTextureFormat m_format = QSSGRenderTextureFormat::Unknown;
     bool m_hasTransparency = false;
     uint32_t m_generationId = 1;
+    uint32_t m_layoutGenerationId = 1;
+    uint32_t m_contentsGenerationId = 1;
+    QVector<std::pair<uint32_t, QRect>> m_dirtyRegions;
 };
 
 QT_END_NAMESPACE
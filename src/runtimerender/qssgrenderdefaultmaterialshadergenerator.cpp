@@ -1026,6 +1026,30 @@ static void generateFragmentShader(QSSGStageGeneratorBase &fragmentShader,
 
     vertexShader.beginFragmentGeneration(shaderLibraryManager);
 
+    // The pick pass writes the object id, the instance index and the depth,
+    // nothing from the material is needed.
+    if (featureSet.isSet(QSSGShaderFeatures::Feature::PickPass)) {
+        vertexShader.generatePickInstanceIndex();
+        fragmentShader.addUniform("qt_pickObjectId", "uint");
+        fragmentShader.append("    fragOutput = vec4(float(qt_pickObjectId), float(qt_varPickInstanceIndex), gl_FragCoord.z, 1.0);");
+        return;
+    }
+
+    // Screen-door cross-fade between two levels of a LOD group. A negative
+    // value selects the complement of the pattern, so that the two levels
+    // together cover every pixel exactly once.
+    if (keyProps.m_lodCrossFade.getValue(inKey)) {
+        fragmentShader.addUniform("qt_lodCrossFade", "float");
+        fragmentShader << "    {\n"
+                       << "        const float qt_bayer[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0,\n"
+                       << "                                             3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);\n"
+                       << "        ivec2 qt_ditherPos = ivec2(gl_FragCoord.xy) & 3;\n"
+                       << "        float qt_ditherThreshold = (qt_bayer[qt_ditherPos.y * 4 + qt_ditherPos.x] + 0.5) / 16.0;\n"
+                       << "        if (qt_lodCrossFade >= 0.0 ? qt_ditherThreshold > qt_lodCrossFade : qt_ditherThreshold <= -qt_lodCrossFade)\n"
+                       << "            discard;\n"
+                       << "    }\n";
+    }
+
     // Unshaded custom materials need no code in main (apart from calling qt_customMain)
     const bool hasCustomFrag = materialAdapter->hasCustomShaderSnippet(QSSGShaderCache::ShaderType::Fragment);
     const bool usesSharedVar = materialAdapter->usesSharedVariables();
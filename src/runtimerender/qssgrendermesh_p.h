@@ -43,6 +43,19 @@ struct QSSGRenderSubset
     };
     QVector<Lod> lods;
 
+    // Clusters of the triangles of the full detail range, culled one by one
+    // against the camera, see QSSGMesh::Mesh::createMeshlets().
+    struct Meshlet {
+        quint32 count = 0;
+        quint32 offset = 0;
+        QVector3D center;
+        float radius = 0.0f;
+        QVector3D coneApex;
+        QVector3D coneAxis;
+        float coneCutoff = 1.0f;
+    };
+    QVector<Meshlet> meshlets;
+
     QSSGRenderSubset() = default;
     QSSGRenderSubset(const QSSGRenderSubset &inOther)
         : count(inOther.count)
@@ -51,6 +64,7 @@ struct QSSGRenderSubset
         , bvhRoot(inOther.bvhRoot)
         , rhi(inOther.rhi)
         , lods(inOther.lods)
+        , meshlets(inOther.meshlets)
     {
     }
     QSSGRenderSubset &operator=(const QSSGRenderSubset &inOther)
@@ -62,6 +76,7 @@ struct QSSGRenderSubset
             bvhRoot = inOther.bvhRoot;
             rhi = inOther.rhi;
             lods = inOther.lods;
+            meshlets = inOther.meshlets;
         }
         return *this;
     }
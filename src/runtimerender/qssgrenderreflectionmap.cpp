@@ -6,17 +6,44 @@
 #include <QtQuick3DRuntimeRender/private/qssglayerrenderdata_p.h>
 #include "qssgrendercontextcore.h"
 
+#include <QtQuick3DUtils/private/qssgassert_p.h>
+
+#include <QtCore/qfile.h>
+
 QT_BEGIN_NAMESPACE
 
 const int prefilterSampleCount = 16;
 
+static constexpr quint8 allCubeFaces = 0x3f;
+
+struct QSSGRenderReflectionMap::PendingBake
+{
+    QString fileName;
+    QSize size;
+    int levelCount = 0;
+    std::vector<QRhiReadbackResult> results; // Level by level, six faces each
+    int remaining = 0;
+};
+
 QSSGRenderReflectionMap::QSSGRenderReflectionMap(const QSSGRenderContextInterface &inContext)
     : m_context(inContext)
 {
+    setFaceBudget(qEnvironmentVariableIntValue("QT_QUICK3D_REFLECTION_FACE_BUDGET"));
 }
 
 QSSGRenderReflectionMap::~QSSGRenderReflectionMap()
 {
+    // The readbacks of the bakes write into, and call back on, the pending
+    // bakes owned by this map, so they must have completed before those go.
+    // Waiting for them also means the requested files do get written.
+    if (!m_pendingBakes.empty()) {
+        if (QRhi *rhi = m_context.rhiContext()->rhi())
+            rhi->finish();
+        QSSG_CHECK_X(std::all_of(m_pendingBakes.cbegin(), m_pendingBakes.cend(),
+                                 [](const std::unique_ptr<PendingBake> &bake) { return bake->remaining == 0; }),
+                     "Reflection probe bakes dropped before their readbacks completed");
+    }
+
     releaseCachedResources();
 }
 
@@ -84,6 +111,10 @@ void QSSGRenderReflectionMap::addReflectionMapEntry(qint32 probeIdx, const QSSGR
 
         if (!pEntry->m_rhiDepthStencil || mapRes != pEntry->m_rhiCube->pixelSize().width()) {
             pEntry->destroyRhiResources();
+            // Nothing of the old contents is left
+            pEntry->m_rendered = false;
+            pEntry->m_renderedFaces = 0;
+            pEntry->m_pendingFaces = 0;
             pEntry->m_rhiDepthStencil = allocateRhiReflectionRenderBuffer(rhi, QRhiRenderBuffer::DepthStencil, pixelSize);
             pEntry->m_rhiCube = allocateRhiReflectionTexture(rhi, rhiFormat, pixelSize, QRhiTexture::RenderTarget | QRhiTexture::CubeMap
                                                                          | QRhiTexture::MipMapped | QRhiTexture::UsedWithGenerateMips);
@@ -287,6 +318,188 @@ QSSGReflectionMapEntry *QSSGRenderReflectionMap::reflectionMapEntry(int probeIdx
     return nullptr;
 }
 
+static float distanceToBox(const QSSGBounds3 &box, const QVector3D &point)
+{
+    QVector3D d;
+    for (int i = 0; i < 3; ++i)
+        d[i] = qMax(0.0f, qMax(box.minimum[i] - point[i], point[i] - box.maximum[i]));
+    return d.length();
+}
+
+// Decides which faces of which probes are rendered in this frame. Without a
+// face budget this is every face of every probe that needs an update, as
+// before. With a budget, the probes are ordered by the time since their last
+// update, scaled by how close the camera is to the probe's box, and raised
+// when the probe has never been rendered completely, is in view, or when
+// reflection casters in its box have moved since its last update. An update
+// that does not fit continues in the next frames.
+void QSSGRenderReflectionMap::scheduleUpdates(const QVector<QSSGRenderReflectionProbe *> &probes,
+                                              const QSSGRenderableObjectList &casters,
+                                              const QVector3D &cameraPosition,
+                                              const std::optional<QSSGClippingFrustum> &cameraFrustum,
+                                              quint32 frame)
+{
+    struct Candidate
+    {
+        float priority;
+        QSSGReflectionMapEntry *entry;
+    };
+    QVarLengthArray<Candidate, 16> candidates;
+
+    for (int i = 0, ie = probes.size(); i != ie; ++i) {
+        QSSGRenderReflectionProbe *probe = probes.at(i);
+        QSSGReflectionMapEntry *entry = reflectionMapEntry(i);
+        if (!entry)
+            continue;
+
+        entry->m_scheduledFaces = 0;
+        if (!probe->bakeFileName.isEmpty())
+            entry->m_bakeFileName = std::exchange(probe->bakeFileName, QString());
+        if (!entry->m_needsRender || probe->texture || !entry->m_rhiCube)
+            continue;
+
+        const QSSGBounds3 box = QSSGBounds3::centerExtents(probe->getGlobalPos() + probe->boxOffset, probe->boxSize / 2);
+        size_t contentKey = qHashBits(probe->globalTransform.constData(), 16 * sizeof(float));
+        for (const auto &handle : casters) {
+            if (box.intersects(handle.obj->globalBounds))
+                contentKey = qHashBits(&handle.obj->globalBounds, sizeof(QSSGBounds3), contentKey);
+        }
+        const bool contentChanged = contentKey != entry->m_contentKey;
+
+        if (!entry->m_pendingFaces) {
+            if (probe->refreshMode == QSSGRenderReflectionProbe::ReflectionRefreshMode::FirstFrame && entry->m_rendered)
+                continue;
+            entry->m_pendingFaces = entry->m_timeSlicing == QSSGRenderReflectionProbe::ReflectionTimeSlicing::IndividualFaces
+                    ? quint8(1 << quint8(entry->m_timeSliceFace))
+                    : allCubeFaces;
+            entry->m_contentKey = contentKey;
+        }
+
+        const float size = qMax(probe->boxSize.length(), 1.0f);
+        float priority = float(qMax(1u, frame - entry->m_lastUpdateFrame)) * size / (size + distanceToBox(box, cameraPosition));
+        if (entry->m_renderedFaces != allCubeFaces)
+            priority *= 16.0f;
+        if (cameraFrustum && !cameraFrustum->intersectsWith(box))
+            priority *= 0.25f;
+        if (contentChanged)
+            priority *= 4.0f;
+        candidates.append({ priority, entry });
+    }
+
+    if (m_faceBudget > 0) {
+        std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+            return a.priority > b.priority;
+        });
+    }
+
+    int budget = m_faceBudget > 0 ? m_faceBudget : std::numeric_limits<int>::max();
+    for (const Candidate &candidate : std::as_const(candidates)) {
+        QSSGReflectionMapEntry *entry = candidate.entry;
+        for (int face = 0; face < 6 && budget > 0; ++face) {
+            if (entry->m_pendingFaces & (1 << face)) {
+                entry->m_scheduledFaces |= quint8(1 << face);
+                --budget;
+            }
+        }
+        if (entry->m_scheduledFaces)
+            entry->m_lastUpdateFrame = frame;
+        if (budget == 0)
+            break;
+    }
+
+    // Bakes whose readbacks have all completed
+    m_pendingBakes.erase(std::remove_if(m_pendingBakes.begin(), m_pendingBakes.end(),
+                                        [](const std::unique_ptr<PendingBake> &bake) { return bake->remaining == 0; }),
+                         m_pendingBakes.end());
+}
+
+static constexpr quint32 glHalfFloat = 0x140B;
+static constexpr quint32 glRgba = 0x1908;
+static constexpr quint32 glRgba16F = 0x881A;
+
+static void writeUInt32(QIODevice &device, quint32 value)
+{
+    device.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+// Same layout and metadata as written by the IBL baker, so that the file can be
+// used as the texture of a probe, or as a light probe.
+static bool writeKtxCubeMap(const QString &fileName, const QSize &size, int levelCount,
+                            const std::vector<QRhiReadbackResult> &images)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    static const char key[] = "QT_IBL_BAKER_VERSION";
+    static const char value[] = "1";
+    QByteArray keyValueData;
+    const quint32 keyAndValueByteSize = sizeof(key) + sizeof(value);
+    keyValueData.append(reinterpret_cast<const char *>(&keyAndValueByteSize), sizeof(keyAndValueByteSize));
+    keyValueData.append(key, sizeof(key));
+    keyValueData.append(value, sizeof(value));
+    keyValueData.resize(keyValueData.size() + 3 - ((keyAndValueByteSize + 3) % 4));
+
+    static const char ktxIdentifier[12] = { '\xAB', 'K', 'T', 'X', ' ', '1', '1', '\xBB', '\r', '\n', '\x1A', '\n' };
+    file.write(ktxIdentifier, sizeof(ktxIdentifier));
+    writeUInt32(file, 0x04030201); // endianness
+    writeUInt32(file, glHalfFloat); // glType
+    writeUInt32(file, 2); // glTypeSize
+    writeUInt32(file, glRgba); // glFormat
+    writeUInt32(file, glRgba16F); // glInternalFormat
+    writeUInt32(file, glRgba); // glBaseInternalFormat
+    writeUInt32(file, quint32(size.width()));
+    writeUInt32(file, quint32(size.height()));
+    writeUInt32(file, 0); // pixelDepth
+    writeUInt32(file, 0); // numberOfArrayElements
+    writeUInt32(file, 6); // numberOfFaces
+    writeUInt32(file, quint32(levelCount));
+    writeUInt32(file, quint32(keyValueData.size()));
+    file.write(keyValueData);
+
+    for (int level = 0; level < levelCount; ++level) {
+        writeUInt32(file, quint32(images[level * 6].data.size()));
+        for (int face = 0; face < 6; ++face)
+            file.write(images[level * 6 + face].data);
+    }
+
+    return file.error() == QFileDevice::NoError;
+}
+
+// Reads back the prefiltered cube map of the entry, and writes it to the file
+// requested for it once all the readbacks have completed.
+void QSSGRenderReflectionMap::bakeToFile(QSSGRhiContext *rhiCtx, QSSGReflectionMapEntry &entry)
+{
+    QSSG_ASSERT(entry.m_rhiPrefilteredCube && !entry.m_bakeFileName.isEmpty(), return);
+
+    auto bake = std::make_unique<PendingBake>();
+    PendingBake *b = bake.get();
+    b->fileName = std::exchange(entry.m_bakeFileName, QString());
+    b->size = entry.m_rhiPrefilteredCube->pixelSize();
+    b->levelCount = entry.m_prefilterMipLevelSizes.size();
+    b->results.resize(b->levelCount * 6);
+    b->remaining = int(b->results.size());
+
+    QRhiResourceUpdateBatch *rub = rhiCtx->rhi()->nextResourceUpdateBatch();
+    for (int level = 0; level < b->levelCount; ++level) {
+        for (int face = 0; face < 6; ++face) {
+            QRhiReadbackResult &result = b->results[level * 6 + face];
+            result.completed = [b] {
+                if (--b->remaining > 0)
+                    return;
+                if (!writeKtxCubeMap(b->fileName, b->size, b->levelCount, b->results))
+                    qWarning("Failed to write reflection probe map to %s", qPrintable(b->fileName));
+            };
+            QRhiReadbackDescription readbackDesc(entry.m_rhiPrefilteredCube);
+            readbackDesc.setLayer(face);
+            readbackDesc.setLevel(level);
+            rub->readBackTexture(readbackDesc, &result);
+        }
+    }
+    rhiCtx->commandBuffer()->resourceUpdate(rub);
+    m_pendingBakes.push_back(std::move(bake));
+}
+
 QSSGReflectionMapEntry::QSSGReflectionMapEntry()
     : m_probeIndex(std::numeric_limits<quint32>::max())
 {
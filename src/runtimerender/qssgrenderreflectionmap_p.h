@@ -17,6 +17,8 @@
 
 #include <QtQuick3DRuntimeRender/private/qtquick3druntimerenderglobal_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderreflectionprobe_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderableobjects_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderclippingfrustum_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -74,6 +76,14 @@ struct QSSGReflectionMapEntry
     bool m_needsRender = false;
     bool m_rendered = false;
 
+    // Scheduling, see QSSGRenderReflectionMap::scheduleUpdates()
+    quint8 m_pendingFaces = 0; // Faces left to render in the current update, one bit each
+    quint8 m_scheduledFaces = 0; // Faces to render in this frame
+    quint8 m_renderedFaces = 0; // Faces rendered at least once
+    quint32 m_lastUpdateFrame = 0;
+    size_t m_contentKey = 0; // Positions of the reflection casters in the box when last rendered
+    QString m_bakeFileName;
+
     QSSGRenderReflectionProbe::ReflectionTimeSlicing m_timeSlicing = QSSGRenderReflectionProbe::ReflectionTimeSlicing::None;
     int m_timeSliceFrame = 1;
     QSSGRenderTextureCubeFace m_timeSliceFace = { QSSGRenderTextureCubeFaces[0] };
@@ -97,10 +107,25 @@ public:
 
     QSSGReflectionMapEntry *reflectionMapEntry(int probeIdx);
 
+    void scheduleUpdates(const QVector<QSSGRenderReflectionProbe *> &probes,
+                         const QSSGRenderableObjectList &casters,
+                         const QVector3D &cameraPosition,
+                         const std::optional<QSSGClippingFrustum> &cameraFrustum,
+                         quint32 frame);
+    void bakeToFile(QSSGRhiContext *rhiCtx, QSSGReflectionMapEntry &entry);
+
+    // Maximum number of cube faces rendered per frame over all probes, 0 for no limit
+    int faceBudget() const { return m_faceBudget; }
+    void setFaceBudget(int faces) { m_faceBudget = qMax(0, faces); }
+
     qint32 reflectionMapEntryCount() { return m_reflectionMapList.size(); }
 
 private:
+    struct PendingBake;
+
     TReflectionMapEntryList m_reflectionMapList;
+    int m_faceBudget = 0;
+    std::vector<std::unique_ptr<PendingBake>> m_pendingBakes;
 };
 
 using QSSGRenderReflectionMapPtr = std::shared_ptr<QSSGRenderReflectionMap>;
@@ -75,7 +75,8 @@ static constexpr DefineEntry DefineTable[] {
     { "QSSG_ENABLE_OPAQUE_DEPTH_PRE_PASS", QSSGShaderFeatures::Feature::OpaqueDepthPrePass },
     { "QSSG_ENABLE_REFLECTION_PROBE", QSSGShaderFeatures::Feature::ReflectionProbe },
     { "QSSG_REDUCE_MAX_NUM_LIGHTS", QSSGShaderFeatures::Feature::ReduceMaxNumLights },
-    { "QSSG_ENABLE_LIGHTMAP", QSSGShaderFeatures::Feature::Lightmap }
+    { "QSSG_ENABLE_LIGHTMAP", QSSGShaderFeatures::Feature::Lightmap },
+    { "QSSG_ENABLE_PICK_PASS", QSSGShaderFeatures::Feature::PickPass }
 };
 
 static_assert(std::size(DefineTable) == QSSGShaderFeatures::Count, "Missing feature define?");
@@ -268,6 +269,11 @@ QSSGShaderCache::QSSGShaderCache(QSSGRhiContext &ctx,
         }
     }
 
+    // Every pipeline that ends up being baked or loaded from the disk cache
+    // is recorded, see warmUp() and shadergen's --recording option for
+    // replaying them.
+    m_recordingFileName = qEnvironmentVariable("QT_QUICK3D_SHADER_RECORD_FILE");
+
     if (!m_initBaker) {
         // It is important to generate all possible shader variants if the qsb
         // collection is going to be stored on disk. Otherwise switching the
@@ -276,20 +282,55 @@ QSSGShaderCache::QSSGShaderCache(QSSGRhiContext &ctx,
         // the application, so do not do it if the disk cache was disabled or
         // the cache directory was not available (no file system, no
         // permissions, etc.).
-        m_initBaker = m_persistentShaderStorageFileName.isEmpty() ? initBakerForNonPersistentUse
-                                                                  : initBakerForPersistentUse;
+        // The same goes for recordings, those are meant to be replayed or
+        // fed to shadergen later on.
+        m_initBaker = (m_persistentShaderStorageFileName.isEmpty() && m_recordingFileName.isEmpty())
+                ? initBakerForNonPersistentUse
+                : initBakerForPersistentUse;
+    }
+
+    // A collection recorded earlier can be replayed before the first frame,
+    // sparing the baking of everything it contains.
+    const QString warmUpFileName = qEnvironmentVariable("QT_QUICK3D_SHADER_WARMUP_FILE");
+    if (!warmUpFileName.isEmpty()) {
+        const qsizetype count = warmUp(warmUpFileName, [](qsizetype done, qsizetype total) {
+            qCDebug(PERF_INFO, "Shader warmup: %lld/%lld", qlonglong(done), qlonglong(total));
+        });
+        qCDebug(PERF_INFO, "Added %lld shader pipelines from %s", qlonglong(count), qPrintable(warmUpFileName));
     }
 }
 
+static void saveRecordedShaders(QQsbInMemoryCollection &recordedShaders, const QString &fileName)
+{
+    // Merge with what is already in the file, so that the recordings of
+    // multiple windows and multiple runs of the application add up.
+    QQsbInMemoryCollection existing;
+    if (QFileInfo::exists(fileName) && existing.load(fileName)) {
+        const auto entries = existing.availableEntries();
+        for (const auto &entry : entries) {
+            QQsbCollection::EntryDesc entryDesc;
+            if (existing.extractEntry(entry, entryDesc))
+                recordedShaders.addEntry(entry.key, entryDesc);
+        }
+    }
+
+    if (!recordedShaders.save(fileName))
+        qWarning("Failed to save the recorded shaders to %s", qPrintable(fileName));
+}
+
 QSSGShaderCache::~QSSGShaderCache()
 {
     if (!m_persistentShaderStorageFileName.isEmpty())
         m_persistentShaderBakingCache.save(m_persistentShaderStorageFileName);
+
+    if (!m_recordingFileName.isEmpty())
+        saveRecordedShaders(m_recordedShaders, m_recordingFileName);
 }
 
 void QSSGShaderCache::releaseCachedResources()
 {
     m_rhiShaders.clear();
+    m_defaultMaterialShaders.clear();
 
     // m_persistentShaderBakingCache is not cleared, that is intentional,
     // otherwise we would permanently lose what got loaded at startup.
@@ -302,12 +343,35 @@ QSSGRhiShaderPipelinePtr QSSGShaderCache::tryGetRhiShaderPipeline(const QByteArr
     cacheKey.m_features = inFeatures;
     cacheKey.updateHashCode();
     const auto theIter = m_rhiShaders.constFind(cacheKey);
-    if (theIter != m_rhiShaders.cend())
+    auto &stats = QSSGRhiContextStats::get(m_rhiContext);
+    if (theIter != m_rhiShaders.cend()) {
+        ++stats.globalInfo.shaderCacheHits;
         return theIter.value();
+    }
+    ++stats.globalInfo.shaderCacheMisses;
     return nullptr;
 }
 
 
+QSSGRhiShaderPipelinePtr QSSGShaderCache::tryGetRhiShaderPipeline(const QSSGShaderDefaultMaterialKey &inMaterialKey,
+                                                                  const QSSGShaderFeatures &inFeatures)
+{
+    const auto theIter = m_defaultMaterialShaders.constFind(QSSGShaderDefaultMaterialCacheKey(inMaterialKey, inFeatures));
+    if (theIter != m_defaultMaterialShaders.cend()) {
+        ++QSSGRhiContextStats::get(m_rhiContext).globalInfo.shaderCacheHits;
+        return theIter.value();
+    }
+    // Not counted as a miss, the caller goes on with the string based lookup.
+    return nullptr;
+}
+
+void QSSGShaderCache::addRhiShaderPipeline(const QSSGShaderDefaultMaterialKey &inMaterialKey,
+                                           const QSSGShaderFeatures &inFeatures,
+                                           const QSSGRhiShaderPipelinePtr &pipeline)
+{
+    m_defaultMaterialShaders.insert(QSSGShaderDefaultMaterialCacheKey(inMaterialKey, inFeatures), pipeline);
+}
+
 void QSSGShaderCache::addShaderPreprocessor(QByteArray &str,
                                             const QByteArray &inKey,
                                             ShaderType shaderType,
@@ -386,6 +450,7 @@ QSSGRhiShaderPipelinePtr QSSGShaderCache::compileForRhi(const QByteArray &inKey,
 
     QShaderBaker baker;
     m_initBaker(&baker, m_rhiContext.rhi());
+    ++m_bakeCount;
 
     const bool editorMode = QSSGRhiContextPrivate::editorMode();
     // Shader debug is disabled in editor mode
@@ -477,7 +542,10 @@ QSSGRhiShaderPipelinePtr QSSGShaderCache::compileForRhi(const QByteArray &inKey,
             result->vertexStage()->shader(),
             result->fragmentStage()->shader()
         };
-        m_persistentShaderBakingCache.addEntry(entryDesc.generateSha(), entryDesc);
+        const QByteArray qsbcKey = entryDesc.generateSha();
+        m_persistentShaderBakingCache.addEntry(qsbcKey, entryDesc);
+        if (!m_recordingFileName.isEmpty())
+            recordShaderPipeline(qsbcKey, entryDesc, inFeatures);
     }
     return result;
 
@@ -573,12 +641,52 @@ QSSGRhiShaderPipelinePtr QSSGShaderCache::tryNewPipelineFromPersistentCache(cons
         QSSGShaderCacheKey cacheKey(inKey);
         cacheKey.m_features = inFeatures;
         cacheKey.updateHashCode();
+        if (!m_recordingFileName.isEmpty())
+            recordShaderPipeline(qsbcKey, entryDesc, inFeatures);
         return m_rhiShaders.insert(cacheKey, shaders).value();
     }
 
     return {};
 }
 
+void QSSGShaderCache::recordShaderPipeline(const QByteArray &qsbcKey,
+                                           const QQsbCollection::EntryDesc &entryDesc,
+                                           const QSSGShaderFeatures &inFeatures)
+{
+    if (m_recordedShaders.addEntry(qsbcKey, entryDesc).isValid())
+        qCDebug(PERF_INFO) << "Recorded shader pipeline" << qsbcKey << entryDesc.materialKey << inFeatures;
+}
+
+qsizetype QSSGShaderCache::warmUp(const QString &collectionFile, const WarmUpProgressFunc &progress)
+{
+    QQsbIODeviceCollection qsbc(collectionFile);
+    if (!qsbc.map(QQsbIODeviceCollection::Read)) {
+        qWarning("Failed to open the shader collection %s for warmup", qPrintable(collectionFile));
+        return 0;
+    }
+
+    // The entries go to the same place as the ones loaded from the disk
+    // cache. That is consulted by all the material and effect code paths
+    // before resorting to generating and baking the shaders, and leaves
+    // creating the pipelines with the right stage flags to them.
+    const QQsbCollection::EntryMap entries = qsbc.availableEntries();
+    const qsizetype total = entries.size();
+    qsizetype done = 0;
+    qsizetype added = 0;
+    for (const auto &entry : entries) {
+        QQsbCollection::EntryDesc entryDesc;
+        if (qsbc.extractEntry(entry, entryDesc) && entryDesc.vertShader.isValid() && entryDesc.fragShader.isValid()) {
+            if (m_persistentShaderBakingCache.addEntry(entry.key, entryDesc).isValid())
+                ++added;
+        }
+        if (progress)
+            progress(++done, total);
+    }
+
+    qsbc.unmap();
+    return added;
+}
+
 QSSGRhiShaderPipelinePtr QSSGShaderCache::loadBuiltinForRhi(const QByteArray &inKey)
 {
     const QSSGRhiShaderPipelinePtr &rhiShaders = tryGetRhiShaderPipeline(inKey, QSSGShaderFeatures());
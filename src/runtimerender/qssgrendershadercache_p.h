@@ -22,12 +22,15 @@
 
 #include <QtQuick3DRuntimeRender/private/qssgrhicontext_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendererimplshaders_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendershaderkeys_p.h>
 
 #include <QtCore/QString>
 #include <QtCore/qcryptographichash.h>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QVector>
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 
 class QSSGRenderContextInterface;
@@ -81,6 +84,7 @@ enum class Feature : FlagType
     ReflectionProbe = (1 << 21) + 13,
     ReduceMaxNumLights = (1 << 22) + 14,
     Lightmap = (1 << 23) + 15,
+    PickPass = (1 << 24) + 16,
 
     LastFeature
 };
@@ -158,6 +162,30 @@ inline size_t qHash(const QSSGShaderCacheKey &key)
     return key.m_hashCode;
 }
 
+// The binary counterpart of QSSGShaderCacheKey for default materials: the
+// packed material key words instead of the string generated from them.
+struct QSSGShaderDefaultMaterialCacheKey
+{
+    QSSGShaderDefaultMaterialKey m_materialKey;
+    QSSGShaderFeatures m_features;
+    size_t m_hashCode = 0;
+
+    QSSGShaderDefaultMaterialCacheKey(const QSSGShaderDefaultMaterialKey &materialKey, QSSGShaderFeatures features)
+        : m_materialKey(materialKey), m_features(features), m_hashCode(materialKey.hash() ^ qHash(features))
+    {
+    }
+
+    bool operator==(const QSSGShaderDefaultMaterialCacheKey &inOther) const
+    {
+        return m_features == inOther.m_features && m_materialKey == inOther.m_materialKey;
+    }
+};
+
+inline size_t qHash(const QSSGShaderDefaultMaterialCacheKey &key)
+{
+    return key.m_hashCode;
+}
+
 class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGShaderCache
 {
     Q_DISABLE_COPY(QSSGShaderCache)
@@ -175,13 +203,20 @@ private:
     typedef QHash<QSSGShaderCacheKey, QSSGRhiShaderPipelinePtr> TRhiShaderMap;
     QSSGRhiContext &m_rhiContext; // Not own, the RCI owns us and the QSSGRhiContext.
     TRhiShaderMap m_rhiShaders;
+    QHash<QSSGShaderDefaultMaterialCacheKey, QSSGRhiShaderPipelinePtr> m_defaultMaterialShaders;
     QByteArray m_insertStr; // member to potentially reuse the allocation after clear
     InitBakerFunc m_initBaker;
     QQsbInMemoryCollection m_persistentShaderBakingCache;
     QString m_persistentShaderStorageFileName;
+    QQsbInMemoryCollection m_recordedShaders;
+    QString m_recordingFileName;
+    qsizetype m_bakeCount = 0;
     QSSGBuiltInRhiShaderCache m_builtInShaders;
 
     QSSGRhiShaderPipelinePtr loadBuiltinForRhi(const QByteArray &inKey);
+    void recordShaderPipeline(const QByteArray &qsbcKey,
+                              const QQsbCollection::EntryDesc &entryDesc,
+                              const QSSGShaderFeatures &inFeatures);
 
     void addShaderPreprocessor(QByteArray &str,
                                const QByteArray &inKey,
@@ -200,6 +235,14 @@ public:
     QSSGRhiShaderPipelinePtr tryGetRhiShaderPipeline(const QByteArray &inKey,
                                                      const QSSGShaderFeatures &inFeatures);
 
+    // Lookup for default materials that does not need the string form of the
+    // material key. Pipelines are only found here after addRhiShaderPipeline().
+    QSSGRhiShaderPipelinePtr tryGetRhiShaderPipeline(const QSSGShaderDefaultMaterialKey &inMaterialKey,
+                                                     const QSSGShaderFeatures &inFeatures);
+    void addRhiShaderPipeline(const QSSGShaderDefaultMaterialKey &inMaterialKey,
+                              const QSSGShaderFeatures &inFeatures,
+                              const QSSGRhiShaderPipelinePtr &pipeline);
+
     QSSGRhiShaderPipelinePtr tryNewPipelineFromPersistentCache(const QByteArray &qsbcKey,
                                                                const QByteArray &inKey,
                                                                const QSSGShaderFeatures &inFeatures,
@@ -219,6 +262,17 @@ public:
 
     QSSGBuiltInRhiShaderCache &getBuiltInRhiShaders() { return m_builtInShaders; }
 
+    // Makes the pipelines of a collection recorded with
+    // QT_QUICK3D_SHADER_RECORD_FILE available to the lookups, so that they are
+    // not baked again when first used. Returns the number of entries added.
+    // Exposed to applications as View3D.warmUpShaders().
+    using WarmUpProgressFunc = std::function<void(qsizetype done, qsizetype total)>;
+    qsizetype warmUp(const QString &collectionFile, const WarmUpProgressFunc &progress = {});
+
+    // The number of material and effect pipelines compiled at run-time, as
+    // opposed to the ones found in a collection or the disk cache.
+    qsizetype bakeCount() const { return m_bakeCount; }
+
     static QByteArray resourceFolder();
     static QByteArray shaderCollectionFile();
 };
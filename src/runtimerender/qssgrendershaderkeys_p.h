@@ -586,6 +586,7 @@ struct QSSGShaderDefaultMaterialKeyProperties
     QSSGShaderKeyBoolean m_specularGlossyEnabled;
     QSSGShaderKeyUnsigned<4> m_debugMode;
     QSSGShaderKeyBoolean m_fogEnabled;
+    QSSGShaderKeyBoolean m_lodCrossFade;
 
     QSSGShaderDefaultMaterialKeyProperties()
         : m_hasLighting("hasLighting")
@@ -622,6 +623,7 @@ struct QSSGShaderDefaultMaterialKeyProperties
         , m_specularGlossyEnabled("specularGlossyEnabled")
         , m_debugMode("debugMode")
         , m_fogEnabled("fogEnabled")
+        , m_lodCrossFade("lodCrossFade")
     {
         m_lightFlags[0].name = "light0HasPosition";
         m_lightFlags[1].name = "light1HasPosition";
@@ -777,6 +779,7 @@ struct QSSGShaderDefaultMaterialKeyProperties
         inVisitor.visit(m_specularGlossyEnabled);
         inVisitor.visit(m_debugMode);
         inVisitor.visit(m_fogEnabled);
+        inVisitor.visit(m_lodCrossFade);
     }
 
     struct OffsetVisitor
@@ -858,18 +861,15 @@ struct QSSGShaderDefaultMaterialKey
 
     size_t hash() const
     {
-        size_t retval = 0;
-        for (size_t idx = 0; idx < DataBufferSize; ++idx)
-            retval = retval ^ qHash(m_dataBuffer[idx]);
-        return retval ^ m_featureSetHash;
+        // Hash the packed words as a whole: xor-ing the hashes of the
+        // individual words lets equal words cancel each other out.
+        return qHashBits(m_dataBuffer, sizeof(m_dataBuffer), m_featureSetHash);
     }
 
     bool operator==(const QSSGShaderDefaultMaterialKey &other) const
     {
-        bool retval = true;
-        for (size_t idx = 0; idx < DataBufferSize && retval; ++idx)
-            retval = m_dataBuffer[idx] == other.m_dataBuffer[idx];
-        return retval && m_featureSetHash == other.m_featureSetHash;
+        return m_featureSetHash == other.m_featureSetHash
+                && memcmp(m_dataBuffer, other.m_dataBuffer, sizeof(m_dataBuffer)) == 0;
     }
 
     // Cast operators to make getting properties easier.
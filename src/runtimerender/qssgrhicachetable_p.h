@@ -0,0 +1,286 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef QSSGRHICACHETABLE_P_H
+#define QSSGRHICACHETABLE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRuntimeRender/qtquick3druntimerenderglobal.h>
+
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qvector.h>
+
+#include <memory>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+// Hash table for the per-frame lookups of QSSGRhiContextPrivate. The slots are
+// probed linearly in one flat array that stores the hash next to the entry
+// index, so a lookup usually touches a single cache line before comparing one
+// key. The entries live in fixed-size chunks that never move, so references
+// returned by the table stay valid until the entry is removed, also when more
+// entries are inserted.
+//
+// Each entry remembers the frame it was last looked up in, which allows
+// releasing the entries nothing asked for in a while with evictStale().
+template<typename Key, typename T>
+class QSSGRhiCacheTable
+{
+public:
+    QSSGRhiCacheTable() = default;
+    Q_DISABLE_COPY_MOVE(QSSGRhiCacheTable)
+
+    // Returns the value for key, or null. Does not touch the entry's frame.
+    [[nodiscard]] T *find(const Key &key)
+    {
+        const qsizetype entry = findEntry(key, hashOf(key));
+        return entry >= 0 ? &entryAt(entry).value : nullptr;
+    }
+
+    [[nodiscard]] const T *find(const Key &key) const
+    {
+        return const_cast<QSSGRhiCacheTable *>(this)->find(key);
+    }
+
+    // Returns the value for key, default constructing it first if needed, and
+    // marks the entry as used in the current frame. When inserted is not null,
+    // it is set to whether the entry is new.
+    T &findOrInsert(const Key &key, bool *inserted = nullptr)
+    {
+        const size_t hash = hashOf(key);
+        qsizetype entry = findEntry(key, hash);
+        if (inserted)
+            *inserted = (entry < 0);
+        if (entry < 0)
+            entry = insertEntry(key, hash);
+        Entry &e = entryAt(entry);
+        e.lastUsed = m_frame;
+        return e.value;
+    }
+
+    T &operator[](const Key &key) { return findOrInsert(key); }
+
+    // Removes key and returns its value, or a default constructed T.
+    T take(const Key &key)
+    {
+        const qsizetype entry = findEntry(key, hashOf(key));
+        if (entry < 0)
+            return T();
+        T value = std::move(entryAt(entry).value);
+        removeEntry(entry);
+        return value;
+    }
+
+    bool remove(const Key &key)
+    {
+        const qsizetype entry = findEntry(key, hashOf(key));
+        if (entry >= 0)
+            removeEntry(entry);
+        return entry >= 0;
+    }
+
+    // Calls f(key, value) for every entry and removes the entry when f returns
+    // true. Returns the number of removed entries.
+    template<typename F>
+    qsizetype removeIf(F f)
+    {
+        qsizetype removed = 0;
+        for (qsizetype i = 0; i < m_entryCount; ++i) {
+            Entry &e = entryAt(i);
+            if (e.used && f(e.key, e.value)) {
+                removeEntry(i);
+                ++removed;
+            }
+        }
+        return removed;
+    }
+
+    // Calls f(key, value) for every entry.
+    template<typename F>
+    void forEach(F f)
+    {
+        for (qsizetype i = 0; i < m_entryCount; ++i) {
+            Entry &e = entryAt(i);
+            if (e.used)
+                f(std::as_const(e.key), e.value);
+        }
+    }
+
+    template<typename F>
+    void forEach(F f) const
+    {
+        const_cast<QSSGRhiCacheTable *>(this)->forEach([&f](const Key &key, const T &value) { f(key, value); });
+    }
+
+    void clear()
+    {
+        m_slots.clear();
+        m_chunks.clear();
+        m_free.clear();
+        m_entryCount = 0;
+        m_size = 0;
+        m_cursor = 0;
+    }
+
+    [[nodiscard]] qsizetype size() const { return m_size; }
+    [[nodiscard]] bool isEmpty() const { return m_size == 0; }
+    [[nodiscard]] qsizetype capacity() const { return m_slots.size(); }
+
+    // The frame findOrInsert() stamps the entries with
+    void setFrame(quint32 frame) { m_frame = frame; }
+    [[nodiscard]] quint32 frame() const { return m_frame; }
+
+    // Visits up to budget entries, continuing where the previous call stopped,
+    // and removes the ones last used more than maxAge frames ago after passing
+    // them to onEvict(key, value). Spreads the cost of finding the unused
+    // entries over many frames. Returns the number of removed entries.
+    template<typename F>
+    qsizetype evictStale(quint32 maxAge, qsizetype budget, F onEvict)
+    {
+        qsizetype removed = 0;
+        budget = qMin(budget, m_entryCount);
+        for (; budget > 0; --budget) {
+            if (m_cursor >= m_entryCount)
+                m_cursor = 0;
+            Entry &e = entryAt(m_cursor);
+            if (e.used && m_frame - e.lastUsed > maxAge) {
+                onEvict(std::as_const(e.key), e.value);
+                removeEntry(m_cursor);
+                ++removed;
+            }
+            ++m_cursor;
+        }
+        return removed;
+    }
+
+private:
+    static constexpr qsizetype ChunkShift = 8;
+    static constexpr qsizetype ChunkSize = qsizetype(1) << ChunkShift;
+    static constexpr qsizetype MinCapacity = 64;
+
+    struct Entry
+    {
+        Key key {};
+        T value {};
+        size_t hash = 0;
+        quint32 lastUsed = 0;
+        bool used = false;
+    };
+    struct Slot
+    {
+        size_t hash;
+        quint32 entry; // index of the entry + 1, 0 when empty
+    };
+
+    static size_t hashOf(const Key &key)
+    {
+        // Some of the key hashes are plain XORs of pointers, mix them so
+        // that the low bits used for the slot index are spread well.
+        return qHash(size_t(qHash(key, 0)), 0);
+    }
+
+    Entry &entryAt(qsizetype index) { return m_chunks[index >> ChunkShift][index & (ChunkSize - 1)]; }
+
+    qsizetype findEntry(const Key &key, size_t hash)
+    {
+        if (m_slots.isEmpty())
+            return -1;
+        const size_t mask = size_t(m_slots.size() - 1);
+        const Slot *slots = m_slots.constData();
+        for (size_t i = hash & mask; slots[i].entry; i = (i + 1) & mask) {
+            if (slots[i].hash == hash && entryAt(slots[i].entry - 1).key == key)
+                return slots[i].entry - 1;
+        }
+        return -1;
+    }
+
+    qsizetype insertEntry(const Key &key, size_t hash)
+    {
+        if ((m_size + 1) * 2 > m_slots.size())
+            rehash(qMax(MinCapacity, m_slots.size() * 2));
+
+        qsizetype entry;
+        if (!m_free.isEmpty()) {
+            entry = m_free.takeLast();
+        } else {
+            if (m_entryCount == qsizetype(m_chunks.size()) * ChunkSize)
+                m_chunks.emplace_back(new Entry[ChunkSize]);
+            entry = m_entryCount++;
+        }
+        Entry &e = entryAt(entry);
+        e.key = key;
+        e.hash = hash;
+        e.used = true;
+
+        const size_t mask = size_t(m_slots.size() - 1);
+        size_t i = hash & mask;
+        while (m_slots.at(i).entry)
+            i = (i + 1) & mask;
+        m_slots[i] = { hash, quint32(entry + 1) };
+        ++m_size;
+        return entry;
+    }
+
+    void removeEntry(qsizetype entry)
+    {
+        Entry &e = entryAt(entry);
+        const size_t mask = size_t(m_slots.size() - 1);
+        size_t i = e.hash & mask;
+        while (m_slots.at(i).entry != quint32(entry + 1))
+            i = (i + 1) & mask;
+
+        // Shift the following slots of the run back instead of leaving a
+        // tombstone, unless they would move before their home slot.
+        for (size_t j = (i + 1) & mask; m_slots.at(j).entry; j = (j + 1) & mask) {
+            const size_t home = m_slots.at(j).hash & mask;
+            const bool movable = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+            if (movable) {
+                m_slots[i] = m_slots.at(j);
+                i = j;
+            }
+        }
+        m_slots[i] = { 0, 0 };
+
+        e = Entry();
+        m_free.append(entry);
+        --m_size;
+    }
+
+    void rehash(qsizetype capacity)
+    {
+        m_slots.fill({ 0, 0 }, capacity);
+        const size_t mask = size_t(capacity - 1);
+        for (qsizetype entry = 0; entry < m_entryCount; ++entry) {
+            const Entry &e = entryAt(entry);
+            if (!e.used)
+                continue;
+            size_t i = e.hash & mask;
+            while (m_slots.at(i).entry)
+                i = (i + 1) & mask;
+            m_slots[i] = { e.hash, quint32(entry + 1) };
+        }
+    }
+
+    QVector<Slot> m_slots;
+    std::vector<std::unique_ptr<Entry[]>> m_chunks;
+    QVector<qsizetype> m_free;
+    qsizetype m_entryCount = 0; // entries ever handed out, including the free ones
+    qsizetype m_size = 0;
+    qsizetype m_cursor = 0;
+    quint32 m_frame = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSSGRHICACHETABLE_P_H
@@ -4,6 +4,11 @@
 #include "qssgrhicontext_p.h"
 
 #include <QtCore/qvariant.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
 #include <QtGui/private/qrhi_p.h>
 
 #include <QtQuick3DUtils/private/qquick3dprofiler_p.h>
@@ -1129,7 +1134,7 @@ int QSSGRhiContext::mainPassSampleCount() const
 
 void QSSGRhiContextPrivate::releaseCachedResources()
 {
-    for (QSSGRhiDrawCallData &dcd : m_drawCallData) {
+    m_drawCallData.forEach([](const QSSGRhiDrawCallDataKey &, QSSGRhiDrawCallData &dcd) {
         // We don't call releaseDrawCallData() here, since we're anyways
         // are going to delete the non-owned resources further down and
         // there's no point in removing each of those one-by-one, as is
@@ -1137,13 +1142,13 @@ void QSSGRhiContextPrivate::releaseCachedResources()
         // This speeds up the release of cached resources greatly when there
         // are many entries in the map, also at application shutdown.
         dcd.reset();
-    }
+    });
 
     m_drawCallData.clear();
 
-    qDeleteAll(m_pipelines);
+    m_pipelines.forEach([](const QSSGGraphicsPipelineStateKey &, QRhiGraphicsPipeline *ps) { delete ps; });
     qDeleteAll(m_computePipelines);
-    qDeleteAll(m_srbCache);
+    m_srbCache.forEach([](const QSSGRhiShaderResourceBindingList &, QRhiShaderResourceBindings *srb) { delete srb; });
     qDeleteAll(m_dummyTextures);
 
     m_pipelines.clear();
@@ -1156,36 +1161,42 @@ void QSSGRhiContextPrivate::releaseCachedResources()
 
     m_samplers.clear();
 
-    for (const auto &particleData : std::as_const(m_particleData))
-        delete particleData.texture;
+    m_particleData.forEach([](const QSSGRenderGraphObject *, QSSGRhiParticleData &particleData) {
+        releaseParticleData(particleData);
+    });
 
     m_particleData.clear();
 
-    for (const auto &instanceData : std::as_const(m_instanceBuffers)) {
-        if (instanceData.owned)
-            delete instanceData.buffer;
-    }
+    m_instanceBuffers.forEach([](QSSGRenderInstanceTable *, QSSGRhiInstanceBufferData &instanceData) {
+        releaseInstanceBufferData(instanceData);
+    });
 
     m_instanceBuffers.clear();
 
-    for (const auto &instanceData : std::as_const(m_instanceBuffersLod)) {
-        if (instanceData.owned)
-            delete instanceData.buffer;
-    }
+    m_instanceBuffersLod.forEach([](const QSSGRenderModel *, QSSGRhiInstanceBufferData &instanceData) {
+        releaseInstanceBufferData(instanceData);
+    });
 
     m_instanceBuffersLod.clear();
+
+    for (QSSGRhiTransientTexture &transientTex : m_transientTextures)
+        transientTex.renderableTex.reset();
+
+    m_transientTextures.clear();
 }
 
 QRhiShaderResourceBindings *QSSGRhiContextPrivate::srb(const QSSGRhiShaderResourceBindingList &bindings)
 {
-    auto it = m_srbCache.constFind(bindings);
-    if (it != m_srbCache.constEnd())
-        return *it;
+    if (QRhiShaderResourceBindings **srb = m_srbCache.find(bindings)) {
+        ++m_stats.globalInfo.srbCacheHits;
+        return *srb;
+    }
 
+    ++m_stats.globalInfo.srbCacheMisses;
     QRhiShaderResourceBindings *srb = m_rhi->newShaderResourceBindings();
     srb->setBindings(bindings.v, bindings.v + bindings.p);
     if (srb->create()) {
-        m_srbCache.insert(bindings, srb);
+        m_srbCache.findOrInsert(bindings) = srb;
     } else {
         qWarning("Failed to build srb");
         delete srb;
@@ -1198,10 +1209,15 @@ void QSSGRhiContextPrivate::releaseDrawCallData(QSSGRhiDrawCallData &dcd)
 {
     delete dcd.ubuf;
     dcd.ubuf = nullptr;
-    auto srb = m_srbCache.take(dcd.bindings);
-    QSSG_CHECK(srb == dcd.srb);
-    delete srb;
+    // The srb is only known by its key when it came from srb(dcd, bindings),
+    // otherwise it stays in the cache, like one whose bindings changed.
+    if (dcd.srb && dcd.bindings.p > 0) {
+        QRhiShaderResourceBindings *srb = m_srbCache.take(dcd.bindings);
+        QSSG_CHECK(srb == dcd.srb);
+        delete srb;
+    }
     dcd.srb = nullptr;
+    dcd.bindings.clear();
     dcd.pipeline = nullptr;
 }
 
@@ -1212,6 +1228,54 @@ QRhiGraphicsPipeline *QSSGRhiContextPrivate::pipeline(const QSSGRhiGraphicsPipel
     return pipeline(QSSGGraphicsPipelineStateKey::create(ps, rpDesc, srb), rpDesc, srb);
 }
 
+// Instead of always doing a hash table lookup in srb(), store the binding list
+// and the srb object in the per-draw QSSGRhiDrawCallData. While this still
+// needs comparing the binding list, to see if something has changed, it
+// results in significant gains with lots of models in the scene (because the
+// srb table becomes large then, so avoiding the lookup as much as possible is
+// helpful)
+QRhiShaderResourceBindings *QSSGRhiContextPrivate::srb(QSSGRhiDrawCallData &dcd,
+                                                       const QSSGRhiShaderResourceBindingList &bindings)
+{
+    if (dcd.srb && dcd.bindings == bindings) {
+        ++m_stats.globalInfo.srbReuses;
+        return dcd.srb;
+    }
+
+    dcd.srb = srb(bindings);
+    dcd.bindings = bindings;
+    return dcd.srb;
+}
+
+// Same for the pipeline: the key is only built, which means hashing the
+// serialized render pass and srb layout descriptions, when something changed.
+QRhiGraphicsPipeline *QSSGRhiContextPrivate::pipeline(QSSGRhiDrawCallData &dcd,
+                                                      const QSSGRhiGraphicsPipelineState &ps,
+                                                      QRhiRenderPassDescriptor *rpDesc,
+                                                      QRhiShaderResourceBindings *srb)
+{
+    // The descriptions are implicitly shared with the render pass descriptor
+    // and the srb, so when nothing changed, comparing them with the ones of
+    // the previous frame stops at comparing the data pointers.
+    const QVector<quint32> rtDesc = rpDesc->serializedFormat();
+    const QVector<quint32> srbDesc = srb->serializedLayoutDescription();
+    if (dcd.pipeline
+        && dcd.renderTargetDescription == rtDesc
+        && dcd.srbLayoutDescription == srbDesc
+        && dcd.ps == ps)
+    {
+        ++m_stats.globalInfo.pipelineReuses;
+        return dcd.pipeline;
+    }
+
+    const QSSGGraphicsPipelineStateKey key { ps, rtDesc, srbDesc, { qHash(rtDesc), qHash(srbDesc) } };
+    dcd.pipeline = pipeline(key, rpDesc, srb);
+    dcd.renderTargetDescription = rtDesc;
+    dcd.srbLayoutDescription = srbDesc;
+    dcd.ps = ps;
+    return dcd.pipeline;
+}
+
 QRhiComputePipeline *QSSGRhiContextPrivate::computePipeline(const QShader &shader,
                                                             QRhiShaderResourceBindings *srb)
 {
@@ -1220,7 +1284,65 @@ QRhiComputePipeline *QSSGRhiContextPrivate::computePipeline(const QShader &shade
 
 QSSGRhiDrawCallData &QSSGRhiContextPrivate::drawCallData(const QSSGRhiDrawCallDataKey &key)
 {
-    return m_drawCallData[key];
+    return m_drawCallData.findOrInsert(key);
+}
+
+// An entry is released once no draw looked it up for this many frames. Model
+// entries are released right away when the model goes, see
+// cleanupDrawCallData(), but the ones keyed on passes, effects, layers and
+// Item2Ds are not, and would otherwise stay until the window goes away.
+// Nothing releases the instance buffers and particle data of removed
+// instance tables, models and particle systems either, they only age out.
+static constexpr quint32 drawCallDataMaxAge = 600;
+// Entries visited per frame when looking for the unused ones
+static constexpr qsizetype drawCallDataEvictionBudget = 256;
+
+void QSSGRhiContextPrivate::releaseInstanceBufferData(QSSGRhiInstanceBufferData &instanceData)
+{
+    if (instanceData.owned)
+        delete instanceData.buffer;
+    instanceData.buffer = nullptr;
+}
+
+void QSSGRhiContextPrivate::releaseParticleData(QSSGRhiParticleData &particleData)
+{
+    delete particleData.texture;
+    particleData.texture = nullptr;
+}
+
+void QSSGRhiContextPrivate::beginFrame()
+{
+    ++m_frame;
+    m_drawCallData.setFrame(m_frame);
+    const qsizetype evicted = m_drawCallData.evictStale(drawCallDataMaxAge, drawCallDataEvictionBudget,
+                                                        [this](const QSSGRhiDrawCallDataKey &, QSSGRhiDrawCallData &dcd) {
+        releaseDrawCallData(dcd);
+    });
+
+    m_instanceBuffers.setFrame(m_frame);
+    m_instanceBuffers.evictStale(drawCallDataMaxAge, drawCallDataEvictionBudget,
+                                 [](QSSGRenderInstanceTable *, QSSGRhiInstanceBufferData &instanceData) {
+        releaseInstanceBufferData(instanceData);
+    });
+    m_instanceBuffersLod.setFrame(m_frame);
+    m_instanceBuffersLod.evictStale(drawCallDataMaxAge, drawCallDataEvictionBudget,
+                                    [](const QSSGRenderModel *, QSSGRhiInstanceBufferData &instanceData) {
+        releaseInstanceBufferData(instanceData);
+    });
+    m_particleData.setFrame(m_frame);
+    m_particleData.evictStale(drawCallDataMaxAge, drawCallDataEvictionBudget,
+                              [](const QSSGRenderGraphObject *, QSSGRhiParticleData &particleData) {
+        releaseParticleData(particleData);
+    });
+
+    auto &globalInfo = m_stats.globalInfo;
+    globalInfo.drawCallDataEvictions += evicted;
+    globalInfo.drawCallDataCount = m_drawCallData.size();
+    globalInfo.drawCallDataCapacity = m_drawCallData.capacity();
+    globalInfo.srbCacheCount = m_srbCache.size();
+    globalInfo.srbCacheCapacity = m_srbCache.capacity();
+    globalInfo.pipelineCacheCount = m_pipelines.size();
+    globalInfo.pipelineCacheCapacity = m_pipelines.capacity();
 }
 
 using SamplerInfo = QPair<QSSGRhiSamplerDescription, QRhiSampler*>;
@@ -1332,18 +1454,30 @@ void QSSGRhiContextPrivate::releaseMesh(QSSGRenderMesh *mesh)
 
 void QSSGRhiContextPrivate::cleanupDrawCallData(const QSSGRenderModel *model)
 {
-    // Find all QSSGRhiUniformBufferSet that reference model
+    // Find all QSSGRhiDrawCallData that reference model
     // and delete them
     const void *modelNode = model;
-    auto it = m_drawCallData.begin();
-    while (it != m_drawCallData.end()) {
-        if (it.key().model == modelNode) {
-            releaseDrawCallData(*it);
-            it = m_drawCallData.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    m_drawCallData.removeIf([this, modelNode](const QSSGRhiDrawCallDataKey &key, QSSGRhiDrawCallData &dcd) {
+        if (key.model != modelNode)
+            return false;
+        releaseDrawCallData(dcd);
+        return true;
+    });
+}
+
+// Visits the table once for all the models, prefer this when releasing more
+// than one model at a time.
+void QSSGRhiContextPrivate::cleanupDrawCallData(const QSet<const void *> &models)
+{
+    if (models.isEmpty() || m_drawCallData.isEmpty())
+        return;
+
+    m_drawCallData.removeIf([this, &models](const QSSGRhiDrawCallDataKey &key, QSSGRhiDrawCallData &dcd) {
+        if (!key.model || !models.contains(key.model))
+            return false;
+        releaseDrawCallData(dcd);
+        return true;
+    });
 }
 
 /*!
@@ -1396,13 +1530,161 @@ QSSGRhiParticleData &QSSGRhiContextPrivate::particleData(const QSSGRenderGraphOb
     return m_particleData[particlesOrModel];
 }
 
+/*!
+    \internal
+
+    Hands a texture released by a layer earlier in the frame, or in the
+    previous frame, to the empty \a renderableTex, so that View3Ds that are
+    not rendered at the same time share their depth, ambient occlusion and
+    screen textures instead of each keeping its own set alive.
+
+    Only a texture matching \a format, \a flags and \a withDepthStencil is
+    reused. One of \a size is preferred, and otherwise the texture last used
+    for the same slot, which the caller then resizes. Taking a texture of a
+    different size that belongs to another slot would just make two layers
+    reallocate it back and forth every frame.
+
+    Returns false, leaving \a renderableTex untouched, when there is nothing
+    suitable to reuse.
+*/
+bool QSSGRhiContextPrivate::acquireTransientTexture(QSSGRhiRenderableTexture *renderableTex,
+                                                    const QSize &size,
+                                                    QRhiTexture::Format format,
+                                                    QRhiTexture::Flags flags,
+                                                    bool withDepthStencil)
+{
+    if (renderableTex->texture)
+        return false;
+
+    qsizetype bestIdx = -1;
+    int bestScore = 0;
+    for (qsizetype i = 0, end = m_transientTextures.size(); i != end; ++i) {
+        const QSSGRhiTransientTexture &transientTex = m_transientTextures.at(i);
+        const QRhiTexture *texture = transientTex.renderableTex.texture;
+        if (texture->format() != format || texture->flags() != flags
+                || (transientTex.renderableTex.depthStencil != nullptr) != withDepthStencil) {
+            continue;
+        }
+        const bool sameSize = texture->pixelSize() == size;
+        const bool sameOwner = transientTex.owner == renderableTex;
+        const int score = (sameSize ? 2 : 0) + (sameOwner ? 1 : 0);
+        if ((sameSize || sameOwner) && score > bestScore) {
+            bestIdx = i;
+            bestScore = score;
+        }
+    }
+
+    if (bestIdx < 0)
+        return false;
+
+    *renderableTex = m_transientTextures.at(bestIdx).renderableTex;
+    m_transientTextures.remove(bestIdx);
+    return true;
+}
+
+/*!
+    \internal
+
+    Moves the texture in \a renderableTex to the pool, leaving it empty. The
+    caller must be done recording every pass that uses the texture.
+*/
+void QSSGRhiContextPrivate::releaseTransientTexture(QSSGRhiRenderableTexture *renderableTex)
+{
+    if (!renderableTex->texture) {
+        renderableTex->reset();
+        return;
+    }
+
+    m_transientTextures.append({ *renderableTex, renderableTex });
+    *renderableTex = {};
+}
+
+/*!
+    \internal
+
+    Deletes the pooled textures last used for the slot \a owner. Called
+    before the slot releases its texture for the frame: whatever is still in
+    the pool for it at that point was neither wanted by the slot itself nor
+    picked up by another layer in the meantime.
+*/
+void QSSGRhiContextPrivate::cleanupTransientTextures(const QSSGRhiRenderableTexture *owner)
+{
+    m_transientTextures.removeIf([owner](QSSGRhiTransientTexture &transientTex) {
+        if (transientTex.owner != owner)
+            return false;
+        transientTex.renderableTex.reset();
+        return true;
+    });
+}
+
+namespace {
+
+// Writes the pass timings in the Chrome trace event format, which
+// chrome://tracing and Perfetto open directly. The closing bracket of the
+// event array is optional in that format, so the file stays usable when the
+// process is killed, which is the usual way a soak run ends.
+class QSSGChromeTraceWriter
+{
+public:
+    QSSGChromeTraceWriter()
+    {
+        m_clock.start();
+        const QString fileName = qEnvironmentVariable("QT_QUICK3D_TRACE_FILE");
+        if (fileName.isEmpty())
+            return;
+        m_file.setFileName(fileName);
+        if (m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            m_file.write("[\n");
+        else
+            qWarning("Failed to open trace file %s", qPrintable(fileName));
+    }
+
+    ~QSSGChromeTraceWriter()
+    {
+        if (m_file.isOpen())
+            m_file.write("\n]\n");
+    }
+
+    bool isOpen() const { return m_file.isOpen(); }
+    qint64 now() const { return m_clock.nsecsElapsed(); }
+
+    void write(const QByteArray &event)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_eventCount++ > 0)
+            m_file.write(",\n");
+        m_file.write(event);
+    }
+
+    void flush()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_file.flush();
+    }
+
+private:
+    QElapsedTimer m_clock;
+    QMutex m_mutex;
+    QFile m_file;
+    quint64 m_eventCount = 0;
+};
+
+}
+
+Q_GLOBAL_STATIC(QSSGChromeTraceWriter, chromeTraceWriter)
+
 void QSSGRhiContextStats::start(QSSGRenderLayer *layer)
 {
     layerKey = layer;
     PerLayerInfo &info(perLayerInfo[layerKey]);
     info.renderPasses.clear();
     info.externalRenderPass = {};
+    info.skinningDispatches = {};
+    info.passTimings.clear();
+    info.opaqueCulling = {};
+    info.transparentCulling = {};
     info.currentRenderPassIndex = -1;
+    info.currentPassTimingIndex = -1;
 }
 
 void QSSGRhiContextStats::stop(QSSGRenderLayer *layer)
@@ -1423,8 +1705,26 @@ void QSSGRhiContextStats::stop(QSSGRenderLayer *layer)
             qDebug("Within external render passes:");
             printRenderPass(info.externalRenderPass);
         }
+        if (info.skinningDispatches.callCount) {
+            qDebug("Skinning pre-pass: %llu dispatches for %llu vertices",
+                   info.skinningDispatches.callCount, info.skinningDispatches.vertexCount);
+        }
+        if (info.opaqueCulling.frustumCulledCount || info.opaqueCulling.occlusionCulledCount
+                || info.transparentCulling.frustumCulledCount || info.transparentCulling.occlusionCulledCount) {
+            qDebug("Culled objects: %u outside of the view, %u occluded",
+                   info.opaqueCulling.frustumCulledCount + info.transparentCulling.frustumCulledCount,
+                   info.opaqueCulling.occlusionCulledCount + info.transparentCulling.occlusionCulledCount);
+        }
+        for (const PassTimingInfo &timing : std::as_const(info.passTimings)) {
+            qDebug("Pass %s: prepare %.3f ms, render %.3f ms, %llu draw calls with %llu vertices or indices",
+                   timing.name.constData(), timing.prepareTime / 1000000.0, timing.renderTime / 1000000.0,
+                   timing.draws.callCount, timing.draws.vertexOrIndexCount);
+        }
     }
 
+    if (traceEnabled())
+        chromeTraceWriter()->flush();
+
     // a new start() may preceed stop() for the previous View3D, must handle this gracefully
     if (layerKey == layer)
         layerKey = nullptr;
@@ -1476,10 +1776,16 @@ bool QSSGRhiContextStats::rendererDebugEnabled()
     return enabled;
 }
 
+bool QSSGRhiContextStats::traceEnabled()
+{
+    static bool enabled = chromeTraceWriter()->isOpen();
+    return enabled;
+}
+
 bool QSSGRhiContextStats::isEnabled() const
 {
     return !dynamicDataSources.isEmpty() || profilingEnabled() || rendererDebugEnabled()
-            || Q_TRACE_ENABLED(QSSG_draw);
+            || traceEnabled() || Q_TRACE_ENABLED(QSSG_draw);
 }
 
 void QSSGRhiContextStats::drawIndexed(quint32 indexCount, quint32 instanceCount)
@@ -1487,6 +1793,11 @@ void QSSGRhiContextStats::drawIndexed(quint32 indexCount, quint32 instanceCount)
     Q_TRACE(QSSG_drawIndexed, indexCount, instanceCount);
     PerLayerInfo &info(perLayerInfo[layerKey]);
     RenderPassInfo &rp(info.currentRenderPassIndex >= 0 ? info.renderPasses[info.currentRenderPassIndex] : info.externalRenderPass);
+    if (info.currentPassTimingIndex >= 0) {
+        DrawInfo &passDraws(info.passTimings[info.currentPassTimingIndex].draws);
+        passDraws.callCount += 1;
+        passDraws.vertexOrIndexCount += indexCount;
+    }
     if (instanceCount > 1) {
         rp.instancedIndexedDraws.callCount += 1;
         rp.instancedIndexedDraws.vertexOrIndexCount += indexCount;
@@ -1502,6 +1813,11 @@ void QSSGRhiContextStats::draw(quint32 vertexCount, quint32 instanceCount)
     Q_TRACE(QSSG_draw, vertexCount, instanceCount);
     PerLayerInfo &info(perLayerInfo[layerKey]);
     RenderPassInfo &rp(info.currentRenderPassIndex >= 0 ? info.renderPasses[info.currentRenderPassIndex] : info.externalRenderPass);
+    if (info.currentPassTimingIndex >= 0) {
+        DrawInfo &passDraws(info.passTimings[info.currentPassTimingIndex].draws);
+        passDraws.callCount += 1;
+        passDraws.vertexOrIndexCount += vertexCount;
+    }
     if (instanceCount > 1) {
         rp.instancedDraws.callCount += 1;
         rp.instancedDraws.vertexOrIndexCount += vertexCount;
@@ -1512,6 +1828,78 @@ void QSSGRhiContextStats::draw(quint32 vertexCount, quint32 instanceCount)
     }
 }
 
+void QSSGRhiContextStats::skinningDispatch(quint32 vertexCount, quint32 uploadedBytes)
+{
+    PerLayerInfo &info(perLayerInfo[layerKey]);
+    info.skinningDispatches.callCount += 1;
+    info.skinningDispatches.vertexCount += vertexCount;
+    info.skinningDispatches.uploadedBytes += uploadedBytes;
+}
+
+void QSSGRhiContextStats::culledObjects(bool transparent, quint32 frustumCulledCount, quint32 occlusionCulledCount)
+{
+    // Set rather than added up, the sorted lists may be built more than once a frame
+    PerLayerInfo &info(perLayerInfo[layerKey]);
+    CullingInfo &culling(transparent ? info.transparentCulling : info.opaqueCulling);
+    culling.frustumCulledCount = frustumCulledCount;
+    culling.occlusionCulledCount = occlusionCulledCount;
+}
+
+void QSSGRhiContextStats::beginPassTiming(const char *name, PassPhase phase)
+{
+    PerLayerInfo &info(perLayerInfo[layerKey]);
+    auto it = std::find_if(info.passTimings.begin(), info.passTimings.end(),
+                           [name](const PassTimingInfo &timing) { return timing.name == name; });
+    if (it == info.passTimings.end()) {
+        info.passTimings.append({ QByteArray(name), 0, 0, {} });
+        it = info.passTimings.end() - 1;
+    }
+    info.currentPassTimingIndex = int(it - info.passTimings.begin());
+    currentPassPhase = phase;
+    passStartDraws = it->draws;
+    passStartTime = chromeTraceWriter()->now();
+}
+
+void QSSGRhiContextStats::endPassTiming()
+{
+    const qint64 endTime = chromeTraceWriter()->now();
+    PerLayerInfo &info(perLayerInfo[layerKey]);
+    QSSG_ASSERT(info.currentPassTimingIndex >= 0, return);
+    PassTimingInfo &timing(info.passTimings[info.currentPassTimingIndex]);
+    info.currentPassTimingIndex = -1;
+
+    const bool prepare = (currentPassPhase == PassPhase::Prepare);
+    (prepare ? timing.prepareTime : timing.renderTime) += endTime - passStartTime;
+
+    if (traceEnabled()) {
+        const QString event = QString::asprintf(
+                "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lld,\"tid\":%llu,"
+                "\"args\":{\"layer\":\"%p\",\"drawCalls\":%llu,\"vertices\":%llu}}",
+                timing.name.constData(),
+                prepare ? "prepare" : "render",
+                passStartTime / 1000.0,
+                (endTime - passStartTime) / 1000.0,
+                QCoreApplication::applicationPid(),
+                quint64(quintptr(QThread::currentThreadId())),
+                layerKey,
+                timing.draws.callCount - passStartDraws.callCount,
+                timing.draws.vertexOrIndexCount - passStartDraws.vertexOrIndexCount);
+        chromeTraceWriter()->write(event.toUtf8());
+    }
+}
+
+void QSSGRhiContextStats::traceGpuFrameTime(float msecs)
+{
+    if (!traceEnabled())
+        return;
+    const QString event = QString::asprintf(
+            "{\"name\":\"GPU frame time\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%lld,\"args\":{\"ms\":%.3f}}",
+            chromeTraceWriter()->now() / 1000.0,
+            QCoreApplication::applicationPid(),
+            msecs);
+    chromeTraceWriter()->write(event.toUtf8());
+}
+
 void QSSGRhiContextStats::printRenderPass(const QSSGRhiContextStats::RenderPassInfo &rp)
 {
     qDebug("%llu indexed draw calls with %llu indices in total, "
@@ -1581,9 +1969,12 @@ QRhiGraphicsPipeline *QSSGRhiContextPrivate::pipeline(const QSSGGraphicsPipeline
                                                       QRhiRenderPassDescriptor *rpDesc,
                                                       QRhiShaderResourceBindings *srb)
 {
-    auto it = m_pipelines.constFind(key);
-    if (it != m_pipelines.constEnd())
-        return it.value();
+    if (QRhiGraphicsPipeline **ps = m_pipelines.find(key)) {
+        ++m_stats.globalInfo.pipelineCacheHits;
+        return *ps;
+    }
+
+    ++m_stats.globalInfo.pipelineCacheMisses;
 
            // Build a new one. This is potentially expensive.
     QRhiGraphicsPipeline *ps = m_rhi->newGraphicsPipeline();
@@ -1640,7 +2031,7 @@ QRhiGraphicsPipeline *QSSGRhiContextPrivate::pipeline(const QSSGGraphicsPipeline
         return nullptr;
     }
 
-    m_pipelines.insert(key, ps);
+    m_pipelines.findOrInsert(key) = ps;
     return ps;
 }
 
@@ -1667,7 +2058,10 @@ QRhiComputePipeline *QSSGRhiContextPrivate::computePipeline(const QSSGComputePip
  */
 QRhiCommandBuffer::BeginPassFlags QSSGRhiContext::commonPassFlags() const
 {
-    // We do not use GPU compute at all at the moment, this means we can
-    // get a small performance gain with OpenGL by declaring this.
-    return QRhiCommandBuffer::DoNotTrackResourcesForCompute;
+    // GPU compute is only used by the skinning pre-pass. As long as that has
+    // not run, we can get a small performance gain with OpenGL by declaring
+    // that no resources need tracking for compute.
+    Q_D(const QSSGRhiContext);
+    return d->m_computeUsed ? QRhiCommandBuffer::BeginPassFlags()
+                            : QRhiCommandBuffer::DoNotTrackResourcesForCompute;
 }
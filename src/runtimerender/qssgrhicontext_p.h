@@ -18,6 +18,7 @@
 #include <QtGui/rhi/qrhi.h>
 
 #include <QtQuick3DRuntimeRender/qtquick3druntimerenderexports.h>
+#include <QtQuick3DRuntimeRender/private/qssgrhicachetable_p.h>
 #include <QtQuick3DUtils/private/qssgrenderbasetypes_p.h>
 #include <ssg/qssgrhicontext.h>
 
@@ -391,6 +392,8 @@ public:
         int fogHeightPropertiesIdx = -1;
         int fogTransmitPropertiesIdx = -1;
 
+        int lodCrossFadeIdx = -1;
+
         struct ImageIndices
         {
             int imageRotationsUniformIndex = -1;
@@ -562,8 +565,8 @@ struct QSSGRhiDrawCallData
     QRhiShaderResourceBindings *srb = nullptr; // not owned
     QSSGRhiShaderResourceBindingList bindings;
     QRhiGraphicsPipeline *pipeline = nullptr; // not owned
-    size_t renderTargetDescriptionHash = 0;
     QVector<quint32> renderTargetDescription;
+    QVector<quint32> srbLayoutDescription;
     QSSGRhiGraphicsPipelineState ps;
 
     void reset()
@@ -596,6 +599,15 @@ struct QSSGRhiRenderableTexture
     }
 };
 
+// A renderable texture that is not in use by any layer at the moment, see
+// QSSGRhiContextPrivate::acquireTransientTexture().
+struct QSSGRhiTransientTexture
+{
+    QSSGRhiRenderableTexture renderableTex;
+    // The slot the texture was last acquired for. Not dereferenced.
+    const QSSGRhiRenderableTexture *owner = nullptr;
+};
+
 struct QSSGRhiSortData
 {
     float d = 0.0f;
@@ -747,6 +759,27 @@ public:
         InstancedDrawInfo instancedIndexedDraws;
         InstancedDrawInfo instancedDraws;
     };
+    struct DispatchInfo {
+        quint64 callCount = 0;
+        quint64 vertexCount = 0;
+        quint64 uploadedBytes = 0;
+    };
+    // CPU time and draw calls of one QSSGRenderPass in the last frame. A pass
+    // can span several render targets and a render target several passes.
+    struct PassTimingInfo {
+        QByteArray name;
+        qint64 prepareTime = 0; // nanoseconds spent in renderPrep()
+        qint64 renderTime = 0; // nanoseconds spent in renderPass()
+        DrawInfo draws;
+    };
+    struct CullingInfo {
+        quint32 frustumCulledCount = 0;
+        quint32 occlusionCulledCount = 0;
+    };
+    enum class PassPhase {
+        Prepare,
+        Render
+    };
     struct PerLayerInfo {
         PerLayerInfo()
         {
@@ -762,13 +795,47 @@ public:
         // control of Qt Quick 3D)
         RenderPassInfo externalRenderPass;
 
+        // Compute dispatches of the skinning pre-pass
+        DispatchInfo skinningDispatches;
+
+        // In execution order
+        QVector<PassTimingInfo> passTimings;
+
+        // Objects left out of the opaque and transparent lists of the main
+        // camera, see QSSGLayerRenderData::getSortedOpaqueRenderableObjects()
+        CullingInfo opaqueCulling;
+        CullingInfo transparentCulling;
+
         int currentRenderPassIndex = -1;
+        int currentPassTimingIndex = -1;
     };
     struct GlobalInfo { // global as in per QSSGRhiContext which is per-QQuickWindow
         quint64 meshDataSize = 0;
         quint64 imageDataSize = 0;
+        // Streamed textures only, see QSSGBufferManager::updateStreamedTextures()
+        quint64 streamedTextureResidentSize = 0;
+        quint64 streamedTextureRequestedSize = 0;
         qint64 materialGenerationTime = 0;
         qint64 effectGenerationTime = 0;
+        // Cache behavior since the context was created, counted always
+        quint64 pipelineCacheHits = 0;
+        quint64 pipelineCacheMisses = 0;
+        quint64 srbCacheHits = 0;
+        quint64 srbCacheMisses = 0;
+        // Draws that reused the pipeline or srb of their previous frame
+        // without any lookup, see QSSGRhiContextPrivate::pipeline(dcd, ...)
+        quint64 pipelineReuses = 0;
+        quint64 srbReuses = 0;
+        quint64 drawCallDataEvictions = 0;
+        quint64 shaderCacheHits = 0;
+        quint64 shaderCacheMisses = 0;
+        // Entries and slots of the caches, updated every frame
+        qsizetype drawCallDataCount = 0;
+        qsizetype drawCallDataCapacity = 0;
+        qsizetype srbCacheCount = 0;
+        qsizetype srbCacheCapacity = 0;
+        qsizetype pipelineCacheCount = 0;
+        qsizetype pipelineCacheCapacity = 0;
     };
 
     QHash<QSSGRenderLayer *, PerLayerInfo> perLayerInfo;
@@ -794,10 +861,16 @@ public:
 
     static bool profilingEnabled();
     static bool rendererDebugEnabled();
+    static bool traceEnabled();
 
     bool isEnabled() const;
     void drawIndexed(quint32 indexCount, quint32 instanceCount);
     void draw(quint32 vertexCount, quint32 instanceCount);
+    void skinningDispatch(quint32 vertexCount, quint32 uploadedBytes);
+    void culledObjects(bool transparent, quint32 frustumCulledCount, quint32 occlusionCulledCount);
+    void beginPassTiming(const char *name, PassPhase phase);
+    void endPassTiming();
+    void traceGpuFrameTime(float msecs);
 
     void meshDataSizeChanges(quint64 newSize) // can be called outside start-stop
     {
@@ -809,6 +882,12 @@ public:
         globalInfo.imageDataSize = newSize;
     }
 
+    void streamedTextureSizeChanges(quint64 residentSize, quint64 requestedSize) // can be called outside start-stop
+    {
+        globalInfo.streamedTextureResidentSize = residentSize;
+        globalInfo.streamedTextureRequestedSize = requestedSize;
+    }
+
     void registerMaterialShaderGenerationTime(qint64 ms)
     {
         globalInfo.materialGenerationTime += ms;
@@ -845,6 +924,9 @@ public:
     QSSGRhiContext *rhiCtx;
     QSSGRenderLayer *layerKey = nullptr;
     QSet<QSSGRenderLayer *> dynamicDataSources;
+    qint64 passStartTime = 0;
+    PassPhase currentPassPhase = PassPhase::Prepare;
+    DrawInfo passStartDraws;
 };
 
 class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGRhiContextPrivate
@@ -890,6 +972,18 @@ public:
                                    QRhiRenderPassDescriptor *rpDesc,
                                    QRhiShaderResourceBindings *srb);
 
+    // The same as above, but if the draw call used the same bindings, or the
+    // same pipeline state with a compatible srb and render pass, in its
+    // previous frame, the objects stored in dcd are returned without building
+    // a key or looking up the caches.
+    QRhiShaderResourceBindings *srb(QSSGRhiDrawCallData &dcd,
+                                    const QSSGRhiShaderResourceBindingList &bindings);
+
+    QRhiGraphicsPipeline *pipeline(QSSGRhiDrawCallData &dcd,
+                                   const QSSGRhiGraphicsPipelineState &ps,
+                                   QRhiRenderPassDescriptor *rpDesc,
+                                   QRhiShaderResourceBindings *srb);
+
     QRhiComputePipeline *computePipeline(const QShader &shader,
                                          QRhiShaderResourceBindings *srb);
 
@@ -899,6 +993,13 @@ public:
     QSSGRhiDrawCallData &drawCallData(const QSSGRhiDrawCallDataKey &key);
     void releaseDrawCallData(QSSGRhiDrawCallData &dcd);
     void cleanupDrawCallData(const QSSGRenderModel *model);
+    void cleanupDrawCallData(const QSet<const void *> &models);
+
+    // Called once per frame, before preparing anything. Releases the draw call
+    // data, instance buffers and particle data that nothing looked up for a
+    // while, e.g. of removed passes, effects, models and View3Ds, a few
+    // entries at a time.
+    void beginFrame();
 
     QSSGRhiInstanceBufferData &instanceBufferData(QSSGRenderInstanceTable *instanceTable);
 
@@ -906,6 +1007,17 @@ public:
 
     QSSGRhiParticleData &particleData(const QSSGRenderGraphObject *particlesOrModel);
 
+    static void releaseInstanceBufferData(QSSGRhiInstanceBufferData &instanceData);
+    static void releaseParticleData(QSSGRhiParticleData &particleData);
+
+    bool acquireTransientTexture(QSSGRhiRenderableTexture *renderableTex,
+                                 const QSize &size,
+                                 QRhiTexture::Format format,
+                                 QRhiTexture::Flags flags,
+                                 bool withDepthStencil);
+    void releaseTransientTexture(QSSGRhiRenderableTexture *renderableTex);
+    void cleanupTransientTextures(const QSSGRhiRenderableTexture *owner);
+
     QSSGRhiContext *q_ptr = nullptr;
     QRhi *m_rhi = nullptr;
 
@@ -915,18 +1027,22 @@ public:
     Textures m_textures;
     Meshes m_meshes;
     int m_mainSamples = 1;
+    // Set once something was rendered with GPU compute, see commonPassFlags()
+    bool m_computeUsed = false;
 
     QVector<QPair<QSSGRhiSamplerDescription, QRhiSampler*>> m_samplers;
 
-    QHash<QSSGRhiDrawCallDataKey, QSSGRhiDrawCallData> m_drawCallData;
-    QHash<QSSGRhiShaderResourceBindingList, QRhiShaderResourceBindings *> m_srbCache;
-    QHash<QSSGGraphicsPipelineStateKey, QRhiGraphicsPipeline *> m_pipelines;
+    QSSGRhiCacheTable<QSSGRhiDrawCallDataKey, QSSGRhiDrawCallData> m_drawCallData;
+    QSSGRhiCacheTable<QSSGRhiShaderResourceBindingList, QRhiShaderResourceBindings *> m_srbCache;
+    QSSGRhiCacheTable<QSSGGraphicsPipelineStateKey, QRhiGraphicsPipeline *> m_pipelines;
     QHash<QSSGComputePipelineStateKey, QRhiComputePipeline *> m_computePipelines;
     QHash<QSSGRhiDummyTextureKey, QRhiTexture *> m_dummyTextures;
-    QHash<QSSGRenderInstanceTable *, QSSGRhiInstanceBufferData> m_instanceBuffers;
-    QHash<const QSSGRenderModel *, QSSGRhiInstanceBufferData> m_instanceBuffersLod;
-    QHash<const QSSGRenderGraphObject *, QSSGRhiParticleData> m_particleData;
+    QSSGRhiCacheTable<QSSGRenderInstanceTable *, QSSGRhiInstanceBufferData> m_instanceBuffers;
+    QSSGRhiCacheTable<const QSSGRenderModel *, QSSGRhiInstanceBufferData> m_instanceBuffersLod;
+    QSSGRhiCacheTable<const QSSGRenderGraphObject *, QSSGRhiParticleData> m_particleData;
+    QVector<QSSGRhiTransientTexture> m_transientTextures;
     QSSGRhiContextStats m_stats;
+    quint32 m_frame = 0;
 };
 
 inline bool operator==(const QSSGRhiDrawCallDataKey &a, const QSSGRhiDrawCallDataKey &b) noexcept
@@ -18,6 +18,7 @@
 #include <QtQuick3DRuntimeRender/private/qssgrendermodel_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgruntimerenderlogging_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrhiparticles_p.h>
+#include "rendererimpl/qssgrenderhelpers_p.h"
 #include <qtquick3d_tracepoints_p.h>
 
 #include <QtCore/qbitarray.h>
@@ -168,6 +169,11 @@ void QSSGCustomMaterialSystem::updateUniformsForCustomMaterial(QSSGRhiShaderPipe
                                                           renderable.renderableFlags.receivesReflections(),
                                                           depthAdjust,
                                                           lightmapTexture);
+
+    if (renderable.lodCrossFade != 0.0f) {
+        shaderPipeline.setUniform(ubufData, "qt_lodCrossFade", &renderable.lodCrossFade, sizeof(float),
+                                  &shaderPipeline.commonUniformIndices.lodCrossFadeIdx);
+    }
 }
 
 static const QRhiShaderResourceBinding::StageFlags CUSTOM_MATERIAL_VISIBILITY_ALL =
@@ -495,47 +501,15 @@ void QSSGCustomMaterialSystem::rhiPrepareRenderable(QSSGRhiGraphicsPipelineState
 
         QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(rhiCtx);
 
-        // do the same srb lookup acceleration as default materials
-        QRhiShaderResourceBindings *&srb = dcd.srb;
-        bool srbChanged = false;
-        if (!srb || bindings != dcd.bindings) {
-            srb = rhiCtxD->srb(bindings);
-            dcd.bindings = bindings;
-            srbChanged = true;
-        }
-
-        if (cubeFace == QSSGRenderTextureCubeFaceNone)
+        // do the same srb and pipeline lookup acceleration as default materials
+        QRhiShaderResourceBindings *srb = rhiCtxD->srb(dcd, bindings);
+        QRhiGraphicsPipeline *pipeline = rhiCtxD->pipeline(dcd, *ps, renderPassDescriptor, srb);
+        if (cubeFace == QSSGRenderTextureCubeFaceNone) {
             renderable.rhiRenderData.mainPass.srb = srb;
-        else
-            renderable.rhiRenderData.reflectionPass.srb[cubeFaceIdx] = srb;
-
-        const auto pipelineKey = QSSGGraphicsPipelineStateKey::create(*ps, renderPassDescriptor, srb);
-        if (dcd.pipeline
-                && !srbChanged
-                && dcd.renderTargetDescriptionHash == pipelineKey.extra.renderTargetDescriptionHash
-                && dcd.renderTargetDescription == pipelineKey.renderTargetDescription
-                && dcd.ps == *ps)
-        {
-            if (cubeFace == QSSGRenderTextureCubeFaceNone)
-                renderable.rhiRenderData.mainPass.pipeline = dcd.pipeline;
-            else
-                renderable.rhiRenderData.reflectionPass.pipeline = dcd.pipeline;
+            renderable.rhiRenderData.mainPass.pipeline = pipeline;
         } else {
-            if (cubeFace == QSSGRenderTextureCubeFaceNone) {
-                renderable.rhiRenderData.mainPass.pipeline = rhiCtxD->pipeline(pipelineKey,
-                                                                               renderPassDescriptor,
-                                                                               srb);
-                dcd.pipeline = renderable.rhiRenderData.mainPass.pipeline;
-            } else {
-                renderable.rhiRenderData.reflectionPass.pipeline = rhiCtxD->pipeline(pipelineKey,
-                                                                                     renderPassDescriptor,
-                                                                                     srb);
-                dcd.pipeline = renderable.rhiRenderData.reflectionPass.pipeline;
-            }
-
-            dcd.renderTargetDescriptionHash = pipelineKey.extra.renderTargetDescriptionHash;
-            dcd.renderTargetDescription = pipelineKey.renderTargetDescription;
-            dcd.ps = *ps;
+            renderable.rhiRenderData.reflectionPass.srb[cubeFaceIdx] = srb;
+            renderable.rhiRenderData.reflectionPass.pipeline = pipeline;
         }
     }
 }
@@ -608,7 +582,7 @@ void QSSGCustomMaterialSystem::rhiRenderRenderable(QSSGRhiContext *rhiCtx,
         return;
 
     Q_QUICK3D_PROFILE_START(QQuick3DProfiler::Quick3DRenderCall);
-    QRhiBuffer *vertexBuffer = renderable.subset.rhi.vertexBuffer->buffer();
+    QRhiBuffer *vertexBuffer = renderable.vertexBuffer();
     QRhiBuffer *indexBuffer = renderable.subset.rhi.indexBuffer ? renderable.subset.rhi.indexBuffer->buffer() : nullptr;
 
     QRhiCommandBuffer *cb = rhiCtx->commandBuffer();
@@ -631,8 +605,12 @@ void QSSGCustomMaterialSystem::rhiRenderRenderable(QSSGRhiContext *rhiCtx,
     }
     if (indexBuffer) {
         cb->setVertexInput(0, vertexBufferCount, vertexBuffers, indexBuffer, 0, renderable.subset.rhi.indexBuffer->indexFormat());
-        cb->drawIndexed(renderable.subset.count, instances, renderable.subset.offset);
-        QSSGRHICTX_STAT(rhiCtx, drawIndexed(renderable.subset.count, instances));
+        if (renderable.hasVisibleRanges && cubeFace == QSSGRenderTextureCubeFaceNone) {
+            RenderHelpers::rhiDrawVisibleRanges(rhiCtx, renderable);
+        } else {
+            cb->drawIndexed(renderable.subset.count, instances, renderable.subset.offset);
+            QSSGRHICTX_STAT(rhiCtx, drawIndexed(renderable.subset.count, instances));
+        }
     } else {
         cb->setVertexInput(0, vertexBufferCount, vertexBuffers);
         cb->draw(renderable.subset.count, instances, renderable.subset.offset);
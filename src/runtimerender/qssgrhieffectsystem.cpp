@@ -12,6 +12,8 @@
 #include <QtQuick3DUtils/private/qssgassert_p.h>
 
 #include <QtCore/qloggingcategory.h>
+#include <QtCore/qregularexpression.h>
+#include <QtCore/qcryptographichash.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -167,19 +169,33 @@ QRhiTexture *QSSGRhiEffectSystem::process(const QSSGRenderEffect &firstEffect,
     m_cameraClipRange = cameraClipRange;
 
     m_currentUbufIndex = 0;
-    auto *currentEffect = &firstEffect;
-    QSSGRhiEffectTexture firstTex{ inTexture, nullptr, nullptr, {}, {}, {} };
-    auto *latestOutput = doRenderEffect(currentEffect, &firstTex);
-    firstTex.texture = nullptr; // make sure we don't delete inTexture when we go out of scope
+    updateEffectSteps(firstEffect);
 
-    while ((currentEffect = currentEffect->m_nextEffect)) {
-        auto *effectOut = doRenderEffect(currentEffect, latestOutput);
-        releaseTexture(latestOutput);
+    QSSGRhiEffectTexture firstTex{ inTexture, nullptr, nullptr, {}, {}, {} };
+    QSSGRhiEffectTexture *latestOutput = &firstTex;
+    const auto advance = [this, &firstTex, &latestOutput](QSSGRhiEffectTexture *effectOut) {
+        if (latestOutput != &firstTex)
+            releaseTexture(latestOutput);
         latestOutput = effectOut;
+    };
+
+    for (EffectStep &step : m_effectSteps) {
+        if (step.fusedShader) {
+            if (auto *effectOut = doRenderFusedEffects(step, latestOutput)) {
+                advance(effectOut);
+                continue;
+            }
+            // The generated shader could not be built, render the effects
+            // one by one from now on.
+            step.fusedShader.reset();
+        }
+        for (const QSSGRenderEffect *effect : std::as_const(step.effects))
+            advance(doRenderEffect(effect, latestOutput));
     }
+    firstTex.texture = nullptr; // make sure we don't delete inTexture when we go out of scope
 
     releaseTextures();
-    return latestOutput ? latestOutput->texture : nullptr;
+    return latestOutput && latestOutput != &firstTex ? latestOutput->texture : nullptr;
 }
 
 void QSSGRhiEffectSystem::releaseResources()
@@ -188,6 +204,162 @@ void QSSGRhiEffectSystem::releaseResources()
     m_textures.clear();
 
     m_shaderPipelines.clear();
+
+    m_effectSteps.clear();
+    m_effectChain.clear();
+}
+
+static bool effectFusionEnabled(const QSSGShaderLibraryManager &shaderLib)
+{
+#ifdef QT_QUICK3D_HAS_RUNTIME_SHADERS
+    static const bool disabled = qEnvironmentVariableIntValue("QT_QUICK3D_DISABLE_EFFECT_FUSION");
+    // The fused shaders are never among the pre-generated ones, and an
+    // application shipping those may not be able to generate shaders at all.
+    return !disabled && shaderLib.m_preGeneratedShaderEntries.isEmpty();
+#else
+    Q_UNUSED(shaderLib);
+    return false;
+#endif
+}
+
+// Returns the shader of an effect QQuick3DEffect flagged as pixel local, once
+// its commands are the ones expected for such an effect.
+static const QSSGBindShader *pixelLocalShader(const QSSGRenderEffect *effect)
+{
+    const auto &commands = effect->commands;
+    if (!effect->isPixelLocal || effect->shaderPrepData.passes.size() != 1 || commands.size() != 4)
+        return nullptr;
+    if (!commands[0].command || commands[0].command->m_type != CommandType::BindShader
+            || commands[1].command->m_type != CommandType::ApplyInstanceValue
+            || commands[2].command->m_type != CommandType::BindTarget
+            || commands[3].command->m_type != CommandType::Render) {
+        return nullptr;
+    }
+    // The output has the format of the input, see overriddenOutputFormat()
+    if (static_cast<const QSSGBindTarget *>(commands[2].command)->m_outputFormat != QSSGRenderTextureFormat::Unknown
+            || effect->outputFormat != QSSGRenderTextureFormat::Unknown) {
+        return nullptr;
+    }
+    return static_cast<const QSSGBindShader *>(commands[0].command);
+}
+
+// Splits the effect chain into the passes it is rendered with. Runs of pixel
+// local effects become one pass, unless they would declare the same names in
+// the fused shader. The result is kept as long as the chain and the shaders
+// of its effects stay the same.
+void QSSGRhiEffectSystem::updateEffectSteps(const QSSGRenderEffect &firstEffect)
+{
+    const bool fusionEnabled = effectFusionEnabled(*m_sgContext->shaderLibraryManager());
+    QVarLengthArray<EffectChainEntry, 8> chain;
+    for (const QSSGRenderEffect *effect = &firstEffect; effect; effect = effect->m_nextEffect) {
+        const QSSGBindShader *shader = fusionEnabled ? pixelLocalShader(effect) : nullptr;
+        chain.append({ effect, shader ? shader->m_shaderPathKey : QByteArray() });
+    }
+
+    if (chain == m_effectChain && !m_effectSteps.empty())
+        return;
+
+    m_effectChain = chain;
+    m_effectSteps.clear();
+
+    QSet<QByteArray> stepNames;
+    bool stepIsPixelLocal = false;
+    for (const EffectChainEntry &entry : std::as_const(m_effectChain)) {
+        const QSSGRenderEffect *effect = entry.effect;
+        const bool isPixelLocal = !entry.shaderPathKey.isEmpty();
+        QSet<QByteArray> names;
+        if (isPixelLocal) {
+            names = QSet<QByteArray>(effect->shaderGlobalNames.cbegin(), effect->shaderGlobalNames.cend());
+            for (const QSSGRenderEffect::Property &property : effect->properties)
+                names.insert(property.name);
+            for (const QSSGRenderEffect::TextureProperty &textureProperty : effect->textureProperties)
+                names.insert(textureProperty.name);
+        }
+
+        if (!(isPixelLocal && stepIsPixelLocal && !stepNames.intersects(names))) {
+            m_effectSteps.emplace_back();
+            stepNames.clear();
+        }
+        m_effectSteps.back().effects.append(effect);
+        stepNames.unite(names);
+        stepIsPixelLocal = isPixelLocal;
+    }
+
+    for (EffectStep &step : m_effectSteps) {
+        if (step.effects.size() > 1)
+            generateFusedShader(step);
+    }
+}
+
+// Pastes the fragment shaders one after the other, renaming their MAIN
+// functions, and calls them in order from main(). Each shader but the first
+// reads the color the previous one wrote instead of sampling INPUT.
+QByteArray QSSGRhiEffectSystem::fuseFragmentShaders(const QByteArrayList &fragmentShaders, bool tonemap)
+{
+    static const QRegularExpression mainRe(QStringLiteral("\\bqt_customMain\\b"));
+    static const QRegularExpression inputRe(QStringLiteral("\\btexture\\s*\\(\\s*qt_inputTexture\\s*,\\s*qt_inputUV\\s*\\)"));
+
+    QByteArray fragmentCode = QByteArrayLiteral("vec4 qt_fusedInputColor;\n");
+    QByteArray mainBody;
+    for (qsizetype i = 0, end = fragmentShaders.size(); i != end; ++i) {
+        const QByteArray mainName = QByteArrayLiteral("qt_customMain_") + QByteArray::number(i);
+        QString code = QString::fromLatin1(fragmentShaders.at(i));
+        code.replace(mainRe, QString::fromLatin1(mainName));
+        if (i > 0) {
+            code.replace(inputRe, QStringLiteral("qt_fusedInputColor"));
+            mainBody += "    qt_fusedInputColor = fragOutput;\n";
+        }
+        fragmentCode += code.toLatin1();
+        mainBody += "    " + mainName + "();\n";
+    }
+
+    if (tonemap) {
+        fragmentCode += "#include \"tonemapping.glsllib\"\n";
+        mainBody += "    fragOutput = qt_tonemap(fragOutput);\n";
+    }
+    fragmentCode += "void main()\n{\n" + mainBody + "}\n";
+    return fragmentCode;
+}
+
+void QSSGRhiEffectSystem::generateFusedShader(EffectStep &step)
+{
+    const auto &shaderLib = m_sgContext->shaderLibraryManager();
+
+    QByteArray componentKeys;
+    QByteArrayList fragmentShaders;
+    QSSGCustomShaderMetaData fragmentMetaData;
+    for (const QSSGRenderEffect *effect : std::as_const(step.effects)) {
+        const QSSGRenderEffect::ShaderPrepPassData &pass = effect->shaderPrepData.passes.first();
+        componentKeys += pixelLocalShader(effect)->m_shaderPathKey + '\n';
+        fragmentShaders.append(pass.fragmentShaderCode);
+        fragmentMetaData.flags |= pass.fragmentMetaData.flags;
+    }
+
+    // Same as in QSSGRenderEffect::finalizeShaders(): the last effect of the
+    // chain performs the tonemapping, and its shader has the features for it.
+    const QSSGRenderEffect *lastEffect = step.effects.last();
+    const QByteArray &lastKey = pixelLocalShader(lastEffect)->m_shaderPathKey;
+    fragmentMetaData.features = shaderLib->getShaderMetaData(lastKey, QSSGShaderCache::ShaderType::Fragment).features;
+    const QByteArray fragmentCode = fuseFragmentShaders(fragmentShaders, !lastEffect->m_nextEffect);
+
+    // The component keys capture the source of each effect, the Y-up and the
+    // tonemapping variations.
+    const QByteArray shaderPathKey = QByteArrayLiteral("effect fused--")
+            + QCryptographicHash::hash(componentKeys, QCryptographicHash::Algorithm::Sha1).toHex();
+
+    // All the effects use the default vertex shader.
+    const QByteArray &firstKey = pixelLocalShader(step.effects.first())->m_shaderPathKey;
+    shaderLib->setShaderSource(shaderPathKey,
+                               QSSGShaderCache::ShaderType::Vertex,
+                               shaderLib->getShaderSource(firstKey, QSSGShaderCache::ShaderType::Vertex),
+                               shaderLib->getShaderMetaData(firstKey, QSSGShaderCache::ShaderType::Vertex));
+    shaderLib->setShaderSource(shaderPathKey,
+                               QSSGShaderCache::ShaderType::Fragment,
+                               fragmentCode,
+                               fragmentMetaData);
+
+    qCDebug(lcEffectSystem) << "fusing" << step.effects.size() << "effects into" << shaderPathKey;
+    step.fusedShader = std::make_unique<QSSGBindShader>(shaderPathKey);
 }
 
 QSSGRenderTextureFormat::Format QSSGRhiEffectSystem::overriddenOutputFormat(const QSSGRenderEffect *inEffect)
@@ -292,6 +464,32 @@ QSSGRhiEffectTexture *QSSGRhiEffectSystem::doRenderEffect(const QSSGRenderEffect
     return finalOutputTexture;
 }
 
+QSSGRhiEffectTexture *QSSGRhiEffectSystem::doRenderFusedEffects(const EffectStep &step,
+                                                                QSSGRhiEffectTexture *inTexture)
+{
+    // The commands of each effect are known to be BindShader,
+    // ApplyInstanceValue, BindTarget and Render, so this does the same for
+    // all of them at once.
+    const QSSGRenderEffect *lastEffect = step.effects.last();
+    qCDebug(lcEffectSystem) << "START fused effects" << step.fusedShader->m_shaderPathKey;
+
+    bindShaderCmd(step.fusedShader.get(), lastEffect);
+    if (!m_currentShaderPipeline)
+        return nullptr;
+
+    static const QSSGApplyInstanceValue applyAll;
+    for (const QSSGRenderEffect *effect : step.effects)
+        applyInstanceValueCmd(&applyAll, effect);
+
+    // The output format of a pixel local effect is always the input format.
+    const QByteArray outputName = QByteArrayLiteral("__output_").append(QByteArray::number(m_currentUbufIndex));
+    QSSGRhiEffectTexture *output = getTexture(outputName, m_outSize, inTexture->texture->format(), true, lastEffect);
+    renderCmd(inTexture, output);
+
+    qCDebug(lcEffectSystem) << "END fused effects";
+    return output;
+}
+
 void QSSGRhiEffectSystem::allocateBufferCmd(const QSSGAllocateBuffer *inCmd, QSSGRhiEffectTexture *inTexture, const QSSGRenderEffect *inEffect)
 {
     // Note: Allocate is used both to allocate new, and refer to buffer created earlier
@@ -573,7 +771,7 @@ void QSSGRhiEffectSystem::renderCmd(QSSGRhiEffectTexture *inTexture, QSSGRhiEffe
     }
     bindings.addUniformBuffer(0, VISIBILITY_ALL, dcd.ubuf);
 
-    QRhiShaderResourceBindings *srb = rhiCtxD->srb(bindings);
+    QRhiShaderResourceBindings *srb = rhiCtxD->srb(dcd, bindings);
 
     QSSGRhiGraphicsPipelineState ps;
     ps.viewport = QRhiViewport(0, 0, float(outputSize.width()), float(outputSize.height()));
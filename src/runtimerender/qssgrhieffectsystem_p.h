@@ -20,6 +20,10 @@
 #include <QtQuick3DRuntimeRender/private/qssgrhicontext_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendercommands_p.h>
 
+#include <QtCore/qvarlengtharray.h>
+
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 struct QSSGRhiEffectTexture;
@@ -80,10 +84,36 @@ public:
                                                          QSSGShaderCache &shaderCache,
                                                          bool isYUpInFramebuffer);
 
+    // The fragment shader of a fused pass, from the processed fragment
+    // shaders of the pixel local effects in it, in order.
+    static QByteArray fuseFragmentShaders(const QByteArrayList &fragmentShaders, bool tonemap);
+
 private:
+    // One or more effects rendered in a single pass. The effects of a step
+    // with more than one effect share the generated fusedShader.
+    struct EffectStep
+    {
+        QVarLengthArray<const QSSGRenderEffect *, 4> effects;
+        std::unique_ptr<QSSGBindShader> fusedShader;
+    };
+
+    struct EffectChainEntry
+    {
+        const QSSGRenderEffect *effect;
+        QByteArray shaderPathKey; // empty unless the effect is pixel local
+        bool operator==(const EffectChainEntry &other) const
+        {
+            return effect == other.effect && shaderPathKey == other.shaderPathKey;
+        }
+    };
+
     void releaseResources();
+    void updateEffectSteps(const QSSGRenderEffect &firstEffect);
+    void generateFusedShader(EffectStep &step);
     QSSGRhiEffectTexture *doRenderEffect(const QSSGRenderEffect *inEffect,
                         QSSGRhiEffectTexture *inTexture);
+    QSSGRhiEffectTexture *doRenderFusedEffects(const EffectStep &step,
+                                               QSSGRhiEffectTexture *inTexture);
 
     void allocateBufferCmd(const QSSGAllocateBuffer *inCmd, QSSGRhiEffectTexture *inTexture, const QSSGRenderEffect *inEffect);
     void applyInstanceValueCmd(const QSSGApplyInstanceValue *inCmd, const QSSGRenderEffect *inEffect);
@@ -112,6 +142,8 @@ private:
     char *m_currentUBufData = nullptr;
     QHash<QByteArray, QSSGRhiTexture> m_currentTextures;
     QSet<QRhiTextureRenderTarget *> m_pendingClears;
+    QVarLengthArray<EffectChainEntry, 8> m_effectChain;
+    std::vector<EffectStep> m_effectSteps;
 };
 
 QT_END_NAMESPACE
@@ -486,46 +486,14 @@ void QSSGParticleRenderer::rhiPrepareRenderable(QSSGRhiShaderPipeline &shaderPip
 
     QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(rhiCtx);
 
-    // TODO: This is identical to other renderables. Make into a function?
-    QRhiShaderResourceBindings *&srb = dcd.srb;
-    bool srbChanged = false;
-    if (!srb || bindings != dcd.bindings) {
-        srb = rhiCtxD->srb(bindings);
-        dcd.bindings = bindings;
-        srbChanged = true;
-    }
-
-    if (cubeFace == QSSGRenderTextureCubeFaceNone)
+    QRhiShaderResourceBindings *srb = rhiCtxD->srb(dcd, bindings);
+    QRhiGraphicsPipeline *pipeline = rhiCtxD->pipeline(dcd, *ps, renderPassDescriptor, srb);
+    if (cubeFace == QSSGRenderTextureCubeFaceNone) {
         renderable.rhiRenderData.mainPass.srb = srb;
-    else
-        renderable.rhiRenderData.reflectionPass.srb[cubeFaceIdx] = srb;
-
-    const auto pipelineKey = QSSGGraphicsPipelineStateKey::create(*ps, renderPassDescriptor, srb);
-    if (dcd.pipeline
-            && !srbChanged
-            && dcd.renderTargetDescriptionHash == pipelineKey.extra.renderTargetDescriptionHash
-            && dcd.renderTargetDescription == pipelineKey.renderTargetDescription
-            && dcd.ps == *ps)
-    {
-        if (cubeFace == QSSGRenderTextureCubeFaceNone)
-            renderable.rhiRenderData.mainPass.pipeline = dcd.pipeline;
-        else
-            renderable.rhiRenderData.reflectionPass.pipeline = dcd.pipeline;
+        renderable.rhiRenderData.mainPass.pipeline = pipeline;
     } else {
-        if (cubeFace == QSSGRenderTextureCubeFaceNone) {
-            renderable.rhiRenderData.mainPass.pipeline = rhiCtxD->pipeline(pipelineKey,
-                                                                           renderPassDescriptor,
-                                                                           srb);
-            dcd.pipeline = renderable.rhiRenderData.mainPass.pipeline;
-        } else {
-            renderable.rhiRenderData.reflectionPass.pipeline = rhiCtxD->pipeline(pipelineKey,
-                                                                                 renderPassDescriptor,
-                                                                                 srb);
-            dcd.pipeline = renderable.rhiRenderData.reflectionPass.pipeline;
-        }
-        dcd.renderTargetDescriptionHash = pipelineKey.extra.renderTargetDescriptionHash;
-        dcd.renderTargetDescription = pipelineKey.renderTargetDescription;
-        dcd.ps = *ps;
+        renderable.rhiRenderData.reflectionPass.srb[cubeFaceIdx] = srb;
+        renderable.rhiRenderData.reflectionPass.pipeline = pipeline;
     }
 }
 
@@ -127,6 +127,8 @@ void QSSGRhiQuadRenderer::recordRenderQuad(QSSGRhiContext *rhiCtx,
     cb->setGraphicsPipeline(pipeline);
     cb->setShaderResources(srb);
     cb->setViewport(ps->viewport);
+    if (ps->flags.testFlag(QSSGRhiGraphicsPipelineState::Flag::UsesScissor))
+        cb->setScissor(ps->scissor);
 
     quint32 vertexOffset = flags.testAnyFlags(RenderBehind) ? 5 * 4 * sizeof(float) : 0;
 
@@ -16,6 +16,7 @@
 #include <QtQuick3DRuntimeRender/private/qssgrenderjoint_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendermorphtarget_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderparticles_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderlodgroup_p.h>
 #include "../qssgrendercontextcore.h"
 #include <QtQuick3DRuntimeRender/private/qssgrenderbuffermanager_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendershadercache_p.h>
@@ -32,6 +33,7 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QBitArray>
+#include <algorithm>
 #include <array>
 
 #include "qssgrenderpass_p.h"
@@ -108,6 +110,50 @@ qsizetype QSSGLayerRenderData::frustumCullingInline(const QSSGClippingFrustum &c
     return back + 1;
 }
 
+// Moves the Item2Ds whose content intersects the frustum to the front, and
+// returns their count. Items without bounds are kept.
+qsizetype QSSGLayerRenderData::frustumCullingInline(const QSSGClippingFrustum &clipFrustum, RenderableItem2DEntries &item2Ds)
+{
+    const auto end = std::stable_partition(item2Ds.begin(), item2Ds.end(), [&clipFrustum](const QSSGRenderItem2D *item2D) {
+        const QRectF &rect = item2D->bounds;
+        if (rect.isEmpty())
+            return true;
+        // The 2D content lies in the xy plane of the item, with y pointing down
+        QSSGBounds3 bounds(QVector3D(float(rect.left()), float(-rect.bottom()), 0.0f),
+                           QVector3D(float(rect.right()), float(-rect.top()), 0.0f));
+        bounds.transform(item2D->globalTransform);
+        return clipFrustum.intersectsWith(bounds);
+    });
+    return end - item2Ds.begin();
+}
+
+qsizetype QSSGLayerRenderData::occlusionCullingInline(const QSSGOcclusionCuller &occlusionCuller, QSSGRenderableObjectList &renderables)
+{
+    const auto isOccluded = [&occlusionCuller](const QSSGRenderableObject &obj) {
+        // The bounds of instanced and skinned models do not enclose what is drawn
+        if (obj.type == QSSGRenderableObject::Type::DefaultMaterialMeshSubset
+                || obj.type == QSSGRenderableObject::Type::CustomMaterialMeshSubset) {
+            const QSSGRenderModel &model = static_cast<const QSSGSubsetRenderable &>(obj).modelContext.model;
+            if (model.instancing() || model.usesBoneTexture())
+                return false;
+        }
+        return occlusionCuller.isOccluded(obj.globalBounds);
+    };
+
+    const qint32 end = renderables.size();
+    qint32 front = 0;
+    qint32 back = end - 1;
+
+    while (front <= back) {
+        if (!isOccluded(*renderables.at(front).obj))
+            ++front;
+        else
+            renderables.swapItemsAt(front, back--);
+    }
+
+    return back + 1;
+}
+
 [[nodiscard]] constexpr static inline bool nearestToFurthestCompare(const QSSGRenderableObjectHandle &lhs, const QSSGRenderableObjectHandle &rhs) noexcept
 {
     return lhs.cameraDistanceSq < rhs.cameraDistanceSq;
@@ -176,73 +222,91 @@ inline void collectNode(V node, QVector<T> &dst, int &dstPos)
 
     ++dstPos;
 }
-template <typename T, typename V>
-static inline void collectNodeFront(V node, QVector<T> &dst, int &dstPos)
-{
-    if (dstPos < dst.size())
-        dst[dst.size() - dstPos - 1] = node;
-    else
-        dst.push_front(node);
-
-    ++dstPos;
-}
+// Fraction of the mesh LOD threshold by which the screen size has to go past it
+// before switching levels, so that models do not flicker at the threshold.
+static constexpr float meshLodHysteresis = 0.1f;
 
 #define MAX_MORPH_TARGET 8
 #define MAX_MORPH_TARGET_INDEX_SUPPORTS_NORMALS 3
 #define MAX_MORPH_TARGET_INDEX_SUPPORTS_TANGENTS 1
 
-static bool maybeQueueNodeForRender(QSSGRenderNode &inNode,
-                                    QVector<QSSGRenderableNodeEntry> &outRenderableModels,
-                                    int &ioRenderableModelsCount,
-                                    QVector<QSSGRenderableNodeEntry> &outRenderableParticles,
-                                    int &ioRenderableParticlesCount,
-                                    QVector<QSSGRenderItem2D *> &outRenderableItem2Ds,
-                                    int &ioRenderableItem2DsCount,
-                                    QVector<QSSGRenderCamera *> &outCameras,
-                                    int &ioCameraCount,
-                                    QVector<QSSGRenderLight *> &outLights,
-                                    int &ioLightCount,
-                                    QVector<QSSGRenderReflectionProbe *> &outReflectionProbes,
-                                    int &ioReflectionProbeCount,
-                                    quint32 &ioDFSIndex)
-{
-    bool wasDirty = inNode.isDirty(QSSGRenderNode::DirtyFlag::GlobalValuesDirty) && inNode.calculateGlobalVariables();
-    if (inNode.getGlobalState(QSSGRenderNode::GlobalState::Active)) {
-        ++ioDFSIndex;
-        inNode.dfsIndex = ioDFSIndex;
+void QSSGLayerRenderData::collectNodes()
+{
+    const QSSGTransformHierarchy &hierarchy = transformHierarchy;
+    collectedNodes.models.clear();
+    collectedNodes.particles.clear();
+    collectedNodes.item2Ds.clear();
+    collectedNodes.cameras.clear();
+    collectedNodes.lights.clear();
+    collectedNodes.reflectionProbes.clear();
+    collectedNodes.lodGroups.clear();
+    collectedNodes.lodGroupLevelRanges.clear();
+
+    // The models of each level of a LOD group are collected as usual, but
+    // their range is recorded, see QSSGLayerRenderData::selectLodGroupLevels().
+    // A level is a child subtree of the LOD group.
+    struct LodGroupLevel
+    {
+        qsizetype lodGroup;
+        qint32 levelEnd;
+        qint32 lodGroupEnd;
+        int firstModel;
+    };
+    QVarLengthArray<LodGroupLevel, 4> lodGroupLevels;
+
+    quint32 dfsIndex = 0;
+    const qint32 nodeCount = qint32(hierarchy.size());
+    for (qint32 i = 0; ; ) {
+        while (!lodGroupLevels.isEmpty() && lodGroupLevels.last().levelEnd == i) {
+            auto &level = lodGroupLevels.last();
+            const int modelCount = int(collectedNodes.models.size());
+            collectedNodes.lodGroupLevelRanges[level.lodGroup].append({ level.firstModel, modelCount });
+            if (i == level.lodGroupEnd) {
+                lodGroupLevels.removeLast();
+            } else {
+                level.levelEnd = hierarchy.subtreeEnd(i);
+                level.firstModel = modelCount;
+                break;
+            }
+        }
+        if (i == nodeCount)
+            break;
+
+        QSSGRenderNode &inNode = *hierarchy.node(i);
+        if (!inNode.getGlobalState(QSSGRenderNode::GlobalState::Active)) {
+            i = hierarchy.subtreeEnd(i);
+            continue;
+        }
+
+        ++dfsIndex;
+        inNode.dfsIndex = dfsIndex;
         if (QSSGRenderGraphObject::isRenderable(inNode.type)) {
             if (inNode.type == QSSGRenderNode::Type::Model)
-                collectNode(QSSGRenderableNodeEntry(inNode), outRenderableModels, ioRenderableModelsCount);
+                collectedNodes.models.append(&inNode);
             else if (inNode.type == QSSGRenderNode::Type::Particles)
-                collectNode(QSSGRenderableNodeEntry(inNode), outRenderableParticles, ioRenderableParticlesCount);
+                collectedNodes.particles.append(&inNode);
             else if (inNode.type == QSSGRenderNode::Type::Item2D) // Pushing front to keep item order inside QML file
-                collectNodeFront(static_cast<QSSGRenderItem2D *>(&inNode), outRenderableItem2Ds, ioRenderableItem2DsCount);
+                collectedNodes.item2Ds.push_front(static_cast<QSSGRenderItem2D *>(&inNode));
         } else if (QSSGRenderGraphObject::isCamera(inNode.type)) {
-            collectNode(static_cast<QSSGRenderCamera *>(&inNode), outCameras, ioCameraCount);
+            collectedNodes.cameras.append(static_cast<QSSGRenderCamera *>(&inNode));
         } else if (QSSGRenderGraphObject::isLight(inNode.type)) {
-            if (auto &light = static_cast<QSSGRenderLight &>(inNode); light.isEnabled())
-                collectNode(&light, outLights, ioLightCount);
+            // Whether a light is enabled is checked every frame, see prepareForRender()
+            collectedNodes.lights.append(static_cast<QSSGRenderLight *>(&inNode));
         } else if (inNode.type == QSSGRenderGraphObject::Type::ReflectionProbe) {
-            collectNode(static_cast<QSSGRenderReflectionProbe *>(&inNode), outReflectionProbes, ioReflectionProbeCount);
+            collectedNodes.reflectionProbes.append(static_cast<QSSGRenderReflectionProbe *>(&inNode));
+        }
+
+        if (inNode.type == QSSGRenderGraphObject::Type::LodGroup) {
+            collectedNodes.lodGroups.append(static_cast<QSSGRenderLodGroup *>(&inNode));
+            collectedNodes.lodGroupLevelRanges.append({});
+            if (hierarchy.subtreeEnd(i) > i + 1) {
+                lodGroupLevels.append({ collectedNodes.lodGroups.size() - 1, hierarchy.subtreeEnd(i + 1),
+                                        hierarchy.subtreeEnd(i), int(collectedNodes.models.size()) });
+            }
         }
 
-        for (auto &theChild : inNode.children)
-            wasDirty |= maybeQueueNodeForRender(theChild,
-                                                outRenderableModels,
-                                                ioRenderableModelsCount,
-                                                outRenderableParticles,
-                                                ioRenderableParticlesCount,
-                                                outRenderableItem2Ds,
-                                                ioRenderableItem2DsCount,
-                                                outCameras,
-                                                ioCameraCount,
-                                                outLights,
-                                                ioLightCount,
-                                                outReflectionProbes,
-                                                ioReflectionProbeCount,
-                                                ioDFSIndex);
+        ++i;
     }
-    return wasDirty;
 }
 
 QSSGDefaultMaterialPreparationResult::QSSGDefaultMaterialPreparationResult(QSSGShaderDefaultMaterialKey inKey)
@@ -303,11 +367,23 @@ const QVector<QSSGRenderableObjectHandle> &QSSGLayerRenderData::getSortedOpaqueR
     if (layer.layerFlags.testFlag(QSSGRenderLayer::LayerFlag::EnableDepthTest))
         sortedOpaqueObjects = std::as_const(opaqueObjectStore)[index];
 
+    const qsizetype objectCount = sortedOpaqueObjects.size();
     const auto &clippingFrustum = getCameraRenderData(&camera).clippingFrustum;
     if (clippingFrustum.has_value()) { // Frustum culling
         const auto visibleObjects = QSSGLayerRenderData::frustumCullingInline(clippingFrustum.value(), sortedOpaqueObjects);
         sortedOpaqueObjects.resize(visibleObjects);
     }
+    const qsizetype frustumVisibleCount = sortedOpaqueObjects.size();
+    if (index == 0 && &camera == this->camera && occlusionCuller.isActive()) { // Occlusion culling
+        const auto visibleObjects = QSSGLayerRenderData::occlusionCullingInline(occlusionCuller, sortedOpaqueObjects);
+        sortedOpaqueObjects.resize(visibleObjects);
+    }
+    if (index == 0 && &camera == this->camera) {
+        QSSGRHICTX_STAT(renderer->contextInterface()->rhiContext().get(),
+                        culledObjects(false,
+                                      quint32(objectCount - frustumVisibleCount),
+                                      quint32(frustumVisibleCount - sortedOpaqueObjects.size())));
+    }
 
     // Render nearest to furthest objects
     std::sort(sortedOpaqueObjects.begin(), sortedOpaqueObjects.end(), nearestToFurthestCompare);
@@ -331,11 +407,23 @@ const QVector<QSSGRenderableObjectHandle> &QSSGLayerRenderData::getSortedTranspa
         sortedTransparentObjects.append(opaqueObjects);
     }
 
+    const qsizetype objectCount = sortedTransparentObjects.size();
     const auto &clippingFrustum = getCameraRenderData(&camera).clippingFrustum;
     if (clippingFrustum.has_value()) { // Frustum culling
         const auto visibleObjects = QSSGLayerRenderData::frustumCullingInline(clippingFrustum.value(), sortedTransparentObjects);
         sortedTransparentObjects.resize(visibleObjects);
     }
+    const qsizetype frustumVisibleCount = sortedTransparentObjects.size();
+    if (index == 0 && &camera == this->camera && occlusionCuller.isActive()) { // Occlusion culling
+        const auto visibleObjects = QSSGLayerRenderData::occlusionCullingInline(occlusionCuller, sortedTransparentObjects);
+        sortedTransparentObjects.resize(visibleObjects);
+    }
+    if (index == 0 && &camera == this->camera) {
+        QSSGRHICTX_STAT(renderer->contextInterface()->rhiContext().get(),
+                        culledObjects(true,
+                                      quint32(objectCount - frustumVisibleCount),
+                                      quint32(frustumVisibleCount - sortedTransparentObjects.size())));
+    }
 
     // render furthest to nearest.
     std::sort(sortedTransparentObjects.begin(), sortedTransparentObjects.end(), furthestToNearestCompare);
@@ -1388,7 +1476,8 @@ void QSSGLayerRenderData::prepareModelMeshes(const QSSGRenderContextInterface &c
             const bool canModelBePickable = (model.globalOpacity > QSSG_RENDER_MINIMUM_RENDER_OPACITY)
                     && (globalPickingEnabled
                         || model.getGlobalState(QSSGRenderModel::GlobalState::Pickable));
-            if (canModelBePickable) {
+            // Occluders are rasterized from the triangles of the BVH too
+            if (canModelBePickable || model.occluder) {
                 // Check if there is BVH data, if not generate it
                 if (!theMesh->bvh) {
                     if (!model.meshPath.isNull())
@@ -1454,6 +1543,164 @@ QRhiTexture *QSSGLayerRenderData::getBonemapTexture(const QSSGModelContext &mode
     return ret;
 }
 
+// Asks for the resolution the streamed textures of a subset need, from the
+// size of the subset on screen. This assumes that the UVs span the texture
+// once over the subset, which holds well enough for most models.
+static void requestTextureDetail(QSSGBufferManager &bufferManager,
+                                 const QSSGRenderableImage *firstImage,
+                                 const QSSGBounds3 &bounds,
+                                 const QMatrix4x4 &globalTransform,
+                                 const QSSGRenderCamera &camera,
+                                 float viewportHeight)
+{
+    QSSGBounds3 transformedBounds = bounds;
+    transformedBounds.transform(globalTransform);
+    const QMatrix4x4 &projection = camera.projection;
+    const bool orthographic = qFuzzyIsNull(projection(3, 2));
+    const float radius = transformedBounds.extents().length();
+    float distance = 1.0f;
+    if (!orthographic)
+        distance = qMax((transformedBounds.center() - camera.getGlobalPos()).length() - radius, camera.clipNear);
+    const float screenSize = radius * projection(1, 1) * viewportHeight / qMax(distance, std::numeric_limits<float>::epsilon());
+
+    for (const QSSGRenderableImage *image = firstImage; image; image = image->m_nextImage) {
+        const QVector2D &tiling = image->m_imageNode.m_scale;
+        const float repeat = qMax(1.0f, qMax(qAbs(tiling.x()), qAbs(tiling.y())));
+        bufferManager.requestTextureDetail(&image->m_imageNode, screenSize * repeat);
+    }
+}
+
+// Visible meshlets next to each other are drawn with one call. When that still
+// leaves more draw calls than this, the ones with the fewest culled indices in
+// between are merged, drawing some culled triangles instead.
+static constexpr qsizetype maxMeshletDrawRanges = 16;
+
+void QSSGLayerRenderData::mergeMeshletDrawRanges(MeshletDrawRanges &ranges, qsizetype maxRanges)
+{
+    QSSG_ASSERT(maxRanges > 0, maxRanges = 1);
+    if (ranges.isEmpty())
+        return;
+
+    qsizetype last = 0;
+    for (qsizetype i = 1; i < ranges.size(); ++i) {
+        QSSGSubsetRenderable::DrawRange &previous = ranges[last];
+        if (previous.offset + previous.count == ranges.at(i).offset)
+            previous.count += ranges.at(i).count;
+        else
+            ranges[++last] = ranges.at(i);
+    }
+    ranges.resize(last + 1);
+
+    if (ranges.size() <= maxRanges)
+        return;
+
+    const qsizetype merges = ranges.size() - maxRanges;
+    QVarLengthArray<quint32, 256> gaps(ranges.size() - 1);
+    for (qsizetype i = 0; i < gaps.size(); ++i)
+        gaps[i] = ranges.at(i + 1).offset - (ranges.at(i).offset + ranges.at(i).count);
+    std::nth_element(gaps.begin(), gaps.begin() + merges - 1, gaps.end());
+    const quint32 maxGap = gaps.at(merges - 1);
+    qsizetype maxGapMerges = merges - std::count_if(gaps.cbegin(), gaps.cend(), [maxGap](quint32 gap) { return gap < maxGap; });
+
+    last = 0;
+    for (qsizetype i = 1; i < ranges.size(); ++i) {
+        QSSGSubsetRenderable::DrawRange &previous = ranges[last];
+        const quint32 gap = ranges.at(i).offset - (previous.offset + previous.count);
+        if (gap < maxGap || (gap == maxGap && maxGapMerges-- > 0))
+            previous.count = ranges.at(i).offset + ranges.at(i).count - previous.offset;
+        else
+            ranges[++last] = ranges.at(i);
+    }
+    ranges.resize(last + 1);
+}
+
+// Culls the meshlets of the subset of a renderable against the view frustum
+// and, for back face culled materials, the direction they are seen from, and
+// gives the renderable the index ranges of the remaining ones. Everything is
+// done in the model's local space, where the meshlet bounds are.
+static void cullMeshlets(QSSGRenderContextInterface &contextInterface,
+                         QSSGSubsetRenderable &renderable,
+                         const QSSGRenderCamera &camera,
+                         const QMatrix4x4 &globalTransform,
+                         bool cullBackFaces)
+{
+    const auto &meshlets = renderable.subset.meshlets;
+    const QMatrix4x4 &mvp = renderable.modelContext.modelViewProjection;
+
+    // Gribb-Hartmann, the near plane is the one for a [-1, 1] depth range,
+    // which is conservative for [0, 1].
+    QVector4D planes[5];
+    for (int i = 0; i < 3; ++i) {
+        planes[2 * i] = mvp.row(3) + mvp.row(i);
+        if (i < 2)
+            planes[2 * i + 1] = mvp.row(3) - mvp.row(i);
+    }
+    for (QVector4D &plane : planes) {
+        const float length = plane.toVector3D().length();
+        if (length > 0.0f)
+            plane /= length;
+    }
+
+    // Which side of a triangle faces the camera is only kept by transforms
+    // that scale uniformly and do not mirror.
+    bool coneCulling = false;
+    bool orthographic = false;
+    QVector3D localCamera;
+    if (cullBackFaces && camera.type != QSSGRenderGraphObject::Type::CustomCamera
+            && globalTransform.determinant() > 0.0) {
+        const QVector3D scale = QSSGUtils::mat44::getScale(globalTransform);
+        const float minScale = qMin(scale.x(), qMin(scale.y(), scale.z()));
+        const float maxScale = qMax(scale.x(), qMax(scale.y(), scale.z()));
+        bool invertible = false;
+        const QMatrix4x4 inverse = globalTransform.inverted(&invertible);
+        if (invertible && maxScale <= minScale * 1.001f) {
+            coneCulling = true;
+            orthographic = (camera.type == QSSGRenderGraphObject::Type::OrthographicCamera);
+            if (orthographic)
+                localCamera = inverse.mapVector(camera.getScalingCorrectDirection()).normalized();
+            else
+                localCamera = inverse.map(camera.getGlobalPos());
+        }
+    }
+
+    const auto isVisible = [&](const QSSGRenderSubset::Meshlet &meshlet) {
+        const QVector4D center(meshlet.center, 1.0f);
+        for (const QVector4D &plane : planes) {
+            if (QVector4D::dotProduct(plane, center) < -meshlet.radius)
+                return false;
+        }
+        if (coneCulling) {
+            const QVector3D viewDirection = orthographic ? localCamera : (meshlet.coneApex - localCamera).normalized();
+            if (QVector3D::dotProduct(viewDirection, meshlet.coneAxis) >= meshlet.coneCutoff)
+                return false;
+        }
+        return true;
+    };
+
+    using DrawRange = QSSGSubsetRenderable::DrawRange;
+    QSSGLayerRenderData::MeshletDrawRanges ranges;
+    quint32 visibleCount = 0;
+    for (const auto &meshlet : meshlets) {
+        if (!isVisible(meshlet))
+            continue;
+        visibleCount += meshlet.count;
+        ranges.append({ meshlet.count, meshlet.offset });
+    }
+
+    // Nothing culled, draw the subset as usual
+    if (visibleCount == renderable.subset.count)
+        return;
+
+    QSSGLayerRenderData::mergeMeshletDrawRanges(ranges, maxMeshletDrawRanges);
+
+    if (!ranges.isEmpty()) {
+        auto visibleRanges = RENDER_FRAME_NEW_BUFFER<DrawRange>(contextInterface, ranges.size());
+        std::copy(ranges.cbegin(), ranges.cend(), visibleRanges.begin());
+        renderable.visibleRanges = QSSGDataView<DrawRange>(visibleRanges.begin(), visibleRanges.size());
+    }
+    renderable.hasVisibleRanges = true;
+}
+
 // inModel is const to emphasize the fact that its members cannot be written
 // here: in case there is a scene shared between multiple View3Ds in different
 // QQuickWindows, each window may run this in their own render thread, while
@@ -1475,6 +1722,10 @@ bool QSSGLayerRenderData::prepareModelsForRender(QSSGRenderContextInterface &con
     const auto &debugDrawSystem = contextInterface.debugDrawSystem();
     const bool maybeDebugDraw = debugDrawSystem && debugDrawSystem->isEnabled();
 
+    const bool streamTextures = bufferManager->isTextureStreamingEnabled();
+    const float viewportHeight = contextInterface.renderer()->viewport().height();
+    static const bool meshletCullingEnabled = !qEnvironmentVariableIntValue("QT_QUICK3D_DISABLE_MESHLET_CULLING");
+
     bool wasDirty = false;
 
     for (const QSSGRenderableNodeEntry &renderable : renderableModels) {
@@ -1566,6 +1817,21 @@ bool QSSGLayerRenderData::prepareModelsForRender(QSSGRenderContextInterface &con
         bool usesBlendParticles = particlesEnabled && theModelContext.model.particleBuffer != nullptr
                 && model.particleBuffer->particleCount();
 
+        // Skinning and morphing done once in a compute pre-pass instead of in
+        // the vertex shader of every pass drawing the model. Instancing, blend
+        // particles and custom vertex shaders still deform in the vertex shader.
+        if (layer.skinningPrePassEnabled && meshSubsetCount > 0 && !model.instancing() && !usesBlendParticles
+                && (model.usesBoneTexture() || meshSubsets.at(0).rhi.targetsTexture)) {
+            const bool hasCustomVertexShader = std::any_of(renderable.materials.cbegin(), renderable.materials.cend(),
+                                                           [](const QSSGRenderGraphObject *material) {
+                return material && material->type == QSSGRenderGraphObject::Type::CustomMaterial
+                        && static_cast<const QSSGRenderCustomMaterial *>(material)->m_customShaderPresence.testFlag(QSSGRenderCustomMaterial::CustomShaderPresenceFlag::Vertex);
+            });
+            if (!hasCustomVertexShader)
+                theModelContext.skinnedVertexBuffer = skinningPass.prepareModel(*rhiCtx, model, meshSubsets.at(0), getBonemapTexture(theModelContext));
+        }
+        const bool preSkinned = (theModelContext.skinnedVertexBuffer != nullptr);
+
         // Subset(s)
         auto &renderableSubsets = theModelContext.subsets;
         const auto &materials = renderable.materials;
@@ -1629,22 +1895,29 @@ bool QSSGLayerRenderData::prepareModelsForRender(QSSGRenderContextInterface &con
                     distanceThreshold = 1.0;
                 }
 
-                int currentLod = -1;
+                // Any level of detail within the hysteresis band around the
+                // threshold is acceptable, the one from the previous frame is
+                // kept if it is one of them.
+                int minLod = -1;
+                int maxLod = -1;
                 if (model.levelOfDetailBias > 0.0f) {
                     const float threshold = distanceThreshold * lodDistanceMultiplier;
                     const float modelBias = 1 / model.levelOfDetailBias;
                     for (qsizetype i = 0; i < theSubset.lods.count(); ++i) {
                         float subsetDistance = theSubset.lods[i].distance * modelScale * modelBias;
                         float screenSize = subsetDistance / threshold;
-                        if (screenSize > lodThreshold)
+                        if (screenSize > lodThreshold * (1.0f + meshLodHysteresis))
                             break;
-                        currentLod = i;
+                        maxLod = i;
+                        if (screenSize <= lodThreshold * (1.0f - meshLodHysteresis))
+                            minLod = i;
                     }
                 }
-                if (currentLod == -1)
-                    subsetLevelOfDetail = 0;
-                else
-                    subsetLevelOfDetail = currentLod + 1;
+                auto &previousLods = model.subsetLevelsOfDetail;
+                if (previousLods.size() <= idx)
+                    previousLods.resize(idx + 1, quint32(maxLod + 1));
+                subsetLevelOfDetail = qBound(quint32(minLod + 1), previousLods[idx], quint32(maxLod + 1));
+                previousLods[idx] = subsetLevelOfDetail;
                 if (maybeDebugDraw && debugDrawSystem->isEnabled(QSSGDebugDrawSystem::Mode::MeshLod))
                     debugDrawSystem->drawBounds(transformedBounds, QSSGDebugDrawSystem::levelOfDetailColor(subsetLevelOfDetail));
             }
@@ -1665,20 +1938,25 @@ bool QSSGLayerRenderData::prepareModelsForRender(QSSGRenderContextInterface &con
                 wasDirty |= theMaterialPrepResult.dirty;
                 renderableFlags = theMaterialPrepResult.renderableFlags;
 
+                if (streamTextures && firstImage)
+                    requestTextureDetail(*bufferManager, firstImage, theSubset.bounds, globalTransform, camera, viewportHeight);
+
                 // Blend particles
                 defaultMaterialShaderKeyProperties.m_blendParticles.setValue(theGeneratedKey, usesBlendParticles);
+                // LOD group cross-fade
+                defaultMaterialShaderKeyProperties.m_lodCrossFade.setValue(theGeneratedKey, renderable.lodCrossFade != 0.0f);
 
                 // Skin
                 const auto boneCount = model.skin ? model.skin->boneCount :
                                                     model.skeleton ? model.skeleton->boneCount : 0;
-                defaultMaterialShaderKeyProperties.m_boneCount.setValue(theGeneratedKey, boneCount);
+                defaultMaterialShaderKeyProperties.m_boneCount.setValue(theGeneratedKey, preSkinned ? 0 : boneCount);
                 defaultMaterialShaderKeyProperties.m_usesFloatJointIndices.setValue(
                         theGeneratedKey, !rhiCtx->rhi()->isFeatureSupported(QRhi::IntAttributes));
                 // Instancing
                 defaultMaterialShaderKeyProperties.m_usesInstancing.setValue(theGeneratedKey, usesInstancing);
                 // Morphing
                 defaultMaterialShaderKeyProperties.m_targetCount.setValue(theGeneratedKey,
-                                        theSubset.rhi.ia.targetCount);
+                                        preSkinned ? 0 : theSubset.rhi.ia.targetCount);
                 defaultMaterialShaderKeyProperties.m_targetPositionOffset.setValue(theGeneratedKey,
                                         theSubset.rhi.ia.targetOffsets[QSSGRhiInputAssemblerState::PositionSemantic]);
                 defaultMaterialShaderKeyProperties.m_targetNormalOffset.setValue(theGeneratedKey,
@@ -1726,10 +2004,13 @@ bool QSSGLayerRenderData::prepareModelsForRender(QSSGRenderContextInterface &con
                 else
                     defaultMaterialShaderKeyProperties.m_blendParticles.setValue(theGeneratedKey, false);
 
+                // LOD group cross-fade
+                defaultMaterialShaderKeyProperties.m_lodCrossFade.setValue(theGeneratedKey, renderable.lodCrossFade != 0.0f);
+
                 // Skin
                 const auto boneCount = model.skin ? model.skin->boneCount :
                                                     model.skeleton ? model.skeleton->boneCount : 0;
-                defaultMaterialShaderKeyProperties.m_boneCount.setValue(theGeneratedKey, boneCount);
+                defaultMaterialShaderKeyProperties.m_boneCount.setValue(theGeneratedKey, preSkinned ? 0 : boneCount);
                 defaultMaterialShaderKeyProperties.m_usesFloatJointIndices.setValue(
                         theGeneratedKey, !rhiCtx->rhi()->isFeatureSupported(QRhi::IntAttributes));
 
@@ -1739,7 +2020,7 @@ bool QSSGLayerRenderData::prepareModelsForRender(QSSGRenderContextInterface &con
                 defaultMaterialShaderKeyProperties.m_usesInstancing.setValue(theGeneratedKey, usesInstancing);
                 // Morphing
                 defaultMaterialShaderKeyProperties.m_targetCount.setValue(theGeneratedKey,
-                                        theSubset.rhi.ia.targetCount);
+                                        preSkinned ? 0 : theSubset.rhi.ia.targetCount);
                 defaultMaterialShaderKeyProperties.m_targetPositionOffset.setValue(theGeneratedKey,
                                         theSubset.rhi.ia.targetOffsets[QSSGRhiInputAssemblerState::PositionSemantic]);
                 defaultMaterialShaderKeyProperties.m_targetNormalOffset.setValue(theGeneratedKey,
@@ -1771,8 +2052,32 @@ bool QSSGLayerRenderData::prepareModelsForRender(QSSGRenderContextInterface &con
                                                                theGeneratedKey,
                                                                lights);
             }
-            if (theRenderableObject) // NOTE: Should just go in with the ctor args
+            if (theRenderableObject) { // NOTE: Should just go in with the ctor args
                 theRenderableObject->camdistSq = getCameraDistanceSq(*theRenderableObject, cameraData);
+                static_cast<QSSGSubsetRenderable *>(theRenderableObject)->lodCrossFade = renderable.lodCrossFade;
+            }
+
+            // Meshlets are only culled when their bounds hold for what is
+            // drawn, so not for skinned, morphed, instanced or displaced
+            // geometry, and only for the full level of detail.
+            if (meshletCullingEnabled && !theSubset.meshlets.isEmpty() && subsetLevelOfDetail == 0
+                    && theSubset.rhi.ia.topology == QRhiGraphicsPipeline::Triangles
+                    && theSubset.rhi.indexBuffer && !theSubset.rhi.targetsTexture
+                    && !model.usesBoneTexture() && !model.instancing() && !usesBlendParticles) {
+                QSSGCullFaceMode cullMode = QSSGCullFaceMode::Back;
+                bool displaced = false;
+                if (theMaterialObject->type == QSSGRenderGraphObject::Type::CustomMaterial) {
+                    const auto &customMaterial = static_cast<const QSSGRenderCustomMaterial &>(*theMaterialObject);
+                    cullMode = customMaterial.m_cullMode;
+                    displaced = customMaterial.m_customShaderPresence.testFlag(QSSGRenderCustomMaterial::CustomShaderPresenceFlag::Vertex);
+                } else {
+                    cullMode = static_cast<const QSSGRenderDefaultMaterial &>(*theMaterialObject).cullMode;
+                }
+                if (!displaced) {
+                    cullMeshlets(contextInterface, static_cast<QSSGSubsetRenderable &>(*theRenderableObject),
+                                 camera, globalTransform, cullMode == QSSGCullFaceMode::Back);
+                }
+            }
         }
 
         // If the indices don't match then something's off and we need to adjust the subset renderable list size.
@@ -1890,13 +2195,18 @@ bool QSSGLayerRenderData::prepareParticlesForRender(const RenderableNodeEntries
 }
 
 bool QSSGLayerRenderData::prepareItem2DsForRender(const QSSGRenderContextInterface &ctxIfc,
-                                                  const RenderableItem2DEntries &renderableItem2Ds)
+                                                  RenderableItem2DEntries &renderableItem2Ds)
 {
     const bool hasItems = (renderableItem2Ds.size() != 0);
     if (hasItems) {
         const auto &clipSpaceCorrMatrix = ctxIfc.rhiContext()->rhi()->clipSpaceCorrMatrix();
         auto cameraData = getCachedCameraData();
-        for (const auto &theItem2D : renderableItem2Ds) {
+        if (cameraData.clippingFrustum.has_value()) { // Frustum culling
+            const qsizetype visibleCount = frustumCullingInline(cameraData.clippingFrustum.value(), renderableItem2Ds);
+            renderableItem2Ds.resize(visibleCount);
+        }
+        for (const auto &theItem2D : std::as_const(renderableItem2Ds)) {
+            theItem2D->combinedOpacity = theItem2D->globalOpacity;
             theItem2D->MVP = cameraData.viewProjection * theItem2D->globalTransform;
             static const QMatrix4x4 flipMatrix(1.0f, 0.0f, 0.0f, 0.0f,
                                                0.0f, -1.0f, 0.0f, 0.0f,
@@ -1918,11 +2228,73 @@ void QSSGLayerRenderData::prepareResourceLoaders()
         bufferManager->processResourceLoader(static_cast<QSSGRenderResourceLoader *>(resourceLoader));
 }
 
+void QSSGLayerRenderData::selectLodGroupLevels(const QSSGRenderCamera &camera, float viewportHeight)
+{
+    if (lodGroups.isEmpty())
+        return;
+
+    // The screen-space error of a level is its geometric error projected at
+    // the position of the group. The distance is not measured along the view
+    // direction, so that just turning the camera does not change the levels.
+    const QMatrix4x4 &projection = camera.projection;
+    const bool orthographic = qFuzzyIsNull(projection(3, 2));
+    const float pixelScale = projection(1, 1) * 0.5f * viewportHeight / renderer->dpr();
+    const QVector3D cameraPosition = camera.getGlobalPos();
+
+    bool hasHiddenModels = false;
+    const auto hideLevel = [&](const std::pair<int, int> &range) {
+        for (int i = range.first; i < range.second; ++i)
+            renderableModels[i].node = nullptr;
+        hasHiddenModels |= (range.first != range.second);
+    };
+    const auto setCrossFade = [&](const std::pair<int, int> &range, float crossFade) {
+        for (int i = range.first; i < range.second; ++i)
+            renderableModels[i].lodCrossFade = crossFade;
+    };
+
+    for (QSSGRenderLodGroup *lodGroup : std::as_const(lodGroups)) {
+        const auto &ranges = lodGroup->levelModelRanges;
+        // Children without an error are never shown
+        const qsizetype levelCount = qMin(ranges.size(), lodGroup->levelErrors.size());
+        for (qsizetype i = levelCount; i < ranges.size(); ++i)
+            hideLevel(ranges[i]);
+        if (levelCount == 0)
+            continue;
+
+        const float distance = orthographic ? 1.0f : (lodGroup->getGlobalPos() - cameraPosition).length();
+        const float pixelsPerUnit = pixelScale / qMax(distance, std::numeric_limits<float>::epsilon());
+        const auto selection = lodGroup->selectLevel(levelCount, pixelsPerUnit, camera.levelOfDetailPixelThreshold);
+
+        for (qsizetype i = 0; i < levelCount; ++i) {
+            if (i == selection.level)
+                setCrossFade(ranges[i], selection.crossFade);
+            else if (i == selection.fadeLevel)
+                setCrossFade(ranges[i], -selection.crossFade); // the complement of the dither pattern
+            else
+                hideLevel(ranges[i]);
+        }
+    }
+
+    if (hasHiddenModels)
+        renderableModels.removeIf([](const QSSGRenderableNodeEntry &e) { return e.isNull(); });
+}
+
 void QSSGLayerRenderData::prepareReflectionProbesForRender()
 {
     const auto probeCount = reflectionProbes.size();
     requestReflectionMapManager(); // ensure that we have a reflection map manager
 
+    // The probes see the whole scene, not only what is in the camera's view
+    QSSG_ASSERT(reflectionCasterObjects.isEmpty(), reflectionCasterObjects.clear());
+    if (probeCount > 0) {
+        for (const auto *objects : { &opaqueObjectStore[0], &transparentObjectStore[0], &screenTextureObjectStore[0] }) {
+            for (const auto &handle : *objects) {
+                if (handle.obj->renderableFlags.testFlag(QSSGRenderableObjectFlag::CastsReflections))
+                    reflectionCasterObjects.push_back(handle);
+            }
+        }
+    }
+
     for (int i = 0; i < probeCount; i++) {
         QSSGRenderReflectionProbe* probe = reflectionProbes.at(i);
 
@@ -1977,6 +2349,12 @@ void QSSGLayerRenderData::prepareReflectionProbesForRender()
         else if (reflectionObjectCount > 0)
             reflectionMapManager->addReflectionMapEntry(i, *probe);
     }
+
+    if (probeCount > 0 && camera) {
+        const auto &cameraData = getCachedCameraData();
+        reflectionMapManager->scheduleUpdates(reflectionProbes, reflectionCasterObjects, cameraData.position,
+                                              cameraData.clippingFrustum, renderer->frameCount());
+    }
 }
 
 static bool scopeLight(QSSGRenderNode *node, QSSGRenderNode *lightScope)
@@ -2015,7 +2393,9 @@ void updateDirtySkeletons(const QVector<QSSGRenderableNodeEntry> &renderableNode
                 const bool hasDirtyNonJoints = (skeletonNode->containsNonJointNodes
                                                 && (hasDirtyNonJointNodes(skeletonNode, hcj) || dirtySkeleton));
                 const bool dirtyTransform = skeletonNode->isDirty(QSSGRenderNode::DirtyFlag::TransformDirty);
+                bool boneDataChanged = false;
                 if (skeletonNode->skinningDirty || hasDirtyNonJoints || dirtyTransform) {
+                    boneDataChanged = true;
                     skeletonNode->boneTransformsDirty = false;
                     if (hasDirtyNonJoints && !dirtySkeleton)
                         dirtySkeletons.insert(skeletonNode);
@@ -2031,8 +2411,16 @@ void updateDirtySkeletons(const QVector<QSSGRenderableNodeEntry> &renderableNode
                 skeletonNode->boneCount = skeletonNode->boneData.size() / 2 / 4 / 16;
                 const int boneTexWidth = qCeil(qSqrt(skeletonNode->boneCount * 4 * 2));
                 skeletonNode->boneTexData.setSize(QSize(boneTexWidth, boneTexWidth));
-                skeletonNode->boneData.resize(boneTexWidth * boneTexWidth * 16);
-                skeletonNode->boneTexData.setTextureData(skeletonNode->boneData);
+                const qsizetype boneTexSize = boneTexWidth * boneTexWidth * 16;
+                if (skeletonNode->boneData.size() != boneTexSize) {
+                    skeletonNode->boneData.resize(boneTexSize);
+                    boneDataChanged = true;
+                }
+                // Only hand over the data when it changed, the bone texture is
+                // kept and just gets new contents uploaded as long as its size
+                // stays the same.
+                if (boneDataChanged)
+                    skeletonNode->boneTexData.setTextureData(skeletonNode->boneData);
             }
             const int numMorphTarget = modelNode->morphTargets.size();
             for (int i = 0; i < numMorphTarget; ++i) {
@@ -2056,6 +2444,9 @@ void QSSGLayerRenderData::prepareForRender()
 
     QRect theViewport(renderer->viewport());
 
+    // Hand over the result of a GPU pick query that completed since the last frame
+    gpuPickPass.publishResult(layer);
+
     // NOTE: The renderer won't change in practice (after being set the first time), but just update
     // it anyways.
     frameData.m_ctx = renderer->contextInterface();
@@ -2155,46 +2546,45 @@ void QSSGLayerRenderData::prepareForRender()
     }
 
     // Gather Spatial Nodes from Render Tree
+    // The tree is only walked again when a node was added, removed, shown or
+    // hidden since the last frame. Otherwise, only the global values of the
+    // dirty nodes are updated, and the lists below are refilled from the
+    // nodes collected the last time.
+    const bool nodesChanged = transformHierarchy.sync(layer);
+    wasDataDirty |= transformHierarchy.update();
+    if (nodesChanged)
+        collectNodes();
+
     // Do not just clear() renderableNodes and friends. Rather, reuse
     // the space (even if clear does not actually deallocate, it still
     // costs time to run dtors and such). In scenes with a static node
     // count in the range of thousands this may matter.
     int renderableModelsCount = 0;
     int renderableParticlesCount = 0;
-    int renderableItem2DsCount = 0;
-    int cameraNodeCount = 0;
     int lightNodeCount = 0;
-    int reflectionProbeCount = 0;
-    quint32 dfsIndex = 0;
-    for (auto &theChild : layer.children)
-        wasDataDirty |= maybeQueueNodeForRender(theChild,
-                                                renderableModels,
-                                                renderableModelsCount,
-                                                renderableParticles,
-                                                renderableParticlesCount,
-                                                renderableItem2Ds,
-                                                renderableItem2DsCount,
-                                                cameras,
-                                                cameraNodeCount,
-                                                lights,
-                                                lightNodeCount,
-                                                reflectionProbes,
-                                                reflectionProbeCount,
-                                                dfsIndex);
+    for (QSSGRenderNode *model : std::as_const(collectedNodes.models))
+        collectNode(QSSGRenderableNodeEntry(*model), renderableModels, renderableModelsCount);
+    for (QSSGRenderNode *particles : std::as_const(collectedNodes.particles))
+        collectNode(QSSGRenderableNodeEntry(*particles), renderableParticles, renderableParticlesCount);
+    for (QSSGRenderLight *light : std::as_const(collectedNodes.lights)) {
+        if (light->isEnabled())
+            collectNode(light, lights, lightNodeCount);
+    }
 
     if (renderableModels.size() != renderableModelsCount)
         renderableModels.resize(renderableModelsCount);
     if (renderableParticles.size() != renderableParticlesCount)
         renderableParticles.resize(renderableParticlesCount);
-    if (renderableItem2Ds.size() != renderableItem2DsCount)
-        renderableItem2Ds.resize(renderableItem2DsCount);
-
-    if (cameras.size() != cameraNodeCount)
-        cameras.resize(cameraNodeCount);
     if (lights.size() != lightNodeCount)
         lights.resize(lightNodeCount);
-    if (reflectionProbes.size() != reflectionProbeCount)
-        reflectionProbes.resize(reflectionProbeCount);
+
+    renderableItem2Ds = collectedNodes.item2Ds;
+    cameras = collectedNodes.cameras;
+    reflectionProbes = collectedNodes.reflectionProbes;
+    lodGroups = collectedNodes.lodGroups;
+    // Restored every frame, as a LOD group can be in the trees of more than one layer
+    for (qsizetype i = 0, end = lodGroups.size(); i != end; ++i)
+        lodGroups.at(i)->levelModelRanges = collectedNodes.lodGroupLevelRanges.at(i);
 
     // Cameras
     // 1. If there's an explicit camera set and it's active (visible) we'll use that.
@@ -2232,6 +2622,9 @@ void QSSGLayerRenderData::prepareForRender()
     if (camera) {
         camera->dpr = renderer->dpr();
         meshLodThreshold = camera->levelOfDetailPixelThreshold / theViewport.width();
+        // Drops the models of the levels that are not shown before anything
+        // else gets to look at them.
+        selectLodGroupLevels(*camera, theViewport.height());
     }
 
     layer.renderedCamera = camera;
@@ -2381,6 +2774,7 @@ void QSSGLayerRenderData::prepareForRender()
     if (camera) { // NOTE: We shouldn't really get this far without a camera...
         const auto &cameraData = getCachedCameraData();
         wasDirty |= prepareModelsForRender(*renderer->contextInterface(), renderableModels, layerPrepResult.flags, *camera, cameraData, modelContexts, opaqueObjects, transparentObjects, screenTextureObjects, meshLodThreshold);
+        prepareOcclusionCulling(renderableModels, cameraData);
         if (particlesEnabled)
             wasDirty |= prepareParticlesForRender(renderableParticles, cameraData);
         wasDirty |= prepareItem2DsForRender(*renderer->contextInterface(), renderableItem2Ds);
@@ -2432,7 +2826,8 @@ void QSSGLayerRenderData::prepareForRender()
         }
     }
 
-    const bool hasItem2Ds = (renderableItem2DsCount > 0);
+    // Item2Ds may have been culled in prepareItem2DsForRender()
+    const bool hasItem2Ds = !renderableItem2Ds.isEmpty();
     const bool layerEnableDepthTest = layer.layerFlags.testFlag(QSSGRenderLayer::LayerFlag::EnableDepthTest);
     const bool layerEnabledDepthPrePass = layer.layerFlags.testFlag(QSSGRenderLayer::LayerFlag::EnableDepthPrePass);
     const bool depthTestEnableDefault = layerEnableDepthTest && (!opaqueObjects.isEmpty() || depthPrepassObjectsState || hasDepthWriteObjects);
@@ -2445,6 +2840,13 @@ void QSSGLayerRenderData::prepareForRender()
 
     // Prepare passes
     QSSG_ASSERT(activePasses.isEmpty(), activePasses.clear());
+    // Skinning and morphing pre-pass. Must come first since all other passes
+    // draw the deformed vertex buffers it produces.
+    if (skinningPass.hasWork())
+        activePasses.push_back(&skinningPass);
+    else
+        skinningPass.releaseResources();
+
     // If needed, generate a depth texture with the opaque objects. This
     // and the SSAO texture must come first since other passes may want to
     // expose these textures to their shaders.
@@ -2469,6 +2871,10 @@ void QSSGLayerRenderData::prepareForRender()
     // Reflection pass
     activePasses.push_back(&reflectionMapPass);
 
+    // GPU picking, renders the ids of the objects under the queried pixel.
+    if (layer.gpuPick.requested)
+        activePasses.push_back(&gpuPickPass);
+
     auto &underlayPass = userPasses[size_t(QSSGRenderLayer::RenderExtensionStage::Underlay)];
     if (underlayPass.hasData())
         activePasses.push_back(&underlayPass);
@@ -2506,6 +2912,92 @@ void QSSGLayerRenderData::prepareForRender()
 
     if (const auto &dbgDrawSystem = renderer->contextInterface()->debugDrawSystem(); dbgDrawSystem && dbgDrawSystem->isEnabled() && dbgDrawSystem->hasContent())
         activePasses.push_back(&debugDrawPass);
+
+    cullUnusedPasses();
+}
+
+void QSSGLayerRenderData::cullUnusedPasses()
+{
+    // Effects run after the layer is rendered and may sample the depth texture.
+    quint32 usedResults = 0;
+    for (QSSGRenderEffect *theEffect = layer.firstEffect; theEffect; theEffect = theEffect->m_nextEffect) {
+        if (theEffect->requiresDepthTexture)
+            usedResults |= QSSGRenderPass::renderResultBit(QSSGFrameData::RenderResult::DepthTexture);
+    }
+
+    // Walk the passes backwards, so that a pass producing render results is
+    // only kept when one of the passes following it reads them.
+    for (qsizetype i = activePasses.size() - 1; i >= 0; --i) {
+        const QSSGRenderPass *pass = activePasses[i];
+        const quint32 writes = pass->writes();
+        if (writes != 0 && (writes & usedResults) == 0) {
+            activePasses.remove(i);
+            continue;
+        }
+        usedResults |= pass->reads(*this);
+    }
+}
+
+static bool isDrawnOpaque(const QSSGModelContext &modelContext)
+{
+    if (modelContext.subsets.isEmpty())
+        return false;
+    for (const QSSGSubsetRenderable &subset : modelContext.subsets) {
+        if (subset.renderableFlags.hasTransparency() || subset.renderableFlags.requiresScreenTexture()
+                || subset.depthWriteMode == QSSGDepthDrawMode::Never) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void QSSGLayerRenderData::prepareOcclusionCulling(const RenderableNodeEntries &renderableModels, const QSSGCameraRenderData &cameraData)
+{
+    static const bool occlusionCullingEnabled = !qEnvironmentVariableIntValue("QT_QUICK3D_DISABLE_OCCLUSION_CULLING");
+
+    occlusionCuller.reset();
+    // Without depth testing the objects are drawn in the order they come and
+    // not hidden by the occluders
+    if (!occlusionCullingEnabled || !layer.layerFlags.testFlag(QSSGRenderLayer::LayerFlag::EnableDepthTest))
+        return;
+
+    // The contexts of the occluders, looked up once rather than per occluder
+    QHash<const QSSGRenderModel *, const QSSGModelContext *> occluderContexts;
+    for (const QSSGModelContext *context : std::as_const(modelContexts)) {
+        if (context->model.occluder)
+            occluderContexts.insert(&context->model, context);
+    }
+    if (occluderContexts.isEmpty())
+        return;
+
+    bool begun = false;
+    for (const QSSGRenderableNodeEntry &renderable : renderableModels) {
+        const QSSGRenderModel &model = *static_cast<QSSGRenderModel *>(renderable.node);
+        // The triangles of the BVH are not where instanced, skinned or
+        // morphed models are drawn
+        if (!model.occluder || !renderable.mesh || !renderable.mesh->bvh
+                || model.instancing() || model.usesBoneTexture() || !model.morphTargets.isEmpty()) {
+            continue;
+        }
+        // Only what is drawn opaque, with depth writes, hides what is behind it
+        const bool altModelOpacity = ((renderable.overridden & QSSGRenderableNodeEntry::Overridden::GlobalOpacity) != 0);
+        if ((altModelOpacity ? renderable.globalOpacity : model.globalOpacity) < 1.f - QSSG_RENDER_MINIMUM_RENDER_OPACITY)
+            continue;
+        const QSSGModelContext *context = occluderContexts.value(&model);
+        if (!context || !isDrawnOpaque(*context))
+            continue;
+
+        if (!begun) {
+            occlusionCuller.begin(cameraData.viewProjection, renderer->viewport().size());
+            begun = true;
+        }
+        const bool altGlobalTransform = ((renderable.overridden & QSSGRenderableNodeEntry::Overridden::GlobalTransform) != 0);
+        occlusionCuller.addOccluder(renderable.mesh->bvh->triangles(),
+                                    altGlobalTransform ? renderable.globalTransform : model.globalTransform);
+    }
+
+    if (begun)
+        occlusionCuller.end();
 }
 
 template<typename T>
@@ -2529,6 +3021,7 @@ void QSSGLayerRenderData::resetForFrame()
     renderedItem2Ds.clear();
     renderedBakedLightingModels.clear();
     renderableItem2Ds.clear();
+    reflectionCasterObjects.clear();
     lightmapTextures.clear();
     bonemapTextures.clear();
     globalLights.clear();
@@ -2551,6 +3044,19 @@ void QSSGLayerRenderData::resetForFrame()
     clearTable(sortedDepthWriteCache);
 }
 
+void QSSGLayerRenderData::releaseRenderResults()
+{
+    // The render results are only sampled while the layer's passes are
+    // recorded. Returning them to the pool when the layer is done lets a
+    // View3D rendered later in the frame reuse the memory, and frees the ones
+    // that are no longer needed at all.
+    QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(renderer->contextInterface()->rhiContext().get());
+    for (auto &renderResult : renderResults) {
+        rhiCtxD->cleanupTransientTextures(&renderResult);
+        rhiCtxD->releaseTransientTexture(&renderResult);
+    }
+}
+
 QSSGLayerRenderPreparationResult::QSSGLayerRenderPreparationResult(const QRectF &inViewport, QSSGRenderLayer &inLayer)
     : layer(&inLayer)
 {
@@ -2601,6 +3107,12 @@ QSSGLayerRenderData::~QSSGLayerRenderData()
 
     for (auto &renderResult : renderResults)
         renderResult.reset();
+
+    if (const auto *ctx = renderer ? renderer->contextInterface() : nullptr) {
+        QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(ctx->rhiContext().get());
+        for (const auto &renderResult : renderResults)
+            rhiCtxD->cleanupTransientTextures(&renderResult);
+    }
 }
 
 static void sortInstances(QByteArray &sortedData, QList<QSSGRhiSortData> &sortData, const void *instances,
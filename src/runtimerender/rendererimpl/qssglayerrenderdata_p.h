@@ -32,6 +32,8 @@
 #include <QtQuick3DRuntimeRender/private/qssgrendermaterialshadergenerator_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgshadermapkey_p.h>
 #include <QtQuick3DRuntimeRender/private/qssglightmapper_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgtransformhierarchy_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgocclusionculler_p.h>
 #include <ssg/qssgrenderextensions.h>
 
 #include <QtQuick3DUtils/private/qssgrenderbasetypes_p.h>
@@ -46,6 +48,7 @@
 QT_BEGIN_NAMESPACE
 
 struct QSSGRenderableObject;
+struct QSSGRenderLodGroup;
 
 enum class QSSGLayerRenderPreparationResultFlag
 {
@@ -222,16 +225,27 @@ public:
                                 float lodThreshold = 0.0f);
     bool prepareParticlesForRender(const RenderableNodeEntries &renderableParticles, const QSSGCameraRenderData &cameraData);
     bool prepareItem2DsForRender(const QSSGRenderContextInterface &ctxIfc,
-                                 const RenderableItem2DEntries &renderableItem2Ds);
+                                 RenderableItem2DEntries &renderableItem2Ds);
 
     void prepareResourceLoaders();
 
     void prepareForRender();
-    // Helper function used during prepareForRender
+    // Helper functions used during prepareForRender
     void prepareReflectionProbesForRender();
+    void selectLodGroupLevels(const QSSGRenderCamera &camera, float viewportHeight);
+    void cullUnusedPasses();
+    void prepareOcclusionCulling(const RenderableNodeEntries &renderableModels, const QSSGCameraRenderData &cameraData);
 
     static qsizetype frustumCulling(const QSSGClippingFrustum &clipFrustum, const QSSGRenderableObjectList &renderables, QSSGRenderableObjectList &visibleRenderables);
     [[nodiscard]] static qsizetype frustumCullingInline(const QSSGClippingFrustum &clipFrustum, QSSGRenderableObjectList &renderables);
+    [[nodiscard]] static qsizetype frustumCullingInline(const QSSGClippingFrustum &clipFrustum, RenderableItem2DEntries &item2Ds);
+    [[nodiscard]] static qsizetype occlusionCullingInline(const QSSGOcclusionCuller &occlusionCuller, QSSGRenderableObjectList &renderables);
+
+    // Joins the index ranges of the visible meshlets of a subset, given in
+    // order, where they are adjacent, then merges the ones with the smallest
+    // gaps in between until no more than maxRanges are left.
+    using MeshletDrawRanges = QVarLengthArray<QSSGSubsetRenderable::DrawRange, 256>;
+    static void mergeMeshletDrawRanges(MeshletDrawRanges &ranges, qsizetype maxRanges);
 
 
     // Per-frame cache of renderable objects post-sort (for the MAIN rendering camera, i.e., don't use these lists for rendering from a different camera).
@@ -245,16 +259,21 @@ public:
     const QSSGRenderableObjectList &getSortedrenderedOpaqueDepthPrepassObjects(const QSSGRenderCamera &camera, size_t index = 0);
 
     void resetForFrame();
+    // Hands the render results to the pool of the rhi context once the layer
+    // is done with them for the frame.
+    void releaseRenderResults();
 
     void maybeBakeLightmap();
 
     QSSGFrameData &getFrameData();
 
+    SkinningPass skinningPass;
     ShadowMapPass shadowMapPass;
     ReflectionMapPass reflectionMapPass;
     ZPrePassPass zPrePassPass;
     SSAOMapPass ssaoMapPass;
     DepthMapPass depthMapPass;
+    GpuPickPass gpuPickPass;
     ScreenMapPass screenMapPass;
     ScreenReflectionPass reflectionPass;
     Item2DPass item2DPass;
@@ -282,6 +301,7 @@ public:
     QVector<QSSGRenderCamera *> cameras;
     QVector<QSSGRenderLight *> lights;
     QVector<QSSGRenderReflectionProbe *> reflectionProbes;
+    QVector<QSSGRenderLodGroup *> lodGroups;
 
     // Results of prepare for render.
     QSSGRenderCamera *camera = nullptr;
@@ -292,6 +312,8 @@ public:
     // it is simplest to duplicate the lists.
     QVector<QSSGBakedLightingModel> renderedBakedLightingModels;
     RenderableItem2DEntries renderedItem2Ds;
+    // The objects drawn into the reflection probes, from the whole scene
+    QSSGRenderableObjectList reflectionCasterObjects;
 
     QSSGLayerRenderPreparationResult layerPrepResult;
     std::optional<QSSGCameraRenderData> cameraData;
@@ -463,6 +485,25 @@ private:
 
     // Persistent data
     QHash<QSSGShaderMapKey, QSSGRhiShaderPipelinePtr> shaderMap;
+    QSSGTransformHierarchy transformHierarchy;
+    // Filled with the occluder models seen from the main camera every frame
+    QSSGOcclusionCuller occlusionCuller;
+    // The active nodes of the layer, in depth-first order, collected again
+    // only when the structure of the tree or the active state of a node
+    // changes. The lists used for rendering are refilled from these.
+    struct CollectedNodes
+    {
+        QVector<QSSGRenderNode *> models;
+        QVector<QSSGRenderNode *> particles;
+        RenderableItem2DEntries item2Ds;
+        QVector<QSSGRenderCamera *> cameras;
+        QVector<QSSGRenderLight *> lights; // Including the disabled ones
+        QVector<QSSGRenderReflectionProbe *> reflectionProbes;
+        QVector<QSSGRenderLodGroup *> lodGroups;
+        QVector<QVarLengthArray<std::pair<int, int>, 4>> lodGroupLevelRanges;
+    };
+    CollectedNodes collectedNodes;
+    void collectNodes();
 
     // Note: Re-used to avoid expensive initialization.
     // - Should be revisit, as we can do better.
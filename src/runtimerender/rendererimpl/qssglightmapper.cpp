@@ -7,12 +7,19 @@
 #include <QtQuick3DRuntimeRender/private/qssglayerrenderdata_p.h>
 #include "../qssgrendercontextcore.h"
 #include <QtQuick3DUtils/private/qssgutils_p.h>
+#include <QtQuick3DUtils/private/qssgassert_p.h>
 
 #ifdef QT_QUICK3D_HAS_LIGHTMAPPER
 #include <QtCore/qfuture.h>
+#include <QtCore/qscopeguard.h>
+#include <QtCore/qsemaphore.h>
 #include <QtCore/qfileinfo.h>
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdatastream.h>
 #include <QtConcurrent/qtconcurrentrun.h>
-#include <QRandomGenerator>
+#include <QtConcurrent/qtconcurrentmap.h>
+#include <atomic>
+#include <numeric>
 #include <qsimd.h>
 #include <embree3/rtcore.h>
 #include <tinyexr.h>
@@ -114,6 +121,7 @@ struct QSSGLightmapperPrivate
         bool isValid() const { return !worldPos.isNull() && !normal.isNull(); }
         QVector3D directLight;
         QVector3D allLight;
+        QVector3D indirectLight; // sum of all the indirect samples computed so far
     };
     struct Lightmap {
         Lightmap(const QSize &pixelSize) : pixelSize(pixelSize) {
@@ -123,6 +131,9 @@ struct QSSGLightmapperPrivate
         QVector<LightmapEntry> entries;
         QByteArray imageFP32;
         bool hasBaseColorTransparency = false;
+        quint32 seed = 0;
+        int indirectSamples = 0; // number of samples accumulated in indirectLight
+        QByteArray bakeSignature; // only set when options.incrementalBaking == true
     };
     QVector<Lightmap> lightmaps;
     QVector<int> geomLightmapMap; // [geomId] -> index in lightmaps (NB lightmap is per-model, geomId is per-submesh)
@@ -147,7 +158,10 @@ struct QSSGLightmapperPrivate
     bool commitGeometry();
     bool prepareLightmaps();
     void computeDirectLight();
-    void computeIndirectLight();
+    void computeIndirectLight(int passSampleCount);
+    QByteArray bakeSignature(int lmIdx) const;
+    void loadBakeStates();
+    bool storeBakeStates();
     bool postProcess();
     bool storeLightmaps();
     void sendOutputInfo(QSSGLightmapper::BakingStatus type, std::optional<QString> msg);
@@ -226,28 +240,42 @@ static const unsigned int LIGHTMAP_UV_SLOT = 1;
 
 static void embreeFilterFunc(const RTCFilterFunctionNArguments *args)
 {
-    RTCHit *hit = reinterpret_cast<RTCHit *>(args->hit);
     QSSGLightmapperPrivate *d = static_cast<QSSGLightmapperPrivate *>(args->geometryUserPtr);
-    RTCGeometry geom = rtcGetGeometry(d->rscene, hit->geomID);
-
-    // convert from barycentric and overwrite u and v in hit with the result
-    rtcInterpolate0(geom, hit->primID, hit->u, hit->v, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, LIGHTMAP_UV_SLOT, &hit->u, 2);
-
-    const float opacity = d->subMeshOpacityMap[hit->geomID];
-    if (opacity < 1.0f || d->lightmaps[d->geomLightmapMap[hit->geomID]].hasBaseColorTransparency) {
-        const QSSGLightmapperPrivate::LightmapEntry &texel(d->texelForLightmapUV(hit->geomID, hit->u, hit->v));
-
-        // In addition to material.opacity, take at least the base color (both
-        // the static color and the value from the base color map, if there is
-        // one) into account. Opacity map, alpha cutoff, etc. are ignored.
-        const float alpha = opacity * texel.baseColor.w();
-
-        // Ignore the hit if the alpha is low enough. This is not exactly perfect,
-        // but better than nothing. An object with an opacity lower than the
-        // threshold will act is if it was not there, as far as the intersection is
-        // concerned. So then the object won't cast shadows for example.
-        if (alpha < d->options.opacityThreshold)
-            args->valid[0] = 0;
+
+    // Called either for a single ray or for (a subset of) a ray packet,
+    // hence work with the RTCHitN accessors and process each valid lane.
+    for (unsigned int i = 0; i < args->N; ++i) {
+        if (args->valid[i] == 0)
+            continue;
+
+        const unsigned int geomId = RTCHitN_geomID(args->hit, args->N, i);
+        const unsigned int primId = RTCHitN_primID(args->hit, args->N, i);
+        float &u(RTCHitN_u(args->hit, args->N, i));
+        float &v(RTCHitN_v(args->hit, args->N, i));
+        RTCGeometry geom = rtcGetGeometry(d->rscene, geomId);
+
+        // convert from barycentric and overwrite u and v in hit with the result
+        float uv[2];
+        rtcInterpolate0(geom, primId, u, v, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, LIGHTMAP_UV_SLOT, uv, 2);
+        u = uv[0];
+        v = uv[1];
+
+        const float opacity = d->subMeshOpacityMap[geomId];
+        if (opacity < 1.0f || d->lightmaps[d->geomLightmapMap[geomId]].hasBaseColorTransparency) {
+            const QSSGLightmapperPrivate::LightmapEntry &texel(d->texelForLightmapUV(geomId, u, v));
+
+            // In addition to material.opacity, take at least the base color (both
+            // the static color and the value from the base color map, if there is
+            // one) into account. Opacity map, alpha cutoff, etc. are ignored.
+            const float alpha = opacity * texel.baseColor.w();
+
+            // Ignore the hit if the alpha is low enough. This is not exactly perfect,
+            // but better than nothing. An object with an opacity lower than the
+            // threshold will act is if it was not there, as far as the intersection is
+            // concerned. So then the object won't cast shadows for example.
+            if (alpha < d->options.opacityThreshold)
+                args->valid[i] = 0;
+        }
     }
 }
 
@@ -627,6 +655,19 @@ bool QSSGLightmapperPrivate::commitGeometry()
     return true;
 }
 
+// The sums of the indirect light samples end up in the bake state files, so
+// the seeds must be the same in every build, unlike qHash().
+static quint32 lightmapSeed(const QString &lightmapKey)
+{
+    // FNV-1a
+    quint32 h = 0x811c9dc5u;
+    for (const char c : lightmapKey.toUtf8()) {
+        h ^= quint8(c);
+        h *= 0x01000193u;
+    }
+    return h;
+}
+
 bool QSSGLightmapperPrivate::prepareLightmaps()
 {
     QRhi *rhi = rhiCtx->rhi();
@@ -988,6 +1029,8 @@ bool QSSGLightmapperPrivate::prepareLightmaps()
                                                               arg(lm.model->lightmapKey).
                                                               arg(QStringLiteral("(%1, %2)").arg(outputSize.width()).arg(outputSize.height())).
                                                               arg(rasterizeTimer.elapsed()));
+        // seeded by the key so that resumed bakes continue the same sequences
+        lightmap.seed = lightmapSeed(lm.model->lightmapKey);
         lightmaps.append(lightmap);
 
         for (const SubMeshInfo &subMeshInfo : std::as_const(subMeshInfos[lmIdx])) {
@@ -1028,6 +1071,57 @@ struct RayHit
     }
 };
 
+// Coherent ray packet, one lane per path. The lane count matches the SSE
+// width of the lowest ISA Embree is built for.
+static const int LM_RAY_PACKET_SIZE = 4;
+
+struct RayHitPacket
+{
+    RayHitPacket() {
+        for (int i = 0; i < LM_RAY_PACKET_SIZE; ++i) {
+            valid[i] = 0;
+            rayhit.ray.time[i] = 0.0f;
+            rayhit.ray.mask[i] = UINT_MAX;
+            rayhit.ray.id[i] = i;
+            rayhit.ray.flags[i] = 0;
+            rayhit.hit.geomID[i] = RTC_INVALID_GEOMETRY_ID;
+            rayhit.hit.instID[0][i] = RTC_INVALID_GEOMETRY_ID;
+        }
+    }
+
+    void setRay(int lane, const QVector3D &org, const QVector3D &dir, float tnear = 0.0f, float tfar = std::numeric_limits<float>::infinity())
+    {
+        valid[lane] = -1;
+        rayhit.ray.org_x[lane] = org.x();
+        rayhit.ray.org_y[lane] = org.y();
+        rayhit.ray.org_z[lane] = org.z();
+        rayhit.ray.dir_x[lane] = dir.x();
+        rayhit.ray.dir_y[lane] = dir.y();
+        rayhit.ray.dir_z[lane] = dir.z();
+        rayhit.ray.tnear[lane] = tnear;
+        rayhit.ray.tfar[lane] = tfar;
+        rayhit.hit.u[lane] = 0.0f;
+        rayhit.hit.v[lane] = 0.0f;
+        rayhit.hit.geomID[lane] = RTC_INVALID_GEOMETRY_ID;
+    }
+
+    bool hasHit(int lane) const
+    {
+        return valid[lane] && rayhit.hit.geomID[lane] != RTC_INVALID_GEOMETRY_ID;
+    }
+
+    alignas(16) int valid[LM_RAY_PACKET_SIZE];
+    RTCRayHit4 rayhit;
+
+    void intersect(RTCScene scene)
+    {
+        RTCIntersectContext ctx;
+        rtcInitIntersectContext(&ctx);
+        ctx.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
+        rtcIntersect4(valid, scene, &ctx, &rayhit);
+    }
+};
+
 static inline QVector3D vectorSign(const QVector3D &v)
 {
     return QVector3D(v.x() < 1.0f ? -1.0f : 1.0f,
@@ -1052,13 +1146,15 @@ void QSSGLightmapperPrivate::computeDirectLight()
     Q_ASSERT(lightmaps.size() == bakedLightingModelCount);
 
     QVector<QFuture<void>> futures;
+    // The output callback is not thread-safe, the times are reported once all are done
+    QVector<qint64> directLightTimes(bakedLightingModelCount);
 
     for (int lmIdx = 0; lmIdx < bakedLightingModelCount; ++lmIdx) {
-        const QSSGBakedLightingModel &lm(bakedLightingModels[lmIdx]);
         Lightmap &lightmap(lightmaps[lmIdx]);
+        qint64 &directLightTime(directLightTimes[lmIdx]);
 
         // direct lighting is relatively fast to calculate, so parallelize per model
-        futures << QtConcurrent::run([this, &lm, &lightmap] {
+        futures << QtConcurrent::run([this, &lightmap, &directLightTime] {
             QElapsedTimer directLightTimer;
             directLightTimer.start();
 
@@ -1122,45 +1218,88 @@ void QSSGLightmapperPrivate::computeDirectLight()
                 }
             }
 
-            sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Direct light computed for model %1 in %2 ms").
-                                                                  arg(lm.model->lightmapKey).
-                                                                  arg(directLightTimer.elapsed()));
+            directLightTime = directLightTimer.elapsed();
         });
     }
 
     for (QFuture<void> &future : futures)
         future.waitForFinished();
 
+    for (int lmIdx = 0; lmIdx < bakedLightingModelCount; ++lmIdx) {
+        sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Direct light computed for model %1 in %2 ms").
+                                                              arg(bakedLightingModels[lmIdx].model->lightmapKey).
+                                                              arg(directLightTimes[lmIdx]));
+    }
+
     sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Direct light computation completed in %1 ms").
                                                           arg(fullDirectLightTimer.elapsed()));
 }
 
-// xorshift rng. this is called a lot -> rand/QRandomGenerator is out of question (way too slow)
-static inline float uniformRand()
+// xorshift rng. this is called a lot -> rand/QRandomGenerator is out of question (way too slow).
+// Seeded per texel so that the result does not depend on how the work is
+// distributed between the threads.
+struct LightmapRandom
 {
-    static thread_local quint32 state = QRandomGenerator::global()->generate();
-    state ^= state << 13;
-    state ^= state >> 17;
-    state ^= state << 5;
-    return float(state) / float(UINT32_MAX);
+    explicit LightmapRandom(quint32 seed) : state(seed ? seed : 0x9e3779b9u) { }
+
+    float uniform()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return float(state) / float(UINT32_MAX);
+    }
+
+    quint32 state;
+};
+
+static inline quint32 texelSeed(quint32 lightmapSeed, qsizetype texelIdx, int sampleIdx)
+{
+    // lowbias32 integer hash
+    quint32 h = quint32(texelIdx) * 0x9e3779b1u ^ lightmapSeed * 0x85ebca6bu ^ quint32(sampleIdx) * 0xc2b2ae35u;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+    return h;
 }
 
-static inline QVector3D cosWeightedHemisphereSample()
+static inline QVector3D cosWeightedHemisphereSample(LightmapRandom &rng)
 {
-    const float r1 = uniformRand();
-    const float r2 = uniformRand() * 2.0f * float(M_PI);
+    const float r1 = rng.uniform();
+    const float r2 = rng.uniform() * 2.0f * float(M_PI);
     const float sqr1 = std::sqrt(r1);
     const float sqr1m = std::sqrt(1.0f - r1);
     return QVector3D(sqr1 * std::cos(r2), sqr1 * std::sin(r2), sqr1m);
 }
 
-void QSSGLightmapperPrivate::computeIndirectLight()
+void QSSGLightmapperPrivate::computeIndirectLight(int passSampleCount)
 {
     sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Computing indirect lighting..."));
     QElapsedTimer fullIndirectLightTimer;
     fullIndirectLightTimer.start();
 
+    // Indirect lighting is slow, so the texels of all lightmaps are split up
+    // into square tiles which are then processed in parallel (how many are
+    // really done concurrently is up to the thread pool). Neighboring texels
+    // map to nearby surface points, so the paths started within a tile are
+    // reasonably coherent. Each texel's samples are traced as packets of
+    // LM_RAY_PACKET_SIZE rays, one lane per sample.
+    //
+    // With progressive baking each call computes the next passSampleCount
+    // samples (continuing from what the lightmap has accumulated so far),
+    // the texel sample sums are normalized only when assembling the image.
+    struct Tile {
+        int lmIdx;
+        QRect rect;
+    };
+    QVector<Tile> tiles;
+    QVector<std::pair<int, int>> sampleRanges(lightmaps.size()); // [lmIdx] -> [begin, end)
+
+    const int tileSize = qMax(1, options.indirectLightWorkgroupSize);
     const int bakedLightingModelCount = bakedLightingModels.size();
+    qsizetype totalTexels = 0;
 
     for (int lmIdx = 0; lmIdx < bakedLightingModelCount; ++lmIdx) {
         // here we only care about the models that will store the lightmap image persistently
@@ -1168,57 +1307,105 @@ void QSSGLightmapperPrivate::computeIndirectLight()
             continue;
 
         const QSSGBakedLightingModel &lm(bakedLightingModels[lmIdx]);
-        Lightmap &lightmap(lightmaps[lmIdx]);
-        int texelsDone = 0;
-        sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Total texels to compute for model %1: %2").
+        const Lightmap &lightmap(lightmaps[lmIdx]);
+        if (lightmap.indirectSamples >= options.indirectLightSamples)
+            continue;
+        sampleRanges[lmIdx] = { lightmap.indirectSamples,
+                                qMin(lightmap.indirectSamples + passSampleCount, options.indirectLightSamples) };
+
+        qsizetype validTexels = 0;
+        for (const LightmapEntry &lmPix : lightmap.entries) {
+            if (lmPix.isValid())
+                ++validTexels;
+        }
+        sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Total texels to compute for model %1: %2 (samples %3-%4)").
                                                               arg(lm.model->lightmapKey).
-                                                              arg(lightmap.entries.size()));
-        QElapsedTimer indirectLightTimer;
-        indirectLightTimer.start();
-
-        // indirect lighting is slow, so parallelize per groups of samples,
-        // e.g. if sample count is 256 and workgroup size is 32, then do up to
-        // 8 sets in parallel, each calculating 32 samples (how many of the 8
-        // are really done concurrently that's up to the thread pool to manage)
-
-        int wgSizePerGroup = qMax(1, options.indirectLightWorkgroupSize);
-        int wgCount = options.indirectLightSamples / wgSizePerGroup;
-        if (options.indirectLightSamples % wgSizePerGroup)
-            ++wgCount;
-
-        QVector<QFuture<QVector3D>> wg(wgCount);
-
-        sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Computing indirect lighting for model %1").
-                                                              arg(lm.model->lightmapKey));
-        sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Sample count: %1, Workgroup size: %2, Max bounces: %3, Multiplier: %4").
-                                                              arg(options.indirectLightSamples).
-                                                              arg(wgSizePerGroup).
-                                                              arg(options.indirectLightBounces).
-                                                              arg(options.indirectLightFactor));
-        for (LightmapEntry &lmPix : lightmap.entries) {
-            if (!lmPix.isValid())
-                continue;
+                                                              arg(validTexels).
+                                                              arg(sampleRanges[lmIdx].first).
+                                                              arg(sampleRanges[lmIdx].second - 1));
+        if (!validTexels)
+            continue;
+        totalTexels += validTexels;
+
+        const int w = lightmap.pixelSize.width();
+        const int h = lightmap.pixelSize.height();
+        for (int y = 0; y < h; y += tileSize) {
+            for (int x = 0; x < w; x += tileSize)
+                tiles.append({ lmIdx, QRect(x, y, qMin(tileSize, w - x), qMin(tileSize, h - y)) });
+        }
+    }
+
+    sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Sample count: %1, Tile size: %2, Tile count: %3, Max bounces: %4, Multiplier: %5").
+                                                          arg(options.indirectLightSamples).
+                                                          arg(tileSize).
+                                                          arg(tiles.size()).
+                                                          arg(options.indirectLightBounces).
+                                                          arg(options.indirectLightFactor));
+
+    std::atomic<qint64> texelsDone = 0;
+    std::atomic<qint64> raysTraced = 0;
+
+    struct PathState {
+        QVector3D position;
+        QVector3D normal;
+        QVector3D direction;
+        QVector3D throughput;
+        QVector3D result;
+        float NdotL = 0.0f;
+        float pdf = 0.0f;
+        bool active = false;
+    };
+
+    QSemaphore finishedTiles;
+
+    auto computeTile = [&](const Tile &tile) {
+        const auto finished = qScopeGuard([&finishedTiles] { finishedTiles.release(); });
+        if (bakingControl.cancelled)
+            return;
+
+        Lightmap &lightmap(lightmaps[tile.lmIdx]);
+        const int w = lightmap.pixelSize.width();
+        const auto [sampleBegin, sampleEnd] = sampleRanges[tile.lmIdx];
+        qint64 tileTexels = 0;
+        qint64 tileRays = 0;
+
+        for (int y = tile.rect.top(); y <= tile.rect.bottom(); ++y) {
+            for (int x = tile.rect.left(); x <= tile.rect.right(); ++x) {
+                const qsizetype texelIdx = x + y * w;
+                LightmapEntry &lmPix(lightmap.entries[texelIdx]);
+                if (!lmPix.isValid())
+                    continue;
 
-            for (int wgIdx = 0; wgIdx < wgCount; ++wgIdx) {
-                const int beginIdx = wgIdx * wgSizePerGroup;
-                const int endIdx = qMin(beginIdx + wgSizePerGroup, options.indirectLightSamples);
+                QVector3D totalIndirect;
+
+                for (int sampleIdx = sampleBegin; sampleIdx < sampleEnd; sampleIdx += LM_RAY_PACKET_SIZE) {
+                    const int laneCount = qMin(LM_RAY_PACKET_SIZE, sampleEnd - sampleIdx);
+                    LightmapRandom rng(texelSeed(lightmap.seed, texelIdx, sampleIdx));
+                    PathState paths[LM_RAY_PACKET_SIZE];
+                    for (int lane = 0; lane < laneCount; ++lane) {
+                        paths[lane].position = lmPix.worldPos;
+                        paths[lane].normal = lmPix.normal;
+                        paths[lane].throughput = QVector3D(1.0f, 1.0f, 1.0f);
+                        paths[lane].active = true;
+                    }
+
+                    for (int bounce = 0; bounce < options.indirectLightBounces; ++bounce) {
+                        RayHitPacket packet;
+                        int activeLanes = 0;
 
-                wg[wgIdx] = QtConcurrent::run([this, beginIdx, endIdx, &lmPix] {
-                    QVector3D wgResult;
-                    for (int sampleIdx = beginIdx; sampleIdx < endIdx; ++sampleIdx) {
-                        QVector3D position = lmPix.worldPos;
-                        QVector3D normal = lmPix.normal;
-                        QVector3D throughput(1.0f, 1.0f, 1.0f);
-                        QVector3D sampleResult;
+                        for (int lane = 0; lane < laneCount; ++lane) {
+                            PathState &path(paths[lane]);
+                            if (!path.active)
+                                continue;
 
-                        for (int bounce = 0; bounce < options.indirectLightBounces; ++bounce) {
                             if (options.useAdaptiveBias)
-                                position += vectorSign(normal) * vectorAbs(position * 0.0000002f);
+                                path.position += vectorSign(path.normal) * vectorAbs(path.position * 0.0000002f);
 
                             // get a sample using a cosine-weighted hemisphere sampler
-                            const QVector3D sample = cosWeightedHemisphereSample();
+                            const QVector3D sample = cosWeightedHemisphereSample(rng);
 
                             // transform to the point's local coordinate system
+                            const QVector3D &normal(path.normal);
                             const QVector3D v0 = qFuzzyCompare(qAbs(normal.z()), 1.0f)
                                     ? QVector3D(0.0f, 1.0f, 0.0f)
                                     : QVector3D(0.0f, 0.0f, 1.0f);
@@ -1231,75 +1418,119 @@ void QSSGLightmapperPrivate::computeIndirectLight()
                             direction.normalize();
 
                             // probability distribution function
-                            const float NdotL = qMax(0.0f, QVector3D::dotProduct(normal, direction));
-                            const float pdf = NdotL / float(M_PI);
-                            if (qFuzzyIsNull(pdf))
-                                break;
+                            path.NdotL = qMax(0.0f, QVector3D::dotProduct(normal, direction));
+                            path.pdf = path.NdotL / float(M_PI);
+                            if (qFuzzyIsNull(path.pdf)) {
+                                path.active = false;
+                                continue;
+                            }
+
+                            path.direction = direction;
+                            packet.setRay(lane, path.position, direction, options.bias);
+                            ++activeLanes;
+                        }
+
+                        if (!activeLanes)
+                            break;
+
+                        // shoot the rays of all the active paths at once
+                        packet.intersect(rscene);
+                        tileRays += activeLanes;
 
-                            // shoot ray, stop if no hit
-                            RayHit ray(position, direction, options.bias);
-                            if (!ray.intersect(rscene))
-                                break;
+                        for (int lane = 0; lane < laneCount; ++lane) {
+                            PathState &path(paths[lane]);
+                            if (!path.active)
+                                continue;
+
+                            // stop if no hit
+                            if (!packet.hasHit(lane)) {
+                                path.active = false;
+                                continue;
+                            }
 
                             // see what (sub)mesh and which texel it intersected with
-                            const LightmapEntry &hitEntry = texelForLightmapUV(ray.rayhit.hit.geomID,
-                                                                               ray.rayhit.hit.u,
-                                                                               ray.rayhit.hit.v);
+                            const LightmapEntry &hitEntry = texelForLightmapUV(packet.rayhit.hit.geomID[lane],
+                                                                               packet.rayhit.hit.u[lane],
+                                                                               packet.rayhit.hit.v[lane]);
 
                             // won't bounce further from a back face
-                            const bool hitBackFace = QVector3D::dotProduct(hitEntry.normal, direction) > 0.0f;
-                            if (hitBackFace)
-                                break;
+                            const bool hitBackFace = QVector3D::dotProduct(hitEntry.normal, path.direction) > 0.0f;
+                            if (hitBackFace) {
+                                path.active = false;
+                                continue;
+                            }
 
                             // the BRDF of a diffuse surface is albedo / PI
                             const QVector3D brdf = hitEntry.baseColor.toVector3D() / float(M_PI);
 
                             // calculate result for this bounce
-                            sampleResult += throughput * hitEntry.emission;
-                            throughput *= brdf * NdotL / pdf;
-                            sampleResult += throughput * hitEntry.directLight;
+                            path.result += path.throughput * hitEntry.emission;
+                            path.throughput *= brdf * path.NdotL / path.pdf;
+                            path.result += path.throughput * hitEntry.directLight;
 
                             // stop if we guess there's no point in bouncing further
                             // (low throughput path wouldn't contribute much)
-                            const float p = qMax(qMax(throughput.x(), throughput.y()), throughput.z());
-                            if (p < uniformRand())
-                                break;
+                            const float p = qMax(qMax(path.throughput.x(), path.throughput.y()), path.throughput.z());
+                            if (p < rng.uniform()) {
+                                path.active = false;
+                                continue;
+                            }
 
                             // was not terminated: boost the energy by the probability to be terminated
-                            throughput /= p;
+                            path.throughput /= p;
 
                             // next bounce starts from the hit's position
-                            position = hitEntry.worldPos;
-                            normal = hitEntry.normal;
+                            path.position = hitEntry.worldPos;
+                            path.normal = hitEntry.normal;
                         }
-
-                        wgResult += sampleResult;
                     }
-                    return wgResult;
-                });
-            }
 
-            QVector3D totalIndirect;
-            for (const auto &future : wg)
-                totalIndirect += future.result();
+                    for (int lane = 0; lane < laneCount; ++lane)
+                        totalIndirect += paths[lane].result;
+                }
 
-            lmPix.allLight += totalIndirect * options.indirectLightFactor / options.indirectLightSamples;
+                lmPix.indirectLight += totalIndirect;
+                ++tileTexels;
+            }
+        }
 
-            ++texelsDone;
-            if (texelsDone % 10000 == 0)
-                sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("%1 texels left").
-                                                                      arg(lightmap.entries.size() - texelsDone));
+        raysTraced += tileRays;
+        texelsDone += tileTexels;
+    };
 
-            if (bakingControl.cancelled)
-                return;
+    // The output callback may touch the UI and is not thread-safe, so the
+    // progress is reported from this thread while the tiles are computed.
+    QFuture<void> future = QtConcurrent::map(tiles, computeTile);
+    qint64 reportedTexels = 0;
+    for (qsizetype tileCount = 0; tileCount < tiles.size(); ) {
+        if (finishedTiles.tryAcquire(1, 100))
+            ++tileCount;
+        const qint64 done = texelsDone.load();
+        if (reportedTexels / 10000 != done / 10000) {
+            reportedTexels = done;
+            sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("%1 texels left").
+                                                                  arg(totalTexels - done));
         }
-        sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Indirect lighting computed for model %1 in %2 ms").
-                                                              arg(lm.model->lightmapKey).
-                                                              arg(indirectLightTimer.elapsed()));
     }
+    future.waitForFinished();
 
+    if (bakingControl.cancelled)
+        return;
+
+    for (int lmIdx = 0, lmCount = lightmaps.size(); lmIdx < lmCount; ++lmIdx) {
+        if (sampleRanges[lmIdx].second > sampleRanges[lmIdx].first)
+            lightmaps[lmIdx].indirectSamples = sampleRanges[lmIdx].second;
+    }
+
+    const qint64 elapsed = fullIndirectLightTimer.elapsed();
+    const double seconds = qMax<qint64>(1, elapsed) / 1000.0;
     sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Indirect light computation completed in %1 ms").
-                                                          arg(fullIndirectLightTimer.elapsed()));
+                                                          arg(elapsed));
+    sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Traced %1 rays for %2 texels (%3 texels/s, %4 rays/s)").
+                                                          arg(raysTraced.load()).
+                                                          arg(texelsDone.load()).
+                                                          arg(qRound64(texelsDone.load() / seconds)).
+                                                          arg(qRound64(raysTraced.load() / seconds)));
 }
 
 struct Edge {
@@ -1427,6 +1658,97 @@ static void blendLine(const QVector2D &from, const QVector2D &to,
     }
 }
 
+// Edge-aware denoising of the indirect light: an à-trous wavelet filter (see
+// Dammertz et al.: Edge-Avoiding À-Trous Wavelet Transform for fast Global
+// Illumination Filtering) where the edge-stopping functions use the world
+// space positions and normals of the texels. The direct light is not noisy
+// and is left alone, so shadow edges remain sharp.
+static const int LM_DENOISE_ITER_COUNT = 3;
+
+QVector<QVector3D> QSSGLightmapper::denoiseIndirectLight(const QSize &pixelSize,
+                                                       const QVector<QVector3D> &positions,
+                                                       const QVector<QVector3D> &normals,
+                                                       QVector<QVector3D> indirect)
+{
+    const int w = pixelSize.width();
+    const int h = pixelSize.height();
+    const qsizetype texelCount = qsizetype(w) * h;
+    QSSG_ASSERT(positions.size() == texelCount && normals.size() == texelCount && indirect.size() == texelCount,
+                return indirect);
+    const auto isValid = [&positions, &normals](qsizetype idx) {
+        return !positions[idx].isNull() && !normals[idx].isNull();
+    };
+
+    // the position weight is relative to the typical world space distance of
+    // neighboring texels, since the scene scale can be anything
+    QVector<float> spacing;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w - 1; ++x) {
+            const qsizetype a = x + y * w;
+            const qsizetype b = a + 1;
+            if (isValid(a) && isValid(b) && QVector3D::dotProduct(normals[a], normals[b]) > 0.9f)
+                spacing.append((positions[a] - positions[b]).length());
+        }
+    }
+    if (spacing.isEmpty())
+        return indirect;
+    const auto median = spacing.begin() + spacing.size() / 2;
+    std::nth_element(spacing.begin(), median, spacing.end());
+    const float texelSpacing = qMax(*median, std::numeric_limits<float>::epsilon());
+
+    // B3 spline kernel, indexed by the absolute offset
+    static const float kernel[3] = { 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f };
+
+    QVector<int> rows(h);
+    std::iota(rows.begin(), rows.end(), 0);
+    QVector<QVector3D> filtered(indirect.size());
+
+    for (int iter = 0; iter < LM_DENOISE_ITER_COUNT; ++iter) {
+        const int step = 1 << iter;
+        const float sigmaPos = 2.0f * texelSpacing * step;
+        const float invSigmaPos2 = 1.0f / (sigmaPos * sigmaPos);
+
+        QtConcurrent::blockingMap(rows, [&](int y) {
+            for (int x = 0; x < w; ++x) {
+                const qsizetype idx = x + y * w;
+                if (!isValid(idx)) {
+                    filtered[idx] = indirect[idx];
+                    continue;
+                }
+                QVector3D sum;
+                float weightSum = 0.0f;
+                for (int dy = -2; dy <= 2; ++dy) {
+                    const int qy = y + dy * step;
+                    if (qy < 0 || qy >= h)
+                        continue;
+                    for (int dx = -2; dx <= 2; ++dx) {
+                        const int qx = x + dx * step;
+                        if (qx < 0 || qx >= w)
+                            continue;
+                        const qsizetype qIdx = qx + qy * w;
+                        if (!isValid(qIdx))
+                            continue;
+                        // normal weight: dot(n, nq)^32
+                        float normalWeight = qMax(0.0f, QVector3D::dotProduct(normals[idx], normals[qIdx]));
+                        for (int i = 0; i < 5; ++i)
+                            normalWeight *= normalWeight;
+                        const float posWeight = std::exp(-(positions[idx] - positions[qIdx]).lengthSquared() * invSigmaPos2);
+                        const float weight = kernel[qAbs(dx)] * kernel[qAbs(dy)] * normalWeight * posWeight;
+                        sum += indirect[qIdx] * weight;
+                        weightSum += weight;
+                    }
+                }
+                // the center texel always contributes, so weightSum > 0
+                filtered[idx] = sum / weightSum;
+            }
+        });
+
+        indirect.swap(filtered);
+    }
+
+    return indirect;
+}
+
 bool QSSGLightmapperPrivate::postProcess()
 {
     QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(rhiCtx);
@@ -1446,13 +1768,37 @@ bool QSSGLightmapperPrivate::postProcess()
 
         Lightmap &lightmap(lightmaps[lmIdx]);
 
+        // Normalize the indirect light sums, and denoise if requested
+        QVector<QVector3D> indirectLight(lightmap.entries.size());
+        if (lightmap.indirectSamples > 0) {
+            const float indirectScale = options.indirectLightFactor / lightmap.indirectSamples;
+            for (qsizetype i = 0, ie = lightmap.entries.size(); i != ie; ++i)
+                indirectLight[i] = lightmap.entries[i].indirectLight * indirectScale;
+            if (options.denoise) {
+                QElapsedTimer denoiseTimer;
+                denoiseTimer.start();
+                QVector<QVector3D> positions(lightmap.entries.size());
+                QVector<QVector3D> normals(lightmap.entries.size());
+                for (qsizetype i = 0, ie = lightmap.entries.size(); i != ie; ++i) {
+                    positions[i] = lightmap.entries[i].worldPos;
+                    normals[i] = lightmap.entries[i].normal;
+                }
+                indirectLight = QSSGLightmapper::denoiseIndirectLight(lightmap.pixelSize, positions, normals, std::move(indirectLight));
+                sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Denoised indirect light for model %1 in %2 ms").
+                                                                      arg(lm.model->lightmapKey).
+                                                                      arg(denoiseTimer.elapsed()));
+            }
+        }
+
         // Assemble the RGBA32F image from the baker data structures
         QByteArray lightmapFP32(lightmap.entries.size() * 4 * sizeof(float), Qt::Uninitialized);
         float *lightmapFloatPtr = reinterpret_cast<float *>(lightmapFP32.data());
-        for (const LightmapEntry &lmPix : std::as_const(lightmap.entries)) {
-            *lightmapFloatPtr++ = lmPix.allLight.x();
-            *lightmapFloatPtr++ = lmPix.allLight.y();
-            *lightmapFloatPtr++ = lmPix.allLight.z();
+        for (qsizetype i = 0, ie = lightmap.entries.size(); i != ie; ++i) {
+            const LightmapEntry &lmPix(lightmap.entries[i]);
+            const QVector3D light = lmPix.allLight + indirectLight[i];
+            *lightmapFloatPtr++ = light.x();
+            *lightmapFloatPtr++ = light.y();
+            *lightmapFloatPtr++ = light.z();
             *lightmapFloatPtr++ = lmPix.isValid() ? 1.0f : 0.0f;
         }
 
@@ -1596,6 +1942,167 @@ bool QSSGLightmapperPrivate::postProcess()
     return true;
 }
 
+static QString outputFolderForModel(const QSSGRenderModel &model)
+{
+    // An empty outputFolder equates to working directory
+    QString outputFolder;
+    if (!model.lightmapLoadPath.startsWith(QStringLiteral(":/")))
+        outputFolder = model.lightmapLoadPath;
+    return outputFolder;
+}
+
+QByteArray QSSGLightmapperPrivate::bakeSignature(int lmIdx) const
+{
+    // Everything that affects the indirect light of the model, apart from
+    // the other models in the scene and the sample count.
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    const auto addValue = [&hash](const auto &v) {
+        hash.addData(QByteArrayView(reinterpret_cast<const char *>(&v), sizeof(v)));
+    };
+    const auto addImage = [&hash, &addValue](const QSSGRenderImage *image) {
+        const QByteArray path = image ? image->m_imagePath.path().toUtf8() : QByteArray();
+        addValue(path.size());
+        hash.addData(path);
+    };
+
+    const QSSGBakedLightingModel &lm(bakedLightingModels[lmIdx]);
+    const DrawInfo &drawInfo(drawInfos[lmIdx]);
+    hash.addData(drawInfo.vertexData);
+    hash.addData(drawInfo.indexData);
+    addValue(drawInfo.lightmapSize.width());
+    addValue(drawInfo.lightmapSize.height());
+    hash.addData(QByteArrayView(reinterpret_cast<const char *>(lm.model->globalTransform.constData()), 16 * sizeof(float)));
+
+    for (const SubMeshInfo &subMeshInfo : subMeshInfos[lmIdx]) {
+        addValue(subMeshInfo.baseColor);
+        addValue(subMeshInfo.emissiveFactor);
+        addValue(subMeshInfo.normalStrength);
+        addValue(subMeshInfo.opacity);
+        addImage(subMeshInfo.baseColorNode);
+        addImage(subMeshInfo.emissiveNode);
+        addImage(subMeshInfo.normalMapNode);
+    }
+
+    for (const Light &light : lights) {
+        addValue(light.type);
+        addValue(light.indirectOnly);
+        addValue(light.direction);
+        addValue(light.color);
+        addValue(light.worldPos);
+        addValue(light.cosConeAngle);
+        addValue(light.cosInnerConeAngle);
+        addValue(light.constantAttenuation);
+        addValue(light.linearAttenuation);
+        addValue(light.quadraticAttenuation);
+    }
+
+    addValue(options.opacityThreshold);
+    addValue(options.bias);
+    addValue(options.useAdaptiveBias);
+    addValue(options.indirectLightBounces);
+
+    return hash.result();
+}
+
+static const quint32 LM_BAKE_STATE_MAGIC = 0x514c4d53; // 'QLMS'
+static const quint32 LM_BAKE_STATE_VERSION = 2;
+
+void QSSGLightmapperPrivate::loadBakeStates()
+{
+    const int bakedLightingModelCount = bakedLightingModels.size();
+    for (int lmIdx = 0; lmIdx < bakedLightingModelCount; ++lmIdx) {
+        const QSSGBakedLightingModel &lm(bakedLightingModels[lmIdx]);
+        if (!lm.model->hasLightmap())
+            continue;
+
+        Lightmap &lightmap(lightmaps[lmIdx]);
+        lightmap.bakeSignature = bakeSignature(lmIdx);
+
+        QFile f(QSSGLightmapper::lightmapAssetPathForSave(*lm.model, QSSGLightmapper::LightmapAsset::BakeState, outputFolderForModel(*lm.model)));
+        if (!f.open(QIODevice::ReadOnly))
+            continue;
+
+        QDataStream ds(&f);
+        ds.setVersion(QDataStream::Qt_6_0);
+        quint32 magic = 0;
+        quint32 version = 0;
+        ds >> magic >> version;
+        if (magic != LM_BAKE_STATE_MAGIC || version != LM_BAKE_STATE_VERSION)
+            continue;
+
+        QByteArray signature;
+        QSize pixelSize;
+        qint32 samples = 0;
+        QByteArray data;
+        ds >> signature >> pixelSize >> samples >> data;
+        if (ds.status() != QDataStream::Ok || samples <= 0
+                || pixelSize != lightmap.pixelSize
+                || data.size() != lightmap.entries.size() * 3 * qsizetype(sizeof(float)))
+        {
+            sendOutputInfo(QSSGLightmapper::BakingStatus::Warning, QStringLiteral("Ignoring invalid bake state file %1").arg(f.fileName()));
+            continue;
+        }
+        if (signature != lightmap.bakeSignature) {
+            sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Model %1 has changed, indirect light will be recomputed").
+                                                                  arg(lm.model->lightmapKey));
+            continue;
+        }
+
+        const float *src = reinterpret_cast<const float *>(data.constData());
+        for (LightmapEntry &lmPix : lightmap.entries) {
+            lmPix.indirectLight = QVector3D(src[0], src[1], src[2]);
+            src += 3;
+        }
+        lightmap.indirectSamples = samples;
+
+        if (samples >= options.indirectLightSamples) {
+            sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Model %1 is unchanged, reusing %2 indirect light samples").
+                                                                  arg(lm.model->lightmapKey).
+                                                                  arg(samples));
+        } else {
+            sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Resuming model %1 from %2/%3 indirect light samples").
+                                                                  arg(lm.model->lightmapKey).
+                                                                  arg(samples).
+                                                                  arg(options.indirectLightSamples));
+        }
+    }
+}
+
+bool QSSGLightmapperPrivate::storeBakeStates()
+{
+    const int bakedLightingModelCount = bakedLightingModels.size();
+    for (int lmIdx = 0; lmIdx < bakedLightingModelCount; ++lmIdx) {
+        const QSSGBakedLightingModel &lm(bakedLightingModels[lmIdx]);
+        if (!lm.model->hasLightmap())
+            continue;
+
+        const Lightmap &lightmap(lightmaps[lmIdx]);
+        if (lightmap.indirectSamples <= 0)
+            continue;
+
+        QByteArray data(lightmap.entries.size() * 3 * sizeof(float), Qt::Uninitialized);
+        float *dst = reinterpret_cast<float *>(data.data());
+        for (const LightmapEntry &lmPix : lightmap.entries) {
+            *dst++ = lmPix.indirectLight.x();
+            *dst++ = lmPix.indirectLight.y();
+            *dst++ = lmPix.indirectLight.z();
+        }
+
+        QFile f(QSSGLightmapper::lightmapAssetPathForSave(*lm.model, QSSGLightmapper::LightmapAsset::BakeState, outputFolderForModel(*lm.model)));
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            sendOutputInfo(QSSGLightmapper::BakingStatus::Warning, QStringLiteral("Failed to write bake state to '%1'").
+                                                                 arg(f.fileName()));
+            return false;
+        }
+        QDataStream ds(&f);
+        ds.setVersion(QDataStream::Qt_6_0);
+        ds << LM_BAKE_STATE_MAGIC << LM_BAKE_STATE_VERSION
+           << lightmap.bakeSignature << lightmap.pixelSize << qint32(lightmap.indirectSamples) << data;
+    }
+
+    return true;
+}
+
 bool QSSGLightmapperPrivate::storeLightmaps()
 {
     const int bakedLightingModelCount = bakedLightingModels.size();
@@ -1610,11 +2117,7 @@ bool QSSGLightmapperPrivate::storeLightmaps()
         QElapsedTimer writeTimer;
         writeTimer.start();
 
-        // An empty outputFolder equates to working directory
-        QString outputFolder;
-        if (!lm.model->lightmapLoadPath.startsWith(QStringLiteral(":/")))
-            outputFolder = lm.model->lightmapLoadPath;
-
+        const QString outputFolder = outputFolderForModel(*lm.model);
         const QString fn = QSSGLightmapper::lightmapAssetPathForSave(*lm.model, QSSGLightmapper::LightmapAsset::LightmapImage, outputFolder);
         const QByteArray fns = fn.toUtf8();
 
@@ -1736,8 +2239,59 @@ bool QSSGLightmapper::bake()
         return false;
     }
 
-    if (d->options.indirectLightEnabled)
-        d->computeIndirectLight();
+    if (d->options.indirectLightEnabled) {
+        if (d->options.incrementalBaking)
+            d->loadBakeStates();
+
+        // Progressive baking: the samples are divided into passes, with the
+        // intermediate results written out after each but the last one. Keep
+        // the pass size a multiple of the packet size so that the result does
+        // not depend on the number of passes.
+        const int sampleCount = d->options.indirectLightSamples;
+        const int passCount = qBound(1, d->options.indirectLightPasses, qMax(1, sampleCount));
+        int passSampleCount = (sampleCount + passCount - 1) / passCount;
+        passSampleCount = (passSampleCount + LM_RAY_PACKET_SIZE - 1) / LM_RAY_PACKET_SIZE * LM_RAY_PACKET_SIZE;
+
+        const auto indirectLightPending = [this] {
+            for (int lmIdx = 0, lmCount = d->lightmaps.size(); lmIdx < lmCount; ++lmIdx) {
+                if (d->bakedLightingModels[lmIdx].model->hasLightmap()
+                        && d->lightmaps[lmIdx].indirectSamples < d->options.indirectLightSamples)
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        for (int pass = 1; indirectLightPending(); ++pass) {
+            if (passCount > 1) {
+                d->sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Indirect light pass %1, %2 samples per pass").
+                                                                         arg(pass).
+                                                                         arg(passSampleCount));
+            }
+
+            d->computeIndirectLight(passSampleCount);
+
+            if (d->bakingControl.cancelled) {
+                d->sendOutputInfo(QSSGLightmapper::BakingStatus::Cancelled, QStringLiteral("Cancelled by user"));
+                return false;
+            }
+
+            if (d->options.incrementalBaking && !d->storeBakeStates()) {
+                d->sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Baking failed"));
+                return false;
+            }
+
+            if (indirectLightPending()) {
+                if (!d->postProcess() || !d->storeLightmaps()) {
+                    d->sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Baking failed"));
+                    return false;
+                }
+                d->sendOutputInfo(QSSGLightmapper::BakingStatus::Progress, QStringLiteral("Intermediate lightmaps written after pass %1").
+                                                                         arg(pass));
+            }
+        }
+    }
 
     if (d->bakingControl.cancelled) {
         d->sendOutputInfo(QSSGLightmapper::BakingStatus::Cancelled, QStringLiteral("Cancelled by user"));
@@ -1764,6 +2318,11 @@ bool QSSGLightmapper::bake()
     return true;
 }
 
+bool QSSGLightmapper::isAvailable()
+{
+    return true;
+}
+
 #else
 
 QSSGLightmapper::QSSGLightmapper(QSSGRhiContext *, QSSGRenderer *)
@@ -1797,6 +2356,17 @@ bool QSSGLightmapper::bake()
     return false;
 }
 
+bool QSSGLightmapper::isAvailable()
+{
+    return false;
+}
+
+QVector<QVector3D> QSSGLightmapper::denoiseIndirectLight(const QSize &, const QVector<QVector3D> &,
+                                                       const QVector<QVector3D> &, QVector<QVector3D> indirect)
+{
+    return indirect;
+}
+
 #endif // QT_QUICK3D_HAS_LIGHTMAPPER
 
 QString QSSGLightmapper::lightmapAssetPathForLoad(const QSSGRenderModel &model, LightmapAsset asset)
@@ -1833,6 +2403,9 @@ QString QSSGLightmapper::lightmapAssetPathForSave(const QSSGRenderModel &model,
     case LightmapAsset::MeshWithLightmapUV:
         result += QStringLiteral("qlm_%1.mesh").arg(model.lightmapKey);
         break;
+    case LightmapAsset::BakeState:
+        result += QStringLiteral("qlm_%1.state").arg(model.lightmapKey);
+        break;
     default:
         result += lightmapAssetPathForSave(asset, outputFolder);
         break;
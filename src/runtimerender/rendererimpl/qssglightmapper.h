@@ -27,6 +27,9 @@ struct QSSGLightmapperOptions
     int indirectLightWorkgroupSize = 32;
     int indirectLightBounces = 3;
     float indirectLightFactor = 1.0f;
+    int indirectLightPasses = 1;
+    bool incrementalBaking = false;
+    bool denoise = false;
 };
 
 QT_END_NAMESPACE
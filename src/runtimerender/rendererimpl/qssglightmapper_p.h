@@ -19,6 +19,10 @@
 #include <ssg/qssglightmapper.h>
 
 #include <QString>
+#include <QtCore/qsize.h>
+#include <QtCore/qvector.h>
+#include <QtGui/qvector3d.h>
+#include <atomic>
 
 QT_BEGIN_NAMESPACE
 
@@ -28,7 +32,7 @@ class QSSGRhiContext;
 class QSSGRenderer;
 struct QSSGRenderModel;
 
-class QSSGLightmapper
+class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGLightmapper
 {
 public:
     enum class BakingStatus {
@@ -41,7 +45,8 @@ public:
     };
 
     struct BakingControl {
-        bool cancelled = false;
+        // Read by the threads computing the indirect light
+        std::atomic<bool> cancelled = false;
     };
 
     typedef std::function<void(BakingStatus, std::optional<QString>, BakingControl*)> Callback;
@@ -54,10 +59,21 @@ public:
     qsizetype add(const QSSGBakedLightingModel &model);
     bool bake();
 
+    // Whether Qt Quick 3D was built with the lightmapper
+    static bool isAvailable();
+    // Edge-aware filtering of the normalized indirect light of a lightmap,
+    // guided by the world space positions and normals of the texels. Unused
+    // texels have a null position or normal.
+    static QVector<QVector3D> denoiseIndirectLight(const QSize &pixelSize,
+                                                   const QVector<QVector3D> &positions,
+                                                   const QVector<QVector3D> &normals,
+                                                   QVector<QVector3D> indirect);
+
     enum class LightmapAsset {
         LightmapImage,
         MeshWithLightmapUV,
-        LightmapImageList
+        LightmapImageList,
+        BakeState
     };
     static QString lightmapAssetPathForLoad(const QSSGRenderModel &model, LightmapAsset asset);
     static QString lightmapAssetPathForSave(const QSSGRenderModel &model, LightmapAsset asset, const QString& outputFolder = {});
@@ -0,0 +1,343 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "qssgocclusionculler_p.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+static constexpr float farDepth = std::numeric_limits<float>::max();
+// Points closer to the camera plane than this are treated as crossing it
+static constexpr float minW = 1e-6f;
+
+void QSSGOcclusionCuller::begin(const QMatrix4x4 &viewProjection, const QSize &viewportSize)
+{
+    m_viewProjection = viewProjection;
+    m_width = BufferWidth;
+    m_height = viewportSize.width() > 0
+            ? qBound(16, qRound(float(BufferWidth) * viewportSize.height() / viewportSize.width()), 2 * BufferWidth)
+            : BufferWidth;
+    m_triangleCount = 0;
+    m_active = false;
+
+    if (m_levels.isEmpty())
+        m_levels.resize(1);
+    Level &level = m_levels[0];
+    level.width = m_width;
+    level.height = m_height;
+    level.depth.fill(farDepth, qsizetype(m_width) * m_height);
+}
+
+void QSSGOcclusionCuller::addOccluder(const QSSGMeshBVHTriangles &triangles, const QMatrix4x4 &globalTransform)
+{
+    const QMatrix4x4 mvp = m_viewProjection * globalTransform;
+    m_clipVertices.clear();
+    m_clipVertices.reserve(qsizetype(triangles.size()) * 3);
+    for (const QSSGMeshBVHTriangle &triangle : triangles) {
+        m_clipVertices.append(mvp.map(QVector4D(triangle.vertex1, 1.0f)));
+        m_clipVertices.append(mvp.map(QVector4D(triangle.vertex2, 1.0f)));
+        m_clipVertices.append(mvp.map(QVector4D(triangle.vertex3, 1.0f)));
+    }
+    addTriangles();
+}
+
+void QSSGOcclusionCuller::addOccluder(QSSGDataView<QVector3D> triangleVertices, const QMatrix4x4 &globalTransform)
+{
+    const QMatrix4x4 mvp = m_viewProjection * globalTransform;
+    const qsizetype vertexCount = triangleVertices.size() - triangleVertices.size() % 3;
+    m_clipVertices.clear();
+    m_clipVertices.reserve(vertexCount);
+    for (qsizetype i = 0; i < vertexCount; ++i)
+        m_clipVertices.append(mvp.map(QVector4D(triangleVertices[i], 1.0f)));
+    addTriangles();
+}
+
+void QSSGOcclusionCuller::end()
+{
+    // Each texel of a level holds the farthest depth of the up to two by two
+    // texels below it.
+    qsizetype levelCount = 1;
+    for (int w = m_width, h = m_height; w > 1 || h > 1; w = (w + 1) / 2, h = (h + 1) / 2)
+        ++levelCount;
+    m_levels.resize(levelCount);
+
+    for (qsizetype i = 1; i < levelCount; ++i) {
+        const Level &below = m_levels.at(i - 1);
+        Level &level = m_levels[i];
+        level.width = (below.width + 1) / 2;
+        level.height = (below.height + 1) / 2;
+        level.depth.resize(qsizetype(level.width) * level.height);
+        const float *src = below.depth.constData();
+        float *dst = level.depth.data();
+        for (int y = 0; y < level.height; ++y) {
+            const int y0 = 2 * y;
+            const int y1 = qMin(y0 + 1, below.height - 1);
+            for (int x = 0; x < level.width; ++x) {
+                const int x0 = 2 * x;
+                const int x1 = qMin(x0 + 1, below.width - 1);
+                dst[y * level.width + x] = qMax(qMax(src[y0 * below.width + x0], src[y0 * below.width + x1]),
+                                                qMax(src[y1 * below.width + x0], src[y1 * below.width + x1]));
+            }
+        }
+    }
+
+    m_active = (m_triangleCount > 0);
+}
+
+void QSSGOcclusionCuller::reset()
+{
+    m_active = false;
+    m_triangleCount = 0;
+}
+
+bool QSSGOcclusionCuller::isOccluded(const QSSGBounds3 &globalBounds) const
+{
+    if (!m_active || globalBounds.isEmpty())
+        return false;
+
+    float minX = farDepth;
+    float minY = farDepth;
+    float maxX = -farDepth;
+    float maxY = -farDepth;
+    float nearestDepth = farDepth;
+    for (const QVector3D &corner : globalBounds.toQSSGBoxPointsNoEmptyCheck()) {
+        const QVector4D clip = m_viewProjection.map(QVector4D(corner, 1.0f));
+        // A box reaching in front of the near plane is never occluded
+        if (clip.w() <= minW || clip.z() < -clip.w())
+            return false;
+        const QVector3D screen = toScreen(clip);
+        minX = qMin(minX, screen.x());
+        minY = qMin(minY, screen.y());
+        maxX = qMax(maxX, screen.x());
+        maxY = qMax(maxY, screen.y());
+        nearestDepth = qMin(nearestDepth, screen.z());
+    }
+
+    // Outside of the view is for frustum culling to decide
+    if (maxX < 0.0f || maxY < 0.0f || minX >= float(m_width) || minY >= float(m_height))
+        return false;
+
+    const int x0 = qMax(0, int(std::floor(minX)));
+    const int y0 = qMax(0, int(std::floor(minY)));
+    const int x1 = qMin(m_width - 1, int(std::floor(maxX)));
+    const int y1 = qMin(m_height - 1, int(std::floor(maxY)));
+
+    qsizetype levelIndex = 0;
+    while (levelIndex + 1 < m_levels.size()
+           && ((x1 >> levelIndex) - (x0 >> levelIndex) > 1 || (y1 >> levelIndex) - (y0 >> levelIndex) > 1)) {
+        ++levelIndex;
+    }
+
+    const Level &level = m_levels.at(levelIndex);
+    for (int y = y0 >> levelIndex, yEnd = y1 >> levelIndex; y <= yEnd; ++y) {
+        for (int x = x0 >> levelIndex, xEnd = x1 >> levelIndex; x <= xEnd; ++x) {
+            if (level.depth.at(y * level.width + x) >= nearestDepth)
+                return false;
+        }
+    }
+    return true;
+}
+
+QVector3D QSSGOcclusionCuller::toScreen(const QVector4D &clip) const
+{
+    const float invW = 1.0f / clip.w();
+    return { (clip.x() * invW * 0.5f + 0.5f) * float(m_width),
+             (clip.y() * invW * 0.5f + 0.5f) * float(m_height),
+             clip.z() * invW };
+}
+
+// Which side of the edge from u to v the point p is on, on screen. The sign
+// of the determinant of the homogeneous x, y and w is the one of the signed
+// area of the projected triangle, as long as all w are positive.
+static float sideOfEdge(const QVector4D &u, const QVector4D &v, const QVector4D &p)
+{
+    if (u.w() <= minW || v.w() <= minW || p.w() <= minW)
+        return 0.0f;
+    return u.x() * (v.y() * p.w() - v.w() * p.y())
+            - u.y() * (v.x() * p.w() - v.w() * p.x())
+            + u.w() * (v.x() * p.y() - v.y() * p.x());
+}
+
+void QSSGOcclusionCuller::addTriangles()
+{
+    const qsizetype triangleCount = m_clipVertices.size() / 3;
+
+    // Sort the edges so that the ones of neighboring triangles, which have
+    // the same end points, come next to each other
+    m_edges.resize(triangleCount * 3);
+    for (qsizetype i = 0; i < m_edges.size(); ++i) {
+        const QVector4D &u = m_clipVertices.at(i);
+        const QVector4D &v = m_clipVertices.at(i % 3 == 2 ? i - 2 : i + 1);
+        const std::array<float, 4> first { u.x(), u.y(), u.z(), u.w() };
+        const std::array<float, 4> second { v.x(), v.y(), v.z(), v.w() };
+        Edge &edge = m_edges[i];
+        edge.index = quint32(i);
+        edge.swapped = second < first;
+        const std::array<float, 4> &low = edge.swapped ? second : first;
+        const std::array<float, 4> &high = edge.swapped ? first : second;
+        std::copy(low.cbegin(), low.cend(), edge.key.begin());
+        std::copy(high.cbegin(), high.cend(), edge.key.begin() + 4);
+    }
+    std::sort(m_edges.begin(), m_edges.end(), [](const Edge &lhs, const Edge &rhs) { return lhs.key < rhs.key; });
+
+    // An edge is interior when exactly two triangles share it and they are on
+    // either side of it on screen. Otherwise it is on the outline.
+    m_interiorEdges.fill(0, triangleCount);
+    const auto side = [this](const Edge &edge) {
+        const qsizetype triangle = edge.index - edge.index % 3;
+        const QVector4D &u = m_clipVertices.at(edge.index);
+        const QVector4D &v = m_clipVertices.at(triangle + (edge.index + 1) % 3);
+        const QVector4D &p = m_clipVertices.at(triangle + (edge.index + 2) % 3);
+        const float result = sideOfEdge(u, v, p);
+        return edge.swapped ? -result : result;
+    };
+    for (qsizetype begin = 0, end = 0; begin < m_edges.size(); begin = end) {
+        end = begin + 1;
+        while (end < m_edges.size() && m_edges.at(end).key == m_edges.at(begin).key)
+            ++end;
+        if (end - begin != 2)
+            continue;
+        const Edge &first = m_edges.at(begin);
+        const Edge &second = m_edges.at(begin + 1);
+        if (side(first) * side(second) < 0.0f) {
+            m_interiorEdges[first.index / 3] |= quint8(1 << (first.index % 3));
+            m_interiorEdges[second.index / 3] |= quint8(1 << (second.index % 3));
+        }
+    }
+
+    for (qsizetype i = 0; i < triangleCount; ++i) {
+        addTriangle(m_clipVertices.at(3 * i), m_clipVertices.at(3 * i + 1), m_clipVertices.at(3 * i + 2),
+                    m_interiorEdges.at(i));
+    }
+}
+
+void QSSGOcclusionCuller::addTriangle(const QVector4D &a, const QVector4D &b, const QVector4D &c, quint8 interiorEdges)
+{
+    // Clip against the near plane, z >= -w, which leaves up to a quad. Each
+    // corner keeps whether the edge to the next one is interior. The edge
+    // along the near plane is, as no box reaching in front of it is occluded.
+    const QVector4D in[3] = { a, b, c };
+    QVector4D polygon[4];
+    bool interior[4];
+    int count = 0;
+    for (int i = 0; i < 3; ++i) {
+        const QVector4D &current = in[i];
+        const QVector4D &next = in[(i + 1) % 3];
+        const float currentDistance = current.z() + current.w();
+        const float nextDistance = next.z() + next.w();
+        const bool edgeInterior = (interiorEdges & (1 << i)) != 0;
+        if (currentDistance >= 0.0f) {
+            polygon[count] = current;
+            interior[count++] = edgeInterior;
+        }
+        if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+            polygon[count] = current + (next - current) * (currentDistance / (currentDistance - nextDistance));
+            interior[count++] = (currentDistance >= 0.0f) || edgeInterior;
+        }
+    }
+    if (count < 3)
+        return;
+
+    QVector3D screen[4];
+    for (int i = 0; i < count; ++i) {
+        if (polygon[i].w() <= minW)
+            return;
+        screen[i] = toScreen(polygon[i]);
+    }
+
+    const auto edges = [](bool ab, bool bc, bool ca) {
+        return quint8((ab ? 1 : 0) | (bc ? 2 : 0) | (ca ? 4 : 0));
+    };
+    ++m_triangleCount;
+    if (count == 4) {
+        // The diagonal of the quad is interior
+        rasterize(screen[0], screen[1], screen[2], edges(interior[0], interior[1], true));
+        rasterize(screen[0], screen[2], screen[3], edges(true, interior[2], interior[3]));
+    } else {
+        rasterize(screen[0], screen[1], screen[2], edges(interior[0], interior[1], interior[2]));
+    }
+}
+
+void QSSGOcclusionCuller::rasterize(const QVector3D &a, const QVector3D &b, const QVector3D &c, quint8 interiorEdges)
+{
+    // Edge function of the edge from u to v at p, positive on the inside for
+    // counter-clockwise triangles
+    const auto edge = [](const QVector3D &u, const QVector3D &v, float px, float py) {
+        return (v.x() - u.x()) * (py - u.y()) - (v.y() - u.y()) * (px - u.x());
+    };
+
+    float area = edge(a, b, c.x(), c.y());
+    if (qFuzzyIsNull(area))
+        return;
+    // Both sides of the occluders are rasterized
+    const bool counterClockwise = area > 0.0f;
+    const QVector3D &p0 = a;
+    const QVector3D &p1 = counterClockwise ? b : c;
+    const QVector3D &p2 = counterClockwise ? c : b;
+    area = std::abs(area);
+
+    // A texel is entirely on the inner side of an edge when the edge function
+    // at its center is at least the largest change of it within half a texel.
+    // The edges p1p2, p2p0 and p0p1 are bc, ca and ab, or bc, ab and ca.
+    const bool interior0 = (interiorEdges & 2) != 0;
+    const bool interior1 = (interiorEdges & (counterClockwise ? 4 : 1)) != 0;
+    const bool interior2 = (interiorEdges & (counterClockwise ? 1 : 4)) != 0;
+    const auto inset = [](bool interior, const QVector3D &u, const QVector3D &v) {
+        return interior ? 0.0f : 0.5f * (std::abs(v.x() - u.x()) + std::abs(v.y() - u.y()));
+    };
+    const float inset0 = inset(interior0, p1, p2);
+    const float inset1 = inset(interior1, p2, p0);
+    const float inset2 = inset(interior2, p0, p1);
+
+    // The pixels with their centers inside the bounding box of the triangle
+    const float minX = qMin(p0.x(), qMin(p1.x(), p2.x()));
+    const float minY = qMin(p0.y(), qMin(p1.y(), p2.y()));
+    const float maxX = qMax(p0.x(), qMax(p1.x(), p2.x()));
+    const float maxY = qMax(p0.y(), qMax(p1.y(), p2.y()));
+    if (maxX < 0.5f || maxY < 0.5f || minX > float(m_width) - 0.5f || minY > float(m_height) - 0.5f)
+        return;
+    const int x0 = qMax(0, int(std::ceil(minX - 0.5f)));
+    const int y0 = qMax(0, int(std::ceil(minY - 0.5f)));
+    const int x1 = qMin(m_width - 1, int(std::floor(maxX - 0.5f)));
+    const int y1 = qMin(m_height - 1, int(std::floor(maxY - 0.5f)));
+    if (x0 > x1 || y0 > y1)
+        return;
+
+    // The weights of p0, p1 and p2 are the edge functions of the opposite
+    // edges, they change linearly along a row.
+    const float invArea = 1.0f / area;
+    const float step0 = -(p2.y() - p1.y());
+    const float step1 = -(p0.y() - p2.y());
+    const float step2 = -(p1.y() - p0.y());
+
+    // The farthest depth of the triangle within half a texel of the center,
+    // but not beyond its corners
+    const float depthStepX = (step0 * p0.z() + step1 * p1.z() + step2 * p2.z()) * invArea;
+    const float depthStepY = ((p2.x() - p1.x()) * p0.z() + (p0.x() - p2.x()) * p1.z() + (p1.x() - p0.x()) * p2.z()) * invArea;
+    const float depthSpread = 0.5f * (std::abs(depthStepX) + std::abs(depthStepY));
+    const float maxDepth = qMax(p0.z(), qMax(p1.z(), p2.z()));
+
+    Level &level = m_levels[0];
+    for (int y = y0; y <= y1; ++y) {
+        const float py = float(y) + 0.5f;
+        const float px = float(x0) + 0.5f;
+        float w0 = edge(p1, p2, px, py);
+        float w1 = edge(p2, p0, px, py);
+        float w2 = edge(p0, p1, px, py);
+        float *row = level.depth.data() + qsizetype(y) * m_width;
+        for (int x = x0; x <= x1; ++x) {
+            if (w0 >= inset0 && w1 >= inset1 && w2 >= inset2) {
+                const float depth = qMin((w0 * p0.z() + w1 * p1.z() + w2 * p2.z()) * invArea + depthSpread, maxDepth);
+                row[x] = qMin(row[x], depth);
+            }
+            w0 += step0;
+            w1 += step1;
+            w2 += step2;
+        }
+    }
+}
+
+QT_END_NAMESPACE
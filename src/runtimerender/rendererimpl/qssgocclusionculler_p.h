@@ -0,0 +1,105 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef QSSGOCCLUSIONCULLER_P_H
+#define QSSGOCCLUSIONCULLER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRuntimeRender/qtquick3druntimerenderglobal.h>
+
+#include <QtQuick3DUtils/private/qssgbounds3_p.h>
+#include <QtQuick3DUtils/private/qssgdataref_p.h>
+#include <QtQuick3DUtils/private/qssgmeshbvh_p.h>
+
+#include <QtCore/qsize.h>
+#include <QtCore/qvector.h>
+#include <QtGui/qmatrix4x4.h>
+
+#include <array>
+
+QT_BEGIN_NAMESPACE
+
+// Occlusion culling against designated occluders, done on the CPU so that it
+// works the same with every graphics API and does not wait for the GPU. The
+// triangles of the occluders are rasterized from the camera's point of view
+// into a small depth buffer, from which a pyramid of the farthest depth per
+// block of pixels is built. A bounding box is occluded when its nearest depth
+// is behind the farthest depth of the occluders everywhere it covers, which is
+// tested on the level of the pyramid where it covers two by two texels at most.
+//
+// The rasterization is conservative: the outline edges of the occluders are
+// moved inwards by half a texel, so that only texels they cover entirely are
+// written, with the farthest depth of the triangle within them. Gaps between
+// occluders, however narrow, are therefore never seen as covered. Edges that
+// two triangles of an occluder share, and that lie between them on screen,
+// are kept where they are, so that the surface leaves no gaps along them.
+class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGOcclusionCuller
+{
+public:
+    static constexpr int BufferWidth = 256;
+
+    // Clears the depth buffer. viewProjection maps to clip space with depth
+    // in [-1, 1], the size of the viewport gives the aspect ratio of the buffer.
+    void begin(const QMatrix4x4 &viewProjection, const QSize &viewportSize);
+    // Rasterizes the triangles, in the local space of globalTransform
+    void addOccluder(const QSSGMeshBVHTriangles &triangles, const QMatrix4x4 &globalTransform);
+    void addOccluder(QSSGDataView<QVector3D> triangleVertices, const QMatrix4x4 &globalTransform);
+    // Builds the pyramid, after which boxes can be tested
+    void end();
+    // Makes isOccluded() return false until the next begin()
+    void reset();
+
+    [[nodiscard]] bool isActive() const { return m_active; }
+    [[nodiscard]] bool isOccluded(const QSSGBounds3 &globalBounds) const;
+
+    [[nodiscard]] quint32 occluderTriangleCount() const { return m_triangleCount; }
+    [[nodiscard]] QSize bufferSize() const { return { m_width, m_height }; }
+
+private:
+    struct Level
+    {
+        int width;
+        int height;
+        QVector<float> depth;
+    };
+
+    // An edge of a triangle in m_clipVertices, keyed by its end points in
+    // lexicographic order, to find the edges triangles share
+    struct Edge
+    {
+        std::array<float, 8> key;
+        quint32 index; // of the first vertex in m_clipVertices
+        bool swapped; // whether the key has the end points in reverse order
+    };
+
+    // Interior edges, bit 0 for ab, 1 for bc and 2 for ca, are not moved inwards
+    void addTriangles();
+    void addTriangle(const QVector4D &a, const QVector4D &b, const QVector4D &c, quint8 interiorEdges);
+    void rasterize(const QVector3D &a, const QVector3D &b, const QVector3D &c, quint8 interiorEdges);
+    [[nodiscard]] QVector3D toScreen(const QVector4D &clip) const;
+
+    QMatrix4x4 m_viewProjection;
+    QVector<Level> m_levels;
+    // The triangles of the occluder being added, and their edges
+    QVector<QVector4D> m_clipVertices;
+    QVector<Edge> m_edges;
+    QVector<quint8> m_interiorEdges;
+    int m_width = 0;
+    int m_height = 0;
+    quint32 m_triangleCount = 0;
+    bool m_active = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSSGOCCLUSIONCULLER_P_H
@@ -56,6 +56,12 @@ QSSGSubsetRenderable::QSSGSubsetRenderable(Type type,
         globalBounds.transform(globalTransform);
 }
 
+QRhiBuffer *QSSGSubsetRenderable::vertexBuffer() const
+{
+    return modelContext.skinnedVertexBuffer ? modelContext.skinnedVertexBuffer
+                                            : subset.rhi.vertexBuffer->buffer();
+}
+
 QSSGParticlesRenderable::QSSGParticlesRenderable(QSSGRenderableObjectFlags inFlags,
                                                  const QVector3D &inWorldCenterPt,
                                                  QSSGRenderer *rendr,
@@ -199,6 +199,9 @@ struct QSSGRenderableNodeEntry
     mutable QSSGShaderLightListView lights;
     mutable float globalOpacity { 1.0f };
     mutable quint16 overridden { Original };
+    // Set for the models of a LOD group that cross-fades its levels, 0 otherwise.
+    // The coverage of the dither pattern, negative for its complement.
+    float lodCrossFade { 0.0f };
 
     bool isNull() const { return (node == nullptr); }
     QSSGRenderableNodeEntry() = default;
@@ -292,6 +295,11 @@ struct QSSGModelContext
     }
 
     QSSGDataRef<QSSGSubsetRenderable> subsets;
+
+    // Set when the skinning pre-pass writes the skinned and morphed vertices
+    // of the model to a buffer of its own this frame. The subsets then draw
+    // from it with skinning and morphing left out of their shaders.
+    QRhiBuffer *skinnedVertexBuffer = nullptr;
 };
 
 Q_STATIC_ASSERT(std::is_trivially_destructible<QSSGModelContext>::value);
@@ -305,6 +313,7 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGSubsetRenderable : public QSSGRenderabl
     int reflectionProbeIndex = -1;
     float distanceFromReflectionProbe;
     quint32 subsetLevelOfDetail = 0;
+    float lodCrossFade = 0.0f; // See QSSGRenderableNodeEntry
     QSSGShaderReflectionProbe reflectionProbe;
     QSSGRenderer *renderer = nullptr;
     const QSSGModelContext &modelContext;
@@ -316,6 +325,17 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGSubsetRenderable : public QSSGRenderabl
     QSSGShaderDefaultMaterialKey shaderDescription;
     const QSSGShaderLightListView &lights;
 
+    // When the subset has meshlets, the index ranges of the ones that are not
+    // culled for the camera, allocated per frame. The main and depth pre-pass
+    // draw only these, the passes that do not render from the camera's point
+    // of view draw the whole subset.
+    struct DrawRange {
+        quint32 count;
+        quint32 offset;
+    };
+    QSSGDataView<DrawRange> visibleRanges;
+    bool hasVisibleRanges = false;
+
     struct {
         // Transient (due to the subsetRenderable being allocated using a
         // per-frame allocator on every frame), not owned refs from the
@@ -336,6 +356,10 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGSubsetRenderable : public QSSGRenderabl
             QRhiGraphicsPipeline *pipeline = nullptr;
             QRhiShaderResourceBindings *srb[6] = {};
         } reflectionPass;
+        struct {
+            QRhiGraphicsPipeline *pipeline = nullptr;
+            QRhiShaderResourceBindings *srb = nullptr;
+        } pickPass;
     } rhiRenderData;
 
     QSSGSubsetRenderable(Type type,
@@ -352,6 +376,7 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGSubsetRenderable : public QSSGRenderabl
                          const QSSGShaderLightListView &inLights);
 
     [[nodiscard]] const QSSGRenderGraphObject &getMaterial() const { return material; }
+    [[nodiscard]] QRhiBuffer *vertexBuffer() const;
 };
 
 Q_STATIC_ASSERT(std::is_trivially_destructible<QSSGSubsetRenderable>::value);
@@ -388,6 +413,10 @@ struct Q_QUICK3DRUNTIMERENDER_EXPORT QSSGParticlesRenderable : public QSSGRender
             QRhiGraphicsPipeline *pipeline = nullptr;
             QRhiShaderResourceBindings *srb[6] = {};
         } reflectionPass;
+        struct {
+            QRhiGraphicsPipeline *pipeline = nullptr;
+            QRhiShaderResourceBindings *srb = nullptr;
+        } pickPass;
     } rhiRenderData;
 
     QSSGParticlesRenderable(QSSGRenderableObjectFlags inFlags,
@@ -91,7 +91,11 @@ void QSSGRenderer::cleanupUnreferencedBuffers(QSSGRenderLayer *inLayer)
 
 void QSSGRenderer::resetResourceCounters(QSSGRenderLayer *inLayer)
 {
-    m_contextInterface->bufferManager()->resetUsageCounters(m_frameCount, inLayer);
+    const auto &bufferManager = m_contextInterface->bufferManager();
+    // The detail requested for streamed textures in the previous window frame
+    // is applied before anything gets to use them in this one.
+    bufferManager->updateStreamedTextures();
+    bufferManager->resetUsageCounters(m_frameCount, inLayer);
 }
 
 bool QSSGRenderer::prepareLayerForRender(QSSGRenderLayer &inLayer)
@@ -122,11 +126,22 @@ void QSSGRenderer::rhiPrepare(QSSGRenderLayer &inLayer)
         // that does can and should be done in the rhi prepare phase.
         // It is assumed that passes are sorted in the list with regards to
         // execution order.
+        auto &stats = QSSGRhiContextStats::get(*rhiCtx);
+        const bool statsEnabled = stats.isEnabled();
         const auto &activePasses = theRenderData->activePasses;
         for (const auto &pass : activePasses) {
+            if (statsEnabled)
+                stats.beginPassTiming(pass->debugName(), QSSGRhiContextStats::PassPhase::Prepare);
             pass->renderPrep(*this, *theRenderData);
-            if (pass->passType() == QSSGRenderPass::Type::Standalone)
+            if (statsEnabled)
+                stats.endPassTiming();
+            if (pass->passType() == QSSGRenderPass::Type::Standalone) {
+                if (statsEnabled)
+                    stats.beginPassTiming(pass->debugName(), QSSGRhiContextStats::PassPhase::Render);
                 pass->renderPass(*this);
+                if (statsEnabled)
+                    stats.endPassTiming();
+            }
         }
 
         endLayerRender();
@@ -141,10 +156,17 @@ void QSSGRenderer::rhiRender(QSSGRenderLayer &inLayer)
     if (theRenderData->layerPrepResult.isLayerVisible()) {
         QSSG_ASSERT(theRenderData->camera, return);
         beginLayerRender(*theRenderData);
+        auto &stats = QSSGRhiContextStats::get(*contextInterface()->rhiContext());
+        const bool statsEnabled = stats.isEnabled();
         const auto &activePasses = theRenderData->activePasses;
         for (const auto &pass : activePasses) {
-            if (pass->passType() == QSSGRenderPass::Type::Main || pass->passType() == QSSGRenderPass::Type::Extension)
+            if (pass->passType() == QSSGRenderPass::Type::Main || pass->passType() == QSSGRenderPass::Type::Extension) {
+                if (statsEnabled)
+                    stats.beginPassTiming(pass->debugName(), QSSGRhiContextStats::PassPhase::Render);
                 pass->renderPass(*this);
+                if (statsEnabled)
+                    stats.endPassTiming();
+            }
         }
         endLayerRender();
     }
@@ -159,13 +181,16 @@ static void cleanupResourcesImpl(const QSSGRenderContextInterface &rci, const Co
 
     const auto &bufferManager = rci.bufferManager();
 
+    // The draw call data of all the models is released in one go, instead of
+    // going through the whole table for each model.
+    QSet<const void *> models;
+
     for (const auto &resource : resources) {
         if (resource->type == QSSGRenderGraphObject::Type::Geometry) {
             auto geometry = static_cast<QSSGRenderGeometry*>(resource);
             bufferManager->releaseGeometry(geometry);
         } else if (resource->type == QSSGRenderGraphObject::Type::Model) {
-            auto model = static_cast<QSSGRenderModel*>(resource);
-            QSSGRhiContextPrivate::get(rhiCtx.get())->cleanupDrawCallData(model);
+            models.insert(resource);
         } else if (resource->type == QSSGRenderGraphObject::Type::TextureData) {
             auto textureData = static_cast<QSSGRenderTextureData *>(resource);
             bufferManager->releaseTextureData(textureData);
@@ -178,6 +203,9 @@ static void cleanupResourcesImpl(const QSSGRenderContextInterface &rci, const Co
 
         delete resource;
     }
+
+    // Only the addresses are compared, the models may be gone already.
+    QSSGRhiContextPrivate::get(rhiCtx.get())->cleanupDrawCallData(models);
 }
 
 void QSSGRenderer::cleanupResources(QList<QSSGRenderGraphObject *> &resources)
@@ -274,7 +302,17 @@ QSSGRhiShaderPipelinePtr QSSGRendererPrivate::generateRhiShaderPipeline(QSSGRend
     const auto &theCache = m_contextInterface->shaderCache();
     const auto &shaderProgramGenerator = m_contextInterface->shaderProgramGenerator();
     const auto &shaderLibraryManager = m_contextInterface->shaderLibraryManager();
-    return QSSGRendererPrivate::generateRhiShaderPipelineImpl(inRenderable, *shaderLibraryManager, *theCache, *shaderProgramGenerator, m_currentLayer->defaultMaterialShaderKeyProperties, inFeatureSet, m_generatedShaderString);
+
+    // Another View3D in the window may have used the same material already.
+    // Look for that with the binary key first, the string form of the key is
+    // only needed to find or generate a new pipeline.
+    if (auto maybePipeline = theCache->tryGetRhiShaderPipeline(inRenderable.shaderDescription, inFeatureSet))
+        return maybePipeline;
+
+    auto pipeline = QSSGRendererPrivate::generateRhiShaderPipelineImpl(inRenderable, *shaderLibraryManager, *theCache, *shaderProgramGenerator, m_currentLayer->defaultMaterialShaderKeyProperties, inFeatureSet, m_generatedShaderString);
+    if (pipeline)
+        theCache->addRhiShaderPipeline(inRenderable.shaderDescription, inFeatureSet, pipeline);
+    return pipeline;
 }
 
 void QSSGRenderer::beginFrame(QSSGRenderLayer &layer, bool allowRecursion)
@@ -283,12 +321,18 @@ void QSSGRenderer::beginFrame(QSSGRenderLayer &layer, bool allowRecursion)
     if (executeBeginFrame) {
         m_contextInterface->perFrameAllocator()->reset();
         QSSGRHICTX_STAT(m_contextInterface->rhiContext().get(), start(&layer));
+        QSSGRhiContextPrivate::get(m_contextInterface->rhiContext().get())->beginFrame();
         resetResourceCounters(&layer);
     }
 }
 
 bool QSSGRenderer::endFrame(QSSGRenderLayer &layer, bool allowRecursion)
 {
+    // Done per layer, also for nested ones, since the next View3D may want
+    // to reuse the textures.
+    if (layer.renderData)
+        layer.renderData->releaseRenderResults();
+
     const bool executeEndFrame = !(allowRecursion && (--m_activeFrameRef != 0));
     if (executeEndFrame) {
         cleanupUnreferencedBuffers(&layer);
@@ -12,9 +12,12 @@
 #include "../resourcemanager/qssgrenderbuffermanager_p.h"
 #include "../qssgrenderdefaultmaterialshadergenerator_p.h"
 #include <QtQuick3DUtils/private/qssgassert_p.h>
+#include <QtQuick3DUtils/private/qssgutils_p.h>
 
 #include <QtCore/qbitarray.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 static constexpr float QSSG_PI = float(M_PI);
@@ -92,6 +95,11 @@ static void updateUniformsForDefaultMaterial(QSSGRhiShaderPipeline &shaderPipeli
                                                           subsetRenderable.renderableFlags.receivesReflections(),
                                                           depthAdjust,
                                                           lightmapTexture);
+
+    if (subsetRenderable.lodCrossFade != 0.0f) {
+        shaderPipeline.setUniform(ubufData, "qt_lodCrossFade", &subsetRenderable.lodCrossFade, sizeof(float),
+                                  &shaderPipeline.commonUniformIndices.lodCrossFadeIdx);
+    }
 }
 
 std::pair<QSSGBoxPoints, QSSGBoxPoints> RenderHelpers::calculateSortedObjectBounds(const QSSGRenderableObjectList &sortedOpaqueObjects,
@@ -180,6 +188,18 @@ static void setupCubeReflectionCameras(const QSSGRenderReflectionProbe *inProbe,
     }
 }
 
+static QSSGClippingFrustum cubeFaceFrustum(const QSSGRenderCamera &camera, const QMatrix4x4 &viewProjection)
+{
+    QSSGClipPlane nearPlane;
+    const QMatrix3x3 theUpper33(camera.globalTransform.normalMatrix());
+    QVector3D dir(QSSGUtils::mat33::transform(theUpper33, QVector3D(0, 0, -1)));
+    dir.normalize();
+    nearPlane.normal = dir;
+    const QVector3D theGlobalPos = camera.getGlobalPos() + camera.clipNear * dir;
+    nearPlane.d = -(QVector3D::dotProduct(dir, theGlobalPos));
+    return QSSGClippingFrustum(viewProjection, nearPlane);
+}
+
 static void setupCameraForShadowMap(const QSSGRenderCamera &inCamera,
                                     const QSSGRenderLight *inLight,
                                     QSSGRenderCamera &theCamera,
@@ -455,6 +475,16 @@ static int setupInstancing(QSSGSubsetRenderable *renderable, QSSGRhiGraphicsPipe
     return instanceBufferBinding;
 }
 
+// Skinned vertices are in world space already, no matter if the vertex shader
+// skins them or they come skinned from the skinning pre-pass.
+static inline bool hasSkinnedVertices(const QSSGShaderDefaultMaterialKeyProperties &keyProperties,
+                                      const QSSGSubsetRenderable &renderable)
+{
+    if (renderable.modelContext.skinnedVertexBuffer)
+        return renderable.modelContext.model.usesBoneTexture();
+    return keyProperties.m_boneCount.getValue(renderable.shaderDescription) > 0;
+}
+
 static void rhiPrepareResourcesForReflectionMap(QSSGRhiContext *rhiCtx,
                                                 QSSGPassKey passKey,
                                                 const QSSGLayerRenderData &inData,
@@ -480,7 +510,7 @@ static void rhiPrepareResourcesForReflectionMap(QSSGRhiContext *rhiCtx,
         QMatrix4x4 modelViewProjection;
         if (inObject.type == QSSGRenderableObject::Type::DefaultMaterialMeshSubset || inObject.type == QSSGRenderableObject::Type::CustomMaterialMeshSubset) {
             QSSGSubsetRenderable &renderable(static_cast<QSSGSubsetRenderable &>(inObject));
-            const bool hasSkinning = defaultMaterialShaderKeyProperties.m_boneCount.getValue(renderable.shaderDescription) > 0;
+            const bool hasSkinning = hasSkinnedVertices(defaultMaterialShaderKeyProperties, renderable);
             modelViewProjection = hasSkinning ? pEntry->m_viewProjection
                                               : pEntry->m_viewProjection * renderable.globalTransform;
         }
@@ -550,7 +580,7 @@ static void rhiPrepareResourcesForShadowMap(QSSGRhiContext *rhiCtx,
         QMatrix4x4 modelViewProjection;
         QSSGSubsetRenderable &renderable(static_cast<QSSGSubsetRenderable &>(*theObject));
         if (theObject->type == QSSGRenderableObject::Type::DefaultMaterialMeshSubset || theObject->type == QSSGRenderableObject::Type::CustomMaterialMeshSubset) {
-            const bool hasSkinning = defaultMaterialShaderKeyProperties.m_boneCount.getValue(renderable.shaderDescription) > 0;
+            const bool hasSkinning = hasSkinnedVertices(defaultMaterialShaderKeyProperties, renderable);
             modelViewProjection = hasSkinning ? pEntry->m_lightVP
                                               : pEntry->m_lightVP * renderable.globalTransform;
             const quintptr entryIdx = quintptr(cubeFace != QSSGRenderTextureCubeFaceNone) * (cubeFaceIdx + (quintptr(renderable.subset.offset) << 3));
@@ -631,8 +661,9 @@ static void rhiPrepareResourcesForShadowMap(QSSGRhiContext *rhiCtx,
                                     dummyTexture, sampler);
             }
 
-            QRhiShaderResourceBindings *srb = rhiCtxD->srb(bindings);
-            subsetRenderable.rhiRenderData.shadowPass.pipeline = rhiCtxD->pipeline(*ps,
+            QRhiShaderResourceBindings *srb = rhiCtxD->srb(*dcd, bindings);
+            subsetRenderable.rhiRenderData.shadowPass.pipeline = rhiCtxD->pipeline(*dcd,
+                                                                                   *ps,
                                                                                    pEntry->m_rhiRenderPassDesc,
                                                                                    srb);
             subsetRenderable.rhiRenderData.shadowPass.srb[cubeFaceIdx] = srb;
@@ -900,52 +931,14 @@ void RenderHelpers::rhiPrepareRenderable(QSSGRhiContext *rhiCtx,
             // Depth and SSAO textures
             addDepthTextureBindings(rhiCtx, shaderPipeline.get(), bindings);
 
-            // Instead of always doing a QHash find in srb(), store the binding
-            // list and the srb object in the per-model+material
-            // QSSGRhiUniformBufferSet. While this still needs comparing the
-            // binding list, to see if something has changed, it results in
-            // significant gains with lots of models in the scene (because the
-            // srb hash table becomes large then, so avoiding the lookup as
-            // much as possible is helpful)
-            QRhiShaderResourceBindings *&srb = dcd.srb;
-            bool srbChanged = false;
-            if (!srb || bindings != dcd.bindings) {
-                srb = rhiCtxD->srb(bindings);
-                dcd.bindings = bindings;
-                srbChanged = true;
-            }
-
-            if (cubeFace != QSSGRenderTextureCubeFaceNone)
+            QRhiShaderResourceBindings *srb = rhiCtxD->srb(dcd, bindings);
+            QRhiGraphicsPipeline *pipeline = rhiCtxD->pipeline(dcd, *ps, renderPassDescriptor, srb);
+            if (cubeFace != QSSGRenderTextureCubeFaceNone) {
                 subsetRenderable.rhiRenderData.reflectionPass.srb[cubeFaceIdx] = srb;
-            else
-                subsetRenderable.rhiRenderData.mainPass.srb = srb;
-
-            const auto pipelineKey = QSSGGraphicsPipelineStateKey::create(*ps, renderPassDescriptor, srb);
-            if (dcd.pipeline
-                && !srbChanged
-                && dcd.renderTargetDescriptionHash == pipelineKey.extra.renderTargetDescriptionHash // we have the hash code anyway, use it to early out upon mismatch
-                && dcd.renderTargetDescription == pipelineKey.renderTargetDescription
-                && dcd.ps == *ps)
-            {
-                if (cubeFace != QSSGRenderTextureCubeFaceNone)
-                    subsetRenderable.rhiRenderData.reflectionPass.pipeline = dcd.pipeline;
-                else
-                    subsetRenderable.rhiRenderData.mainPass.pipeline = dcd.pipeline;
+                subsetRenderable.rhiRenderData.reflectionPass.pipeline = pipeline;
             } else {
-                if (cubeFace != QSSGRenderTextureCubeFaceNone) {
-                    subsetRenderable.rhiRenderData.reflectionPass.pipeline = rhiCtxD->pipeline(pipelineKey,
-                                                                                               renderPassDescriptor,
-                                                                                               srb);
-                    dcd.pipeline = subsetRenderable.rhiRenderData.reflectionPass.pipeline;
-                } else {
-                    subsetRenderable.rhiRenderData.mainPass.pipeline = rhiCtxD->pipeline(pipelineKey,
-                                                                                         renderPassDescriptor,
-                                                                                         srb);
-                    dcd.pipeline = subsetRenderable.rhiRenderData.mainPass.pipeline;
-                }
-                dcd.renderTargetDescriptionHash = pipelineKey.extra.renderTargetDescriptionHash;
-                dcd.renderTargetDescription = pipelineKey.renderTargetDescription;
-                dcd.ps = *ps;
+                subsetRenderable.rhiRenderData.mainPass.srb = srb;
+                subsetRenderable.rhiRenderData.mainPass.pipeline = pipeline;
             }
         }
         break;
@@ -1010,7 +1003,7 @@ void RenderHelpers::rhiRenderRenderable(QSSGRhiContext *rhiCtx,
         if (!ps || !srb)
             return;
 
-        QRhiBuffer *vertexBuffer = subsetRenderable.subset.rhi.vertexBuffer->buffer();
+        QRhiBuffer *vertexBuffer = subsetRenderable.vertexBuffer();
         QRhiBuffer *indexBuffer = subsetRenderable.subset.rhi.indexBuffer ? subsetRenderable.subset.rhi.indexBuffer->buffer() : nullptr;
 
         QRhiCommandBuffer *cb = rhiCtx->commandBuffer();
@@ -1045,8 +1038,12 @@ void RenderHelpers::rhiRenderRenderable(QSSGRhiContext *rhiCtx,
             cb->setStencilRef(state.stencilRef);
         if (indexBuffer) {
             cb->setVertexInput(0, vertexBufferCount, vertexBuffers, indexBuffer, 0, subsetRenderable.subset.rhi.indexBuffer->indexFormat());
-            cb->drawIndexed(subsetRenderable.subset.lodCount(subsetRenderable.subsetLevelOfDetail), instances, subsetRenderable.subset.lodOffset(subsetRenderable.subsetLevelOfDetail));
-            QSSGRHICTX_STAT(rhiCtx, drawIndexed(subsetRenderable.subset.lodCount(subsetRenderable.subsetLevelOfDetail), instances));
+            if (subsetRenderable.hasVisibleRanges && cubeFace == QSSGRenderTextureCubeFaceNone) {
+                rhiDrawVisibleRanges(rhiCtx, subsetRenderable);
+            } else {
+                cb->drawIndexed(subsetRenderable.subset.lodCount(subsetRenderable.subsetLevelOfDetail), instances, subsetRenderable.subset.lodOffset(subsetRenderable.subsetLevelOfDetail));
+                QSSGRHICTX_STAT(rhiCtx, drawIndexed(subsetRenderable.subset.lodCount(subsetRenderable.subsetLevelOfDetail), instances));
+            }
         } else {
             cb->setVertexInput(0, vertexBufferCount, vertexBuffers);
             cb->draw(subsetRenderable.subset.count, instances, subsetRenderable.subset.offset);
@@ -1073,6 +1070,15 @@ void RenderHelpers::rhiRenderRenderable(QSSGRhiContext *rhiCtx,
     }
 }
 
+void RenderHelpers::rhiDrawVisibleRanges(QSSGRhiContext *rhiCtx, const QSSGSubsetRenderable &renderable)
+{
+    QRhiCommandBuffer *cb = rhiCtx->commandBuffer();
+    for (const auto &range : renderable.visibleRanges) {
+        cb->drawIndexed(range.count, 1, range.offset);
+        QSSGRHICTX_STAT(rhiCtx, drawIndexed(range.count, 1));
+    }
+}
+
 void RenderHelpers::rhiRenderShadowMap(QSSGRhiContext *rhiCtx,
                                        QSSGPassKey passKey,
                                        QSSGRhiGraphicsPipelineState &ps,
@@ -1099,7 +1105,7 @@ void RenderHelpers::rhiRenderShadowMap(QSSGRhiContext *rhiCtx,
             if (theObject->type == QSSGRenderableObject::Type::DefaultMaterialMeshSubset || theObject->type == QSSGRenderableObject::Type::CustomMaterialMeshSubset) {
                 QSSGSubsetRenderable *renderable(static_cast<QSSGSubsetRenderable *>(theObject));
 
-                QRhiBuffer *vertexBuffer = renderable->subset.rhi.vertexBuffer->buffer();
+                QRhiBuffer *vertexBuffer = renderable->vertexBuffer();
                 QRhiBuffer *indexBuffer = renderable->subset.rhi.indexBuffer
                         ? renderable->subset.rhi.indexBuffer->buffer()
                         : nullptr;
@@ -1207,7 +1213,7 @@ void RenderHelpers::rhiRenderShadowMap(QSSGRhiContext *rhiCtx,
         QSSGRhiShaderResourceBindingList bindings;
         bindings.addUniformBuffer(0, RENDERER_VISIBILITY_ALL, dcd.ubuf);
         bindings.addTexture(1, QRhiShaderResourceBinding::FragmentStage, map, sampler);
-        QRhiShaderResourceBindings *srb = rhiCtxD->srb(bindings);
+        QRhiShaderResourceBindings *srb = rhiCtxD->srb(dcd, bindings);
 
         QSSGRhiQuadRenderer::Flags quadFlags;
         if (orthographic) // orthoshadowshadowblurx and y have attr_uv as well
@@ -1223,10 +1229,13 @@ void RenderHelpers::rhiRenderShadowMap(QSSGRhiContext *rhiCtx,
             return;
         QSSGRhiGraphicsPipelineStatePrivate::setShaderPipeline(ps, blurYPipeline.get());
 
+        // The srb of the second step is kept in an entry of its own, so that
+        // both are released with the uniform buffer
+        QSSGRhiDrawCallData &dcdY = rhiCtxD->drawCallData({ map, nullptr, nullptr, 1 });
         bindings.clear();
         bindings.addUniformBuffer(0, RENDERER_VISIBILITY_ALL, dcd.ubuf);
         bindings.addTexture(1, QRhiShaderResourceBinding::FragmentStage, workMap, sampler);
-        srb = rhiCtxD->srb(bindings);
+        srb = rhiCtxD->srb(dcdY, bindings);
 
         renderer.rhiQuadRenderer()->prepareQuad(rhiCtx, nullptr);
         renderer.rhiQuadRenderer()->recordRenderQuadPass(rhiCtx, &ps, srb, pEntry->m_rhiBlurRenderTarget1, quadFlags);
@@ -1375,14 +1384,13 @@ void RenderHelpers::rhiRenderReflectionMap(QSSGRhiContext *rhiCtx,
         if (!pEntry)
             continue;
 
-        if (!pEntry->m_needsRender)
-            continue;
-
-        if (reflectionProbes[i]->refreshMode == QSSGRenderReflectionProbe::ReflectionRefreshMode::FirstFrame && pEntry->m_rendered)
-            continue;
-
-        if (reflectionProbes[i]->texture)
+        // Which faces are rendered is decided by QSSGRenderReflectionMap::scheduleUpdates()
+        const quint8 scheduledFaces = std::exchange(pEntry->m_scheduledFaces, 0);
+        if (!scheduledFaces || reflectionProbes[i]->texture) {
+            if (!pEntry->m_bakeFileName.isEmpty() && pEntry->m_renderedFaces == 0x3f && !pEntry->m_pendingFaces)
+                reflectionMapManager.bakeToFile(rhiCtx, *pEntry);
             continue;
+        }
 
         Q_ASSERT(pEntry->m_rhiDepthStencil);
         Q_ASSERT(pEntry->m_rhiCube);
@@ -1398,17 +1406,37 @@ void RenderHelpers::rhiRenderReflectionMap(QSSGRhiContext *rhiCtx,
                                          QSSGRenderCamera{QSSGRenderCamera::Type::PerspectiveCamera} };
         setupCubeReflectionCameras(reflectionProbes[i], theCameras);
         const bool swapYFaces = !rhi->isYUpInFramebuffer();
+
+        // The transparent casters are drawn after the opaque ones, the furthest
+        // from the probe first. The distances in the handles are from the camera.
+        QSSGRenderableObjectList probeObjects = reflectionPassObjects;
+        const QVector3D probePosition = reflectionProbes[i]->getGlobalPos();
+        const auto transparentBegin = std::stable_partition(probeObjects.begin(), probeObjects.end(), [](const QSSGRenderableObjectHandle &handle) {
+            return !handle.obj->renderableFlags.hasTransparency() && !handle.obj->renderableFlags.requiresScreenTexture();
+        });
+        for (auto it = transparentBegin; it != probeObjects.end(); ++it)
+            it->cameraDistanceSq = (it->obj->worldCenterPoint - probePosition).lengthSquared() + it->obj->depthBiasSq;
+        std::sort(transparentBegin, probeObjects.end(), [](const QSSGRenderableObjectHandle &lhs, const QSSGRenderableObjectHandle &rhs) {
+            return lhs.cameraDistanceSq > rhs.cameraDistanceSq;
+        });
+
+        // Each face only draws the casters in its own frustum
+        QSSGRenderableObjectList faceObjects[6];
         for (const auto face : QSSGRenderTextureCubeFaces) {
+            if (!(scheduledFaces & (1 << quint8(face))))
+                continue;
             const auto cubeFaceIdx = QSSGBaseTypeHelpers::indexOfCubeFace(face);
             theCameras[cubeFaceIdx].calculateViewProjectionMatrix(pEntry->m_viewProjection);
+            QSSGLayerRenderData::frustumCulling(cubeFaceFrustum(theCameras[cubeFaceIdx], pEntry->m_viewProjection),
+                                                probeObjects, faceObjects[cubeFaceIdx]);
 
             rhiPrepareResourcesForReflectionMap(rhiCtx, passKey, inData, pEntry, ps,
-                                                reflectionPassObjects, theCameras[cubeFaceIdx], renderer, face);
+                                                faceObjects[cubeFaceIdx], theCameras[cubeFaceIdx], renderer, face);
         }
         QRhiRenderPassDescriptor *renderPassDesc = nullptr;
-        for (auto face : QSSGRenderTextureCubeFaces) {
-            if (pEntry->m_timeSlicing == QSSGRenderReflectionProbe::ReflectionTimeSlicing::IndividualFaces)
-                face = pEntry->m_timeSliceFace;
+        for (const auto face : QSSGRenderTextureCubeFaces) {
+            if (!(scheduledFaces & (1 << quint8(face))))
+                continue;
 
             QSSGRenderTextureCubeFace outFace = face;
             // Faces are swapped similarly to shadow maps due to differences in backends
@@ -1440,28 +1468,37 @@ void RenderHelpers::rhiRenderReflectionMap(QSSGRhiContext *rhiCtx,
             }
 
             bool needsSetViewport = true;
-            for (const auto &handle : reflectionPassObjects)
+            for (const auto &handle : std::as_const(faceObjects[QSSGBaseTypeHelpers::indexOfCubeFace(face)]))
                 rhiRenderRenderable(rhiCtx, *ps, *handle.obj, &needsSetViewport, face);
 
             cb->endPass();
             QSSGRHICTX_STAT(rhiCtx, endRenderPass());
             Q_QUICK3D_PROFILE_END_WITH_STRING(QQuick3DProfiler::Quick3DRenderPass, 0, QSSG_RENDERPASS_NAME("reflection_cube", 0, outFace));
-
-            if (pEntry->m_timeSlicing == QSSGRenderReflectionProbe::ReflectionTimeSlicing::IndividualFaces)
-                break;
         }
         if (renderPassDesc)
             renderPassDesc->deleteLater();
 
-        pEntry->renderMips(rhiCtx);
+        pEntry->m_renderedFaces |= scheduledFaces;
+        pEntry->m_pendingFaces &= ~scheduledFaces;
+        const bool individualFaces = pEntry->m_timeSlicing == QSSGRenderReflectionProbe::ReflectionTimeSlicing::IndividualFaces;
+
+        // Time sliced probes prefilter the face they rendered, the others
+        // only once all their faces are up to date.
+        if (individualFaces || !pEntry->m_pendingFaces)
+            pEntry->renderMips(rhiCtx);
 
-        if (pEntry->m_timeSlicing == QSSGRenderReflectionProbe::ReflectionTimeSlicing::IndividualFaces)
-            pEntry->m_timeSliceFace = QSSGBaseTypeHelpers::next(pEntry->m_timeSliceFace); // Wraps
+        if (!pEntry->m_pendingFaces) {
+            if (individualFaces)
+                pEntry->m_timeSliceFace = QSSGBaseTypeHelpers::next(pEntry->m_timeSliceFace); // Wraps
 
-        if (reflectionProbes[i]->refreshMode == QSSGRenderReflectionProbe::ReflectionRefreshMode::FirstFrame)
-            pEntry->m_rendered = true;
+            if (reflectionProbes[i]->refreshMode == QSSGRenderReflectionProbe::ReflectionRefreshMode::FirstFrame)
+                pEntry->m_rendered = true;
 
-        reflectionProbes[i]->hasScheduledUpdate = false;
+            reflectionProbes[i]->hasScheduledUpdate = false;
+
+            if (!pEntry->m_bakeFileName.isEmpty() && pEntry->m_renderedFaces == 0x3f)
+                reflectionMapManager.bakeToFile(rhiCtx, *pEntry);
+        }
         pEntry->m_needsRender = false;
     }
 }
@@ -1471,6 +1508,8 @@ bool RenderHelpers::rhiPrepareAoTexture(QSSGRhiContext *rhiCtx, const QSize &siz
     QRhi *rhi = rhiCtx->rhi();
     bool needsBuild = false;
 
+    QSSGRhiContextPrivate::get(rhiCtx)->acquireTransientTexture(renderableTex, size, QRhiTexture::RGBA8, QRhiTexture::RenderTarget, false);
+
     if (!renderableTex->texture) {
         // the ambient occlusion texture is always non-msaa, even if multisampling is used in the main pass
         renderableTex->texture = rhiCtx->rhi()->newTexture(QRhiTexture::RGBA8, size, 1, QRhiTexture::RenderTarget);
@@ -1567,7 +1606,7 @@ void RenderHelpers::rhiRenderAoTexture(QSSGRhiContext *rhiCtx,
     QSSGRhiShaderResourceBindingList bindings;
     bindings.addUniformBuffer(0, RENDERER_VISIBILITY_ALL, dcd.ubuf);
     bindings.addTexture(1, QRhiShaderResourceBinding::FragmentStage, rhiDepthTexture.texture, sampler);
-    QRhiShaderResourceBindings *srb = rhiCtxD->srb(bindings);
+    QRhiShaderResourceBindings *srb = rhiCtxD->srb(dcd, bindings);
 
     renderer.rhiQuadRenderer()->prepareQuad(rhiCtx, nullptr);
     renderer.rhiQuadRenderer()->recordRenderQuadPass(rhiCtx, &ps, srb, rhiAoTexture.rt, {});
@@ -1581,6 +1620,8 @@ bool RenderHelpers::rhiPrepareScreenTexture(QSSGRhiContext *rhiCtx, const QSize
     if (wantsMips)
         flags |= QRhiTexture::MipMapped | QRhiTexture::UsedWithGenerateMips;
 
+    QSSGRhiContextPrivate::get(rhiCtx)->acquireTransientTexture(renderableTex, size, QRhiTexture::RGBA8, flags, true);
+
     if (!renderableTex->texture) {
         // always non-msaa, even if multisampling is used in the main pass
         renderableTex->texture = rhi->newTexture(QRhiTexture::RGBA8, size, 1, flags);
@@ -1671,7 +1712,7 @@ void RenderHelpers::rhiPrepareGrid(QSSGRhiContext *rhiCtx, QSSGPassKey passKey,
 
     bindings.addUniformBuffer(uniformBinding, RENDERER_VISIBILITY_ALL, dcd.ubuf);
 
-    layer.gridSrb = rhiCtxD->srb(bindings);
+    layer.gridSrb = rhiCtxD->srb(dcd, bindings);
     renderer.rhiQuadRenderer()->prepareQuad(rhiCtx, nullptr);
 
     cb->debugMarkEnd();
@@ -1752,9 +1793,9 @@ static void rhiPrepareSkyBox_helper(QSSGRhiContext *rhiCtx,
 
         if (cubeFace != QSSGRenderTextureCubeFaceNone) {
             const auto cubeFaceIdx = QSSGBaseTypeHelpers::indexOfCubeFace(cubeFace);
-            entry->m_skyBoxSrbs[cubeFaceIdx] = rhiCtxD->srb(bindings);
+            entry->m_skyBoxSrbs[cubeFaceIdx] = rhiCtxD->srb(dcd, bindings);
         } else {
-            layer.skyBoxSrb = rhiCtxD->srb(bindings);
+            layer.skyBoxSrb = rhiCtxD->srb(dcd, bindings);
         }
 
         if (cubeMapMode)
@@ -1883,9 +1924,10 @@ bool RenderHelpers::rhiPrepareDepthPass(QSSGRhiContext *rhiCtx,
                                               (obj->type == QSSGRenderableObject::Type::CustomMaterialMeshSubset));
             }
 
-            QRhiShaderResourceBindings *srb = rhiCtxD->srb(bindings);
+            QRhiShaderResourceBindings *srb = rhiCtxD->srb(*dcd, bindings);
 
-            subsetRenderable.rhiRenderData.depthPrePass.pipeline = rhiCtxD->pipeline(*ps,
+            subsetRenderable.rhiRenderData.depthPrePass.pipeline = rhiCtxD->pipeline(*dcd,
+                                                                                     *ps,
                                                                                      rpDesc,
                                                                                      srb);
             subsetRenderable.rhiRenderData.depthPrePass.srb = srb;
@@ -1939,7 +1981,7 @@ void RenderHelpers::rhiRenderDepthPass(QSSGRhiContext *rhiCtx,
                 QRhiCommandBuffer *cb = rhiCtx->commandBuffer();
                 QSSGSubsetRenderable *subsetRenderable(static_cast<QSSGSubsetRenderable *>(obj));
 
-                QRhiBuffer *vertexBuffer = subsetRenderable->subset.rhi.vertexBuffer->buffer();
+                QRhiBuffer *vertexBuffer = subsetRenderable->vertexBuffer();
                 QRhiBuffer *indexBuffer = subsetRenderable->subset.rhi.indexBuffer
                         ? subsetRenderable->subset.rhi.indexBuffer->buffer()
                         : nullptr;
@@ -1973,8 +2015,12 @@ void RenderHelpers::rhiRenderDepthPass(QSSGRhiContext *rhiCtx,
 
                 if (indexBuffer) {
                     cb->setVertexInput(0, vertexBufferCount, vertexBuffers, indexBuffer, 0, subsetRenderable->subset.rhi.indexBuffer->indexFormat());
-                    cb->drawIndexed(subsetRenderable->subset.count, instances, subsetRenderable->subset.offset);
-                    QSSGRHICTX_STAT(rhiCtx, drawIndexed(subsetRenderable->subset.count, instances));
+                    if (subsetRenderable->hasVisibleRanges) {
+                        rhiDrawVisibleRanges(rhiCtx, *subsetRenderable);
+                    } else {
+                        cb->drawIndexed(subsetRenderable->subset.count, instances, subsetRenderable->subset.offset);
+                        QSSGRHICTX_STAT(rhiCtx, drawIndexed(subsetRenderable->subset.count, instances));
+                    }
                 } else {
                     cb->setVertexInput(0, vertexBufferCount, vertexBuffers);
                     cb->draw(subsetRenderable->subset.count, instances, subsetRenderable->subset.offset);
@@ -1991,15 +2037,186 @@ void RenderHelpers::rhiRenderDepthPass(QSSGRhiContext *rhiCtx,
     rhiRenderDepthPassForImp(rhiCtx, pipelineState, sortedTransparentObjects, needsSetViewport);
 }
 
+bool RenderHelpers::rhiPrepareGpuPickPass(QSSGRhiContext *rhiCtx,
+                                          QSSGPassKey passKey,
+                                          const QSSGRhiGraphicsPipelineState &basePipelineState,
+                                          QRhiRenderPassDescriptor *rpDesc,
+                                          QSSGLayerRenderData &inData,
+                                          const QSSGRenderCamera &pickCamera,
+                                          const QSSGRenderableObjectList &pickObjects)
+{
+    // Each object is drawn with its 1-based position in pickObjects as the
+    // object id, 0 is left for the cleared background.
+    QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(rhiCtx);
+    const auto &defaultMaterialShaderKeyProperties = inData.getDefaultMaterialPropertyTable();
+    QMatrix4x4 pickViewProjection(Qt::Uninitialized);
+    pickCamera.calculateViewProjectionMatrix(pickViewProjection);
+
+    QSSGShaderFeatures featureSet;
+    featureSet.set(QSSGShaderFeatures::Feature::PickPass, true);
+
+    QSSGRhiGraphicsPipelineState ps = basePipelineState;
+    ps.samples = 1;
+    ps.flags |= { QSSGRhiGraphicsPipelineState::Flag::DepthTestEnabled, QSSGRhiGraphicsPipelineState::Flag::DepthWriteEnabled };
+    ps.flags.setFlag(QSSGRhiGraphicsPipelineState::Flag::BlendEnabled, false);
+    ps.targetBlend = {};
+
+    quint32 objectId = 0;
+    for (const QSSGRenderableObjectHandle &handle : pickObjects) {
+        ++objectId;
+        QSSGRenderableObject *obj = handle.obj;
+        if (obj->type != QSSGRenderableObject::Type::DefaultMaterialMeshSubset && obj->type != QSSGRenderableObject::Type::CustomMaterialMeshSubset)
+            continue;
+
+        QSSGSubsetRenderable &subsetRenderable(static_cast<QSSGSubsetRenderable &>(*obj));
+        subsetRenderable.rhiRenderData.pickPass = {};
+
+        const bool hasSkinning = hasSkinnedVertices(defaultMaterialShaderKeyProperties, subsetRenderable);
+        const QMatrix4x4 modelViewProjection = hasSkinning ? pickViewProjection
+                                                           : pickViewProjection * subsetRenderable.globalTransform;
+
+        QSSGRhiDrawCallData &dcd = rhiCtxD->drawCallData({ passKey, &subsetRenderable.modelContext.model,
+                                                           &subsetRenderable.material, quintptr(subsetRenderable.subset.offset) });
+
+        QSSGRhiShaderPipelinePtr shaderPipeline;
+        if (obj->type == QSSGRenderableObject::Type::DefaultMaterialMeshSubset) {
+            const auto &material = static_cast<const QSSGRenderDefaultMaterial &>(subsetRenderable.getMaterial());
+            ps.cullMode = QSSGRhiHelpers::toCullMode(material.cullMode);
+
+            shaderPipeline = shadersForDefaultMaterial(&ps, subsetRenderable, featureSet);
+            if (!shaderPipeline)
+                continue;
+            shaderPipeline->ensureCombinedMainLightsUniformBuffer(&dcd.ubuf);
+            char *ubufData = dcd.ubuf->beginFullDynamicBufferUpdateForCurrentFrame();
+            updateUniformsForDefaultMaterial(*shaderPipeline, rhiCtx, inData, ubufData, &ps, subsetRenderable, pickCamera, nullptr, &modelViewProjection);
+            shaderPipeline->setUniform(ubufData, "qt_pickObjectId", &objectId, sizeof(quint32));
+            dcd.ubuf->endFullDynamicBufferUpdateForCurrentFrame();
+        } else {
+            const auto &material = static_cast<const QSSGRenderCustomMaterial &>(subsetRenderable.getMaterial());
+            ps.cullMode = QSSGRhiHelpers::toCullMode(material.m_cullMode);
+
+            QSSGCustomMaterialSystem &customMaterialSystem(*subsetRenderable.renderer->contextInterface()->customMaterialSystem().get());
+            shaderPipeline = customMaterialSystem.shadersForCustomMaterial(&ps, material, subsetRenderable, defaultMaterialShaderKeyProperties, featureSet);
+            if (!shaderPipeline)
+                continue;
+            shaderPipeline->ensureCombinedMainLightsUniformBuffer(&dcd.ubuf);
+            char *ubufData = dcd.ubuf->beginFullDynamicBufferUpdateForCurrentFrame();
+            customMaterialSystem.updateUniformsForCustomMaterial(*shaderPipeline, rhiCtx, inData, ubufData, &ps, material, subsetRenderable,
+                                                                 pickCamera, nullptr, &modelViewProjection);
+            shaderPipeline->setUniform(ubufData, "qt_pickObjectId", &objectId, sizeof(quint32));
+            dcd.ubuf->endFullDynamicBufferUpdateForCurrentFrame();
+        }
+
+        QSSGRhiGraphicsPipelineStatePrivate::setShaderPipeline(ps, shaderPipeline.get());
+        auto &ia = QSSGRhiInputAssemblerStatePrivate::get(ps);
+        ia = subsetRenderable.subset.rhi.ia;
+        int instanceBufferBinding = setupInstancing(&subsetRenderable, &ps, rhiCtx, inData.cameraData->direction, inData.cameraData->position);
+        QSSGRhiHelpers::bakeVertexInputLocations(&ia, *shaderPipeline, instanceBufferBinding);
+
+        QSSGRhiShaderResourceBindingList bindings;
+        bindings.addUniformBuffer(0, RENDERER_VISIBILITY_ALL, dcd.ubuf);
+
+        // The pick shader has to deform the mesh exactly like the main pass does
+        if (QRhiTexture *boneTexture = inData.getBonemapTexture(subsetRenderable.modelContext)) {
+            int binding = shaderPipeline->bindingForTexture("qt_boneTexture");
+            if (binding >= 0) {
+                QRhiSampler *boneSampler = rhiCtx->sampler({ QRhiSampler::Nearest,
+                                                             QRhiSampler::Nearest,
+                                                             QRhiSampler::None,
+                                                             QRhiSampler::ClampToEdge,
+                                                             QRhiSampler::ClampToEdge,
+                                                             QRhiSampler::Repeat });
+                bindings.addTexture(binding, QRhiShaderResourceBinding::VertexStage, boneTexture, boneSampler);
+            }
+        }
+        if (auto *targetsTexture = subsetRenderable.subset.rhi.targetsTexture) {
+            int binding = shaderPipeline->bindingForTexture("qt_morphTargetTexture");
+            if (binding >= 0) {
+                QRhiSampler *targetsSampler = rhiCtx->sampler({ QRhiSampler::Nearest,
+                                                                QRhiSampler::Nearest,
+                                                                QRhiSampler::None,
+                                                                QRhiSampler::ClampToEdge,
+                                                                QRhiSampler::ClampToEdge,
+                                                                QRhiSampler::ClampToEdge });
+                bindings.addTexture(binding, QRhiShaderResourceBinding::VertexStage, targetsTexture, targetsSampler);
+            }
+        }
+
+        // A custom vertex shader may still reference these
+        addDepthTextureBindings(rhiCtx, shaderPipeline.get(), bindings);
+
+        QRhiShaderResourceBindings *srb = rhiCtxD->srb(dcd, bindings);
+        subsetRenderable.rhiRenderData.pickPass.pipeline = rhiCtxD->pipeline(dcd, ps, rpDesc, srb);
+        subsetRenderable.rhiRenderData.pickPass.srb = srb;
+    }
+
+    return true;
+}
+
+void RenderHelpers::rhiRenderGpuPickPass(QSSGRhiContext *rhiCtx,
+                                         const QSSGRhiGraphicsPipelineState &ps,
+                                         const QSSGRenderableObjectList &pickObjects)
+{
+    QRhiCommandBuffer *cb = rhiCtx->commandBuffer();
+    cb->setViewport(ps.viewport);
+
+    for (const QSSGRenderableObjectHandle &handle : pickObjects) {
+        QSSGRenderableObject *obj = handle.obj;
+        if (obj->type != QSSGRenderableObject::Type::DefaultMaterialMeshSubset && obj->type != QSSGRenderableObject::Type::CustomMaterialMeshSubset)
+            continue;
+
+        QSSGSubsetRenderable *subsetRenderable(static_cast<QSSGSubsetRenderable *>(obj));
+        QRhiGraphicsPipeline *pipeline = subsetRenderable->rhiRenderData.pickPass.pipeline;
+        QRhiShaderResourceBindings *srb = subsetRenderable->rhiRenderData.pickPass.srb;
+        if (!pipeline || !srb)
+            continue;
+
+        QRhiBuffer *vertexBuffer = subsetRenderable->vertexBuffer();
+        QRhiBuffer *indexBuffer = subsetRenderable->subset.rhi.indexBuffer
+                ? subsetRenderable->subset.rhi.indexBuffer->buffer()
+                : nullptr;
+
+        Q_QUICK3D_PROFILE_START(QQuick3DProfiler::Quick3DRenderCall);
+        cb->setGraphicsPipeline(pipeline);
+        cb->setShaderResources(srb);
+
+        QRhiCommandBuffer::VertexInput vertexBuffers[2];
+        int vertexBufferCount = 1;
+        vertexBuffers[0] = QRhiCommandBuffer::VertexInput(vertexBuffer, 0);
+        quint32 instances = 1;
+        if (subsetRenderable->modelContext.model.instancing()) {
+            instances = subsetRenderable->modelContext.model.instanceCount();
+            vertexBuffers[1] = QRhiCommandBuffer::VertexInput(subsetRenderable->instanceBuffer, 0);
+            vertexBufferCount = 2;
+        }
+
+        if (indexBuffer) {
+            cb->setVertexInput(0, vertexBufferCount, vertexBuffers, indexBuffer, 0, subsetRenderable->subset.rhi.indexBuffer->indexFormat());
+            cb->drawIndexed(subsetRenderable->subset.count, instances, subsetRenderable->subset.offset);
+            QSSGRHICTX_STAT(rhiCtx, drawIndexed(subsetRenderable->subset.count, instances));
+        } else {
+            cb->setVertexInput(0, vertexBufferCount, vertexBuffers);
+            cb->draw(subsetRenderable->subset.count, instances, subsetRenderable->subset.offset);
+            QSSGRHICTX_STAT(rhiCtx, draw(subsetRenderable->subset.count, instances));
+        }
+        Q_QUICK3D_PROFILE_END_WITH_IDS(QQuick3DProfiler::Quick3DRenderCall, (subsetRenderable->subset.count | quint64(instances) << 32),
+                                       QVector<int>({subsetRenderable->modelContext.model.profilingId,
+                                                     subsetRenderable->material.profilingId}));
+    }
+}
+
 bool RenderHelpers::rhiPrepareDepthTexture(QSSGRhiContext *rhiCtx, const QSize &size, QSSGRhiRenderableTexture *renderableTex)
 {
     QRhi *rhi = rhiCtx->rhi();
     bool needsBuild = false;
 
+    QRhiTexture::Format format = QRhiTexture::D32F;
+    if (!rhi->isTextureFormatSupported(format))
+        format = QRhiTexture::D16;
+
+    QSSGRhiContextPrivate::get(rhiCtx)->acquireTransientTexture(renderableTex, size, format, QRhiTexture::RenderTarget, false);
+
     if (!renderableTex->texture) {
-        QRhiTexture::Format format = QRhiTexture::D32F;
-        if (!rhi->isTextureFormatSupported(format))
-            format = QRhiTexture::D16;
         if (!rhi->isTextureFormatSupported(format))
             qWarning("Depth texture not supported");
         // the depth texture is always non-msaa, even if multisampling is used in the main pass
@@ -70,6 +70,23 @@ void rhiRenderDepthPass(QSSGRhiContext *rhiCtx, const QSSGRhiGraphicsPipelineSta
                         const QSSGRenderableObjectList &sortedTransparentObjects,
                         bool *needsSetViewport);
 
+// Draws the index ranges of the meshlets of the renderable that are not culled
+// for the camera. The caller has set the vertex input and checked that the
+// renderable has visible ranges.
+void rhiDrawVisibleRanges(QSSGRhiContext *rhiCtx, const QSSGSubsetRenderable &renderable);
+
+bool rhiPrepareGpuPickPass(QSSGRhiContext *rhiCtx,
+                           QSSGPassKey passKey,
+                           const QSSGRhiGraphicsPipelineState &basePipelineState,
+                           QRhiRenderPassDescriptor *rpDesc,
+                           QSSGLayerRenderData &inData,
+                           const QSSGRenderCamera &pickCamera,
+                           const QSSGRenderableObjectList &pickObjects);
+
+void rhiRenderGpuPickPass(QSSGRhiContext *rhiCtx,
+                          const QSSGRhiGraphicsPipelineState &ps,
+                          const QSSGRenderableObjectList &pickObjects);
+
 bool rhiPrepareAoTexture(QSSGRhiContext *rhiCtx, const QSize &size, QSSGRhiRenderableTexture *renderableTex);
 
 void rhiRenderAoTexture(QSSGRhiContext *rhiCtx,
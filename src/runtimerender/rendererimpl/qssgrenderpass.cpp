@@ -8,10 +8,14 @@
 #include "qssgdebugdrawsystem_p.h"
 #include "extensionapi/qssgrenderextensions.h"
 #include "qssgrenderhelpers_p.h"
+#include "../resourcemanager/qssgrenderbuffermanager_p.h"
+#include "../qssgrendershadercache_p.h"
 
 #include "../utils/qssgassert_p.h"
 
 #include <QtQuick/private/qsgrenderer_p.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qmath.h>
 #include <qtquick3d_tracepoints_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -37,6 +41,261 @@ QSSGRenderPass::~QSSGRenderPass()
 
 }
 
+// SKINNING PRE-PASS
+
+static constexpr quint32 SKINNING_ABSENT = UINT32_MAX;
+static constexpr quint32 SKINNING_MAX_TARGETS = 8;
+static constexpr quint32 SKINNING_WORKGROUP_SIZE = 64;
+
+static quint32 floatComponentCount(QRhiVertexInputAttribute::Format format)
+{
+    switch (format) {
+    case QRhiVertexInputAttribute::Float4:
+        return 4;
+    case QRhiVertexInputAttribute::Float3:
+        return 3;
+    case QRhiVertexInputAttribute::Float2:
+        return 2;
+    case QRhiVertexInputAttribute::Float:
+        return 1;
+    default:
+        break;
+    }
+    return 0;
+}
+
+SkinningPass::~SkinningPass()
+{
+    releaseResources();
+}
+
+QRhiBuffer *SkinningPass::prepareModel(QSSGRhiContext &rhiContext,
+                                       const QSSGRenderModel &model,
+                                       const QSSGRenderSubset &subset,
+                                       QRhiTexture *boneTexture)
+{
+    QRhi *rhi = rhiContext.rhi();
+    if (!rhi->isFeatureSupported(QRhi::Compute) || !subset.rhi.vertexBuffer)
+        return nullptr;
+
+    // The buffer manager only makes the vertex buffers of meshes with joints
+    // or morph targets readable from compute.
+    QRhiBuffer *sourceBuffer = subset.rhi.vertexBuffer->buffer();
+    if (!sourceBuffer->usage().testFlag(QRhiBuffer::StorageBuffer))
+        return nullptr;
+
+    const QSSGRhiInputAssemblerState &ia = subset.rhi.ia;
+    const QRhiVertexInputBinding *binding = ia.inputLayout.bindingAt(0);
+    const quint32 stride = binding ? binding->stride() : 0;
+    if (stride == 0 || stride % 4 != 0 || ia.inputs.size() != ia.inputLayout.attributeCount())
+        return nullptr;
+
+    Dispatch dispatch;
+    Params &params = dispatch.params;
+    params = {};
+    std::fill(std::begin(params.attribOffsets), std::end(params.attribOffsets), SKINNING_ABSENT);
+    std::fill(std::begin(params.targetLayers), std::end(params.targetLayers), SKINNING_ABSENT);
+    params.vertexLayout[0] = quint32(sourceBuffer->size()) / stride;
+    params.vertexLayout[1] = stride / 4;
+    params.vertexLayout[2] = SKINNING_ABSENT;
+    params.vertexLayout[3] = SKINNING_ABSENT;
+
+    const bool morph = subset.rhi.targetsTexture && ia.targetCount > 0;
+    if (morph && ia.targetCount > SKINNING_MAX_TARGETS)
+        return nullptr;
+
+    for (qsizetype i = 0, end = ia.inputs.size(); i < end; ++i) {
+        const auto semantic = ia.inputs[i];
+        const QRhiVertexInputAttribute *attr = ia.inputLayout.attributeAt(i);
+        const quint32 offset = attr->offset() / 4;
+        if (semantic <= QSSGRhiInputAssemblerState::MaxTargetSemantic) {
+            const quint32 componentCount = floatComponentCount(attr->format());
+            if (componentCount == 0)
+                return nullptr;
+            params.attribOffsets[semantic] = offset;
+            params.attribComponents[semantic] = componentCount;
+            if (morph && ia.targetOffsets[semantic] != UINT8_MAX)
+                params.targetLayers[semantic] = ia.targetOffsets[semantic];
+        } else if (semantic == QSSGRhiInputAssemblerState::JointSemantic) {
+            params.vertexLayout[2] = offset;
+            params.options[1] = (attr->format() == QRhiVertexInputAttribute::Float4) ? 1 : 0;
+        } else if (semantic == QSSGRhiInputAssemblerState::WeightSemantic) {
+            params.vertexLayout[3] = offset;
+        }
+    }
+
+    const bool skin = model.usesBoneTexture();
+    if (skin && (!boneTexture || params.vertexLayout[2] == SKINNING_ABSENT || params.vertexLayout[3] == SKINNING_ABSENT))
+        return nullptr;
+    if (!skin && !morph)
+        return nullptr;
+
+    if (morph) {
+        params.options[0] = ia.targetCount;
+        const qsizetype weightCount = qMin<qsizetype>(ia.targetCount, model.morphWeights.size());
+        for (qsizetype i = 0; i < weightCount; ++i)
+            params.morphWeights[i] = model.morphWeights[i];
+    }
+
+    dispatch.variant = skin ? (morph ? SkinMorph : Skin) : Morph;
+    if (!shadersLoaded[dispatch.variant]) {
+        static const char *names[ShaderVariantCount] = { "skinning_skin", "skinning_morph", "skinning_skin_morph" };
+        shadersLoaded[dispatch.variant] = true;
+        QFile f(QString::fromUtf8(QSSGShaderCache::resourceFolder() + names[dispatch.variant] + ".comp.qsb"));
+        if (f.open(QIODevice::ReadOnly))
+            shaders[dispatch.variant] = QShader::fromSerialized(f.readAll());
+        else
+            qWarning("Failed to open %s", qPrintable(f.fileName()));
+    }
+    if (!shaders[dispatch.variant].isValid())
+        return nullptr;
+
+    Entry &entry = entries[&model];
+    if (!entry.vertexBuffer) {
+        entry.vertexBuffer = rhi->newBuffer(QRhiBuffer::Static,
+                                            QRhiBuffer::VertexBuffer | QRhiBuffer::StorageBuffer,
+                                            sourceBuffer->size());
+        entry.vertexBuffer->setName(QByteArrayLiteral("Quick3D skinned vertices"));
+        if (!entry.vertexBuffer->create())
+            qWarning("Failed to build skinned vertex buffer of size %u", sourceBuffer->size());
+        entry.sourceBuffer = nullptr;
+    } else if (entry.vertexBuffer->size() != sourceBuffer->size()) {
+        entry.vertexBuffer->setSize(sourceBuffer->size());
+        entry.vertexBuffer->create();
+        entry.sourceBuffer = nullptr;
+    }
+    if (!entry.ubuf) {
+        entry.ubuf = rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, sizeof(Params));
+        entry.ubuf->create();
+    }
+    entry.used = true;
+
+    dispatch.model = &model;
+    dispatch.sourceBuffer = sourceBuffer;
+    dispatch.boneTexture = skin ? boneTexture : nullptr;
+    dispatch.targetsTexture = morph ? subset.rhi.targetsTexture : nullptr;
+    dispatches.push_back(dispatch);
+
+    return entry.vertexBuffer;
+}
+
+void SkinningPass::renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data)
+{
+    Q_UNUSED(renderer);
+    Q_UNUSED(data);
+
+    // Models that were not deformed this frame give their buffers back
+    for (auto it = entries.begin(); it != entries.end(); ) {
+        if (!it->used) {
+            delete it->srb;
+            delete it->ubuf;
+            delete it->vertexBuffer;
+            it = entries.erase(it);
+        } else {
+            it->used = false;
+            ++it;
+        }
+    }
+}
+
+void SkinningPass::renderPass(QSSGRenderer &renderer)
+{
+    // INPUT: Skinned and/or morphed models with their bone and morph target textures
+
+    // DEPENDECY: None
+
+    // OUTPUT: Deformed vertex buffers, consumed by all other passes
+
+    // CONDITION: Skinning pre-pass enabled on the layer and compute supported
+
+    if (dispatches.isEmpty())
+        return;
+
+    const auto &rhiCtx = renderer.contextInterface()->rhiContext();
+    QSSG_ASSERT(rhiCtx->rhi()->isRecordingFrame(), return);
+    QRhi *rhi = rhiCtx->rhi();
+    QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(rhiCtx.get());
+    QRhiCommandBuffer *cb = rhiCtx->commandBuffer();
+
+    QRhiSampler *sampler = rhiCtx->sampler({ QRhiSampler::Nearest,
+                                                 QRhiSampler::Nearest,
+                                                 QRhiSampler::None,
+                                                 QRhiSampler::ClampToEdge,
+                                                 QRhiSampler::ClampToEdge,
+                                                 QRhiSampler::ClampToEdge });
+
+    QRhiResourceUpdateBatch *rub = rhi->nextResourceUpdateBatch();
+    for (const Dispatch &dispatch : std::as_const(dispatches)) {
+        Entry &entry = entries[dispatch.model];
+        rub->updateDynamicBuffer(entry.ubuf, 0, sizeof(Params), &dispatch.params);
+
+        if (entry.srb && entry.sourceBuffer == dispatch.sourceBuffer
+                && entry.boneTexture == dispatch.boneTexture
+                && entry.targetsTexture == dispatch.targetsTexture) {
+            continue;
+        }
+
+        const auto stage = QRhiShaderResourceBinding::ComputeStage;
+        QVarLengthArray<QRhiShaderResourceBinding, 5> bindings;
+        bindings.append(QRhiShaderResourceBinding::uniformBuffer(0, stage, entry.ubuf));
+        bindings.append(QRhiShaderResourceBinding::bufferLoad(1, stage, dispatch.sourceBuffer));
+        bindings.append(QRhiShaderResourceBinding::bufferStore(2, stage, entry.vertexBuffer));
+        if (dispatch.boneTexture)
+            bindings.append(QRhiShaderResourceBinding::sampledTexture(3, stage, dispatch.boneTexture, sampler));
+        if (dispatch.targetsTexture)
+            bindings.append(QRhiShaderResourceBinding::sampledTexture(4, stage, dispatch.targetsTexture, sampler));
+        if (!entry.srb)
+            entry.srb = rhi->newShaderResourceBindings();
+        entry.srb->setBindings(bindings.cbegin(), bindings.cend());
+        entry.srb->create();
+        entry.sourceBuffer = dispatch.sourceBuffer;
+        entry.boneTexture = dispatch.boneTexture;
+        entry.targetsTexture = dispatch.targetsTexture;
+    }
+
+    cb->debugMarkBegin(QByteArrayLiteral("Quick3D skinning pre-pass"));
+    Q_TRACE_SCOPE(QSSG_renderPass, QStringLiteral("Quick3D skinning pre-pass"));
+    Q_QUICK3D_PROFILE_START(QQuick3DProfiler::Quick3DRenderPass);
+
+    auto &stats = QSSGRhiContextStats::get(*rhiCtx);
+    const bool statsEnabled = stats.isEnabled();
+
+    cb->beginComputePass(rub);
+    for (const Dispatch &dispatch : std::as_const(dispatches)) {
+        const Entry &entry = entries[dispatch.model];
+        QRhiComputePipeline *pipeline = rhiCtxD->computePipeline(shaders[dispatch.variant], entry.srb);
+        cb->setComputePipeline(pipeline);
+        cb->setShaderResources(entry.srb);
+        const quint32 vertexCount = dispatch.params.vertexLayout[0];
+        cb->dispatch((vertexCount + SKINNING_WORKGROUP_SIZE - 1) / SKINNING_WORKGROUP_SIZE, 1, 1);
+        if (statsEnabled)
+            stats.skinningDispatch(vertexCount, sizeof(Params));
+    }
+    cb->endComputePass();
+
+    // From now on render passes have to track their resources for compute
+    rhiCtxD->m_computeUsed = true;
+
+    cb->debugMarkEnd();
+    Q_QUICK3D_PROFILE_END_WITH_STRING(QQuick3DProfiler::Quick3DRenderPass, 0, QByteArrayLiteral("skinning_prepass"));
+}
+
+void SkinningPass::resetForFrame()
+{
+    dispatches.clear();
+}
+
+void SkinningPass::releaseResources()
+{
+    for (Entry &entry : entries) {
+        delete entry.srb;
+        delete entry.ubuf;
+        delete entry.vertexBuffer;
+    }
+    entries.clear();
+    dispatches.clear();
+}
+
 // SHADOW PASS
 
 void ShadowMapPass::renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data)
@@ -147,20 +406,9 @@ void ReflectionMapPass::renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &
     reflectionProbes = data.reflectionProbes;
     reflectionMapManager = data.requestReflectionMapManager();
 
-    const auto &sortedOpaqueObjects = data.getSortedOpaqueRenderableObjects(*camera);
-    const auto &sortedTransparentObjects = data.getSortedTransparentRenderableObjects(*camera);
-    const auto &sortedScreenTextureObjects = data.getSortedScreenTextureRenderableObjects(*camera);
-
+    // Collected while preparing the probes, and culled per cube face when rendering
     QSSG_ASSERT(reflectionPassObjects.isEmpty(), reflectionPassObjects.clear());
-
-    // NOTE: We should consider keeping track of the reflection casting objects to avoid
-    // filtering this list on each prep.
-    for (const auto &handles : { &sortedOpaqueObjects, &sortedTransparentObjects, &sortedScreenTextureObjects }) {
-        for (const auto &handle : *handles) {
-            if (handle.obj->renderableFlags.testFlag(QSSGRenderableObjectFlag::CastsReflections))
-                reflectionPassObjects.push_back(handle);
-        }
-    }
+    reflectionPassObjects = data.reflectionCasterObjects;
 }
 
 void ReflectionMapPass::renderPass(QSSGRenderer &renderer)
@@ -210,6 +458,13 @@ void ReflectionMapPass::resetForFrame()
     reflectionPassObjects.clear();
 }
 
+quint32 ReflectionMapPass::reads(const QSSGLayerRenderData &data) const
+{
+    // The probes are rendered with the layer's materials, which sample
+    // whatever the main pass samples.
+    return data.reflectionProbes.isEmpty() ? 0 : AllRenderResults;
+}
+
 // ZPrePass
 void ZPrePassPass::renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data)
 {
@@ -435,6 +690,227 @@ void DepthMapPass::resetForFrame()
     ps = {};
 }
 
+// GPU PICK PASS
+
+GpuPickPass::~GpuPickPass()
+{
+    releaseResources();
+}
+
+void GpuPickPass::renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data)
+{
+    using namespace RenderHelpers;
+
+    auto *camera = data.camera;
+    QSSG_ASSERT(camera, return);
+
+    const auto &rhiCtxPtr = renderer.contextInterface()->rhiContext();
+    QSSG_ASSERT(rhiCtxPtr->rhi()->isRecordingFrame(), return);
+    rhiCtx = rhiCtxPtr.get();
+    QRhi *rhi = rhiCtx->rhi();
+
+    auto &layer = data.layer;
+    const QRectF viewport = data.layerPrepResult.viewport;
+    ready = false;
+
+    // One query at a time, a request made while one is in flight is
+    // picked up again once that one has completed.
+    if (query.inFlight || viewport.isEmpty())
+        return;
+
+    const QPointF pos = layer.gpuPick.position;
+    layer.gpuPick.requested = false;
+    if (pos.x() < 0 || pos.y() < 0 || pos.x() >= viewport.width() || pos.y() >= viewport.height())
+        return;
+
+    if (!pickTexture.texture) {
+        if (!rhi->isTextureFormatSupported(QRhiTexture::RGBA32F)) {
+            qWarning("GPU picking requires RGBA32F render targets");
+            return;
+        }
+        const QSize size(1, 1);
+        pickTexture.texture = rhi->newTexture(QRhiTexture::RGBA32F, size, 1, QRhiTexture::RenderTarget | QRhiTexture::UsedAsTransferSource);
+        pickTexture.depthStencil = rhi->newRenderBuffer(QRhiRenderBuffer::DepthStencil, size);
+        if (!pickTexture.texture->create() || !pickTexture.depthStencil->create()) {
+            qWarning("Failed to build GPU pick texture");
+            pickTexture.reset();
+            return;
+        }
+        QRhiTextureRenderTargetDescription rtDesc(QRhiColorAttachment(pickTexture.texture));
+        rtDesc.setDepthStencilBuffer(pickTexture.depthStencil);
+        pickTexture.rt = rhi->newTextureRenderTarget(rtDesc);
+        pickTexture.rt->setName(QByteArrayLiteral("GPU pick texture"));
+        pickTexture.rpDesc = pickTexture.rt->newCompatibleRenderPassDescriptor();
+        pickTexture.rt->setRenderPassDescriptor(pickTexture.rpDesc);
+        if (!pickTexture.rt->create()) {
+            qWarning("Failed to build render target for GPU pick texture");
+            pickTexture.reset();
+            return;
+        }
+    }
+
+    // Narrow the projection down to the queried pixel so that a 1x1 target
+    // is enough, rather than rendering the whole view and reading one texel.
+    const float w = float(viewport.width());
+    const float h = float(viewport.height());
+    const float cx = 2.0f * (float(pos.x()) + 0.5f) / w - 1.0f;
+    const float cy = 1.0f - 2.0f * (float(pos.y()) + 0.5f) / h;
+    QMatrix4x4 pickMatrix;
+    pickMatrix.scale(w, h, 1.0f);
+    pickMatrix.translate(-cx, -cy, 0.0f);
+
+    QSSGRenderCamera pickCamera(camera->type);
+    pickCamera.clipNear = camera->clipNear;
+    pickCamera.clipFar = camera->clipFar;
+    pickCamera.fov = camera->fov;
+    pickCamera.dpr = camera->dpr;
+    pickCamera.parent = nullptr;
+    pickCamera.globalTransform = camera->globalTransform;
+    pickCamera.projection = pickMatrix * camera->projection;
+
+    const bool pickEverything = QSSGRendererPrivate::isGlobalPickingEnabled(renderer);
+    const auto &bufferManager = renderer.contextInterface()->bufferManager();
+    QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(rhiCtx);
+
+    query.targets.clear();
+    const auto collect = [&](const QSSGRenderableObjectList &objects) {
+        for (const QSSGRenderableObjectHandle &handle : objects) {
+            QSSGRenderableObject *obj = handle.obj;
+            if (obj->type != QSSGRenderableObject::Type::DefaultMaterialMeshSubset && obj->type != QSSGRenderableObject::Type::CustomMaterialMeshSubset)
+                continue;
+            QSSGSubsetRenderable &subsetRenderable(static_cast<QSSGSubsetRenderable &>(*obj));
+            const QSSGRenderModel &model = subsetRenderable.modelContext.model;
+            if (!pickEverything && !model.getLocalState(QSSGRenderNode::LocalState::Pickable))
+                continue;
+
+            PickTarget target;
+            target.object = &model;
+            target.inverseGlobalTransform = subsetRenderable.globalTransform.inverted();
+            if (QSSGRenderMesh *mesh = bufferManager->getMeshForPicking(model)) {
+                const qsizetype subsetIndex = &subsetRenderable.subset - mesh->subsets.constData();
+                if (subsetIndex >= 0 && subsetIndex < mesh->subsets.size())
+                    target.subset = int(subsetIndex);
+            }
+            if (model.instancing()) {
+                target.instanced = true;
+                if (model.instanceTable->isDepthSortingEnabled()) {
+                    const bool usesLod = subsetRenderable.instancingLodMin >= 0 || subsetRenderable.instancingLodMax >= 0;
+                    const auto &instanceData = usesLod ? rhiCtxD->instanceBufferData(&model)
+                                                       : rhiCtxD->instanceBufferData(model.instanceTable);
+                    target.instanceRemap.reserve(instanceData.sortData.size());
+                    for (const QSSGRhiSortData &sd : instanceData.sortData)
+                        target.instanceRemap.append(sd.indexOrOffset);
+                }
+            }
+            pickObjects.push_back(handle);
+            query.targets.append(target);
+        }
+    };
+    collect(data.getSortedOpaqueRenderableObjects(*camera));
+    collect(data.getSortedTransparentRenderableObjects(*camera));
+    collect(data.getSortedScreenTextureRenderableObjects(*camera));
+
+    QMatrix4x4 viewProjection(Qt::Uninitialized);
+    camera->calculateViewProjectionMatrix(viewProjection);
+    query.inverseViewProjection = viewProjection.inverted();
+    query.cameraPosition = camera->getGlobalPos();
+    query.ndcPosition = QPointF(cx, cy);
+
+    ps = data.getPipelineState();
+    ps.viewport = QRhiViewport(0, 0, 1, 1);
+    ps.flags.setFlag(QSSGRhiGraphicsPipelineState::Flag::UsesScissor, false);
+    ready = rhiPrepareGpuPickPass(rhiCtx, this, ps, pickTexture.rpDesc, data, pickCamera, pickObjects);
+}
+
+void GpuPickPass::renderPass(QSSGRenderer &renderer)
+{
+    using namespace RenderHelpers;
+
+    if (!ready || !pickTexture.isValid())
+        return;
+
+    const auto &rhiCtxPtr = renderer.contextInterface()->rhiContext();
+    QSSG_ASSERT(rhiCtxPtr->rhi()->isRecordingFrame(), return);
+    QRhiCommandBuffer *cb = rhiCtxPtr->commandBuffer();
+    cb->debugMarkBegin(QByteArrayLiteral("Quick3D GPU pick"));
+
+    query.inFlight = true;
+    query.readback = {};
+    query.readback.completed = [this] {
+        query.inFlight = false;
+        query.hasResult = true;
+        query.result = {};
+
+        const QByteArray &data = query.readback.data;
+        if (data.size() < qsizetype(4 * sizeof(float)))
+            return;
+        float texel[4];
+        memcpy(texel, data.constData(), sizeof(texel));
+
+        const int objectId = qRound(texel[0]);
+        if (objectId <= 0 || objectId > query.targets.size())
+            return;
+
+        const PickTarget &target = query.targets.at(objectId - 1);
+        // Window depth is in [0, 1] on every backend, clipSpaceCorrMatrix
+        // takes care of that, so map it back into the GL style NDC range
+        // the unclipped view projection matrix expects.
+        const QVector3D ndc(float(query.ndcPosition.x()), float(query.ndcPosition.y()), 2.0f * texel[2] - 1.0f);
+        const QVector3D scenePos = query.inverseViewProjection.map(ndc);
+
+        QSSGRenderPickResult &result = query.result;
+        result.m_hitObject = target.object;
+        result.m_scenePosition = scenePos;
+        result.m_distanceSq = (scenePos - query.cameraPosition).lengthSquared();
+        result.m_subset = target.subset;
+        if (target.instanced) {
+            const int sortedIndex = qRound(texel[1]);
+            result.m_instanceIndex = (sortedIndex >= 0 && sortedIndex < target.instanceRemap.size())
+                    ? target.instanceRemap.at(sortedIndex)
+                    : sortedIndex;
+        } else {
+            result.m_localPosition = target.inverseGlobalTransform.map(scenePos);
+        }
+    };
+
+    cb->beginPass(pickTexture.rt, Qt::transparent, { 1.0f, 0 }, nullptr, rhiCtxPtr->commonPassFlags());
+    QSSGRHICTX_STAT(rhiCtxPtr, beginRenderPass(pickTexture.rt));
+    Q_QUICK3D_PROFILE_START(QQuick3DProfiler::Quick3DRenderPass);
+    rhiRenderGpuPickPass(rhiCtxPtr.get(), ps, pickObjects);
+    QRhiResourceUpdateBatch *rub = rhiCtxPtr->rhi()->nextResourceUpdateBatch();
+    rub->readBackTexture(QRhiReadbackDescription(pickTexture.texture), &query.readback);
+    cb->endPass(rub);
+    QSSGRHICTX_STAT(rhiCtxPtr, endRenderPass());
+    Q_QUICK3D_PROFILE_END_WITH_STRING(QQuick3DProfiler::Quick3DRenderPass, 0, QByteArrayLiteral("gpu_pick"));
+
+    cb->debugMarkEnd();
+}
+
+void GpuPickPass::resetForFrame()
+{
+    pickObjects.clear();
+    ps = {};
+    ready = false;
+}
+
+void GpuPickPass::publishResult(QSSGRenderLayer &layer)
+{
+    if (!query.hasResult)
+        return;
+    query.hasResult = false;
+    layer.gpuPick.result = query.result;
+    ++layer.gpuPick.resultSerial;
+}
+
+void GpuPickPass::releaseResources()
+{
+    // The readback callback refers to this pass, so it must not be left pending.
+    if (query.inFlight && rhiCtx && rhiCtx->isValid() && !rhiCtx->rhi()->isRecordingFrame())
+        rhiCtx->rhi()->finish();
+    query = {};
+    pickTexture.reset();
+}
+
 // SCREEN TEXTURE PASS
 
 void ScreenMapPass::renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data)
@@ -882,6 +1358,108 @@ void SkyboxCubeMapPass::resetForFrame()
     layer = nullptr;
 }
 
+// Renders the 2D content of the item into its cached texture when it changed,
+// and returns the shader resources for drawing the texture with the
+// texturedquad shader.
+static QRhiShaderResourceBindings *prepareCachedItem2D(QSSGRhiContext *rhiCtx,
+                                                        const QSSGRenderPass *pass,
+                                                        QSSGRenderItem2D *item2D,
+                                                        float dpr)
+{
+    const QRectF &rect = item2D->bounds;
+    if (rect.isEmpty()) {
+        item2D->releaseCachedTexture();
+        return nullptr;
+    }
+    // Keep the texture, the item is likely to be faded in again
+    if (item2D->combinedOpacity <= 0.0f)
+        return nullptr;
+
+    QRhi *rhi = rhiCtx->rhi();
+    QRhiCommandBuffer *cb = rhiCtx->commandBuffer();
+    const int maxSize = rhi->resourceLimit(QRhi::TextureSizeMax);
+    const QSize pixelSize(qBound(1, qCeil(rect.width() * dpr), maxSize),
+                          qBound(1, qCeil(rect.height() * dpr), maxSize));
+
+    if (item2D->m_texture && item2D->m_texture->pixelSize() != pixelSize)
+        item2D->releaseCachedTexture();
+
+    if (!item2D->m_texture) {
+        item2D->m_texture = rhi->newTexture(QRhiTexture::RGBA8, pixelSize, 1,
+                                            QRhiTexture::RenderTarget | QRhiTexture::MipMapped | QRhiTexture::UsedWithGenerateMips);
+        item2D->m_texture->setName(QByteArrayLiteral("Item2D cache texture"));
+        item2D->m_textureDepthStencil = rhi->newRenderBuffer(QRhiRenderBuffer::DepthStencil, pixelSize);
+        if (!item2D->m_texture->create() || !item2D->m_textureDepthStencil->create()) {
+            qWarning("Failed to create the cache texture of 2D content");
+            item2D->releaseCachedTexture();
+            return nullptr;
+        }
+        QRhiTextureRenderTargetDescription rtDesc { QRhiColorAttachment(item2D->m_texture) };
+        rtDesc.setDepthStencilBuffer(item2D->m_textureDepthStencil);
+        item2D->m_textureRt = rhi->newTextureRenderTarget(rtDesc);
+        item2D->m_textureRp = item2D->m_textureRt->newCompatibleRenderPassDescriptor();
+        item2D->m_textureRt->setRenderPassDescriptor(item2D->m_textureRp);
+        item2D->m_textureRt->create();
+        item2D->contentDirty = true;
+    }
+
+    if (item2D->contentDirty) {
+        QSGRenderer *renderer2D = item2D->m_renderer;
+        // Same orientation as a layer in Qt Quick, the top-left of the
+        // content ends up at the texture coordinate (0, 0).
+        const QRectF mirrored = rhi->isYUpInFramebuffer() ? QRectF(rect.left(), rect.bottom(), rect.width(), -rect.height())
+                                                          : rect;
+        QSGAbstractRenderer::MatrixTransformFlags matrixFlags;
+        if (!rhi->isYUpInNDC())
+            matrixFlags |= QSGAbstractRenderer::MatrixTransformFlipY;
+        const QRect deviceRect(QPoint(0, 0), pixelSize);
+        renderer2D->setDevicePixelRatio(dpr);
+        renderer2D->setDeviceRect(deviceRect);
+        renderer2D->setViewportRect(deviceRect);
+        renderer2D->setProjectionMatrixToRect(mirrored, matrixFlags);
+        renderer2D->setRenderTarget({ item2D->m_textureRt, item2D->m_textureRp, cb });
+        renderer2D->prepareSceneInline();
+
+        cb->beginPass(item2D->m_textureRt, Qt::transparent, { 1.0f, 0 }, nullptr, rhiCtx->commonPassFlags());
+        QSSGRHICTX_STAT(rhiCtx, beginRenderPass(item2D->m_textureRt));
+        renderer2D->renderSceneInline();
+        QRhiResourceUpdateBatch *rub = rhi->nextResourceUpdateBatch();
+        rub->generateMips(item2D->m_texture);
+        cb->endPass(rub);
+        QSSGRHICTX_STAT(rhiCtx, endRenderPass());
+        item2D->contentDirty = false;
+    }
+
+    // The quad covers the bounds of the content, see texturedquad.vert
+    QMatrix4x4 quadTransform;
+    quadTransform.translate(float(rect.center().x()), float(rect.center().y()));
+    quadTransform.scale(1.0f, -1.0f);
+    const QMatrix4x4 mvp = item2D->MVP * quadTransform;
+    const float dimensions[2] = { float(rect.width()), float(rect.height()) };
+    const float opacity = item2D->combinedOpacity;
+
+    QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(rhiCtx);
+    QSSGRhiDrawCallData &dcd = rhiCtxD->drawCallData({ pass, nullptr, item2D, 0 });
+    const int ubufSize = 64 + 2 * sizeof(float) + sizeof(float); // mat4 + vec2 + float
+    if (!dcd.ubuf) {
+        dcd.ubuf = rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, ubufSize);
+        dcd.ubuf->create();
+    }
+    char *ubufData = dcd.ubuf->beginFullDynamicBufferUpdateForCurrentFrame();
+    memcpy(ubufData, mvp.constData(), 64);
+    memcpy(ubufData + 64, dimensions, 2 * sizeof(float));
+    memcpy(ubufData + 64 + 2 * sizeof(float), &opacity, sizeof(float));
+    dcd.ubuf->endFullDynamicBufferUpdateForCurrentFrame();
+
+    // Trilinear filtering, so that distant items sample the smaller mip levels
+    QRhiSampler *sampler = rhiCtx->sampler({ QRhiSampler::Linear, QRhiSampler::Linear, QRhiSampler::Linear,
+                                             QRhiSampler::ClampToEdge, QRhiSampler::ClampToEdge, QRhiSampler::Repeat });
+    QSSGRhiShaderResourceBindingList bindings;
+    bindings.addUniformBuffer(0, QRhiShaderResourceBinding::VertexStage | QRhiShaderResourceBinding::FragmentStage, dcd.ubuf);
+    bindings.addTexture(1, QRhiShaderResourceBinding::FragmentStage, item2D->m_texture, sampler);
+    return rhiCtxD->srb(dcd, bindings);
+}
+
 void Item2DPass::renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data)
 {
     const auto &rhiCtx = renderer.contextInterface()->rhiContext();
@@ -894,7 +1472,17 @@ void Item2DPass::renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data)
     ps.flags.setFlag(QSSGRhiGraphicsPipelineState::Flag::BlendEnabled, false);
 
     item2Ds = data.getRenderableItem2Ds();
-    for (const auto &item2D: std::as_const(item2Ds)) {
+
+    const bool cached = layer.item2DCachingEnabled;
+    if (cached) {
+        texturedQuadShader = renderer.contextInterface()->shaderCache()->getBuiltInRhiShaders().getRhiTexturedQuadShader();
+        renderer.rhiQuadRenderer()->prepareQuad(rhiCtx.get(), nullptr);
+        cachedItemSrbs.resize(item2Ds.size());
+        std::fill(cachedItemSrbs.begin(), cachedItemSrbs.end(), nullptr);
+    }
+
+    for (qsizetype i = 0, end = item2Ds.size(); i != end; ++i) {
+        QSSGRenderItem2D *item2D = item2Ds.at(i);
         // Set the projection matrix
         if (!item2D->m_renderer)
             continue;
@@ -907,9 +1495,17 @@ void Item2DPass::renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data)
             continue;
         }
 
+        const auto &renderTarget = rhiCtx->renderTarget();
+
+        if (cached) {
+            cachedItemSrbs[i] = prepareCachedItem2D(rhiCtx.get(), this, item2D, renderTarget->devicePixelRatio());
+            continue;
+        }
+        if (item2D->m_texture)
+            item2D->releaseCachedTexture();
+
         auto layerPrepResult = data.layerPrepResult;
 
-        const auto &renderTarget = rhiCtx->renderTarget();
         item2D->m_renderer->setDevicePixelRatio(renderTarget->devicePixelRatio());
         const QRect deviceRect(QPoint(0, 0), renderTarget->pixelSize());
         if (layer.scissorRect.isValid()) {
@@ -955,10 +1551,26 @@ void Item2DPass::renderPass(QSSGRenderer &renderer)
     cb->debugMarkBegin(QByteArrayLiteral("Quick3D render 2D sub-scene"));
     Q_QUICK3D_PROFILE_START(QQuick3DProfiler::Quick3DRenderPass);
     Q_TRACE_SCOPE(QSSG_renderPass, QStringLiteral("Quick3D render 2D sub-scene"));
-    for (const auto &item : std::as_const(item2Ds)) {
-        QSSGRenderItem2D *item2D = static_cast<QSSGRenderItem2D *>(item);
-        if (item2D->m_renderer && item2D->m_renderer->currentRhi() == renderer.contextInterface()->rhiContext()->rhi())
-            item2D->m_renderer->renderSceneInline();
+    if (!cachedItemSrbs.isEmpty()) {
+        QSSG_ASSERT(texturedQuadShader, return);
+        QRhiRenderPassDescriptor *rpDesc = rhiCtx->mainRenderPassDescriptor();
+        QSSGRhiQuadRenderer::Flags quadFlags = QSSGRhiQuadRenderer::UvCoords | QSSGRhiQuadRenderer::PremulBlend;
+        if (ps.flags.testFlag(QSSGRhiGraphicsPipelineState::Flag::DepthTestEnabled))
+            quadFlags |= QSSGRhiQuadRenderer::DepthTest;
+        for (QRhiShaderResourceBindings *srb : std::as_const(cachedItemSrbs)) {
+            if (!srb)
+                continue;
+            // recordRenderQuad() adds to the input assembler state
+            QSSGRhiGraphicsPipelineState quadPs = ps;
+            QSSGRhiGraphicsPipelineStatePrivate::setShaderPipeline(quadPs, texturedQuadShader.get());
+            renderer.rhiQuadRenderer()->recordRenderQuad(rhiCtx.get(), &quadPs, srb, rpDesc, quadFlags);
+        }
+    } else {
+        for (const auto &item : std::as_const(item2Ds)) {
+            QSSGRenderItem2D *item2D = static_cast<QSSGRenderItem2D *>(item);
+            if (item2D->m_renderer && item2D->m_renderer->currentRhi() == renderer.contextInterface()->rhiContext()->rhi())
+                item2D->m_renderer->renderSceneInline();
+        }
     }
     cb->debugMarkEnd();
     Q_QUICK3D_PROFILE_END_WITH_STRING(QQuick3DProfiler::Quick3DRenderPass, 0, QByteArrayLiteral("2D_sub_scene"));
@@ -967,6 +1579,8 @@ void Item2DPass::renderPass(QSSGRenderer &renderer)
 void Item2DPass::resetForFrame()
 {
     item2Ds.clear();
+    cachedItemSrbs.clear();
+    texturedQuadShader.reset();
     ps = {};
 }
 
@@ -1040,7 +1654,7 @@ void DebugDrawPass::renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data
 
         QSSGRhiShaderResourceBindingList bindings;
         bindings.addUniformBuffer(0, QRhiShaderResourceBinding::VertexStage, dcd.ubuf);
-        dcd.srb = rhiCtxD->srb(bindings);
+        rhiCtxD->srb(dcd, bindings);
 
         rhiCtx->commandBuffer()->resourceUpdate(rub);
     }
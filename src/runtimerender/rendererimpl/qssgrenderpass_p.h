@@ -22,6 +22,8 @@
 #include <QtQuick3DRuntimeRender/private/qssgrhicontext_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendershadercache_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrenderableobjects_p.h>
+#include <ssg/qssgrenderpickresult.h>
+#include <ssg/qssgrenderextensions.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -48,12 +50,83 @@ public:
     virtual void renderPass(QSSGRenderer &renderer) = 0;
     virtual Type passType() const = 0;
     virtual void resetForFrame() = 0;
+    // Name used for the pass in statistics and traces
+    virtual const char *debugName() const = 0;
 
     // Output:
 
     // Flags: Debug markers(?)
 
-    // Dependency
+    // Dependency: the render results (see QSSGFrameData::RenderResult) the
+    // pass samples and the ones it renders into, as masks of renderResultBit().
+    // A pass that writes render results is dropped from the frame when none
+    // of the passes after it reads them, see QSSGLayerRenderData::cullUnusedPasses().
+    static constexpr quint32 renderResultBit(QSSGFrameData::RenderResult id) { return 1u << quint32(id); }
+    static constexpr quint32 AllRenderResults = (1u << 3) - 1;
+    virtual quint32 reads(const QSSGLayerRenderData &) const { return AllRenderResults; }
+    virtual quint32 writes() const { return 0; }
+};
+
+class SkinningPass : public QSSGRenderPass
+{
+public:
+    ~SkinningPass() override;
+    void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
+    void renderPass(QSSGRenderer &renderer) final;
+    Type passType() const final { return Type::Standalone; }
+    const char *debugName() const final { return "skinning_prepass"; }
+    quint32 reads(const QSSGLayerRenderData &) const final { return 0; }
+    void resetForFrame() final;
+
+    // Returns the buffer the skinned and morphed vertices of the model are
+    // written to this frame, or null when the model has to be deformed in the
+    // vertex shaders as usual.
+    QRhiBuffer *prepareModel(QSSGRhiContext &rhiContext,
+                             const QSSGRenderModel &model,
+                             const QSSGRenderSubset &subset,
+                             QRhiTexture *boneTexture);
+    bool hasWork() const { return !dispatches.isEmpty(); }
+    void releaseResources();
+
+    enum ShaderVariant { Skin, Morph, SkinMorph, ShaderVariantCount };
+
+    // Matches the uniform block in skinning.comp
+    struct Params
+    {
+        quint32 vertexLayout[4];
+        quint32 attribOffsets[8];
+        quint32 attribComponents[8];
+        quint32 targetLayers[8];
+        quint32 options[4];
+        float morphWeights[8];
+    };
+
+    struct Entry
+    {
+        QRhiBuffer *vertexBuffer = nullptr;
+        QRhiBuffer *ubuf = nullptr;
+        QRhiShaderResourceBindings *srb = nullptr;
+        // Not owned, the srb is rebuilt when any of these change
+        QRhiBuffer *sourceBuffer = nullptr;
+        QRhiTexture *boneTexture = nullptr;
+        QRhiTexture *targetsTexture = nullptr;
+        bool used = false;
+    };
+
+    struct Dispatch
+    {
+        const QSSGRenderModel *model = nullptr;
+        QRhiBuffer *sourceBuffer = nullptr;
+        QRhiTexture *boneTexture = nullptr;
+        QRhiTexture *targetsTexture = nullptr;
+        ShaderVariant variant = Skin;
+        Params params;
+    };
+
+    QShader shaders[ShaderVariantCount];
+    bool shadersLoaded[ShaderVariantCount] = {};
+    QHash<const QSSGRenderModel *, Entry> entries;
+    QVector<Dispatch> dispatches;
 };
 
 class ShadowMapPass : public QSSGRenderPass
@@ -62,6 +135,8 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Standalone; }
+    const char *debugName() const final { return "shadow_map"; }
+    quint32 reads(const QSSGLayerRenderData &) const final { return 0; }
     void resetForFrame() final;
 
     std::shared_ptr<QSSGRenderShadowMap> shadowMapManager;
@@ -80,6 +155,8 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Standalone; }
+    const char *debugName() const final { return "reflection_map"; }
+    quint32 reads(const QSSGLayerRenderData &data) const final;
     void resetForFrame() final;
 
     std::shared_ptr<QSSGRenderReflectionMap> reflectionMapManager;
@@ -94,6 +171,8 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Main; }
+    const char *debugName() const final { return "z_prepass"; }
+    quint32 reads(const QSSGLayerRenderData &) const final { return 0; }
     void resetForFrame() final;
 
     QSSGRenderableObjectList renderedDepthWriteObjects;
@@ -108,6 +187,9 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Standalone; }
+    const char *debugName() const final { return "ssao_map"; }
+    quint32 reads(const QSSGLayerRenderData &) const final { return renderResultBit(QSSGFrameData::RenderResult::DepthTexture); }
+    quint32 writes() const final { return renderResultBit(QSSGFrameData::RenderResult::AoTexture); }
     void resetForFrame() final;
 
     const QSSGRhiRenderableTexture *rhiDepthTexture = nullptr;
@@ -124,6 +206,9 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Standalone; }
+    const char *debugName() const final { return "depth_texture"; }
+    quint32 reads(const QSSGLayerRenderData &) const final { return 0; }
+    quint32 writes() const final { return renderResultBit(QSSGFrameData::RenderResult::DepthTexture); }
     void resetForFrame() final;
 
     QSSGRenderableObjectList sortedOpaqueObjects;
@@ -132,12 +217,61 @@ public:
     QSSGRhiRenderableTexture *rhiDepthTexture = nullptr;
 };
 
+class GpuPickPass : public QSSGRenderPass
+{
+public:
+    ~GpuPickPass() override;
+    void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
+    void renderPass(QSSGRenderer &renderer) final;
+    Type passType() const final { return Type::Standalone; }
+    const char *debugName() const final { return "gpu_pick"; }
+    quint32 reads(const QSSGLayerRenderData &) const final { return 0; }
+    void resetForFrame() final;
+
+    // Moves a completed result, if any, over to the layer.
+    void publishResult(QSSGRenderLayer &layer);
+    void releaseResources();
+
+    struct PickTarget
+    {
+        const QSSGRenderGraphObject *object = nullptr;
+        QMatrix4x4 inverseGlobalTransform;
+        int subset = 0;
+        bool instanced = false;
+        // sorted instance -> instance table index, empty when not depth sorted
+        QList<int> instanceRemap;
+    };
+
+    // Per-query state, kept alive until the readback completes
+    struct Query
+    {
+        QList<PickTarget> targets;
+        QMatrix4x4 inverseViewProjection;
+        QVector3D cameraPosition;
+        QPointF ndcPosition;
+        QRhiReadbackResult readback;
+        bool inFlight = false;
+        bool hasResult = false;
+        QSSGRenderPickResult result;
+    };
+
+    QSSGRenderableObjectList pickObjects;
+    QSSGRhiGraphicsPipelineState ps;
+    QSSGRhiRenderableTexture pickTexture;
+    QSSGRhiContext *rhiCtx = nullptr;
+    Query query;
+    bool ready = false;
+};
+
 class ScreenMapPass : public QSSGRenderPass
 {
 public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Standalone; }
+    const char *debugName() const final { return "screen_texture"; }
+    quint32 reads(const QSSGLayerRenderData &) const final { return AllRenderResults & ~writes(); }
+    quint32 writes() const final { return renderResultBit(QSSGFrameData::RenderResult::ScreenTexture); }
     void resetForFrame() final;
 
     QSSGRhiRenderableTexture *rhiScreenTexture = nullptr;
@@ -155,6 +289,7 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Main; }
+    const char *debugName() const final { return "screen_texture_dependent"; }
     void resetForFrame() final;
 
     QSSGRenderableObjectList sortedScreenTextureObjects;
@@ -180,6 +315,7 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Main; }
+    const char *debugName() const final { return "opaque_pass"; }
     void resetForFrame() final;
 
     QSSGRenderableObjectList sortedOpaqueObjects;
@@ -208,6 +344,7 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Main; }
+    const char *debugName() const final { return "transparent_pass"; }
     void resetForFrame() final;
 
     QSSGRenderableObjectList sortedTransparentObjects;
@@ -221,6 +358,8 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Main; }
+    const char *debugName() const final { return "skybox_map"; }
+    quint32 reads(const QSSGLayerRenderData &) const final { return 0; }
     void resetForFrame() final;
 
     QSSGRenderLayer *layer = nullptr;
@@ -235,6 +374,8 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Main; }
+    const char *debugName() const final { return "skybox_cube"; }
+    quint32 reads(const QSSGLayerRenderData &) const final { return 0; }
     void resetForFrame() final;
 
     QSSGRhiShaderPipelinePtr skyBoxCubeShader;
@@ -249,10 +390,18 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Main; }
+    const char *debugName() const final { return "2D_sub_scene"; }
+    quint32 reads(const QSSGLayerRenderData &) const final { return 0; }
     void resetForFrame() final;
 
     QList<QSSGRenderItem2D *> item2Ds;
     QSSGRhiGraphicsPipelineState ps {};
+
+    // With QSSGRenderLayer::item2DCachingEnabled the items are drawn as a
+    // textured quad, their shader resources are in the order of item2Ds
+    // (null for the items that are skipped).
+    QSSGRhiShaderPipelinePtr texturedQuadShader;
+    QVarLengthArray<QRhiShaderResourceBindings *, 8> cachedItemSrbs;
 };
 
 class InfiniteGridPass : public QSSGRenderPass
@@ -261,6 +410,8 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Main; }
+    const char *debugName() const final { return "render_grid"; }
+    quint32 reads(const QSSGLayerRenderData &) const final { return 0; }
     void resetForFrame() final;
 
     QSSGRhiShaderPipelinePtr gridShader;
@@ -274,6 +425,8 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Main; }
+    const char *debugName() const final { return "debug_objects"; }
+    quint32 reads(const QSSGLayerRenderData &) const final { return 0; }
     void resetForFrame() final;
 
     QSSGRhiShaderPipelinePtr debugObjectShader;
@@ -288,6 +441,7 @@ public:
     void renderPrep(QSSGRenderer &renderer, QSSGLayerRenderData &data) final;
     void renderPass(QSSGRenderer &renderer) final;
     Type passType() const final { return Type::Extension; }
+    const char *debugName() const final { return "user_pass"; }
     void resetForFrame() final;
 
     bool hasData() const { return extensions.size() != 0; }
@@ -0,0 +1,173 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "qssgtransformhierarchy_p.h"
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderlayer_p.h>
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthreadpool.h>
+
+QT_BEGIN_NAMESPACE
+
+// Subtrees up to this size are updated by a single thread
+static constexpr qint32 batchSize = 2048;
+// Below this many nodes in dirty batches, waking up other threads costs more than it saves
+static constexpr qint32 parallelUpdateThreshold = 4 * batchSize;
+
+static constexpr QSSGRenderNode::FlagT visitMask = QSSGRenderNode::FlagT(QSSGRenderNode::DirtyFlag::GlobalValuesDirty)
+        | QSSGRenderNode::FlagT(QSSGRenderNode::DirtyFlag::ChildDirty);
+
+// The imported scene node is never marked as having dirty children, as the
+// root of the imported scene has its own parent.
+static inline bool needsVisit(const QSSGRenderNode &node)
+{
+    return (node.flags & visitMask) != 0 || node.type == QSSGRenderGraphObject::Type::ImportScene;
+}
+
+bool QSSGTransformHierarchy::sync(QSSGRenderLayer &layer)
+{
+    const quint32 activeStateVersion = QSSGRenderNode::activeStateVersion();
+    const bool activeStateChanged = (m_activeStateVersion != activeStateVersion);
+    m_activeStateVersion = activeStateVersion;
+
+    const quint32 structureVersion = QSSGRenderNode::structureVersion();
+    if (m_built && m_structureVersion == structureVersion)
+        return activeStateChanged;
+
+    m_built = true;
+    m_structureVersion = structureVersion;
+    m_nodes.clear();
+    m_subtreeEnds.clear();
+    m_spine.clear();
+    m_batches.clear();
+
+    for (auto &child : layer.children)
+        add(child);
+    partition(0, qint32(m_nodes.size()), -1);
+    m_spineActive.resize(m_spine.size());
+    m_hasImportedScene = (layer.importSceneNode != nullptr);
+    return true;
+}
+
+void QSSGTransformHierarchy::add(QSSGRenderNode &node)
+{
+    const qsizetype index = m_nodes.size();
+    m_nodes.append(&node);
+    m_subtreeEnds.append(0);
+    for (auto &child : node.children)
+        add(child);
+    m_subtreeEnds[index] = qint32(m_nodes.size());
+}
+
+void QSSGTransformHierarchy::partition(qint32 begin, qint32 end, qint32 parent)
+{
+    qint32 batchBegin = begin;
+    for (qint32 i = begin; i < end; i = m_subtreeEnds.at(i)) {
+        const qint32 subtreeEnd = m_subtreeEnds.at(i);
+        if (subtreeEnd - i > batchSize) {
+            if (batchBegin < i)
+                m_batches.append({ batchBegin, i, parent });
+            m_spine.append({ i, parent });
+            partition(i + 1, subtreeEnd, qint32(m_spine.size() - 1));
+            batchBegin = subtreeEnd;
+        } else if (subtreeEnd - batchBegin >= batchSize) {
+            m_batches.append({ batchBegin, subtreeEnd, parent });
+            batchBegin = subtreeEnd;
+        }
+    }
+    if (batchBegin < end)
+        m_batches.append({ batchBegin, end, parent });
+}
+
+bool QSSGTransformHierarchy::isBatchDirty(const Batch &batch) const
+{
+    for (qint32 i = batch.begin; i < batch.end; i = m_subtreeEnds.at(i)) {
+        if (needsVisit(*m_nodes.at(i)))
+            return true;
+    }
+    return false;
+}
+
+bool QSSGTransformHierarchy::updateBatch(const Batch &batch) const
+{
+    bool wasDirty = false;
+    const auto *nodes = m_nodes.constData();
+    const auto *subtreeEnds = m_subtreeEnds.constData();
+    for (qint32 i = batch.begin; i < batch.end;) {
+        QSSGRenderNode &node = *nodes[i];
+        if (!needsVisit(node)) {
+            i = subtreeEnds[i];
+            continue;
+        }
+        // The parent, if any, is either earlier in the batch or in the spine,
+        // so it is up to date and the calculation does not walk up the graph.
+        if (node.isDirty(QSSGRenderNode::DirtyFlag::GlobalValuesDirty))
+            wasDirty |= node.calculateGlobalVariables();
+        node.clearDirty(QSSGRenderNode::DirtyFlag::ChildDirty);
+        i = node.getGlobalState(QSSGRenderNode::GlobalState::Active) ? i + 1 : subtreeEnds[i];
+    }
+    return wasDirty;
+}
+
+bool QSSGTransformHierarchy::update()
+{
+    bool wasDirty = false;
+
+    for (qsizetype i = 0, end = m_spine.size(); i != end; ++i) {
+        const SpineNode &spineNode = m_spine.at(i);
+        if (spineNode.parent >= 0 && !m_spineActive.at(spineNode.parent)) {
+            m_spineActive[i] = false;
+            continue;
+        }
+        QSSGRenderNode &node = *m_nodes.at(spineNode.index);
+        if (node.isDirty(QSSGRenderNode::DirtyFlag::GlobalValuesDirty))
+            wasDirty |= node.calculateGlobalVariables();
+        node.clearDirty(QSSGRenderNode::DirtyFlag::ChildDirty);
+        m_spineActive[i] = node.getGlobalState(QSSGRenderNode::GlobalState::Active);
+    }
+
+    m_dirtyBatches.clear();
+    qint32 dirtyNodeCount = 0;
+    for (const Batch &batch : std::as_const(m_batches)) {
+        if (batch.parent >= 0 && !m_spineActive.at(batch.parent))
+            continue;
+        if (isBatchDirty(batch)) {
+            m_dirtyBatches.append(batch);
+            dirtyNodeCount += batch.end - batch.begin;
+        }
+    }
+
+    if (m_hasImportedScene || m_dirtyBatches.size() < 2 || dirtyNodeCount < parallelUpdateThreshold) {
+        for (const Batch &batch : std::as_const(m_dirtyBatches))
+            wasDirty |= updateBatch(batch);
+        return wasDirty;
+    }
+
+    // The batches do not share any node, and their parents are done, so
+    // any thread can take the next one. The calling thread takes part too,
+    // so that only the threads that are idle right now are used.
+    QAtomicInt nextBatch = 0;
+    QAtomicInt anyDirty = 0;
+    const auto updateBatches = [this, &nextBatch, &anyDirty]() {
+        bool dirty = false;
+        for (int i = nextBatch.fetchAndAddRelaxed(1); i < m_dirtyBatches.size(); i = nextBatch.fetchAndAddRelaxed(1))
+            dirty |= updateBatch(m_dirtyBatches.at(i));
+        if (dirty)
+            anyDirty.storeRelaxed(1);
+    };
+
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    const int maxHelpers = qMin(threadPool->maxThreadCount(), int(m_dirtyBatches.size()) - 1);
+    QSemaphore done;
+    int helpers = 0;
+    while (helpers < maxHelpers && threadPool->tryStart([&updateBatches, &done] { updateBatches(); done.release(); }))
+        ++helpers;
+    updateBatches();
+    done.acquire(helpers);
+
+    return wasDirty || anyDirty.loadRelaxed() != 0;
+}
+
+QT_END_NAMESPACE
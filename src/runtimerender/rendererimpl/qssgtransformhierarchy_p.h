@@ -0,0 +1,91 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef QSSGTRANSFORMHIERARCHY_P_H
+#define QSSGTRANSFORMHIERARCHY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DRuntimeRender/private/qtquick3druntimerenderglobal_p.h>
+
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+struct QSSGRenderNode;
+struct QSSGRenderLayer;
+
+// A flattened copy of the node trees of a layer, in depth-first order, so that
+// updating the global values of the nodes and collecting them for rendering are
+// linear passes over contiguous arrays instead of walks through the child lists.
+// The subtree of the node at index i is [i + 1, subtreeEnd(i)).
+class Q_QUICK3DRUNTIMERENDER_EXPORT QSSGTransformHierarchy
+{
+public:
+    // Rebuilds the arrays if a node was added to or removed from any node since
+    // the last time, see QSSGRenderNode::structureVersion(). Returns true if
+    // that, or the active state of any node, changed, meaning that the nodes
+    // to render have to be collected again.
+    [[nodiscard]] bool sync(QSSGRenderLayer &layer);
+
+    // Calculates the global values of the dirty nodes of the active subtrees.
+    // Subtrees without anything dirty are skipped as a whole, and large enough
+    // batches of dirty subtrees are updated in parallel. Returns true if an
+    // active node was dirty.
+    bool update();
+
+    [[nodiscard]] qsizetype size() const { return m_nodes.size(); }
+    [[nodiscard]] QSSGRenderNode *node(qsizetype index) const { return m_nodes.at(index); }
+    [[nodiscard]] qint32 subtreeEnd(qsizetype index) const { return m_subtreeEnds.at(index); }
+
+    // The nodes with subtrees too large to be updated by one thread. They
+    // are updated first, one after the other, in depth-first order.
+    struct SpineNode
+    {
+        qint32 index;
+        qint32 parent; // index in m_spine, -1 for the top level
+    };
+    // A range of sibling subtrees that can be updated independently
+    // once its parent in the spine is.
+    struct Batch
+    {
+        qint32 begin;
+        qint32 end;
+        qint32 parent; // index in m_spine, -1 for the top level
+    };
+
+    [[nodiscard]] const QVector<SpineNode> &spine() const { return m_spine; }
+    [[nodiscard]] const QVector<Batch> &batches() const { return m_batches; }
+
+private:
+    void add(QSSGRenderNode &node);
+    void partition(qint32 begin, qint32 end, qint32 parent);
+    [[nodiscard]] bool isBatchDirty(const Batch &batch) const;
+    [[nodiscard]] bool updateBatch(const Batch &batch) const;
+
+    QVector<QSSGRenderNode *> m_nodes;
+    QVector<qint32> m_subtreeEnds;
+    QVector<SpineNode> m_spine;
+    QVector<bool> m_spineActive;
+    QVector<Batch> m_batches;
+    QVector<Batch> m_dirtyBatches;
+    quint32 m_structureVersion = 0;
+    quint32 m_activeStateVersion = 0;
+    bool m_built = false;
+    // Imported scenes have parents outside of the layer, which are updated
+    // through their children, so those are never updated in parallel.
+    bool m_hasImportedScene = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSSGTRANSFORMHIERARCHY_P_H
@@ -235,11 +235,13 @@ void QSSGMaterialVertexPipeline::beginVertexGeneration(const QSSGShaderDefaultMa
 
     // The custom fragment main should be skipped if this is a
     // depth pass, but not if it is also a OpaqueDepthPrePass
-    // because then we need to know the real alpha values
+    // because then we need to know the real alpha values.
+    // The pick pass only writes ids, so it never needs it.
     skipCustomFragmentSnippet = false;
     const bool isDepthPass = inFeatureSet.isSet(QSSGShaderFeatures::Feature::DepthPass);
     const bool isOpaqueDepthPrePass = inFeatureSet.isSet(QSSGShaderFeatures::Feature::OpaqueDepthPrePass);
-    skipCustomFragmentSnippet = (isDepthPass && !isOpaqueDepthPrePass);
+    const bool isPickPass = inFeatureSet.isSet(QSSGShaderFeatures::Feature::PickPass);
+    skipCustomFragmentSnippet = (isDepthPass && !isOpaqueDepthPrePass) || isPickPass;
 
     if (hasCustomVertexShader || hasCustomFragmentShader) {
         // This is both for unshaded and shaded. Regardless of any other
@@ -37,7 +37,8 @@ struct QSSGMaterialVertexPipeline
         UVCoords1 = 1 << 7,
         VertexColor = 1 << 8,
         PerspDivDepth = 1 << 9,
-        PerspDivWorldPos = 1 << 10
+        PerspDivWorldPos = 1 << 10,
+        PickInstanceIndex = 1 << 11
     };
 
     typedef QHash<QByteArray, QByteArray> TStrTableStrMap;
@@ -233,6 +234,15 @@ struct QSSGMaterialVertexPipeline
         vertex().append("    qt_varDepth = gl_Position.z / gl_Position.w;");
     }
 
+    void generatePickInstanceIndex()
+    {
+        if (setCode(GenerationFlag::PickInstanceIndex))
+            return;
+
+        addInterpolationParameter("qt_varPickInstanceIndex", "flat uint");
+        vertex().append("    qt_varPickInstanceIndex = uint(gl_InstanceIndex);");
+    }
+
     void generateShadowWorldPosition(const QSSGShaderDefaultMaterialKey &inKey)
     {
         if (setCode(GenerationFlag::PerspDivWorldPos))
@@ -14,6 +14,7 @@
 #include <QtQuick/QSGTexture>
 
 #include <QtCore/QDir>
+#include <QtCore/qthreadpool.h>
 #include <QtGui/private/qimage_p.h>
 #include <QtQuick/private/qsgtexture_p.h>
 #include <QtQuick/private/qsgcompressedtexture_p.h>
@@ -126,8 +127,25 @@ static constexpr QSize sizeForMipLevel(int mipLevel, const QSize &baseLevelSize)
     return QSize(qMax(1, baseLevelSize.width() >> mipLevel), qMax(1, baseLevelSize.height() >> mipLevel));
 }
 
+// Textures are streamed in starting from the first level not larger than this
+static constexpr int streamedTextureBaseSize = 256;
+// Caps the amount of texture data loaded for streaming in one frame, counting
+// the files that start decoding and the textures created from decoded ones. A
+// single texture is always allowed, however large.
+static constexpr quint64 streamedTextureBytesPerFrame = 16 * 1024 * 1024;
+
+struct QSSGBufferManager::StreamedTextureLoad
+{
+    QScopedPointer<QSSGLoadedTexture> texture;
+    QAtomicInt done;
+};
+
 QSSGBufferManager::QSSGBufferManager()
 {
+    const int budgetMB = qEnvironmentVariableIntValue("QT_QUICK3D_TEXTURE_MEMORY_BUDGET");
+    if (budgetMB > 0)
+        environmentTextureBudget = quint64(budgetMB) * 1024 * 1024;
+    textureBudget = environmentTextureBudget;
 }
 
 QSSGBufferManager::~QSSGBufferManager()
@@ -227,10 +245,36 @@ QSSGRenderImageTexture QSSGBufferManager::loadRenderImage(const QSSGRenderImage
                 CreateRhiTextureFlags rhiTexFlags = ScanForTransparency;
                 if (image->type == QSSGRenderGraphObject::Type::ImageCube)
                     rhiTexFlags |= CubeMap;
-                if (!createRhiTexture(foundIt.value().renderImageTexture, theLoadedTexture.data(), inMipMode, rhiTexFlags, QFileInfo(path).fileName())) {
+                StreamedTexture streamed;
+                if (textureBudget && !rhiTexFlags.testFlag(CubeMap) && inMipMode != MipModeBsdf) {
+                    // Plain 2D images can be scaled down, container files
+                    // only if they come with their mip levels.
+                    if (theLoadedTexture->textureFileData.isValid()) {
+                        streamed.size = theLoadedTexture->textureFileData.size();
+                        streamed.levelCount = theLoadedTexture->textureFileData.numLevels();
+                    } else if (!theLoadedTexture->image.isNull()) {
+                        streamed.size = theLoadedTexture->image.size();
+                        streamed.levelCount = context->rhi()->mipLevelsForSize(streamed.size);
+                    }
+                    const int maxDimension = qMax(streamed.size.width(), streamed.size.height());
+                    while (streamed.baseLevel + 1 < streamed.levelCount && (maxDimension >> streamed.baseLevel) > streamedTextureBaseSize)
+                        ++streamed.baseLevel;
+                }
+                if (!createRhiTexture(foundIt.value().renderImageTexture, theLoadedTexture.data(), inMipMode, rhiTexFlags, QFileInfo(path).fileName(), streamed.baseLevel)) {
                     foundIt.value() = ImageData();
-                } else if (QSSGBufferManagerStat::enabled(QSSGBufferManagerStat::Level::Debug)) {
-                    qDebug() << "+ uploadTexture: " << image->m_imagePath.path() << currentLayer;
+                } else {
+                    if (streamed.baseLevel > 0) {
+                        const QRhiTexture *texture = foundIt.value().renderImageTexture.m_texture;
+                        streamed.path = path;
+                        streamed.format = image->m_format;
+                        streamed.rhiFormat = texture->format();
+                        streamed.rhiFlags = texture->flags();
+                        streamed.residentLevel = streamed.baseLevel;
+                        streamed.flipY = flipY;
+                        streamedTextures.insert(imageKey, streamed);
+                    }
+                    if (QSSGBufferManagerStat::enabled(QSSGBufferManagerStat::Level::Debug))
+                        qDebug() << "+ uploadTexture: " << image->m_imagePath.path() << currentLayer;
                 }
                 result = foundIt.value().renderImageTexture;
                 increaseMemoryStat(result.m_texture);
@@ -244,6 +288,11 @@ QSSGRenderImageTexture QSSGBufferManager::loadRenderImage(const QSSGRenderImage
             Q_QUICK3D_PROFILE_END_WITH_STRING(QQuick3DProfiler::Quick3DTextureLoad, stats.imageDataSize, path.toUtf8());
         }
         foundIt.value().usageCounts[currentLayer]++;
+        if (textureBudget) {
+            auto streamedIt = streamedTextures.find(imageKey);
+            if (streamedIt != streamedTextures.end())
+                streamedIt->used = true;
+        }
     } else if (image->m_extensionsSource) {
         auto it = renderExtensionTexture.find(image->m_extensionsSource);
         if (it != renderExtensionTexture.end()) {
@@ -262,6 +311,13 @@ QSSGRenderImageTexture QSSGBufferManager::loadTextureData(QSSGRenderTextureData
     if (theImageData == customTextureMap.end()) {
         theImageData = customTextureMap.insert(imageKey, ImageData());
     } else if (data->generationId() != theImageData->generationId) {
+        // When only the contents changed, upload them to the existing texture
+        if (theImageData->generationId >= data->layoutGenerationId()
+                && updateRhiTexture(theImageData.value(), data, inMipMode)) {
+            theImageData.value().generationId = data->generationId();
+            theImageData.value().usageCounts[currentLayer]++;
+            return theImageData.value().renderImageTexture;
+        }
         // release first
         releaseTextureData(imageKey);
         // reinsert the placeholder since releaseTextureData removed from map
@@ -914,7 +970,8 @@ bool QSSGBufferManager::createRhiTexture(QSSGRenderImageTexture &texture,
                                          const QSSGLoadedTexture *inTexture,
                                          MipMode inMipMode,
                                          CreateRhiTextureFlags inFlags,
-                                         const QString &debugObjectName)
+                                         const QString &debugObjectName,
+                                         int baseLevel)
 {
     Q_ASSERT(inMipMode != MipModeFollowRenderImage);
     QVarLengthArray<QRhiTextureUploadEntry, 16> textureUploads;
@@ -979,8 +1036,10 @@ bool QSSGBufferManager::createRhiTexture(QSSGRenderImageTexture &texture,
         }
     } else if (inTexture->textureFileData.isValid()) {
         const QTextureFileData &tex = inTexture->textureFileData;
-        size = tex.size();
-        mipmapCount = tex.numLevels();
+        // The levels above baseLevel are not uploaded when streaming
+        baseLevel = qMax(0, qMin(baseLevel, tex.numLevels() - 1));
+        size = sizeForMipLevel(baseLevel, tex.size());
+        mipmapCount = tex.numLevels() - baseLevel;
 
         int numFaces = 1;
         // Just having a container with 6 faces is not enough, we only treat it
@@ -989,12 +1048,12 @@ bool QSSGBufferManager::createRhiTexture(QSSGRenderImageTexture &texture,
         if (tex.numFaces() == 6 && inFlags.testFlag(CubeMap))
             numFaces = 6;
 
-        for (int level = 0; level < tex.numLevels(); ++level) {
+        for (int level = baseLevel; level < tex.numLevels(); ++level) {
             QRhiTextureSubresourceUploadDescription subDesc;
-            subDesc.setSourceSize(sizeForMipLevel(level, size));
+            subDesc.setSourceSize(sizeForMipLevel(level, tex.size()));
             for (int face = 0; face < numFaces; ++face) {
                 subDesc.setData(tex.getDataView(level, face).toByteArray());
-                textureUploads << QRhiTextureUploadEntry{ face, level, subDesc };
+                textureUploads << QRhiTextureUploadEntry{ face, level - baseLevel, subDesc };
             }
         }
 
@@ -1022,10 +1081,17 @@ bool QSSGBufferManager::createRhiTexture(QSSGRenderImageTexture &texture,
         QRhiTextureSubresourceUploadDescription subDesc;
         if (!inTexture->image.isNull()) {
             rhiFormat = toRhiFormat(inTexture->format.format);
-            size = inTexture->image.size();
-            subDesc.setImage(inTexture->image);
+            QImage image = inTexture->image;
+            if (baseLevel > 0) {
+                // Streamed in later, start with a scaled down version
+                image = image.scaled(sizeForMipLevel(baseLevel, image.size()),
+                                     Qt::IgnoreAspectRatio,
+                                     Qt::SmoothTransformation).convertToFormat(image.format());
+            }
+            size = image.size();
+            subDesc.setImage(image);
             if (checkTransp)
-                hasTransp = QImageData::get(inTexture->image)->checkForAlphaPixels();
+                hasTransp = QImageData::get(image)->checkForAlphaPixels();
         } else if (inTexture->data) {
             rhiFormat = toRhiFormat(inTexture->format.format);
             size = QSize(inTexture->width, inTexture->height);
@@ -1098,6 +1164,78 @@ bool QSSGBufferManager::createRhiTexture(QSSGRenderImageTexture &texture,
     return true;
 }
 
+bool QSSGBufferManager::updateRhiTexture(const ImageData &imageData,
+                                         QSSGRenderTextureData *data,
+                                         MipMode inMipMode)
+{
+    QRhiTexture *tex = imageData.renderImageTexture.m_texture;
+    // environment maps are generated from the data, those are always recreated
+    if (!tex || inMipMode == MipModeBsdf || data->textureData().isNull())
+        return false;
+
+    const QSSGRenderTextureFormat format = data->format();
+    const QSize size = data->size();
+    const QByteArray &textureData = data->textureData();
+    QVarLengthArray<QRhiTextureUploadEntry, 16> textureUploads;
+    QVector<QRect> regions;
+    if (format.isUncompressedTextureFormat() && data->depth() == 0
+            && data->dirtyRegionsSince(imageData.generationId, &regions)) {
+        const int bytesPerPixel = format.getSizeofFormat();
+        // rows are 4 byte aligned, like in QSSGLoadedTexture::loadTextureData()
+        const qsizetype pitch = (qsizetype(size.width()) * bytesPerPixel + 3) & ~3;
+        if (textureData.size() < pitch * size.height())
+            return false;
+        for (const QRect &region : std::as_const(regions)) {
+            const QRect rect = region & QRect(QPoint(0, 0), size);
+            if (rect.isEmpty())
+                continue;
+            const qsizetype rowSize = qsizetype(rect.width()) * bytesPerPixel;
+            QByteArray regionData(rowSize * rect.height(), Qt::Uninitialized);
+            for (int y = 0; y < rect.height(); ++y) {
+                memcpy(regionData.data() + y * rowSize,
+                       textureData.constData() + (rect.y() + y) * pitch + rect.x() * bytesPerPixel,
+                       rowSize);
+            }
+            QRhiTextureSubresourceUploadDescription subDesc(regionData);
+            subDesc.setDestinationTopLeft(rect.topLeft());
+            subDesc.setSourceSize(rect.size());
+            textureUploads << QRhiTextureUploadEntry{ 0, 0, subDesc };
+        }
+        if (textureUploads.isEmpty())
+            return true;
+    } else {
+        QScopedPointer<QSSGLoadedTexture> loadedTexture(QSSGLoadedTexture::loadTextureData(data));
+        loadedTexture->ownsData = false;
+        if (quint32(textureData.size()) < loadedTexture->dataSizeInBytes)
+            return false;
+        if (loadedTexture->depth > 0) {
+            const quint32 size2D = loadedTexture->dataSizeInBytes / loadedTexture->depth;
+            for (int slice = 0; slice < loadedTexture->depth; ++slice) {
+                QRhiTextureSubresourceUploadDescription sliceUpload(textureData.mid(slice * size2D, size2D));
+                textureUploads << QRhiTextureUploadEntry(slice, 0, sliceUpload);
+            }
+        } else {
+            // the data is implicitly shared, no copy is made when it fits exactly
+            QRhiTextureSubresourceUploadDescription subDesc(textureData.left(loadedTexture->dataSizeInBytes));
+            subDesc.setSourceSize(size);
+            textureUploads << QRhiTextureUploadEntry{ 0, 0, subDesc };
+        }
+    }
+
+    const auto &context = m_contextInterface->rhiContext();
+    QRhiTextureUploadDescription uploadDescription;
+    uploadDescription.setEntries(textureUploads.cbegin(), textureUploads.cend());
+    auto *rub = context->rhi()->nextResourceUpdateBatch();
+    rub->uploadTexture(tex, uploadDescription);
+    if (tex->flags().testFlag(QRhiTexture::UsedWithGenerateMips))
+        rub->generateMips(tex);
+    context->commandBuffer()->resourceUpdate(rub);
+
+    if (QSSGBufferManagerStat::enabled(QSSGBufferManagerStat::Level::Debug))
+        qDebug() << "~ updateTexture: " << data << (regions.isEmpty() ? -1 : regions.size()) << currentLayer;
+    return true;
+}
+
 QString QSSGBufferManager::primitivePath(const QString &primitive)
 {
     QByteArray theName = primitive.toUtf8();
@@ -1221,9 +1359,18 @@ QSSGRenderMesh *QSSGBufferManager::createRenderMesh(const QSSGMesh::Mesh &mesh,
     QRhiResourceUpdateBatch *rub = meshBufferUpdateBatch();
     const auto &context = m_contextInterface->rhiContext();
     QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(context.get());
+    // Skinned and morphed meshes may be read by the skinning pre-pass
+    QRhiBuffer::UsageFlags vertexBufferUsage = QRhiBuffer::VertexBuffer;
+    if (context->rhi()->isFeatureSupported(QRhi::Compute)) {
+        bool deformable = !targetBuffer.data.isEmpty();
+        for (const auto &entry : std::as_const(vertexBuffer.entries))
+            deformable |= (entry.name == QSSGMesh::MeshInternal::getJointAttrName());
+        if (deformable)
+            vertexBufferUsage |= QRhiBuffer::StorageBuffer;
+    }
     rhi.vertexBuffer = std::make_shared<QSSGRhiBuffer>(*context.get(),
                                                        QRhiBuffer::Static,
-                                                       QRhiBuffer::VertexBuffer,
+                                                       vertexBufferUsage,
                                                        vertexBuffer.stride,
                                                        vertexBuffer.data.size());
     rhi.vertexBuffer->buffer()->setName(debugObjectName.toLatin1()); // this is what shows up in DebugView
@@ -1349,6 +1496,13 @@ QSSGRenderMesh *QSSGBufferManager::createRenderMesh(const QSSGMesh::Mesh &mesh,
         subset.offset = source.offset;
         for (auto &lod : source.lods)
             subset.lods.append(QSSGRenderSubset::Lod({lod.count, lod.offset, lod.distance}));
+        subset.meshlets.reserve(source.meshlets.size());
+        for (const auto &meshlet : source.meshlets) {
+            subset.meshlets.append(QSSGRenderSubset::Meshlet({ meshlet.count, meshlet.offset,
+                                                               meshlet.center, meshlet.radius,
+                                                               meshlet.coneApex, meshlet.coneAxis,
+                                                               meshlet.coneCutoff }));
+        }
 
 
         if (rhi.vertexBuffer) {
@@ -1458,6 +1612,7 @@ void QSSGBufferManager::releaseImage(const ImageCacheKey &key)
             Q_QUICK3D_PROFILE_END_WITH_STRING(QQuick3DProfiler::Quick3DTextureLoad,
                                                stats.imageDataSize, key.path.path().toUtf8());
         }
+        streamedTextures.remove(key);
         imageMap.erase(imageItr);
     }
 }
@@ -1534,6 +1689,7 @@ void QSSGBufferManager::cleanupUnreferencedBuffers(quint32 frameId, QSSGRenderLa
                 decreaseMemoryStat(rhiTexture);
                 rhiCtxD->releaseTexture(rhiTexture);
             }
+            streamedTextures.remove(imageKeyIterator.key());
             imageKeyIterator = imageMap.erase(imageKeyIterator);
         } else {
             ++imageKeyIterator;
@@ -1677,7 +1833,9 @@ QSSGRenderMesh *QSSGBufferManager::loadRenderMesh(const QSSGRenderPath &inMeshPa
 
     if (!result.isValid()) {
         resultSourcePath = inMeshPath.path();
-        result = loadMeshData(inMeshPath);
+        // Map the file rather than reading it: the vertex and index data is
+        // then copied only once, from the mapping into the update batch.
+        result = loadMeshData(inMeshPath, true);
     }
 
     if (!result.isValid()) {
@@ -1696,6 +1854,8 @@ QSSGRenderMesh *QSSGBufferManager::loadRenderMesh(const QSSGRenderPath &inMeshPa
         result.createLightmapUVChannel(options.lightmapBaseResolution);
     }
 
+    // The update batch has its own copy of the data, so the mapping goes
+    // together with result
     auto ret = createRenderMesh(result, QFileInfo(resultSourcePath).fileName());
     meshMap.insert(inMeshPath, { ret, {{currentLayer, 1}}, 0, options });
     QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(m_contextInterface->rhiContext().get());
@@ -1813,7 +1973,7 @@ std::unique_ptr<QSSGMeshBVH> QSSGBufferManager::loadMeshBVH(QSSGRenderGeometry *
     return meshBVHBuilder.buildTree();
 }
 
-QSSGMesh::Mesh QSSGBufferManager::loadMeshData(const QSSGRenderPath &inMeshPath)
+QSSGMesh::Mesh QSSGBufferManager::loadMeshData(const QSSGRenderPath &inMeshPath, bool allowMapping)
 {
     QSSGMesh::Mesh result;
 
@@ -1848,7 +2008,11 @@ QSSGMesh::Mesh QSSGBufferManager::loadMeshData(const QSSGRenderPath &inMeshPath)
         if (!pathBuilder.isEmpty()) {
             QSharedPointer<QIODevice> device(QSSGInputUtil::getStreamForFile(pathBuilder));
             if (device) {
-                QSSGMesh::Mesh mesh = QSSGMesh::Mesh::loadMesh(device.data(), id);
+                QSharedPointer<QFile> file;
+                if (allowMapping)
+                    file = qSharedPointerObjectCast<QFile>(device);
+                QSSGMesh::Mesh mesh = file ? QSSGMesh::Mesh::loadMeshMapped(file, id)
+                                           : QSSGMesh::Mesh::loadMesh(device.data(), id);
                 if (mesh.isValid())
                     result = mesh;
             }
@@ -1931,6 +2095,7 @@ void QSSGBufferManager::clear()
         releaseImage(it.key());
 
     imageMap.clear();
+    streamedTextures.clear();
 
     // Textures (custom)
     for (auto it = customTextureMap.cbegin(), end = customTextureMap.cend(); it != end; ++it)
@@ -1975,17 +2140,13 @@ void QSSGBufferManager::processResourceLoader(const QSSGRenderResourceLoader *lo
     commitBufferResourceUpdates();
 }
 
-static inline quint64 textureMemorySize(QRhiTexture *texture)
+static inline quint64 textureMemorySize(QRhiTexture::Format format, QSize pixelSize, QRhiTexture::Flags flags)
 {
     quint64 s = 0;
-    if (!texture)
-        return s;
-
-    auto format = texture->format();
     if (format == QRhiTexture::UnknownFormat)
         return 0;
 
-    s = texture->pixelSize().width() * texture->pixelSize().height();
+    s = pixelSize.width() * pixelSize.height();
     /*
         UnknownFormat,
         RGBA8,
@@ -2026,13 +2187,20 @@ static inline quint64 textureMemorySize(QRhiTexture *texture)
     else
         s /= 16;
 
-    if (texture->flags() & QRhiTexture::MipMapped)
+    if (flags & QRhiTexture::MipMapped)
         s += s / 4;
-    if (texture->flags() & QRhiTexture::CubeMap)
+    if (flags & QRhiTexture::CubeMap)
         s *= 6;
     return s;
 }
 
+static inline quint64 textureMemorySize(QRhiTexture *texture)
+{
+    if (!texture)
+        return 0;
+    return textureMemorySize(texture->format(), texture->pixelSize(), texture->flags());
+}
+
 static inline quint64 bufferMemorySize(const QSSGRhiBufferPtr &buffer)
 {
     quint64 s = 0;
@@ -2071,4 +2239,228 @@ void QSSGBufferManager::decreaseMemoryStat(QSSGRenderMesh *mesh)
     QSSGRhiContextStats::get(*m_contextInterface->rhiContext()).meshDataSizeChanges(stats.meshDataSize);
 }
 
+static inline quint64 streamedTextureSize(const QSSGBufferManager::StreamedTexture &streamed, int level)
+{
+    return textureMemorySize(streamed.rhiFormat, sizeForMipLevel(level, streamed.size), streamed.rhiFlags);
+}
+
+void QSSGBufferManager::setTextureMemoryBudget(quint64 bytes)
+{
+    textureBudget = bytes;
+}
+
+void QSSGBufferManager::requestTextureMemoryBudget(quint64 bytes)
+{
+    // Every View3D of the window asks again in each frame, the last one to do
+    // so leaves the largest budget in place
+    requestedTextureBudget = qMax(requestedTextureBudget, bytes);
+    textureBudget = requestedTextureBudget ? requestedTextureBudget : environmentTextureBudget;
+}
+
+void QSSGBufferManager::requestTextureDetail(const QSSGRenderImage *image, float texelsAcross)
+{
+    if (streamedTextures.isEmpty() || image->m_qsgTexture || image->m_rawTextureData || image->m_imagePath.isEmpty())
+        return;
+
+    const ImageCacheKey imageKey = { image->m_imagePath,
+                                     image->m_generateMipmaps ? MipModeEnable : MipModeDisable,
+                                     int(image->type) };
+    auto it = streamedTextures.find(imageKey);
+    if (it == streamedTextures.end())
+        return;
+
+    // The coarsest level that still has the requested number of texels
+    StreamedTexture &streamed = it.value();
+    const float maxDimension = float(qMax(streamed.size.width(), streamed.size.height()));
+    int level = streamed.levelCount - 1;
+    if (texelsAcross >= 1.0f)
+        level = qBound(0, int(std::floor(std::log2(maxDimension / texelsAcross))), level);
+    streamed.requestedLevel = streamed.requestedLevel < 0 ? level : qMin(streamed.requestedLevel, level);
+}
+
+quint64 QSSGBufferManager::selectStreamedTextureLevels(QList<StreamedTexture *> textures,
+                                                       quint64 totalSize,
+                                                       quint64 budget,
+                                                       quint32 frameId)
+{
+    // Textures used without any request for detail, by custom materials or
+    // effects for instance, get their full resolution. The ones not used at
+    // all need nothing above the base level.
+    for (StreamedTexture *streamed : std::as_const(textures)) {
+        if (streamed->used)
+            streamed->desiredLevel = streamed->requestedLevel < 0 ? 0 : qMin(streamed->requestedLevel, streamed->baseLevel);
+        else
+            streamed->desiredLevel = streamed->baseLevel;
+        if (streamed->desiredLevel <= streamed->residentLevel)
+            streamed->lastNeededFrame = frameId;
+        streamed->targetLevel = streamed->residentLevel;
+    }
+
+    // Least recently needed at full resident detail first, then largest first
+    std::sort(textures.begin(), textures.end(), [](const StreamedTexture *a, const StreamedTexture *b) {
+        if (a->lastNeededFrame != b->lastNeededFrame)
+            return a->lastNeededFrame < b->lastNeededFrame;
+        return streamedTextureSize(*a, a->residentLevel) > streamedTextureSize(*b, b->residentLevel);
+    });
+
+    // Drops levels, in the order above, until extraBytes fit in the budget.
+    // Levels that are still needed are only dropped when dropNeeded is set.
+    const auto evict = [&](quint64 extraBytes, bool dropNeeded) {
+        for (StreamedTexture *streamed : std::as_const(textures)) {
+            if (totalSize + extraBytes <= budget)
+                break;
+            const int minLevel = dropNeeded ? streamed->baseLevel : streamed->desiredLevel;
+            while (streamed->targetLevel < minLevel && totalSize + extraBytes > budget) {
+                totalSize -= streamedTextureSize(*streamed, streamed->targetLevel)
+                        - streamedTextureSize(*streamed, streamed->targetLevel + 1);
+                ++streamed->targetLevel;
+            }
+        }
+        return totalSize + extraBytes <= budget;
+    };
+
+    // Over budget, for instance after new textures got loaded
+    if (totalSize > budget && !evict(0, false))
+        evict(0, true);
+
+    // Raise the detail where it is missing, the most blurry first
+    QVarLengthArray<StreamedTexture *, 64> upgrades;
+    for (StreamedTexture *streamed : std::as_const(textures)) {
+        if (streamed->desiredLevel < streamed->targetLevel)
+            upgrades.append(streamed);
+    }
+    std::stable_sort(upgrades.begin(), upgrades.end(), [](const StreamedTexture *a, const StreamedTexture *b) {
+        return (a->targetLevel - a->desiredLevel) > (b->targetLevel - b->desiredLevel);
+    });
+
+    quint64 loadedBytes = 0;
+    for (StreamedTexture *streamed : upgrades) {
+        if (loadedBytes >= streamedTextureBytesPerFrame)
+            break;
+        const quint64 currentSize = streamedTextureSize(*streamed, streamed->targetLevel);
+        evict(streamedTextureSize(*streamed, streamed->desiredLevel) - currentSize, false);
+        int level = streamed->desiredLevel;
+        while (level < streamed->targetLevel && totalSize + streamedTextureSize(*streamed, level) - currentSize > budget)
+            ++level;
+        if (level == streamed->targetLevel)
+            continue;
+        totalSize += streamedTextureSize(*streamed, level) - currentSize;
+        loadedBytes += streamedTextureSize(*streamed, level);
+        streamed->targetLevel = level;
+    }
+
+    return totalSize;
+}
+
+void QSSGBufferManager::endStreamingFrame()
+{
+    ++streamingFrame;
+    streamingUpdatePending = true;
+    requestedTextureBudget = 0;
+}
+
+void QSSGBufferManager::updateStreamedTextures()
+{
+    // Once per window frame, with the requests of all the View3Ds in it
+    if (!streamingUpdatePending)
+        return;
+    streamingUpdatePending = false;
+
+    if (streamedTextures.isEmpty())
+        return;
+
+    // Without a budget, whatever was streamed before comes back in full
+    const quint64 budget = textureBudget ? textureBudget : std::numeric_limits<quint64>::max();
+    QList<StreamedTexture *> textures;
+    textures.reserve(streamedTextures.size());
+    for (auto &streamed : streamedTextures)
+        textures.append(&streamed);
+    selectStreamedTextureLevels(textures, stats.imageDataSize, budget, streamingFrame);
+
+    quint64 residentSize = 0;
+    quint64 requestedSize = 0;
+    for (auto it = streamedTextures.begin(), end = streamedTextures.end(); it != end; ++it) {
+        StreamedTexture &streamed = it.value();
+        if (streamed.targetLevel != streamed.residentLevel && setStreamedTextureLevel(it.key(), streamed, streamed.targetLevel))
+            streamed.residentLevel = streamed.targetLevel;
+        // The detail is not to be raised anymore, the decoded file can go
+        if (streamed.targetLevel >= streamed.residentLevel)
+            streamed.pendingLoad.reset();
+        residentSize += streamedTextureSize(streamed, streamed.residentLevel);
+        requestedSize += streamedTextureSize(streamed, streamed.desiredLevel);
+        streamed.requestedLevel = -1;
+        streamed.used = false;
+    }
+    QSSGRhiContextStats::get(*m_contextInterface->rhiContext()).streamedTextureSizeChanges(residentSize, requestedSize);
+}
+
+bool QSSGBufferManager::setStreamedTextureLevel(const ImageCacheKey &key, StreamedTexture &streamed, int level)
+{
+    auto imageIt = imageMap.find(key);
+    if (imageIt == imageMap.end() || !imageIt->renderImageTexture.m_texture)
+        return false;
+
+    const auto &context = m_contextInterface->rhiContext();
+    QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(context.get());
+    QRhi *rhi = context->rhi();
+    QSSGRenderImageTexture &current = imageIt->renderImageTexture;
+    QRhiTexture *oldTexture = current.m_texture;
+
+    QSSGRenderImageTexture texture;
+    const int droppedLevels = level - streamed.residentLevel;
+    if (droppedLevels > 0 && droppedLevels < current.m_mipmapCount) {
+        // The remaining levels are on the GPU already, no need to go to the file
+        QRhiTexture *tex = rhi->newTexture(oldTexture->format(), sizeForMipLevel(level, streamed.size), 1, oldTexture->flags());
+        tex->setName(oldTexture->name());
+        if (!tex->create()) {
+            delete tex;
+            return false;
+        }
+        texture.m_texture = tex;
+        texture.m_mipmapCount = current.m_mipmapCount - droppedLevels;
+        auto *rub = rhi->nextResourceUpdateBatch();
+        for (int i = 0; i < texture.m_mipmapCount; ++i) {
+            QRhiTextureCopyDescription desc;
+            desc.setSourceLevel(i + droppedLevels);
+            desc.setDestinationLevel(i);
+            rub->copyTexture(tex, oldTexture, desc);
+        }
+        context->commandBuffer()->resourceUpdate(rub);
+        rhiCtxD->registerTexture(tex);
+    } else {
+        // The file is decoded in a worker thread, so that the frames go on
+        // meanwhile. The texture is created once that is done, with the level
+        // wanted by then.
+        if (!streamed.pendingLoad) {
+            auto load = std::make_shared<StreamedTextureLoad>();
+            streamed.pendingLoad = load;
+            QThreadPool::globalInstance()->start([load, path = streamed.path, format = streamed.format, flipY = streamed.flipY] {
+                load->texture.reset(QSSGLoadedTexture::load(path, format, flipY));
+                load->done.storeRelease(1);
+            });
+            return false;
+        }
+        if (!streamed.pendingLoad->done.loadAcquire())
+            return false;
+
+        const std::shared_ptr<StreamedTextureLoad> load = std::exchange(streamed.pendingLoad, nullptr);
+        Q_QUICK3D_PROFILE_START(QQuick3DProfiler::Quick3DTextureLoad);
+        const bool created = load->texture && createRhiTexture(texture, load->texture.data(), MipMode(key.mipMode), {},
+                                                                QFileInfo(streamed.path).fileName(), level);
+        Q_QUICK3D_PROFILE_END_WITH_STRING(QQuick3DProfiler::Quick3DTextureLoad, stats.imageDataSize, streamed.path.toUtf8());
+        if (!created)
+            return false;
+    }
+
+    if (QSSGBufferManagerStat::enabled(QSSGBufferManagerStat::Level::Debug))
+        qDebug() << "~ streamTexture: " << streamed.path << "level" << streamed.residentLevel << "->" << level;
+
+    decreaseMemoryStat(oldTexture);
+    rhiCtxD->releaseTexture(oldTexture);
+    current.m_texture = texture.m_texture;
+    current.m_mipmapCount = texture.m_mipmapCount;
+    increaseMemoryStat(current.m_texture);
+    return true;
+}
+
 QT_END_NAMESPACE
@@ -27,6 +27,8 @@
 
 #include <QtCore/QMutex>
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 struct QSSGRenderMesh;
@@ -102,6 +104,28 @@ public:
         QSSGMeshProcessingOptions options;
     };
 
+    // The file of a streamed texture, decoded in a worker thread
+    struct StreamedTextureLoad;
+
+    struct StreamedTexture {
+        QString path;
+        QSSGRenderTextureFormat format = QSSGRenderTextureFormat::Unknown;
+        QRhiTexture::Format rhiFormat = QRhiTexture::UnknownFormat;
+        QRhiTexture::Flags rhiFlags;
+        QSize size; // of level 0, the full resolution
+        int levelCount = 1; // levels that can be made resident
+        int baseLevel = 0; // the coarsest level, always resident
+        int residentLevel = 0;
+        int requestedLevel = -1; // -1 when nobody asked for a level this frame
+        int desiredLevel = 0;
+        int targetLevel = 0;
+        quint32 lastNeededFrame = 0;
+        bool flipY = true;
+        bool used = false;
+        // Set while the file is decoded to raise the detail
+        std::shared_ptr<StreamedTextureLoad> pendingLoad;
+    };
+
     struct MemoryStats {
         quint64 meshDataSize = 0;
         quint64 imageDataSize = 0;
@@ -139,6 +163,30 @@ public:
 
     QSSGRenderMesh *loadMesh(const QSSGRenderModel *model);
 
+    // Texture streaming: with a non-zero budget, textures loaded from files
+    // are first uploaded with a reduced resolution. Each frame the renderer
+    // requests the detail it needs and the higher resolution levels are
+    // loaded, or dropped again, while keeping the texture memory in budget.
+    void setTextureMemoryBudget(quint64 bytes);
+    quint64 textureMemoryBudget() const { return textureBudget; }
+    // Called when synchronizing each View3D, 0 for none. The largest budget
+    // requested in a window frame applies, QT_QUICK3D_TEXTURE_MEMORY_BUDGET
+    // when there is none.
+    void requestTextureMemoryBudget(quint64 bytes);
+    bool isTextureStreamingEnabled() const { return textureBudget != 0; }
+    void requestTextureDetail(const QSSGRenderImage *image, float texelsAcross);
+    // Called when all View3Ds of the window rendered their frame, and at the
+    // start of each View3D frame: the requests collected over one window frame
+    // are applied once, at the start of the next.
+    void endStreamingFrame();
+    void updateStreamedTextures();
+    // Picks the levels the textures should have, the targetLevel, from the
+    // requests and the budget. Returns the total texture size with them.
+    static quint64 selectStreamedTextureLevels(QList<StreamedTexture *> textures,
+                                               quint64 totalSize,
+                                               quint64 budget,
+                                               quint32 frameId);
+
     // Called at the end of the frame to release unreferenced geometry and textures
     void cleanupUnreferencedBuffers(quint32 frameId, QSSGRenderLayer *layer);
     void resetUsageCounters(quint32 frameId, QSSGRenderLayer *layer);
@@ -155,7 +203,7 @@ public:
     static std::unique_ptr<QSSGMeshBVH> loadMeshBVH(const QSSGRenderPath &inSourcePath);
     static std::unique_ptr<QSSGMeshBVH> loadMeshBVH(QSSGRenderGeometry *geometry);
 
-    static QSSGMesh::Mesh loadMeshData(const QSSGRenderPath &inSourcePath);
+    static QSSGMesh::Mesh loadMeshData(const QSSGRenderPath &inSourcePath, bool allowMapping = false);
     QSSGMesh::Mesh loadMeshData(const QSSGRenderGeometry *geometry);
 
     void registerExtensionResult(const QSSGRenderExtension &extensions, QRhiTexture *texture);
@@ -180,6 +228,7 @@ public:
     const QHash<QSGTexture *, ImageData> &getSGImageMap() const { return qsgImageMap; }
     const QHash<QSSGRenderPath, MeshData> &getMeshMap() const { return meshMap; }
     const QHash<QSSGRenderGeometry *, MeshData> &getCustomMeshMap() const { return customMeshMap; }
+    const QHash<ImageCacheKey, StreamedTexture> &getStreamedTextureMap() const { return streamedTextures; }
 
 private:
     void clear();
@@ -196,7 +245,9 @@ private:
                           const QSSGLoadedTexture *inTexture,
                           MipMode inMipMode,
                           CreateRhiTextureFlags inFlags,
-                          const QString &debugObjectName);
+                          const QString &debugObjectName,
+                          int baseLevel = 0);
+    bool updateRhiTexture(const ImageData &imageData, QSSGRenderTextureData *data, MipMode inMipMode);
 
     QSSGRenderMesh *loadRenderMesh(const QSSGRenderPath &inSourcePath, QSSGMeshProcessingOptions options);
     QSSGRenderMesh *loadRenderMesh(QSSGRenderGeometry *geometry, QSSGMeshProcessingOptions options);
@@ -208,6 +259,8 @@ private:
     void releaseMesh(const QSSGRenderPath &inSourcePath);
     void releaseImage(const ImageCacheKey &key);
 
+    bool setStreamedTextureLevel(const ImageCacheKey &key, StreamedTexture &streamed, int level);
+
     QSSGRenderContextInterface *m_contextInterface = nullptr; // ContextInterfaces owns BufferManager
 
     // These store the actual buffer handles
@@ -217,14 +270,20 @@ private:
     QHash<const QSSGRenderExtension *, ImageData> renderExtensionTexture; // Textures (from QQuick3DRenderExtension)
     QHash<QSSGRenderPath, MeshData> meshMap;                    // Meshes (specififed by path)
     QHash<QSSGRenderGeometry *, MeshData> customMeshMap;        // Meshes (QQuick3DGeometry)
+    QHash<ImageCacheKey, StreamedTexture> streamedTextures;     // Streaming state of imageMap entries
 
     QRhiResourceUpdateBatch *meshBufferUpdates = nullptr;
     QMutex meshBufferMutex;
 
     quint32 frameCleanupIndex = 0;
     quint32 frameResetIndex = 0;
+    quint32 streamingFrame = 0;
+    bool streamingUpdatePending = false;
     QSSGRenderLayer *currentLayer = nullptr;
     MemoryStats stats;
+    quint64 textureBudget = 0;
+    quint64 environmentTextureBudget = 0;
+    quint64 requestedTextureBudget = 0;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(QSSGBufferManager::LoadRenderImageFlags)
@@ -10,6 +10,7 @@
 #include "meshoptimizer.h"
 
 #include <algorithm>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
@@ -40,6 +41,9 @@ static const size_t SUBSET_STRUCT_SIZE_V6 = 52;
 //lod entry: count, offset, distance
 static const size_t LOD_STRUCT_SIZE = 12;
 
+// meshlet entry: count, offset, centerXYZ, radius, coneApexXYZ, coneAxisXYZ, coneCutoff
+static const size_t MESHLET_STRUCT_SIZE = 52;
+
 MeshInternal::MultiMeshInfo MeshInternal::readFileHeader(QIODevice *device)
 {
     const qint64 multiHeaderStartOffset = device->size() - qint64(MULTI_HEADER_STRUCT_SIZE);
@@ -92,7 +96,79 @@ void MeshInternal::writeFileHeader(QIODevice *device, const MeshInternal::MultiM
     outputStream << meshFileInfo.fileId << meshFileInfo.fileVersion << multiEntriesOffset << meshCount;
 }
 
-quint64 MeshInternal::readMeshData(QIODevice *device, quint64 offset, Mesh *mesh, MeshDataHeader *header)
+// With a mapped file the (potentially large) buffer contents are not copied,
+// the returned QByteArray references the mapping instead.
+static QByteArray readBufferData(QIODevice *device, const uchar *mappedData, quint32 size)
+{
+    if (mappedData) {
+        const qint64 pos = device->pos();
+        if (pos + qint64(size) <= device->size()) {
+            device->seek(pos + size);
+            return QByteArray::fromRawData(reinterpret_cast<const char *>(mappedData + pos), size);
+        }
+    }
+    return device->read(size);
+}
+
+// Reads the data of one buffer, decoding it when the mesh was saved with
+// compressed buffers. byteSize receives the number of bytes consumed.
+static bool readMeshBufferData(QIODevice *device, QDataStream &inputStream, const uchar *mappedData,
+                               const MeshInternal::MeshDataHeader &header, quint32 dataSize,
+                               QByteArray *data, quint32 *byteSize)
+{
+    if (!header.hasCompressedBuffers()) {
+        *data = readBufferData(device, mappedData, dataSize);
+        *byteSize = dataSize;
+        return true;
+    }
+
+    quint32 encoding = 0;
+    quint32 elementSize = 0;
+    quint32 encodedSize = 0;
+    inputStream >> encoding >> elementSize >> encodedSize;
+    *byteSize = 3 * sizeof(quint32) + encodedSize;
+
+    const QByteArray encoded = readBufferData(device, mappedData, encodedSize);
+    if (quint32(encoded.size()) != encodedSize)
+        return false;
+
+    if (MeshInternal::BufferEncoding(encoding) == MeshInternal::BufferEncoding::Raw) {
+        *data = encoded;
+        return encodedSize == dataSize;
+    }
+
+    if (elementSize == 0 || dataSize % elementSize != 0)
+        return false;
+
+    const size_t count = dataSize / elementSize;
+    const unsigned char *src = reinterpret_cast<const unsigned char *>(encoded.constData());
+    QByteArray decoded(dataSize, Qt::Uninitialized);
+    int result = -1;
+    switch (MeshInternal::BufferEncoding(encoding)) {
+    case MeshInternal::BufferEncoding::MeshOptVertex:
+        if (elementSize <= 256 && elementSize % 4 == 0)
+            result = meshopt_decodeVertexBuffer(decoded.data(), count, elementSize, src, encodedSize);
+        break;
+    case MeshInternal::BufferEncoding::MeshOptIndexTriangles:
+        if ((elementSize == 2 || elementSize == 4) && count % 3 == 0)
+            result = meshopt_decodeIndexBuffer(decoded.data(), count, elementSize, src, encodedSize);
+        break;
+    case MeshInternal::BufferEncoding::MeshOptIndexSequence:
+        if (elementSize == 2 || elementSize == 4)
+            result = meshopt_decodeIndexSequence(decoded.data(), count, elementSize, src, encodedSize);
+        break;
+    default:
+        break;
+    }
+    if (result != 0)
+        return false;
+
+    *data = decoded;
+    return true;
+}
+
+quint64 MeshInternal::readMeshData(QIODevice *device, quint64 offset, Mesh *mesh, MeshDataHeader *header,
+                                   const uchar *mappedData)
 {
     static char alignPadding[4] = {};
 
@@ -236,13 +312,22 @@ quint64 MeshInternal::readMeshData(QIODevice *device, quint64 offset, Mesh *mesh
         }
     }
 
-    mesh->m_vertexBuffer.data = device->read(vertexBufferDataSize);
-    alignAmount = offsetTracker.alignedAdvance(vertexBufferDataSize);
+    quint32 bufferByteSize = 0;
+    if (!readMeshBufferData(device, inputStream, mappedData, *header, vertexBufferDataSize,
+                            &mesh->m_vertexBuffer.data, &bufferByteSize)) {
+        qWarning() << "Failed to read vertex buffer data";
+        return 0;
+    }
+    alignAmount = offsetTracker.alignedAdvance(bufferByteSize);
     if (alignAmount)
         device->read(alignPadding, alignAmount);
 
-    mesh->m_indexBuffer.data = device->read(indexBufferDataSize);
-    alignAmount = offsetTracker.alignedAdvance(indexBufferDataSize);
+    if (!readMeshBufferData(device, inputStream, mappedData, *header, indexBufferDataSize,
+                            &mesh->m_indexBuffer.data, &bufferByteSize)) {
+        qWarning() << "Failed to read index buffer data";
+        return 0;
+    }
+    alignAmount = offsetTracker.alignedAdvance(bufferByteSize);
     if (alignAmount)
         device->read(alignPadding, alignAmount);
 
@@ -321,6 +406,51 @@ quint64 MeshInternal::readMeshData(QIODevice *device, quint64 offset, Mesh *mesh
     if (alignAmount)
         device->read(alignPadding, alignAmount);
 
+    if (header->hasMeshlets()) {
+        quint32 meshletByteSize = 0;
+        for (Mesh::Subset &subset : mesh->m_subsets) {
+            quint32 meshletCount = 0;
+            inputStream >> meshletCount;
+            meshletByteSize += sizeof(quint32);
+            // every meshlet has at least one triangle
+            if (inputStream.status() != QDataStream::Ok || meshletCount > subset.count / 3) {
+                qWarning() << "Invalid meshlet data";
+                mesh->m_subsets.clear();
+                return 0;
+            }
+            subset.meshlets.resize(meshletCount);
+            for (Mesh::Meshlet &meshlet : subset.meshlets) {
+                float centerX, centerY, centerZ;
+                float apexX, apexY, apexZ;
+                float axisX, axisY, axisZ;
+                inputStream >> meshlet.count >> meshlet.offset
+                            >> centerX >> centerY >> centerZ >> meshlet.radius
+                            >> apexX >> apexY >> apexZ
+                            >> axisX >> axisY >> axisZ >> meshlet.coneCutoff;
+                meshlet.center = QVector3D(centerX, centerY, centerZ);
+                meshlet.coneApex = QVector3D(apexX, apexY, apexZ);
+                meshlet.coneAxis = QVector3D(axisX, axisY, axisZ);
+            }
+            // the meshlets are sorted, non-overlapping ranges of the subset
+            bool valid = true;
+            quint64 previousEnd = subset.offset;
+            for (const Mesh::Meshlet &meshlet : std::as_const(subset.meshlets)) {
+                const quint64 end = quint64(meshlet.offset) + meshlet.count;
+                valid = valid && meshlet.offset >= previousEnd && end <= quint64(subset.offset) + subset.count;
+                previousEnd = end;
+            }
+            if (inputStream.status() != QDataStream::Ok || !valid) {
+                qWarning() << "Invalid meshlet data";
+                mesh->m_subsets.clear();
+                return 0;
+            }
+            meshletByteSize += meshletCount * MESHLET_STRUCT_SIZE;
+        }
+        alignAmount = offsetTracker.alignedAdvance(meshletByteSize);
+        if (alignAmount)
+            device->read(alignPadding, alignAmount);
+    }
+
 
     // Data for morphTargets
     if (targetBufferEntriesCount > 0) {
@@ -353,7 +483,12 @@ quint64 MeshInternal::readMeshData(QIODevice *device, quint64 offset, Mesh *mesh
                     device->read(alignPadding, alignAmount);
             }
 
-            mesh->m_targetBuffer.data = device->read(targetBufferDataSize);
+            if (!readMeshBufferData(device, inputStream, mappedData, *header, targetBufferDataSize,
+                                    &mesh->m_targetBuffer.data, &bufferByteSize)) {
+                qWarning() << "Failed to read morph target buffer data";
+                mesh->m_subsets.clear();
+                return 0;
+            }
         } else {
             // remove target entries from vertexbuffer entries
             mesh->m_vertexBuffer.entries.remove(vertexBufferEntriesCount - targetBufferEntriesCount,
@@ -395,6 +530,113 @@ void MeshInternal::writeMeshHeader(QIODevice *device, const MeshDataHeader &head
     outputStream << header.fileId << header.fileVersion << header.flags << header.sizeInBytes;
 }
 
+template<typename T>
+static QByteArray encodeIndexData(const QByteArray &data, bool triangles)
+{
+    const T *indices = reinterpret_cast<const T *>(data.constData());
+    const size_t indexCount = data.size() / sizeof(T);
+    const size_t vertexCount = size_t(*std::max_element(indices, indices + indexCount)) + 1;
+    QByteArray encoded;
+    if (triangles) {
+        encoded.resize(meshopt_encodeIndexBufferBound(indexCount, vertexCount));
+        encoded.resize(meshopt_encodeIndexBuffer(reinterpret_cast<unsigned char *>(encoded.data()),
+                                                 encoded.size(), indices, indexCount));
+    } else {
+        encoded.resize(meshopt_encodeIndexSequenceBound(indexCount, vertexCount));
+        encoded.resize(meshopt_encodeIndexSequence(reinterpret_cast<unsigned char *>(encoded.data()),
+                                                   encoded.size(), indices, indexCount));
+    }
+    return encoded;
+}
+
+// Writes the data of one buffer, and with compression, the header for it as
+// well. Data the codecs cannot handle, or where encoding does not pay off,
+// is stored as-is. Returns the number of bytes written.
+static quint32 writeMeshBufferData(QIODevice *device, const QByteArray &data, bool compress,
+                                   MeshInternal::BufferEncoding encoding, quint32 elementSize)
+{
+    if (!compress) {
+        device->write(data.constData(), data.size());
+        return data.size();
+    }
+
+    QByteArray encoded;
+    if (!data.isEmpty() && elementSize && data.size() % elementSize == 0) {
+        switch (encoding) {
+        case MeshInternal::BufferEncoding::MeshOptVertex:
+            if (elementSize <= 256 && elementSize % 4 == 0) {
+                const size_t vertexCount = data.size() / elementSize;
+                encoded.resize(meshopt_encodeVertexBufferBound(vertexCount, elementSize));
+                encoded.resize(meshopt_encodeVertexBuffer(reinterpret_cast<unsigned char *>(encoded.data()),
+                                                          encoded.size(), data.constData(),
+                                                          vertexCount, elementSize));
+            }
+            break;
+        case MeshInternal::BufferEncoding::MeshOptIndexTriangles:
+        case MeshInternal::BufferEncoding::MeshOptIndexSequence:
+        {
+            const bool triangles = encoding == MeshInternal::BufferEncoding::MeshOptIndexTriangles;
+            if (triangles && (data.size() / elementSize) % 3 != 0)
+                break;
+            if (elementSize == 2)
+                encoded = encodeIndexData<quint16>(data, triangles);
+            else if (elementSize == 4)
+                encoded = encodeIndexData<quint32>(data, triangles);
+        }
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (encoded.isEmpty() || encoded.size() >= data.size()) {
+        encoding = MeshInternal::BufferEncoding::Raw;
+        encoded = data;
+    }
+
+    QDataStream outputStream(device);
+    outputStream.setByteOrder(QDataStream::LittleEndian);
+    outputStream << quint32(encoding) << elementSize << quint32(encoded.size());
+    device->write(encoded.constData(), encoded.size());
+    return 3 * sizeof(quint32) + encoded.size();
+}
+
+// Rounds direction vectors and texture coordinates to fewer mantissa bits.
+// The zeroed low bits make the data considerably more compressible.
+static QByteArray quantizeVertexData(const Mesh::VertexBuffer &vertexBuffer)
+{
+    QByteArray data = vertexBuffer.data;
+    if (vertexBuffer.stride == 0)
+        return data;
+
+    const quint32 vertexCount = data.size() / vertexBuffer.stride;
+    char *vertexData = data.data();
+    for (const Mesh::VertexBufferEntry &entry : vertexBuffer.entries) {
+        if (entry.componentType != Mesh::ComponentType::Float32)
+            continue;
+        int mantissaBits = 0;
+        if (entry.name == MeshInternal::getNormalAttrName()
+                || entry.name == MeshInternal::getTexTanAttrName()
+                || entry.name == MeshInternal::getTexBinormalAttrName())
+            mantissaBits = 10;
+        else if (entry.name == MeshInternal::getUV0AttrName()
+                 || entry.name == MeshInternal::getUV1AttrName())
+            mantissaBits = 12;
+        if (mantissaBits == 0)
+            continue;
+        for (quint32 v = 0; v < vertexCount; ++v) {
+            char *p = vertexData + v * vertexBuffer.stride + entry.offset;
+            for (quint32 c = 0; c < entry.componentCount; ++c) {
+                float f;
+                memcpy(&f, p + c * sizeof(float), sizeof(float));
+                f = meshopt_quantizeFloat(f, mantissaBits);
+                memcpy(p + c * sizeof(float), &f, sizeof(float));
+            }
+        }
+    }
+    return data;
+}
+
 // The legacy, now-removed, insane mesh code used to use a "serialization"
 // strategy with dumping memory, yet combined with with an in-memory layout
 // that is different from what's in the file. In version 4 we no longer write
@@ -404,7 +646,7 @@ void MeshInternal::writeMeshHeader(QIODevice *device, const MeshDataHeader &head
 // that's also legacy nonsense, but having that allows the reader not have to
 // branch based on the version.
 
-quint64 MeshInternal::writeMeshData(QIODevice *device, const Mesh &mesh)
+quint64 MeshInternal::writeMeshData(QIODevice *device, const Mesh &mesh, Mesh::SaveFlags flags)
 {
     static const char alignPadding[4] = {};
 
@@ -474,13 +716,22 @@ quint64 MeshInternal::writeMeshData(QIODevice *device, const Mesh &mesh)
             device->write(alignPadding, alignAmount);
     }
 
-    device->write(mesh.m_vertexBuffer.data.constData(), vertexBufferDataSize);
-    alignAmount = offsetTracker.alignedAdvance(vertexBufferDataSize);
+    const bool compress = flags.testFlag(Mesh::SaveFlag::Compress);
+    const QByteArray vertexBufferData = compress && flags.testFlag(Mesh::SaveFlag::QuantizeAttributes)
+            ? quantizeVertexData(mesh.m_vertexBuffer)
+            : mesh.m_vertexBuffer.data;
+    quint32 bufferByteSize = writeMeshBufferData(device, vertexBufferData, compress,
+                                                 BufferEncoding::MeshOptVertex, vertexBufferStride);
+    alignAmount = offsetTracker.alignedAdvance(bufferByteSize);
     if (alignAmount)
         device->write(alignPadding, alignAmount);
 
-    device->write(mesh.m_indexBuffer.data.constData(), indexBufferDataSize);
-    alignAmount = offsetTracker.alignedAdvance(indexBufferDataSize);
+    const BufferEncoding indexEncoding = mesh.m_drawMode == Mesh::DrawMode::Triangles
+            ? BufferEncoding::MeshOptIndexTriangles
+            : BufferEncoding::MeshOptIndexSequence;
+    bufferByteSize = writeMeshBufferData(device, mesh.m_indexBuffer.data, compress, indexEncoding,
+                                         byteSizeForComponentType(mesh.m_indexBuffer.componentType));
+    alignAmount = offsetTracker.alignedAdvance(bufferByteSize);
     if (alignAmount)
         device->write(alignPadding, alignAmount);
 
@@ -544,6 +795,27 @@ quint64 MeshInternal::writeMeshData(QIODevice *device, const Mesh &mesh)
     if (alignAmount)
         device->write(alignPadding, alignAmount);
 
+    // Meshlet data, see Mesh::save() for the header flag
+    if (mesh.hasMeshlets()) {
+        quint32 meshletByteSize = 0;
+        for (quint32 i = 0; i < subsetsCount; ++i) {
+            const Mesh::Subset &subset(mesh.m_subsets[i]);
+            const quint32 meshletCount = subset.meshlets.size();
+            outputStream << meshletCount;
+            for (const Mesh::Meshlet &meshlet : subset.meshlets) {
+                outputStream << meshlet.count << meshlet.offset
+                             << meshlet.center.x() << meshlet.center.y() << meshlet.center.z() << meshlet.radius
+                             << meshlet.coneApex.x() << meshlet.coneApex.y() << meshlet.coneApex.z()
+                             << meshlet.coneAxis.x() << meshlet.coneAxis.y() << meshlet.coneAxis.z()
+                             << meshlet.coneCutoff;
+            }
+            meshletByteSize += sizeof(quint32) + meshletCount * MESHLET_STRUCT_SIZE;
+        }
+        alignAmount = offsetTracker.alignedAdvance(meshletByteSize);
+        if (alignAmount)
+            device->write(alignPadding, alignAmount);
+    }
+
     // Data for morphTargets
     for (quint32 i = 0; i < targetBufferEntriesCount; ++i) {
         const Mesh::VertexBufferEntry &entry(mesh.m_targetBuffer.entries[i]);
@@ -570,7 +842,10 @@ quint64 MeshInternal::writeMeshData(QIODevice *device, const Mesh &mesh)
             device->write(alignPadding, alignAmount);
     }
 
-    device->write(mesh.m_targetBuffer.data.constData(), targetBufferDataSize);
+    // morph target data is laid out as float4 texels
+    if (targetBufferEntriesCount > 0)
+        writeMeshBufferData(device, mesh.m_targetBuffer.data, compress,
+                            BufferEncoding::MeshOptVertex, 4 * sizeof(float));
 
     const quint32 endPos = device->pos();
     const quint32 sizeInBytes = endPos - startPos;
@@ -597,6 +872,31 @@ Mesh Mesh::loadMesh(QIODevice *device, quint32 id)
     return Mesh();
 }
 
+Mesh Mesh::loadMeshMapped(const QSharedPointer<QFile> &file, quint32 id)
+{
+    if (!file)
+        return Mesh();
+
+    const uchar *mappedData = file->map(0, file->size());
+    if (!mappedData)
+        return loadMesh(file.data(), id);
+
+    MeshInternal::MeshDataHeader header;
+    const MeshInternal::MultiMeshInfo meshFileInfo = MeshInternal::readFileHeader(file.data());
+    auto it = meshFileInfo.meshEntries.constFind(id);
+    if (it == meshFileInfo.meshEntries.constEnd() && id == 0 && !meshFileInfo.meshEntries.isEmpty())
+        it = meshFileInfo.meshEntries.cbegin();
+    if (it != meshFileInfo.meshEntries.constEnd()) {
+        Mesh mesh;
+        quint64 size = MeshInternal::readMeshData(file.data(), *it, &mesh, &header, mappedData);
+        if (size) {
+            mesh.m_mappedFile = file;
+            return mesh;
+        }
+    }
+    return Mesh();
+}
+
 QMap<quint32, Mesh> Mesh::loadAll(QIODevice *device)
 {
     MeshInternal::MeshDataHeader header;
@@ -910,7 +1210,7 @@ Mesh Mesh::fromRuntimeData(const RuntimeMeshData &data, QString *error)
     return mesh;
 }
 
-quint32 Mesh::save(QIODevice *device, quint32 id) const
+quint32 Mesh::save(QIODevice *device, quint32 id, SaveFlags flags) const
 {
     qint64 newMeshStartPosFromEnd = 0;
     quint32 newId = 1;
@@ -941,9 +1241,13 @@ quint32 Mesh::save(QIODevice *device, quint32 id) const
     header.meshEntries.insert(newId, meshOffset);
 
     MeshInternal::MeshDataHeader meshHeader = MeshInternal::MeshDataHeader::withDefaults();
+    if (flags.testFlag(SaveFlag::Compress))
+        meshHeader.flags |= MeshInternal::MeshDataHeader::CompressedBuffers;
+    if (hasMeshlets())
+        meshHeader.flags |= MeshInternal::MeshDataHeader::Meshlets;
     // skip the space for the mesh header for now
     device->seek(device->pos() + MESH_HEADER_STRUCT_SIZE);
-    meshHeader.sizeInBytes = MeshInternal::writeMeshData(device, *this);
+    meshHeader.sizeInBytes = MeshInternal::writeMeshData(device, *this, flags);
     // now the mesh header is ready to be written out
     device->seek(meshOffset);
     MeshInternal::writeMeshHeader(device, meshHeader);
@@ -1019,6 +1323,114 @@ bool Mesh::hasLightmapUVChannel() const
     return false;
 }
 
+bool Mesh::hasMeshlets() const
+{
+    for (const Subset &subset : m_subsets) {
+        if (!subset.meshlets.isEmpty())
+            return true;
+    }
+    return false;
+}
+
+bool Mesh::createMeshlets(quint32 minimumTriangleCount)
+{
+    // The limits meshoptimizer suggests for meshlets culled on the CPU or in
+    // a compute shader. The cone weight trades a bit of spatial compactness
+    // for tighter normal cones.
+    static constexpr size_t maxVertices = 64;
+    static constexpr size_t maxTriangles = 124;
+    static constexpr float coneWeight = 0.25f;
+
+    if (m_drawMode != DrawMode::Triangles)
+        return false;
+
+    const quint32 indexSize = MeshInternal::byteSizeForComponentType(m_indexBuffer.componentType);
+    if (indexSize != 2 && indexSize != 4)
+        return false;
+
+    const quint32 stride = m_vertexBuffer.stride;
+    if (stride < 3 * sizeof(float) || stride > 256 || stride % sizeof(float) != 0)
+        return false;
+
+    const char *posAttrName = MeshInternal::getPositionAttrName();
+    const VertexBufferEntry *positionEntry = nullptr;
+    for (const VertexBufferEntry &entry : std::as_const(m_vertexBuffer.entries)) {
+        if (entry.name == posAttrName) {
+            positionEntry = &entry;
+            break;
+        }
+    }
+    if (!positionEntry || positionEntry->componentType != ComponentType::Float32
+            || positionEntry->componentCount != 3 || positionEntry->offset + 3 * sizeof(float) > stride) {
+        return false;
+    }
+
+    const size_t vertexCount = m_vertexBuffer.data.size() / stride;
+    const float *positions = reinterpret_cast<const float *>(m_vertexBuffer.data.constData() + positionEntry->offset);
+    const quint32 indexCount = m_indexBuffer.data.size() / indexSize;
+
+    bool created = false;
+    for (Subset &subset : m_subsets) {
+        subset.meshlets.clear();
+        if (subset.count % 3 != 0 || subset.count / 3 < minimumTriangleCount
+                || quint64(subset.offset) + subset.count > indexCount) {
+            continue;
+        }
+
+        QVector<quint32> indices(subset.count);
+        const char *indexData = m_indexBuffer.data.constData();
+        for (quint32 i = 0; i < subset.count; ++i) {
+            indices[i] = indexSize == 2 ? reinterpret_cast<const quint16 *>(indexData)[subset.offset + i]
+                                        : reinterpret_cast<const quint32 *>(indexData)[subset.offset + i];
+        }
+
+        const size_t maxMeshlets = meshopt_buildMeshletsBound(indices.size(), maxVertices, maxTriangles);
+        std::vector<meshopt_Meshlet> meshlets(maxMeshlets);
+        std::vector<unsigned int> meshletVertices(maxMeshlets * maxVertices);
+        std::vector<unsigned char> meshletTriangles(maxMeshlets * maxTriangles * 3);
+        const size_t meshletCount = meshopt_buildMeshlets(meshlets.data(), meshletVertices.data(), meshletTriangles.data(),
+                                                          indices.constData(), indices.size(),
+                                                          positions, vertexCount, stride,
+                                                          maxVertices, maxTriangles, coneWeight);
+
+        // Write the triangles back meshlet by meshlet, so that each meshlet
+        // is a range of indices that can be drawn on its own.
+        char *outIndexData = m_indexBuffer.data.data();
+        quint32 written = 0;
+        subset.meshlets.reserve(meshletCount);
+        for (size_t i = 0; i < meshletCount; ++i) {
+            const meshopt_Meshlet &source = meshlets[i];
+            const unsigned int *vertices = meshletVertices.data() + source.vertex_offset;
+            const unsigned char *triangles = meshletTriangles.data() + source.triangle_offset;
+
+            Meshlet meshlet;
+            meshlet.offset = subset.offset + written;
+            meshlet.count = source.triangle_count * 3;
+            for (quint32 j = 0; j < meshlet.count; ++j) {
+                const quint32 index = vertices[triangles[j]];
+                if (indexSize == 2)
+                    reinterpret_cast<quint16 *>(outIndexData)[meshlet.offset + j] = quint16(index);
+                else
+                    reinterpret_cast<quint32 *>(outIndexData)[meshlet.offset + j] = index;
+            }
+            written += meshlet.count;
+
+            const meshopt_Bounds bounds = meshopt_computeMeshletBounds(vertices, triangles, source.triangle_count,
+                                                                       positions, vertexCount, stride);
+            meshlet.center = QVector3D(bounds.center[0], bounds.center[1], bounds.center[2]);
+            meshlet.radius = bounds.radius;
+            meshlet.coneApex = QVector3D(bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2]);
+            meshlet.coneAxis = QVector3D(bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]);
+            meshlet.coneCutoff = bounds.cone_cutoff;
+            subset.meshlets.append(meshlet);
+        }
+        Q_ASSERT(written == subset.count);
+        created = true;
+    }
+
+    return created;
+}
+
 bool Mesh::createLightmapUVChannel(uint lightmapBaseResolution)
 {
     const char *posAttrName = MeshInternal::getPositionAttrName();
@@ -24,6 +24,8 @@
 #include <QtCore/qstring.h>
 #include <QtCore/qbytearray.h>
 #include <QtCore/qiodevice.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qsharedpointer.h>
 #include <QtCore/qmap.h>
 
 QT_BEGIN_NAMESPACE
@@ -127,6 +129,22 @@ public:
         float distance = 0.0f;
     };
 
+    // A cluster of up to 124 triangles, using up to 64 vertices, of a
+    // subset, stored as a contiguous range of the subset's indices, with the
+    // bounds needed to cull it on its own: a bounding sphere, and a cone
+    // containing the normals of its triangles, see createMeshlets().
+    struct Meshlet {
+        quint32 count = 0;
+        quint32 offset = 0;
+        QVector3D center;
+        float radius = 0.0f;
+        QVector3D coneApex;
+        QVector3D coneAxis;
+        // all triangles face away from a viewer at position p when
+        // dot(normalize(coneApex - p), coneAxis) >= coneCutoff
+        float coneCutoff = 1.0f;
+    };
+
     struct Subset {
         QString name;
         SubsetBounds bounds;
@@ -134,6 +152,7 @@ public:
         quint32 offset = 0;
         QSize lightmapSizeHint;
         QVector<Lod> lods;
+        QVector<Meshlet> meshlets;
     };
 
     // can just return by value (big data is all implicitly shared)
@@ -147,6 +166,12 @@ public:
 
     static QMap<quint32, Mesh> loadAll(QIODevice *device);
 
+    // Like loadMesh(), but maps the file instead of reading it: the vertex,
+    // index and target data are then views into the mapping, which stays
+    // alive as long as the returned Mesh (or a copy of it) exists. Falls
+    // back to reading when the file cannot be mapped.
+    static Mesh loadMeshMapped(const QSharedPointer<QFile> &file, quint32 id = 0);
+
     static Mesh fromAssetData(const QVector<AssetVertexEntry> &vbufEntries,
                               const QByteArray &indexBufferData,
                               ComponentType indexComponentType,
@@ -158,15 +183,36 @@ public:
 
     bool isValid() const { return !m_subsets.isEmpty(); }
 
+    // non-null when the buffer data references a file mapping, keep a
+    // reference to it for as long as the data is used without the Mesh
+    QSharedPointer<QFile> mappedFile() const { return m_mappedFile; }
+
     DrawMode drawMode() const { return m_drawMode; }
     Winding winding() const { return m_winding; }
 
+    enum class SaveFlag : quint32 {
+        None = 0x0,
+        // encode the vertex, index and morph target data with the meshoptimizer codecs
+        Compress = 0x1,
+        // round normals, tangents, binormals and UV coordinates to a reduced
+        // precision before compressing; lossy, has no effect without Compress
+        QuantizeAttributes = 0x2
+    };
+    Q_DECLARE_FLAGS(SaveFlags, SaveFlag)
+
     // id 0 == generate new id; otherwise uses it as-is, and must be an unused one
-    quint32 save(QIODevice *device, quint32 id = 0) const;
+    quint32 save(QIODevice *device, quint32 id = 0, SaveFlags flags = SaveFlag::None) const;
 
     bool hasLightmapUVChannel() const;
     bool createLightmapUVChannel(uint lightmapBaseResolution);
 
+    // Reorders the indices of the triangle subsets with at least
+    // minimumTriangleCount triangles into meshlets of spatially close
+    // triangles, and calculates their bounds. The subsets draw the same
+    // triangles as before. Returns true if any subset got meshlets.
+    bool createMeshlets(quint32 minimumTriangleCount = 4096);
+    bool hasMeshlets() const;
+
 private:
     DrawMode m_drawMode = DrawMode::Triangles;
     Winding m_winding = Winding::CounterClockwise;
@@ -174,6 +220,7 @@ private:
     IndexBuffer m_indexBuffer;
     TargetBuffer m_targetBuffer;
     QVector<Subset> m_subsets;
+    QSharedPointer<QFile> m_mappedFile;
     friend struct MeshInternal;
 };
 
@@ -310,7 +357,16 @@ struct Q_QUICK3DUTILS_EXPORT MeshInternal
         // Version 6 differs from 5 with additional lodCount per subset as well
         // as a list of Level of Detail data after the subset names.
         // Version 7 will split the morph target data
-        static const quint32 FILE_VERSION = 7;
+        // Version 8 allows compressing the vertex, index and morph target
+        // data, indicated by the CompressedBuffers flag.
+        // Version 9 allows a list of meshlets per subset after the Level of
+        // Detail data, indicated by the Meshlets flag.
+        static const quint32 FILE_VERSION = 9;
+
+        enum Flag : quint16 {
+            CompressedBuffers = 0x1,
+            Meshlets = 0x2
+        };
 
         static MeshDataHeader withDefaults() {
             return { FILE_ID, FILE_VERSION, 0, 0 };
@@ -333,6 +389,23 @@ struct Q_QUICK3DUTILS_EXPORT MeshInternal
         bool hasSeparateTargetBuffer() const {
             return fileVersion >= 7;
         }
+
+        bool hasCompressedBuffers() const {
+            return fileVersion >= 8 && (flags & CompressedBuffers);
+        }
+
+        bool hasMeshlets() const {
+            return fileVersion >= 9 && (flags & Meshlets);
+        }
+    };
+
+    // With CompressedBuffers each buffer's data is preceded by the encoding,
+    // the element (vertex or index) size and the encoded size in bytes.
+    enum class BufferEncoding : quint32 {
+        Raw,
+        MeshOptVertex,
+        MeshOptIndexTriangles,
+        MeshOptIndexSequence
     };
 
     struct MeshOffsetTracker {
@@ -383,9 +456,10 @@ struct Q_QUICK3DUTILS_EXPORT MeshInternal
 
     static MultiMeshInfo readFileHeader(QIODevice *device);
     static void writeFileHeader(QIODevice *device, const MultiMeshInfo &meshFileInfo);
-    static quint64 readMeshData(QIODevice *device, quint64 offset, Mesh *mesh, MeshDataHeader *header);
+    static quint64 readMeshData(QIODevice *device, quint64 offset, Mesh *mesh, MeshDataHeader *header,
+                                const uchar *mappedData = nullptr);
     static void writeMeshHeader(QIODevice *device, const MeshDataHeader &header);
-    static quint64 writeMeshData(QIODevice *device, const Mesh &mesh);
+    static quint64 writeMeshData(QIODevice *device, const Mesh &mesh, Mesh::SaveFlags flags = Mesh::SaveFlag::None);
 
     static quint32 byteSizeForComponentType(Mesh::ComponentType componentType) { return quint32(QSSGBaseTypeHelpers::getSizeOfType(componentType)); }
 
@@ -431,6 +505,8 @@ void Q_QUICK3DUTILS_EXPORT optimizeVertexCache(unsigned int* destination,
 
 } // namespace QSSGMesh
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(QSSGMesh::Mesh::SaveFlags)
+
 QT_END_NAMESPACE
 
 #endif // QSSGMESHUTILITIES_P_H
@@ -0,0 +1,256 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest>
+#include <QtCore/qdir.h>
+#include <QtCore/qdiriterator.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qlibraryinfo.h>
+#include <QtCore/qprocess.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qtemporarydir.h>
+
+class tst_balsam : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void incremental();
+    void reconvertOnOptionChange();
+    void parallelJobs();
+
+private:
+    // Writes a glTF file with a single triangle, with the vertices in an
+    // external buffer of the same base name
+    static bool writeTriangle(const QDir &dir, const QString &baseName, float topX = 0.0f);
+    bool runBalsam(const QStringList &arguments);
+    static QJsonObject manifestEntry(const QString &manifestFile, const QString &sourceFile);
+    static QStringList manifestList(const QJsonObject &entry, const QString &key);
+    static bool appendMarker(const QString &fileName);
+    static bool hasMarker(const QString &fileName);
+    static QMap<QString, QByteArray> readAllFiles(const QDir &dir);
+
+    QString m_balsam;
+};
+
+void tst_balsam::initTestCase()
+{
+    m_balsam = QStandardPaths::findExecutable(QStringLiteral("balsam"),
+                                              { QLibraryInfo::path(QLibraryInfo::BinariesPath) });
+    if (m_balsam.isEmpty())
+        QSKIP("balsam is not available");
+}
+
+bool tst_balsam::writeTriangle(const QDir &dir, const QString &baseName, float topX)
+{
+    const float positions[9] = { 0.0f, 0.0f, 0.0f,
+                                 1.0f, 0.0f, 0.0f,
+                                 topX, 1.0f, 0.0f };
+    QByteArray buffer(sizeof(positions), Qt::Uninitialized);
+    qToLittleEndian<float>(positions, 9, buffer.data());
+
+    QFile bin(dir.filePath(baseName + QStringLiteral(".bin")));
+    if (!bin.open(QIODevice::WriteOnly) || bin.write(buffer) != buffer.size())
+        return false;
+
+    // The same node and mesh names in every file, so that the ids generated
+    // for them clash
+    const QJsonObject gltf {
+        { "asset", QJsonObject { { "version", "2.0" } } },
+        { "scene", 0 },
+        { "scenes", QJsonArray { QJsonObject { { "nodes", QJsonArray { 0 } } } } },
+        { "nodes", QJsonArray { QJsonObject { { "name", "Triangle" }, { "mesh", 0 } } } },
+        { "meshes", QJsonArray { QJsonObject {
+            { "name", "Triangle" },
+            { "primitives", QJsonArray { QJsonObject { { "attributes", QJsonObject { { "POSITION", 0 } } } } } } } } },
+        { "buffers", QJsonArray { QJsonObject { { "uri", baseName + QStringLiteral(".bin") },
+                                                { "byteLength", int(buffer.size()) } } } },
+        { "bufferViews", QJsonArray { QJsonObject { { "buffer", 0 }, { "byteOffset", 0 },
+                                                    { "byteLength", int(buffer.size()) } } } },
+        { "accessors", QJsonArray { QJsonObject {
+            { "bufferView", 0 }, { "componentType", 5126 }, { "count", 3 }, { "type", "VEC3" },
+            { "min", QJsonArray { 0, 0, 0 } }, { "max", QJsonArray { 1, 1, 0 } } } } }
+    };
+    QFile file(dir.filePath(baseName + QStringLiteral(".gltf")));
+    return file.open(QIODevice::WriteOnly) && file.write(QJsonDocument(gltf).toJson()) > 0;
+}
+
+bool tst_balsam::runBalsam(const QStringList &arguments)
+{
+    QProcess process;
+    process.setProcessChannelMode(QProcess::ForwardedChannels);
+    process.start(m_balsam, arguments);
+    if (!process.waitForFinished(120000))
+        return false;
+    return process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+}
+
+QJsonObject tst_balsam::manifestEntry(const QString &manifestFile, const QString &sourceFile)
+{
+    QFile file(manifestFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    const QJsonObject files = QJsonDocument::fromJson(file.readAll()).object().value(QStringLiteral("files")).toObject();
+    return files.value(QFileInfo(sourceFile).absoluteFilePath()).toObject();
+}
+
+QStringList tst_balsam::manifestList(const QJsonObject &entry, const QString &key)
+{
+    QStringList result;
+    const QJsonArray values = entry.value(key).toArray();
+    for (const QJsonValue &value : values)
+        result.append(value.toString());
+    return result;
+}
+
+// A file that is skipped is not written again, so the marker stays
+bool tst_balsam::appendMarker(const QString &fileName)
+{
+    QFile file(fileName);
+    return file.open(QIODevice::Append) && file.write("// marker\n") > 0;
+}
+
+bool tst_balsam::hasMarker(const QString &fileName)
+{
+    QFile file(fileName);
+    return file.open(QIODevice::ReadOnly) && file.readAll().endsWith("// marker\n");
+}
+
+QMap<QString, QByteArray> tst_balsam::readAllFiles(const QDir &dir)
+{
+    QMap<QString, QByteArray> files;
+    QDirIterator it(dir.path(), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString fileName = it.next();
+        QFile file(fileName);
+        if (file.open(QIODevice::ReadOnly))
+            files.insert(dir.relativeFilePath(fileName), file.readAll());
+    }
+    return files;
+}
+
+void tst_balsam::incremental()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QDir dir(tempDir.path());
+    QVERIFY(dir.mkdir(QStringLiteral("out")));
+    const QDir outDir(dir.filePath(QStringLiteral("out")));
+    const QString manifest = dir.filePath(QStringLiteral("manifest.json"));
+    const QString first = dir.filePath(QStringLiteral("first.gltf"));
+    const QString second = dir.filePath(QStringLiteral("second.gltf"));
+    QVERIFY(writeTriangle(dir, QStringLiteral("first")));
+    QVERIFY(writeTriangle(dir, QStringLiteral("second")));
+
+    const QStringList arguments { QStringLiteral("--manifest"), manifest,
+                                  QStringLiteral("-o"), outDir.path(), first, second };
+    QVERIFY(runBalsam(arguments));
+
+    const QJsonObject firstEntry = manifestEntry(manifest, first);
+    const QJsonObject secondEntry = manifestEntry(manifest, second);
+    const QStringList firstOutputs = manifestList(firstEntry, QStringLiteral("outputs"));
+    const QStringList secondOutputs = manifestList(secondEntry, QStringLiteral("outputs"));
+    const QStringList firstIds = manifestList(firstEntry, QStringLiteral("ids"));
+    // The QML file and at least the mesh
+    QVERIFY(firstOutputs.size() >= 2);
+    QVERIFY(secondOutputs.size() >= 2);
+    QVERIFY(!firstIds.isEmpty());
+    const QString firstQml = outDir.filePath(firstOutputs.first());
+    const QString secondQml = outDir.filePath(secondOutputs.first());
+    for (const QString &output : firstOutputs + secondOutputs)
+        QVERIFY2(outDir.exists(output), qPrintable(output));
+
+    // Nothing changed, nothing is written
+    QVERIFY(appendMarker(firstQml));
+    QVERIFY(appendMarker(secondQml));
+    QVERIFY(runBalsam(arguments));
+    QVERIFY(hasMarker(firstQml));
+    QVERIFY(hasMarker(secondQml));
+
+    // The buffer the second file refers to changed
+    QVERIFY(writeTriangle(dir, QStringLiteral("second"), 1.0f));
+    QVERIFY(runBalsam(arguments));
+    QVERIFY(hasMarker(firstQml));
+    QVERIFY(!hasMarker(secondQml));
+
+    // The ids of the file that was skipped are not given out again, even
+    // though the objects in both files have the same names
+    const QStringList secondIds = manifestList(manifestEntry(manifest, second), QStringLiteral("ids"));
+    QVERIFY(!secondIds.isEmpty());
+    for (const QString &id : secondIds)
+        QVERIFY2(!firstIds.contains(id), qPrintable(id));
+    QCOMPARE(manifestList(manifestEntry(manifest, first), QStringLiteral("ids")), firstIds);
+
+    // An output of the first file was deleted
+    QVERIFY(appendMarker(secondQml));
+    QVERIFY(QFile::remove(outDir.filePath(firstOutputs.last())));
+    QVERIFY(runBalsam(arguments));
+    QVERIFY(!hasMarker(firstQml));
+    QVERIFY(hasMarker(secondQml));
+    QVERIFY(outDir.exists(firstOutputs.last()));
+}
+
+void tst_balsam::reconvertOnOptionChange()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QDir dir(tempDir.path());
+    QVERIFY(dir.mkdir(QStringLiteral("out")));
+    const QDir outDir(dir.filePath(QStringLiteral("out")));
+    const QString manifest = dir.filePath(QStringLiteral("manifest.json"));
+    const QString source = dir.filePath(QStringLiteral("triangle.gltf"));
+    QVERIFY(writeTriangle(dir, QStringLiteral("triangle")));
+
+    const QStringList arguments { QStringLiteral("--manifest"), manifest,
+                                  QStringLiteral("-o"), outDir.path(), source };
+    QVERIFY(runBalsam(arguments));
+    const QStringList outputs = manifestList(manifestEntry(manifest, source), QStringLiteral("outputs"));
+    QVERIFY(!outputs.isEmpty());
+    const QString qml = outDir.filePath(outputs.first());
+
+    QVERIFY(appendMarker(qml));
+    QVERIFY(runBalsam(QStringList { QStringLiteral("--expandValueComponents") } + arguments));
+    QVERIFY(!hasMarker(qml));
+
+    // The same options again
+    QVERIFY(appendMarker(qml));
+    QVERIFY(runBalsam(QStringList { QStringLiteral("--expandValueComponents") } + arguments));
+    QVERIFY(hasMarker(qml));
+}
+
+void tst_balsam::parallelJobs()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QDir dir(tempDir.path());
+    QStringList sources;
+    for (int i = 0; i != 6; ++i) {
+        const QString baseName = QStringLiteral("triangle%1").arg(i);
+        QVERIFY(writeTriangle(dir, baseName, float(i) / 5.0f));
+        sources.append(dir.filePath(baseName + QStringLiteral(".gltf")));
+    }
+
+    // The ids, and so the names of the meshes, depend on the order in which
+    // the files are written, which must not depend on the number of jobs
+    const QString serialDir = dir.filePath(QStringLiteral("serial"));
+    const QString parallelDir = dir.filePath(QStringLiteral("parallel"));
+    QVERIFY(runBalsam(QStringList { QStringLiteral("--jobs"), QStringLiteral("1"),
+                                    QStringLiteral("-o"), serialDir } + sources));
+    QVERIFY(runBalsam(QStringList { QStringLiteral("--jobs"), QStringLiteral("4"),
+                                    QStringLiteral("-o"), parallelDir } + sources));
+
+    const QMap<QString, QByteArray> serial = readAllFiles(QDir(serialDir));
+    const QMap<QString, QByteArray> parallel = readAllFiles(QDir(parallelDir));
+    QVERIFY(serial.size() >= 2 * sources.size());
+    QCOMPARE(parallel.keys(), serial.keys());
+    for (auto it = serial.cbegin(); it != serial.cend(); ++it)
+        QVERIFY2(parallel.value(it.key()) == it.value(), qPrintable(it.key()));
+}
+
+QTEST_GUILESS_MAIN(tst_balsam)
+
+#include "tst_balsam.moc"
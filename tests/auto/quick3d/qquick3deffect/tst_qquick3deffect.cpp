@@ -0,0 +1,180 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+
+#include <QtQuick3D/private/qquick3deffect_p.h>
+
+#include <QtQuick3DRuntimeRender/private/qssgrhieffectsystem_p.h>
+
+class tst_QQuick3DEffect : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testSamplesInputOnlyAtInputUV_data();
+    void testSamplesInputOnlyAtInputUV();
+    void testShaderGlobalNames_data();
+    void testShaderGlobalNames();
+    void testFuseFragmentShaders();
+    void testFuseFragmentShadersTonemap();
+};
+
+void tst_QQuick3DEffect::testSamplesInputOnlyAtInputUV_data()
+{
+    QTest::addColumn<QByteArray>("code");
+    QTest::addColumn<bool>("pixelLocal");
+
+    QTest::newRow("default")
+            << QByteArray("void MAIN()\n{\n    FRAGCOLOR = texture(INPUT, INPUT_UV);\n}\n")
+            << true;
+    QTest::newRow("multiple lookups")
+            << QByteArray("void MAIN()\n{\n"
+                          "    vec4 c = texture(INPUT, INPUT_UV);\n"
+                          "    FRAGCOLOR = c * 0.5 + texture(INPUT, INPUT_UV) * 0.5;\n"
+                          "}\n")
+            << true;
+    QTest::newRow("whitespace")
+            << QByteArray("void MAIN()\n{\n    FRAGCOLOR = texture ( INPUT ,\n INPUT_UV );\n}\n")
+            << true;
+    QTest::newRow("no input")
+            << QByteArray("void MAIN()\n{\n    FRAGCOLOR = vec4(1.0);\n}\n")
+            << true;
+    QTest::newRow("input in comments")
+            << QByteArray("void MAIN()\n{\n"
+                          "    // texture(INPUT, INPUT_UV + vec2(0.1))\n"
+                          "    /* texelFetch(INPUT, ivec2(0), 0) */\n"
+                          "    FRAGCOLOR = texture(INPUT, INPUT_UV).bgra;\n"
+                          "}\n")
+            << true;
+
+    QTest::newRow("offset uv")
+            << QByteArray("void MAIN()\n{\n    FRAGCOLOR = texture(INPUT, INPUT_UV + vec2(0.01, 0.0));\n}\n")
+            << false;
+    QTest::newRow("custom uv")
+            << QByteArray("void MAIN()\n{\n    vec2 uv = INPUT_UV * 0.5;\n    FRAGCOLOR = texture(INPUT, uv);\n}\n")
+            << false;
+    QTest::newRow("texture size")
+            << QByteArray("void MAIN()\n{\n"
+                          "    vec2 size = vec2(textureSize(INPUT, 0));\n"
+                          "    FRAGCOLOR = texture(INPUT, INPUT_UV) * size.x;\n"
+                          "}\n")
+            << false;
+    QTest::newRow("texel fetch")
+            << QByteArray("void MAIN()\n{\n    FRAGCOLOR = texelFetch(INPUT, ivec2(gl_FragCoord.xy), 0);\n}\n")
+            << false;
+    QTest::newRow("varying")
+            << QByteArray("VARYING vec2 center;\n"
+                          "void MAIN()\n{\n    FRAGCOLOR = texture(INPUT, INPUT_UV);\n}\n")
+            << false;
+}
+
+void tst_QQuick3DEffect::testSamplesInputOnlyAtInputUV()
+{
+    QFETCH(QByteArray, code);
+    QFETCH(bool, pixelLocal);
+    QCOMPARE(QQuick3DEffect::samplesInputOnlyAtInputUV(code), pixelLocal);
+}
+
+void tst_QQuick3DEffect::testShaderGlobalNames_data()
+{
+    QTest::addColumn<QByteArray>("code");
+    QTest::addColumn<QByteArrayList>("names");
+
+    QTest::newRow("main only")
+            << QByteArray("void MAIN()\n{\n    float x = 1.0;\n    FRAGCOLOR = vec4(x);\n}\n")
+            << QByteArrayList();
+    QTest::newRow("define")
+            << QByteArray("#define STRENGTH 2.0\n# define  OTHER\nvoid MAIN() { }\n")
+            << QByteArrayList { "STRENGTH", "OTHER" };
+    QTest::newRow("constant")
+            << QByteArray("const float strength = 2.0;\nvoid MAIN() { }\n")
+            << QByteArrayList { "strength" };
+    QTest::newRow("function")
+            << QByteArray("vec4 blend(vec4 a, vec4 b)\n{\n    vec4 c = a * b;\n    return c;\n}\n"
+                          "void MAIN() { FRAGCOLOR = blend(vec4(1.0), vec4(0.5)); }\n")
+            << QByteArrayList { "blend" };
+    QTest::newRow("struct")
+            << QByteArray("struct Sample { vec2 uv; float weight; };\nvoid MAIN() { }\n")
+            << QByteArrayList { "Sample" };
+    QTest::newRow("array")
+            << QByteArray("const float weights[3] = float[3](0.25, 0.5, 0.25);\nvoid MAIN() { }\n")
+            << QByteArrayList { "weights" };
+    QTest::newRow("declaration list")
+            << QByteArray("float a, b;\nvoid MAIN() { }\n")
+            << QByteArrayList { "a", "b" };
+    QTest::newRow("declaration list with initializers")
+            << QByteArray("float a = max(1.0, 2.0), b;\nvoid MAIN() { }\n")
+            << QByteArrayList { "a", "b" };
+    QTest::newRow("comments")
+            << QByteArray("// float commented;\n/* vec4 alsoCommented(); */\nvoid MAIN() { }\n")
+            << QByteArrayList();
+}
+
+void tst_QQuick3DEffect::testShaderGlobalNames()
+{
+    QFETCH(QByteArray, code);
+    QFETCH(QByteArrayList, names);
+    QCOMPARE(QQuick3DEffect::shaderGlobalNames(code), names);
+}
+
+void tst_QQuick3DEffect::testFuseFragmentShaders()
+{
+    // The shaders as they are after QSSGShaderCustomMaterialAdapter has
+    // processed them
+    const QByteArray first = "void qt_customMain()\n{\n"
+                             "    fragOutput = texture(qt_inputTexture, qt_inputUV).bgra;\n"
+                             "}\n";
+    const QByteArray second = "void qt_customMain()\n{\n"
+                              "    fragOutput = texture( qt_inputTexture , qt_inputUV ) * 0.5;\n"
+                              "}\n";
+    const QByteArray third = "void qt_customMain()\n{\n"
+                             "    fragOutput = vec4(1.0) - texture(qt_inputTexture, qt_inputUV);\n"
+                             "}\n";
+
+    const QByteArray fused = QSSGRhiEffectSystem::fuseFragmentShaders({ first, second, third }, false);
+    QVERIFY(fused.startsWith("vec4 qt_fusedInputColor;\n"));
+
+    // Every MAIN is renamed, none is left under its own name
+    QVERIFY(!fused.contains("qt_customMain("));
+    QVERIFY(fused.contains("void qt_customMain_0()"));
+    QVERIFY(fused.contains("void qt_customMain_1()"));
+    QVERIFY(fused.contains("void qt_customMain_2()"));
+
+    // Only the first shader samples the input, the others get the color the
+    // previous one wrote
+    QCOMPARE(fused.count("qt_inputTexture"), 1);
+    QVERIFY(fused.contains("fragOutput = texture(qt_inputTexture, qt_inputUV).bgra;"));
+    QVERIFY(fused.contains("fragOutput = qt_fusedInputColor * 0.5;"));
+    QVERIFY(fused.contains("fragOutput = vec4(1.0) - qt_fusedInputColor;"));
+
+    QVERIFY(!fused.contains("tonemapping.glsllib"));
+    QVERIFY(!fused.contains("qt_tonemap"));
+    QVERIFY(fused.endsWith("void main()\n{\n"
+                           "    qt_customMain_0();\n"
+                           "    qt_fusedInputColor = fragOutput;\n"
+                           "    qt_customMain_1();\n"
+                           "    qt_fusedInputColor = fragOutput;\n"
+                           "    qt_customMain_2();\n"
+                           "}\n"));
+}
+
+void tst_QQuick3DEffect::testFuseFragmentShadersTonemap()
+{
+    const QByteArray shader = "void qt_customMain()\n{\n"
+                              "    fragOutput = texture(qt_inputTexture, qt_inputUV);\n"
+                              "}\n";
+
+    const QByteArray fused = QSSGRhiEffectSystem::fuseFragmentShaders({ shader, shader }, true);
+    QCOMPARE(fused.count("qt_inputTexture"), 1);
+    QVERIFY(fused.contains("#include \"tonemapping.glsllib\"\n"));
+    QVERIFY(fused.endsWith("void main()\n{\n"
+                           "    qt_customMain_0();\n"
+                           "    qt_fusedInputColor = fragOutput;\n"
+                           "    qt_customMain_1();\n"
+                           "    fragOutput = qt_tonemap(fragOutput);\n"
+                           "}\n"));
+}
+
+QTEST_APPLESS_MAIN(tst_QQuick3DEffect)
+#include "tst_qquick3deffect.moc"
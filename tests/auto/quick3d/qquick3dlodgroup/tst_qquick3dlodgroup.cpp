@@ -0,0 +1,173 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+#include <QSignalSpy>
+
+#include <QtQuick3D/private/qquick3dlodgroup_p.h>
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderlodgroup_p.h>
+
+class tst_QQuick3DLodGroup : public QObject
+{
+    Q_OBJECT
+
+    // Work-around to get access to updateSpatialNode
+    class LodGroup : public QQuick3DLodGroup
+    {
+    public:
+        using QQuick3DLodGroup::updateSpatialNode;
+    };
+
+private slots:
+    void testProperties();
+    void testSelectLevel();
+    void testSelectLevelHysteresis();
+    void testSelectLevelCrossFade();
+};
+
+void tst_QQuick3DLodGroup::testProperties()
+{
+    LodGroup lodGroup;
+    auto node = static_cast<QSSGRenderLodGroup *>(lodGroup.updateSpatialNode(nullptr));
+    const auto originalNode = node; // for comparisons later...
+    QVERIFY(node);
+    QVERIFY(node->levelErrors.isEmpty());
+    QCOMPARE(node->maximumScreenError, 1.0f);
+    QCOMPARE(node->hysteresis, 0.1f);
+    QVERIFY(!node->crossFade);
+
+    QSignalSpy levelErrorsSpy(&lodGroup, &QQuick3DLodGroup::levelErrorsChanged);
+    const QList<float> levelErrors { 0.0f, 0.5f, 4.0f };
+    lodGroup.setLevelErrors(levelErrors);
+    lodGroup.setLevelErrors(levelErrors);
+    QCOMPARE(levelErrorsSpy.size(), 1);
+    node->currentLevel = 2;
+    node = static_cast<QSSGRenderLodGroup *>(lodGroup.updateSpatialNode(node));
+    QCOMPARE(originalNode, node);
+    QCOMPARE(node->levelErrors, levelErrors);
+    // The levels changed, the selection starts over
+    QCOMPARE(node->currentLevel, -1);
+
+    // Other properties do not reset the current level
+    node->currentLevel = 1;
+    lodGroup.setMaximumScreenError(2.5f);
+    lodGroup.setCrossFade(true);
+    node = static_cast<QSSGRenderLodGroup *>(lodGroup.updateSpatialNode(node));
+    QCOMPARE(node->maximumScreenError, 2.5f);
+    QVERIFY(node->crossFade);
+    QCOMPARE(node->currentLevel, 1);
+
+    // Out of range values are clamped
+    QSignalSpy hysteresisSpy(&lodGroup, &QQuick3DLodGroup::hysteresisChanged);
+    lodGroup.setHysteresis(1.5f);
+    QCOMPARE(lodGroup.hysteresis(), 0.99f);
+    lodGroup.setHysteresis(-1.0f);
+    QCOMPARE(lodGroup.hysteresis(), 0.0f);
+    QCOMPARE(hysteresisSpy.size(), 2);
+    lodGroup.setMaximumScreenError(-1.0f);
+    QCOMPARE(lodGroup.maximumScreenError(), 0.0f);
+    node = static_cast<QSSGRenderLodGroup *>(lodGroup.updateSpatialNode(node));
+    QCOMPARE(node->hysteresis, 0.0f);
+    QCOMPARE(node->maximumScreenError, 0.0f);
+}
+
+void tst_QQuick3DLodGroup::testSelectLevel()
+{
+    // A level is picked when its error is below 2 pixels, the hysteresis band
+    // being [1.8, 2.2] pixels
+    QSSGRenderLodGroup lodGroup;
+    lodGroup.levelErrors = { 0.0f, 1.0f, 4.0f };
+    lodGroup.maximumScreenError = 2.0f;
+    lodGroup.hysteresis = 0.1f;
+
+    // Close by, only the most detailed level is good enough
+    QSSGRenderLodGroup::Selection selection = lodGroup.selectLevel(3, 10.0f, 1.0f);
+    QCOMPARE(selection.level, 0);
+    QCOMPARE(selection.fadeLevel, -1);
+    QCOMPARE(selection.crossFade, 0.0f);
+    QCOMPARE(lodGroup.currentLevel, 0);
+
+    lodGroup.currentLevel = -1;
+    QCOMPARE(lodGroup.selectLevel(3, 1.0f, 1.0f).level, 1);
+    QCOMPARE(lodGroup.currentLevel, 1);
+
+    lodGroup.currentLevel = -1;
+    QCOMPARE(lodGroup.selectLevel(3, 0.4f, 1.0f).level, 2);
+
+    // The pixel threshold scales the maximum error
+    lodGroup.currentLevel = -1;
+    QCOMPARE(lodGroup.selectLevel(3, 2.0f, 0.5f).level, 0);
+
+    // Levels beyond the ones that exist are ignored
+    lodGroup.currentLevel = -1;
+    QCOMPARE(lodGroup.selectLevel(2, 0.4f, 1.0f).level, 1);
+    lodGroup.currentLevel = -1;
+    QCOMPARE(lodGroup.selectLevel(0, 0.4f, 1.0f).level, -1);
+
+    lodGroup.levelErrors.clear();
+    QCOMPARE(lodGroup.selectLevel(3, 0.4f, 1.0f).level, -1);
+}
+
+void tst_QQuick3DLodGroup::testSelectLevelHysteresis()
+{
+    QSSGRenderLodGroup lodGroup;
+    lodGroup.levelErrors = { 0.0f, 1.0f, 4.0f };
+    lodGroup.maximumScreenError = 2.0f;
+    lodGroup.hysteresis = 0.1f;
+
+    // Within the band the current level is kept, whichever it is
+    QCOMPARE(lodGroup.selectLevel(3, 10.0f, 1.0f).level, 0);
+    QCOMPARE(lodGroup.selectLevel(3, 2.0f, 1.0f).level, 0);
+    QCOMPARE(lodGroup.selectLevel(3, 1.0f, 1.0f).level, 1);
+    QCOMPARE(lodGroup.selectLevel(3, 2.0f, 1.0f).level, 1);
+    // Out of the band on the detailed side
+    QCOMPARE(lodGroup.selectLevel(3, 2.5f, 1.0f).level, 0);
+
+    // Without any current level, the coarsest acceptable one is picked
+    lodGroup.currentLevel = -1;
+    QCOMPARE(lodGroup.selectLevel(3, 2.0f, 1.0f).level, 1);
+}
+
+void tst_QQuick3DLodGroup::testSelectLevelCrossFade()
+{
+    QSSGRenderLodGroup lodGroup;
+    lodGroup.levelErrors = { 0.0f, 1.0f, 4.0f };
+    lodGroup.maximumScreenError = 2.0f;
+    lodGroup.hysteresis = 0.1f;
+    lodGroup.crossFade = true;
+
+    // Outside of the band a single level is drawn without dithering
+    QSSGRenderLodGroup::Selection selection = lodGroup.selectLevel(3, 10.0f, 1.0f);
+    QCOMPARE(selection.level, 0);
+    QCOMPARE(selection.fadeLevel, -1);
+    QCOMPARE(selection.crossFade, 0.0f);
+
+    selection = lodGroup.selectLevel(3, 1.0f, 1.0f);
+    QCOMPARE(selection.level, 1);
+    QCOMPARE(selection.fadeLevel, -1);
+    QCOMPARE(selection.crossFade, 0.0f);
+
+    // Within the band both levels are drawn, the fraction following the
+    // position in the band
+    selection = lodGroup.selectLevel(3, 1.9f, 1.0f);
+    QCOMPARE(selection.level, 0);
+    QCOMPARE(selection.fadeLevel, 1);
+    QVERIFY(qAbs(selection.crossFade - 0.25f) < 0.001f);
+    QCOMPARE(lodGroup.currentLevel, 1); // the fade level dominates
+
+    selection = lodGroup.selectLevel(3, 2.1f, 1.0f);
+    QCOMPARE(selection.level, 0);
+    QCOMPARE(selection.fadeLevel, 1);
+    QVERIFY(qAbs(selection.crossFade - 0.75f) < 0.001f);
+    QCOMPARE(lodGroup.currentLevel, 0);
+
+    // Leaving the band stops the dithering
+    selection = lodGroup.selectLevel(3, 2.5f, 1.0f);
+    QCOMPARE(selection.level, 0);
+    QCOMPARE(selection.fadeLevel, -1);
+    QCOMPARE(selection.crossFade, 0.0f);
+}
+
+QTEST_APPLESS_MAIN(tst_QQuick3DLodGroup)
+#include "tst_qquick3dlodgroup.moc"
@@ -14,6 +14,7 @@ class tst_QQuick3DTextureData : public QObject
     Q_OBJECT
 private Q_SLOTS:
     void testProperties();
+    void testUpdateRegion();
 };
 
 namespace {
@@ -140,5 +141,53 @@ void tst_QQuick3DTextureData::testProperties()
     }
 }
 
+void tst_QQuick3DTextureData::testUpdateRegion()
+{
+    QQuick3DTextureData textureData;
+    const QSize size(16, 16);
+    textureData.setSize(size);
+    textureData.setFormat(QQuick3DTextureData::RGBA8);
+    textureData.setTextureData(QByteArray(16 * 16 * 4, 'x'));
+    auto *node = static_cast<QSSGRenderTextureData *>(QQuick3DObjectPrivate::updateSpatialNode(&textureData, nullptr));
+    QVERIFY(node);
+    const uint32_t uploadedGeneration = node->generationId();
+    const uint32_t layoutGeneration = node->layoutGenerationId();
+
+    // region updates change the contents only
+    const QRect rect(2, 3, 4, 5);
+    textureData.updateRegion(rect, QByteArray(rect.width() * rect.height() * 4, 'y'));
+    node = static_cast<QSSGRenderTextureData *>(QQuick3DObjectPrivate::updateSpatialNode(&textureData, node));
+    QVERIFY(node->generationId() != uploadedGeneration);
+    QCOMPARE(node->layoutGenerationId(), layoutGeneration);
+    QVector<QRect> regions;
+    QVERIFY(node->dirtyRegionsSince(uploadedGeneration, &regions));
+    QCOMPARE(regions, QVector<QRect>{ rect });
+
+    const QByteArray &data = node->textureData();
+    QCOMPARE(data, textureData.textureData());
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x)
+            QCOMPARE(data.at((y * size.width() + x) * 4), rect.contains(x, y) ? 'y' : 'x');
+    }
+
+    // replacing the data makes the regions irrelevant, but keeps the layout
+    textureData.setTextureData(QByteArray(16 * 16 * 4, 'z'));
+    node = static_cast<QSSGRenderTextureData *>(QQuick3DObjectPrivate::updateSpatialNode(&textureData, node));
+    QCOMPARE(node->layoutGenerationId(), layoutGeneration);
+    regions.clear();
+    QVERIFY(!node->dirtyRegionsSince(uploadedGeneration, &regions));
+
+    // resizing changes the layout
+    textureData.setSize(QSize(8, 8));
+    node = static_cast<QSSGRenderTextureData *>(QQuick3DObjectPrivate::updateSpatialNode(&textureData, node));
+    QVERIFY(node->layoutGenerationId() != layoutGeneration);
+
+    // out of bounds regions are rejected
+    const QByteArray before = textureData.textureData();
+    QTest::ignoreMessage(QtWarningMsg, "QQuick3DTextureData::updateRegion: Region is outside of the texture");
+    textureData.updateRegion(QRect(6, 6, 4, 4), QByteArray(4 * 4 * 4, 'w'));
+    QCOMPARE(textureData.textureData(), before);
+}
+
 QTEST_APPLESS_MAIN(tst_QQuick3DTextureData)
 #include "tst_qquick3dtexturedata.moc"
@@ -0,0 +1,301 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+#include <QBuffer>
+#include <QDataStream>
+#include <QtEndian>
+
+#include <QtQuick3DUtils/private/qssgmesh_p.h>
+
+#include <QtQuick3DRuntimeRender/private/qssglayerrenderdata_p.h>
+
+#include <algorithm>
+#include <array>
+
+using Triangle = std::array<quint32, 3>;
+// offset, count
+using Ranges = QList<std::pair<quint32, quint32>>;
+
+class tst_QSSGMeshlets : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testCreateMeshlets();
+    void testRoundTrip_data();
+    void testRoundTrip();
+    void testInvalidRanges_data();
+    void testInvalidRanges();
+    void testMergeDrawRanges_data();
+    void testMergeDrawRanges();
+
+private:
+    static QSSGMesh::Mesh createGrid(int size);
+    static QVector<Triangle> triangles(const QSSGMesh::Mesh &mesh);
+    static QByteArray save(const QSSGMesh::Mesh &mesh, QSSGMesh::Mesh::SaveFlags flags);
+};
+
+// A grid of size x size quads in the xy plane with 16-bit indices
+QSSGMesh::Mesh tst_QSSGMeshlets::createGrid(int size)
+{
+    QByteArray positions;
+    for (int y = 0; y <= size; ++y) {
+        for (int x = 0; x <= size; ++x) {
+            const float position[3] = { float(x), float(y), 0.0f };
+            positions.append(reinterpret_cast<const char *>(position), sizeof(position));
+        }
+    }
+
+    QByteArray indices;
+    const auto appendIndex = [&indices](int index) {
+        const quint16 value = quint16(index);
+        indices.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    };
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const int corner = y * (size + 1) + x;
+            appendIndex(corner);
+            appendIndex(corner + 1);
+            appendIndex(corner + size + 2);
+            appendIndex(corner);
+            appendIndex(corner + size + 2);
+            appendIndex(corner + size + 1);
+        }
+    }
+
+    QSSGMesh::AssetVertexEntry positionEntry;
+    positionEntry.name = QSSGMesh::MeshInternal::getPositionAttrName();
+    positionEntry.data = positions;
+    positionEntry.componentType = QSSGMesh::Mesh::ComponentType::Float32;
+    positionEntry.componentCount = 3;
+
+    QSSGMesh::AssetMeshSubset subset;
+    subset.name = QStringLiteral("grid");
+    subset.count = quint32(size * size * 6);
+    subset.offset = 0;
+    subset.boundsPositionEntryIndex = 0;
+
+    return QSSGMesh::Mesh::fromAssetData({ positionEntry }, indices, QSSGMesh::Mesh::ComponentType::UnsignedInt16, { subset });
+}
+
+// The triangles of the first subset, each rotated to start with its smallest
+// index, which keeps the winding
+QVector<Triangle> tst_QSSGMeshlets::triangles(const QSSGMesh::Mesh &mesh)
+{
+    const QSSGMesh::Mesh::Subset subset = mesh.subsets().first();
+    const QByteArray indexData = mesh.indexBuffer().data;
+    const quint16 *indices = reinterpret_cast<const quint16 *>(indexData.constData());
+    QVector<Triangle> result;
+    for (quint32 i = subset.offset; i < subset.offset + subset.count; i += 3) {
+        Triangle triangle { indices[i], indices[i + 1], indices[i + 2] };
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        result.append(triangle);
+    }
+    return result;
+}
+
+QByteArray tst_QSSGMeshlets::save(const QSSGMesh::Mesh &mesh, QSSGMesh::Mesh::SaveFlags flags)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    mesh.save(&buffer, 0, flags);
+    return data;
+}
+
+void tst_QSSGMeshlets::testCreateMeshlets()
+{
+    QSSGMesh::Mesh mesh = createGrid(16);
+    QVERIFY(mesh.isValid());
+    QVERIFY(!mesh.hasMeshlets());
+    QVector<Triangle> before = triangles(mesh);
+
+    // Subsets below the minimum are left alone
+    QVERIFY(!mesh.createMeshlets(1024));
+    QVERIFY(!mesh.hasMeshlets());
+
+    QVERIFY(mesh.createMeshlets(1));
+    QVERIFY(mesh.hasMeshlets());
+
+    // The meshlets cover the subset, one after the other
+    const QSSGMesh::Mesh::Subset subset = mesh.subsets().first();
+    QVERIFY(subset.meshlets.size() >= 512 / 124 + 1);
+    quint32 offset = subset.offset;
+    for (const QSSGMesh::Mesh::Meshlet &meshlet : subset.meshlets) {
+        QCOMPARE(meshlet.offset, offset);
+        QVERIFY(meshlet.count > 0);
+        QVERIFY(meshlet.count <= 124 * 3);
+        QCOMPARE(meshlet.count % 3, 0u);
+        QVERIFY(meshlet.radius > 0.0f);
+        QVERIFY(meshlet.center.x() >= 0.0f && meshlet.center.x() <= 16.0f);
+        QVERIFY(meshlet.center.y() >= 0.0f && meshlet.center.y() <= 16.0f);
+        // All triangles of the grid face +z
+        QVERIFY(meshlet.coneAxis.z() > 0.99f);
+        offset += meshlet.count;
+    }
+    QCOMPARE(offset, subset.offset + subset.count);
+
+    // The subset draws the same triangles, with the same winding
+    QVector<Triangle> after = triangles(mesh);
+    std::sort(before.begin(), before.end());
+    std::sort(after.begin(), after.end());
+    QVERIFY(after == before);
+}
+
+void tst_QSSGMeshlets::testRoundTrip_data()
+{
+    QTest::addColumn<bool>("compress");
+
+    QTest::newRow("raw") << false;
+    QTest::newRow("compressed") << true;
+}
+
+void tst_QSSGMeshlets::testRoundTrip()
+{
+    QFETCH(bool, compress);
+    const QSSGMesh::Mesh::SaveFlags flags = compress ? QSSGMesh::Mesh::SaveFlag::Compress
+                                                     : QSSGMesh::Mesh::SaveFlag::None;
+
+    QSSGMesh::Mesh mesh = createGrid(16);
+    QVERIFY(mesh.createMeshlets(1));
+
+    QByteArray data = save(mesh, flags);
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    const QSSGMesh::Mesh loaded = QSSGMesh::Mesh::loadMesh(&buffer);
+    QVERIFY(loaded.isValid());
+    QVERIFY(loaded.hasMeshlets());
+
+    const QVector<QSSGMesh::Mesh::Meshlet> meshlets = mesh.subsets().first().meshlets;
+    const QVector<QSSGMesh::Mesh::Meshlet> loadedMeshlets = loaded.subsets().first().meshlets;
+    QCOMPARE(loadedMeshlets.size(), meshlets.size());
+    for (qsizetype i = 0; i < meshlets.size(); ++i) {
+        QCOMPARE(loadedMeshlets.at(i).count, meshlets.at(i).count);
+        QCOMPARE(loadedMeshlets.at(i).offset, meshlets.at(i).offset);
+        QCOMPARE(loadedMeshlets.at(i).center, meshlets.at(i).center);
+        QCOMPARE(loadedMeshlets.at(i).radius, meshlets.at(i).radius);
+        QCOMPARE(loadedMeshlets.at(i).coneApex, meshlets.at(i).coneApex);
+        QCOMPARE(loadedMeshlets.at(i).coneAxis, meshlets.at(i).coneAxis);
+        QCOMPARE(loadedMeshlets.at(i).coneCutoff, meshlets.at(i).coneCutoff);
+    }
+
+    // The compressed index buffer may rotate the triangles, but keeps their
+    // order, so the meshlets still refer to the same ones
+    QVERIFY(triangles(loaded) == triangles(mesh));
+
+    // Without meshlets the file is written as before
+    buffer.close();
+    data = save(createGrid(16), flags);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    const QSSGMesh::Mesh loadedPlain = QSSGMesh::Mesh::loadMesh(&buffer);
+    QVERIFY(loadedPlain.isValid());
+    QVERIFY(!loadedPlain.hasMeshlets());
+}
+
+void tst_QSSGMeshlets::testInvalidRanges_data()
+{
+    QTest::addColumn<int>("meshlet");
+    QTest::addColumn<int>("offsetChange");
+    QTest::addColumn<int>("countChange");
+
+    // meshlet -1 is the last one, -2 changes the number of meshlets instead
+    QTest::newRow("overlapping") << 1 << -3 << 0;
+    QTest::newRow("past the subset") << -1 << 0 << 3;
+    QTest::newRow("moved past the subset") << -1 << 3 << 0;
+    QTest::newRow("too many meshlets") << -2 << 0 << 0;
+}
+
+void tst_QSSGMeshlets::testInvalidRanges()
+{
+    QFETCH(int, meshlet);
+    QFETCH(int, offsetChange);
+    QFETCH(int, countChange);
+
+    QSSGMesh::Mesh mesh = createGrid(16);
+    QVERIFY(mesh.createMeshlets(1));
+    const QSSGMesh::Mesh::Subset subset = mesh.subsets().first();
+    QByteArray data = save(mesh, QSSGMesh::Mesh::SaveFlag::None);
+
+    // Find the meshlet list in the file by its contents
+    QByteArray list;
+    {
+        QDataStream stream(&list, QIODevice::WriteOnly);
+        stream.setByteOrder(QDataStream::LittleEndian);
+        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+        const QSSGMesh::Mesh::Meshlet &first = subset.meshlets.first();
+        stream << quint32(subset.meshlets.size()) << first.count << first.offset
+               << first.center.x() << first.center.y() << first.center.z() << first.radius;
+    }
+    const qsizetype listPos = data.indexOf(list);
+    QVERIFY(listPos >= 0);
+    QCOMPARE(data.indexOf(list, listPos + 1), -1);
+
+    const auto patch = [&data](qsizetype pos, quint32 value) {
+        const quint32 littleEndian = qToLittleEndian(value);
+        data.replace(pos, sizeof(quint32), reinterpret_cast<const char *>(&littleEndian), sizeof(quint32));
+    };
+    if (meshlet == -2) {
+        patch(listPos, subset.count / 3 + 1);
+    } else {
+        // count and offset lead each entry of 52 bytes
+        const qsizetype index = meshlet < 0 ? subset.meshlets.size() - 1 : meshlet;
+        const QSSGMesh::Mesh::Meshlet &entry = subset.meshlets.at(index);
+        const qsizetype entryPos = listPos + sizeof(quint32) + index * 52;
+        patch(entryPos, entry.count + countChange);
+        patch(entryPos + sizeof(quint32), entry.offset + offsetChange);
+    }
+
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QTest::ignoreMessage(QtWarningMsg, "Invalid meshlet data");
+    const QSSGMesh::Mesh loaded = QSSGMesh::Mesh::loadMesh(&buffer);
+    QVERIFY(!loaded.isValid());
+}
+
+void tst_QSSGMeshlets::testMergeDrawRanges_data()
+{
+    QTest::addColumn<Ranges>("ranges");
+    QTest::addColumn<int>("maxRanges");
+    QTest::addColumn<Ranges>("merged");
+
+    QTest::newRow("empty") << Ranges() << 4 << Ranges();
+    QTest::newRow("adjacent")
+            << Ranges { { 0, 3 }, { 3, 6 }, { 9, 3 } } << 16
+            << Ranges { { 0, 12 } };
+    QTest::newRow("within the limit")
+            << Ranges { { 0, 3 }, { 6, 3 }, { 12, 3 } } << 3
+            << Ranges { { 0, 3 }, { 6, 3 }, { 12, 3 } };
+    QTest::newRow("smallest gaps")
+            << Ranges { { 0, 3 }, { 6, 3 }, { 39, 3 }, { 45, 3 }, { 108, 3 } } << 3
+            << Ranges { { 0, 9 }, { 39, 9 }, { 108, 3 } };
+    QTest::newRow("equal gaps")
+            << Ranges { { 0, 3 }, { 6, 3 }, { 12, 3 }, { 18, 3 } } << 3
+            << Ranges { { 0, 9 }, { 12, 3 }, { 18, 3 } };
+    QTest::newRow("adjacent and gaps")
+            << Ranges { { 0, 3 }, { 3, 3 }, { 9, 3 }, { 30, 3 } } << 2
+            << Ranges { { 0, 12 }, { 30, 3 } };
+    QTest::newRow("single range")
+            << Ranges { { 0, 3 }, { 100, 3 }, { 200, 3 } } << 1
+            << Ranges { { 0, 203 } };
+}
+
+void tst_QSSGMeshlets::testMergeDrawRanges()
+{
+    QFETCH(Ranges, ranges);
+    QFETCH(int, maxRanges);
+    QFETCH(Ranges, merged);
+
+    QSSGLayerRenderData::MeshletDrawRanges drawRanges;
+    for (const auto &range : std::as_const(ranges))
+        drawRanges.append({ range.second, range.first });
+    QSSGLayerRenderData::mergeMeshletDrawRanges(drawRanges, maxRanges);
+
+    Ranges result;
+    for (const QSSGSubsetRenderable::DrawRange &range : std::as_const(drawRanges))
+        result.append({ range.offset, range.count });
+    QCOMPARE(result, merged);
+}
+
+QTEST_APPLESS_MAIN(tst_QSSGMeshlets)
+#include "tst_qssgmeshlets.moc"
@@ -0,0 +1,98 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+#include <QRegularExpression>
+
+#include <QtQuick3DRuntimeRender/private/qssgrhicontext_p.h>
+
+#include <memory>
+
+class tst_QSSGRhiContext : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testEvictStaleDrawCallData();
+
+private:
+    std::unique_ptr<QRhi> m_rhi;
+};
+
+void tst_QSSGRhiContext::initTestCase()
+{
+    QRhiNullInitParams params;
+    m_rhi.reset(QRhi::create(QRhi::Null, &params));
+    QVERIFY(m_rhi);
+}
+
+void tst_QSSGRhiContext::testEvictStaleDrawCallData()
+{
+    // Releasing an entry must not trip over an srb it does not know the key of
+    QTest::failOnWarning(QRegularExpression(QStringLiteral("Unexpected condition met")));
+
+    QSSGRhiContext rhiCtx(m_rhi.get());
+    QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(&rhiCtx);
+
+    int live, stale, unkeyed;
+    const QSSGRhiDrawCallDataKey liveKey { &live, nullptr, nullptr, 0 };
+    const QSSGRhiDrawCallDataKey staleKey { &stale, nullptr, nullptr, 0 };
+    const QSSGRhiDrawCallDataKey unkeyedKey { &unkeyed, nullptr, nullptr, 0 };
+
+    const auto prepare = [&](const QSSGRhiDrawCallDataKey &key, bool throughDrawCallData) {
+        QSSGRhiDrawCallData &dcd = rhiCtxD->drawCallData(key);
+        if (!dcd.ubuf) {
+            dcd.ubuf = m_rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, 64);
+            dcd.ubuf->create();
+        }
+        QSSGRhiShaderResourceBindingList bindings;
+        bindings.addUniformBuffer(0, QRhiShaderResourceBinding::VertexStage, dcd.ubuf);
+        if (throughDrawCallData)
+            rhiCtxD->srb(dcd, bindings);
+        else
+            dcd.srb = rhiCtxD->srb(bindings);
+        return bindings;
+    };
+
+    rhiCtxD->beginFrame();
+    prepare(liveKey, true);
+    const QSSGRhiShaderResourceBindingList staleBindings = prepare(staleKey, true);
+    const QSSGRhiShaderResourceBindingList unkeyedBindings = prepare(unkeyedKey, false);
+    QCOMPARE(rhiCtxD->m_drawCallData.size(), qsizetype(3));
+    QCOMPARE(rhiCtxD->m_srbCache.size(), qsizetype(3));
+
+    // Entries are released 600 frames after their last use, the live one is
+    // used in every frame
+    for (int frame = 0; frame != 600; ++frame) {
+        rhiCtxD->beginFrame();
+        prepare(liveKey, true);
+    }
+    QCOMPARE(rhiCtxD->m_drawCallData.size(), qsizetype(3));
+    QCOMPARE(rhiCtxD->m_stats.globalInfo.drawCallDataEvictions, quint64(0));
+
+    rhiCtxD->beginFrame();
+    prepare(liveKey, true);
+    QCOMPARE(rhiCtxD->m_drawCallData.size(), qsizetype(1));
+    QVERIFY(rhiCtxD->m_drawCallData.find(liveKey));
+    QVERIFY(!rhiCtxD->m_drawCallData.find(staleKey));
+    QVERIFY(!rhiCtxD->m_drawCallData.find(unkeyedKey));
+    QCOMPARE(rhiCtxD->m_stats.globalInfo.drawCallDataEvictions, quint64(2));
+
+    // The srb of the entry goes with it, one that was not obtained through the
+    // entry stays in the cache
+    QVERIFY(!rhiCtxD->m_srbCache.find(staleBindings));
+    QVERIFY(rhiCtxD->m_srbCache.find(unkeyedBindings));
+    QCOMPARE(rhiCtxD->m_srbCache.size(), qsizetype(2));
+
+    // The live entry kept its resources
+    const QSSGRhiDrawCallData *liveData = rhiCtxD->m_drawCallData.find(liveKey);
+    QVERIFY(liveData->ubuf);
+    QVERIFY(liveData->srb);
+    QRhiShaderResourceBindings **cachedSrb = rhiCtxD->m_srbCache.find(liveData->bindings);
+    QVERIFY(cachedSrb);
+    QCOMPARE(*cachedSrb, liveData->srb);
+}
+
+QTEST_APPLESS_MAIN(tst_QSSGRhiContext)
+#include "tst_qssgrhicontext.moc"
@@ -0,0 +1,317 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderlayer_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgtransformhierarchy_p.h>
+
+#include <memory>
+#include <vector>
+
+class tst_QSSGTransformHierarchy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+    void testPartition();
+    void testChildDirty();
+    void testUpdate();
+    void testParallelUpdate();
+    void testInactiveSpineNode();
+    void testSync();
+
+private:
+    // Every node is moved by one along x, so the global x of a node is its depth
+    QSSGRenderNode *createNode(QSSGRenderNode &parent)
+    {
+        m_nodes.push_back(std::make_unique<QSSGRenderNode>());
+        QSSGRenderNode *node = m_nodes.back().get();
+        node->localTransform.translate(1.0f, 0.0f, 0.0f);
+        parent.addChild(*node);
+        return node;
+    }
+
+    QSSGRenderNode *createSubtree(QSSGRenderNode &parent, int leafCount)
+    {
+        QSSGRenderNode *node = createNode(parent);
+        for (int i = 0; i != leafCount; ++i)
+            createNode(*node);
+        return node;
+    }
+
+    static QSSGRenderNode *child(QSSGRenderNode &node, int index)
+    {
+        auto it = node.children.begin();
+        while (index--)
+            ++it;
+        return &*it;
+    }
+
+    static bool isClean(const QSSGRenderNode &node)
+    {
+        return !node.isDirty(QSSGRenderNode::DirtyFlag::GlobalValuesDirty)
+                && !node.isDirty(QSSGRenderNode::DirtyFlag::ChildDirty);
+    }
+
+    static float depth(const QSSGRenderNode &node) { return node.globalTransform.column(3).x(); }
+
+    std::vector<std::unique_ptr<QSSGRenderNode>> m_nodes;
+};
+
+void tst_QSSGTransformHierarchy::cleanup()
+{
+    m_nodes.clear();
+}
+
+void tst_QSSGTransformHierarchy::testPartition()
+{
+    // The batches are cut at 2048 nodes, a subtree larger than that is
+    // split over its children
+    QSSGRenderLayer layer;
+    QSSGRenderNode *a = createSubtree(layer, 9);
+    QSSGRenderNode *b = createNode(layer);
+    QSSGRenderNode *b1 = createSubtree(*b, 1499);
+    QSSGRenderNode *b2 = createSubtree(*b, 1499);
+    QSSGRenderNode *b3 = createSubtree(*b, 1499);
+    QSSGRenderNode *c = createSubtree(layer, 4);
+
+    QSSGTransformHierarchy hierarchy;
+    QVERIFY(hierarchy.sync(layer));
+    QCOMPARE(hierarchy.size(), qsizetype(10 + 4501 + 5));
+
+    // Depth-first order
+    QCOMPARE(hierarchy.node(0), a);
+    QCOMPARE(hierarchy.subtreeEnd(0), 10);
+    QCOMPARE(hierarchy.node(1), child(*a, 0));
+    QCOMPARE(hierarchy.subtreeEnd(1), 2);
+    QCOMPARE(hierarchy.node(10), b);
+    QCOMPARE(hierarchy.subtreeEnd(10), 4511);
+    QCOMPARE(hierarchy.node(11), b1);
+    QCOMPARE(hierarchy.subtreeEnd(11), 1511);
+    QCOMPARE(hierarchy.node(1511), b2);
+    QCOMPARE(hierarchy.node(3011), b3);
+    QCOMPARE(hierarchy.subtreeEnd(3011), 4511);
+    QCOMPARE(hierarchy.node(4511), c);
+    QCOMPARE(hierarchy.subtreeEnd(4511), 4516);
+
+    const QVector<QSSGTransformHierarchy::SpineNode> &spine = hierarchy.spine();
+    QCOMPARE(spine.size(), qsizetype(1));
+    QCOMPARE(spine.at(0).index, 10);
+    QCOMPARE(spine.at(0).parent, -1);
+
+    // The siblings before the spine node, two children of b that fill a batch,
+    // the remaining child of b, and the siblings after it
+    const QVector<QSSGTransformHierarchy::Batch> &batches = hierarchy.batches();
+    QCOMPARE(batches.size(), qsizetype(4));
+    QCOMPARE(batches.at(0).begin, 0);
+    QCOMPARE(batches.at(0).end, 10);
+    QCOMPARE(batches.at(0).parent, -1);
+    QCOMPARE(batches.at(1).begin, 11);
+    QCOMPARE(batches.at(1).end, 3011);
+    QCOMPARE(batches.at(1).parent, 0);
+    QCOMPARE(batches.at(2).begin, 3011);
+    QCOMPARE(batches.at(2).end, 4511);
+    QCOMPARE(batches.at(2).parent, 0);
+    QCOMPARE(batches.at(3).begin, 4511);
+    QCOMPARE(batches.at(3).end, 4516);
+    QCOMPARE(batches.at(3).parent, -1);
+}
+
+void tst_QSSGTransformHierarchy::testChildDirty()
+{
+    QSSGRenderLayer layer;
+    QSSGRenderNode *root = createNode(layer);
+    QSSGRenderNode *middle = createSubtree(*root, 2);
+    QSSGRenderNode *leaf = child(*middle, 0);
+    QSSGRenderNode *sibling = createSubtree(*root, 2);
+
+    QSSGTransformHierarchy hierarchy;
+    QVERIFY(hierarchy.sync(layer));
+    QVERIFY(hierarchy.update());
+    for (qsizetype i = 0; i != hierarchy.size(); ++i)
+        QVERIFY(isClean(*hierarchy.node(i)));
+
+    // The ancestors of a dirty node know, the rest of the tree does not
+    leaf->markDirty(QSSGRenderNode::DirtyFlag::TransformDirty);
+    QVERIFY(leaf->isDirty(QSSGRenderNode::DirtyFlag::TransformDirty));
+    QVERIFY(!leaf->isDirty(QSSGRenderNode::DirtyFlag::ChildDirty));
+    QVERIFY(middle->isDirty(QSSGRenderNode::DirtyFlag::ChildDirty));
+    QVERIFY(!middle->isDirty(QSSGRenderNode::DirtyFlag::GlobalValuesDirty));
+    QVERIFY(root->isDirty(QSSGRenderNode::DirtyFlag::ChildDirty));
+    QVERIFY(isClean(*sibling));
+    QVERIFY(isClean(*child(*middle, 1)));
+    QVERIFY(hierarchy.update());
+    QVERIFY(isClean(*leaf));
+    QVERIFY(isClean(*middle));
+    QVERIFY(isClean(*root));
+
+    // Marking a node with children marks them too
+    middle->markDirty(QSSGRenderNode::DirtyFlag::OpacityDirty);
+    QVERIFY(middle->isDirty(QSSGRenderNode::DirtyFlag::OpacityDirty));
+    QVERIFY(middle->isDirty(QSSGRenderNode::DirtyFlag::ChildDirty));
+    QVERIFY(leaf->isDirty(QSSGRenderNode::DirtyFlag::OpacityDirty));
+    QVERIFY(root->isDirty(QSSGRenderNode::DirtyFlag::ChildDirty));
+    QVERIFY(isClean(*sibling));
+    QVERIFY(hierarchy.update());
+
+    // The walk up stops at the first ancestor that already knows
+    middle->flags |= QSSGRenderNode::FlagT(QSSGRenderNode::DirtyFlag::ChildDirty);
+    leaf->markDirty(QSSGRenderNode::DirtyFlag::TransformDirty);
+    QVERIFY(!root->isDirty(QSSGRenderNode::DirtyFlag::ChildDirty));
+    // Which is why a subtree without it is skipped as a whole
+    QVERIFY(!hierarchy.update());
+    QVERIFY(leaf->isDirty(QSSGRenderNode::DirtyFlag::TransformDirty));
+    root->flags |= QSSGRenderNode::FlagT(QSSGRenderNode::DirtyFlag::ChildDirty);
+    QVERIFY(hierarchy.update());
+    QVERIFY(isClean(*leaf));
+
+    // Flags other than the global values do not concern the ancestors
+    sibling->markDirty(QSSGRenderNode::DirtyFlag::SubNodeDirty);
+    QVERIFY(!root->isDirty(QSSGRenderNode::DirtyFlag::ChildDirty));
+    sibling->clearDirty(QSSGRenderNode::DirtyFlag::SubNodeDirty);
+}
+
+void tst_QSSGTransformHierarchy::testUpdate()
+{
+    QSSGRenderLayer layer;
+    QSSGRenderNode *root = createNode(layer);
+    QSSGRenderNode *middle = createSubtree(*root, 2);
+    QSSGRenderNode *leaf = child(*middle, 0);
+    QSSGRenderNode *otherLeaf = child(*middle, 1);
+
+    QSSGTransformHierarchy hierarchy;
+    QVERIFY(hierarchy.sync(layer));
+    QVERIFY(hierarchy.update());
+    QCOMPARE(depth(*root), 1.0f);
+    QCOMPARE(depth(*middle), 2.0f);
+    QCOMPARE(depth(*leaf), 3.0f);
+    QCOMPARE(depth(*otherLeaf), 3.0f);
+    QVERIFY(leaf->getGlobalState(QSSGRenderNode::GlobalState::Active));
+
+    // Nothing dirty, nothing to do
+    QVERIFY(!hierarchy.update());
+
+    // Only the dirty node is calculated, this value would be overwritten
+    // if the clean sibling was too
+    otherLeaf->globalTransform = QMatrix4x4();
+    leaf->localTransform.translate(1.0f, 0.0f, 0.0f);
+    leaf->markDirty(QSSGRenderNode::DirtyFlag::TransformDirty);
+    QVERIFY(hierarchy.update());
+    QCOMPARE(depth(*leaf), 4.0f);
+    QCOMPARE(depth(*otherLeaf), 0.0f);
+
+    // A change to an ancestor reaches every descendant
+    root->localTransform.translate(10.0f, 0.0f, 0.0f);
+    root->markDirty(QSSGRenderNode::DirtyFlag::TransformDirty);
+    QVERIFY(hierarchy.update());
+    QCOMPARE(depth(*root), 11.0f);
+    QCOMPARE(depth(*middle), 12.0f);
+    QCOMPARE(depth(*leaf), 14.0f);
+    QCOMPARE(depth(*otherLeaf), 13.0f);
+
+    // Inactive subtrees are skipped and stay dirty until they are active again
+    middle->setState(QSSGRenderNode::LocalState::Active, false);
+    QVERIFY(!hierarchy.update()); // no active node changed
+    QVERIFY(!middle->getGlobalState(QSSGRenderNode::GlobalState::Active));
+    QVERIFY(leaf->isDirty(QSSGRenderNode::DirtyFlag::GlobalValuesDirty));
+    middle->setState(QSSGRenderNode::LocalState::Active, true);
+    QVERIFY(hierarchy.update());
+    QVERIFY(leaf->getGlobalState(QSSGRenderNode::GlobalState::Active));
+    QVERIFY(isClean(*leaf));
+}
+
+void tst_QSSGTransformHierarchy::testParallelUpdate()
+{
+    // Enough dirty batches to be spread over the threads
+    QSSGRenderLayer layer;
+    for (int i = 0; i != 10; ++i)
+        createSubtree(layer, 2000);
+
+    QSSGTransformHierarchy hierarchy;
+    QVERIFY(hierarchy.sync(layer));
+    QVERIFY(hierarchy.spine().isEmpty());
+    QCOMPARE(hierarchy.batches().size(), qsizetype(5));
+    QVERIFY(hierarchy.update());
+    for (qsizetype i = 0; i != hierarchy.size(); ++i) {
+        const QSSGRenderNode &node = *hierarchy.node(i);
+        QVERIFY(isClean(node));
+        QCOMPARE(depth(node), node.parent ? 2.0f : 1.0f);
+    }
+
+    for (auto &child : layer.children) {
+        child.localTransform.translate(1.0f, 0.0f, 0.0f);
+        child.markDirty(QSSGRenderNode::DirtyFlag::TransformDirty);
+    }
+    QVERIFY(hierarchy.update());
+    for (qsizetype i = 0; i != hierarchy.size(); ++i) {
+        const QSSGRenderNode &node = *hierarchy.node(i);
+        QVERIFY(isClean(node));
+        QCOMPARE(depth(node), node.parent ? 3.0f : 2.0f);
+    }
+}
+
+void tst_QSSGTransformHierarchy::testInactiveSpineNode()
+{
+    QSSGRenderLayer layer;
+    QSSGRenderNode *small = createSubtree(layer, 9);
+    QSSGRenderNode *large = createNode(layer);
+    createSubtree(*large, 1499);
+    createSubtree(*large, 1499);
+    createSubtree(*large, 1499);
+
+    QSSGTransformHierarchy hierarchy;
+    QVERIFY(hierarchy.sync(layer));
+    QCOMPARE(hierarchy.spine().size(), qsizetype(1));
+    QCOMPARE(hierarchy.node(hierarchy.spine().at(0).index), large);
+    QVERIFY(hierarchy.update());
+
+    // The batches under the inactive spine node are not touched
+    large->setState(QSSGRenderNode::LocalState::Active, false);
+    small->markDirty(QSSGRenderNode::DirtyFlag::TransformDirty);
+    QVERIFY(hierarchy.update());
+    QVERIFY(!large->getGlobalState(QSSGRenderNode::GlobalState::Active));
+    QVERIFY(isClean(*small));
+    for (qsizetype i = hierarchy.spine().at(0).index + 1; i != hierarchy.size(); ++i)
+        QVERIFY(hierarchy.node(i)->isDirty(QSSGRenderNode::DirtyFlag::ActiveDirty));
+
+    large->setState(QSSGRenderNode::LocalState::Active, true);
+    QVERIFY(hierarchy.update());
+    for (qsizetype i = 0; i != hierarchy.size(); ++i) {
+        QVERIFY(isClean(*hierarchy.node(i)));
+        QVERIFY(hierarchy.node(i)->getGlobalState(QSSGRenderNode::GlobalState::Active));
+    }
+}
+
+void tst_QSSGTransformHierarchy::testSync()
+{
+    QSSGRenderLayer layer;
+    QSSGRenderNode *root = createSubtree(layer, 2);
+
+    QSSGTransformHierarchy hierarchy;
+    QVERIFY(hierarchy.sync(layer));
+    QCOMPARE(hierarchy.size(), qsizetype(3));
+    QVERIFY(!hierarchy.sync(layer));
+
+    // Structure changes rebuild the arrays
+    QSSGRenderNode *added = createNode(*root);
+    QVERIFY(hierarchy.sync(layer));
+    QCOMPARE(hierarchy.size(), qsizetype(4));
+    QCOMPARE(hierarchy.node(3), added);
+    QCOMPARE(hierarchy.subtreeEnd(0), 4);
+    QVERIFY(!hierarchy.sync(layer));
+
+    root->removeChild(*added);
+    QVERIFY(hierarchy.sync(layer));
+    QCOMPARE(hierarchy.size(), qsizetype(3));
+
+    // Active state changes keep the arrays, but the nodes to render change
+    added->setState(QSSGRenderNode::LocalState::Active, false);
+    QVERIFY(hierarchy.sync(layer));
+    QCOMPARE(hierarchy.size(), qsizetype(3));
+    QVERIFY(!hierarchy.sync(layer));
+}
+
+QTEST_APPLESS_MAIN(tst_QSSGTransformHierarchy)
+#include "tst_qssgtransformhierarchy.moc"
@@ -38,8 +38,25 @@ private slots:
     void staticScene_data();
     void staticScene();
     void dynamicScene();
+    void textureStreamingBudget();
+    void textureStreamingEviction();
+    void textureMemoryBudget();
 
 private:
+    static QSSGBufferManager::StreamedTexture streamedTexture(int size, int residentLevel, bool used, int requestedLevel)
+    {
+        QSSGBufferManager::StreamedTexture streamed;
+        streamed.rhiFormat = QRhiTexture::RGBA8;
+        streamed.size = QSize(size, size);
+        streamed.levelCount = int(std::log2(size)) + 1;
+        while ((size >> streamed.baseLevel) > 256)
+            ++streamed.baseLevel;
+        streamed.residentLevel = residentLevel;
+        streamed.used = used;
+        streamed.requestedLevel = requestedLevel;
+        return streamed;
+    }
+
     bool initRenderer(QQuick3DTestOffscreenRenderer *renderer, const QString &filename);
 #if QT_CONFIG(vulkan)
     QVulkanInstance vulkanInstance;
@@ -339,5 +356,137 @@ bool tst_BufferManager::initRenderer(QQuick3DTestOffscreenRenderer *renderer, co
     return initSuccess;
 }
 
+void tst_BufferManager::textureStreamingBudget()
+{
+    constexpr quint64 MB = 1024 * 1024;
+
+    // 1024x1024 RGBA8 is 4 MB at level 0, 1 MB at level 1 and 256 KB at the
+    // base level 2. Both want full detail, only one of them gets it.
+    QSSGBufferManager::StreamedTexture a = streamedTexture(1024, 2, true, 0);
+    QSSGBufferManager::StreamedTexture b = streamedTexture(1024, 2, true, 0);
+    QCOMPARE(a.baseLevel, 2);
+    quint64 totalSize = QSSGBufferManager::selectStreamedTextureLevels({ &a, &b }, MB / 2, 6 * MB, 1);
+    QCOMPARE(totalSize, 5 * MB);
+    QCOMPARE(qMin(a.targetLevel, b.targetLevel), 0);
+    QCOMPARE(qMax(a.targetLevel, b.targetLevel), 1);
+    QCOMPARE(a.desiredLevel, 0);
+    QCOMPARE(b.desiredLevel, 0);
+
+    // Used without a request, by a custom material for instance
+    QSSGBufferManager::StreamedTexture c = streamedTexture(1024, 2, true, -1);
+    totalSize = QSSGBufferManager::selectStreamedTextureLevels({ &c }, MB / 4, 6 * MB, 1);
+    QCOMPARE(c.targetLevel, 0);
+    QCOMPARE(totalSize, 4 * MB);
+
+    // Requesting less than the base level still keeps the base level
+    QSSGBufferManager::StreamedTexture d = streamedTexture(1024, 2, true, 5);
+    totalSize = QSSGBufferManager::selectStreamedTextureLevels({ &d }, MB / 4, 6 * MB, 1);
+    QCOMPARE(d.desiredLevel, 2);
+    QCOMPARE(d.targetLevel, 2);
+    QCOMPARE(totalSize, MB / 4);
+
+    // At most 16 MB is loaded per frame, 2048x2048 RGBA8 is 16 MB at level 0
+    QList<QSSGBufferManager::StreamedTexture> large(4, streamedTexture(2048, 3, true, 0));
+    QList<QSSGBufferManager::StreamedTexture *> textures;
+    for (auto &streamed : large)
+        textures.append(&streamed);
+    totalSize = QSSGBufferManager::selectStreamedTextureLevels(textures, 4 * MB / 4, 1024 * MB, 1);
+    QCOMPARE(std::count_if(large.cbegin(), large.cend(), [](const auto &streamed) { return streamed.targetLevel == 0; }), qsizetype(1));
+    QCOMPARE(std::count_if(large.cbegin(), large.cend(), [](const auto &streamed) { return streamed.targetLevel == 3; }), qsizetype(3));
+    QCOMPARE(totalSize, 16 * MB + 3 * MB / 4);
+}
+
+void tst_BufferManager::textureStreamingEviction()
+{
+    constexpr quint64 MB = 1024 * 1024;
+
+    // Room for c is made by dropping the levels of a, which was not used in
+    // this frame, while b keeps the ones it needs
+    QSSGBufferManager::StreamedTexture a = streamedTexture(1024, 0, false, -1);
+    QSSGBufferManager::StreamedTexture b = streamedTexture(1024, 0, true, 0);
+    QSSGBufferManager::StreamedTexture c = streamedTexture(1024, 2, true, 0);
+    a.lastNeededFrame = 5;
+    quint64 totalSize = QSSGBufferManager::selectStreamedTextureLevels({ &a, &b, &c }, 8 * MB + MB / 4, 8 * MB + MB / 2, 10);
+    QCOMPARE(a.targetLevel, 2);
+    QCOMPARE(b.targetLevel, 0);
+    QCOMPARE(c.targetLevel, 0);
+    QCOMPARE(a.lastNeededFrame, 5u);
+    QCOMPARE(b.lastNeededFrame, 10u);
+    QCOMPARE(c.lastNeededFrame, 10u);
+    QCOMPARE(totalSize, 8 * MB + MB / 4);
+
+    // Without pressure on the budget, nothing is dropped
+    a = streamedTexture(1024, 0, false, -1);
+    totalSize = QSSGBufferManager::selectStreamedTextureLevels({ &a }, 4 * MB, 8 * MB, 11);
+    QCOMPARE(a.targetLevel, 0);
+    QCOMPARE(totalSize, 4 * MB);
+
+    // The levels needed least recently go first, even when a more recently
+    // needed texture is larger. Neither needs its level 0 anymore.
+    a = streamedTexture(512, 0, true, 1);
+    b = streamedTexture(1024, 0, true, 2);
+    a.lastNeededFrame = 3;
+    b.lastNeededFrame = 11;
+    totalSize = QSSGBufferManager::selectStreamedTextureLevels({ &a, &b }, 5 * MB, 4 * MB + MB / 2, 12);
+    QCOMPARE(a.targetLevel, 1);
+    QCOMPARE(b.targetLevel, 0);
+    QCOMPARE(totalSize, 4 * MB + MB / 4);
+
+    // When the needed levels do not fit either, they are dropped too, but
+    // never below the base level
+    a = streamedTexture(1024, 0, true, 0);
+    b = streamedTexture(1024, 0, true, 0);
+    totalSize = QSSGBufferManager::selectStreamedTextureLevels({ &a, &b }, 8 * MB, 5 * MB, 13);
+    QCOMPARE(qMin(a.targetLevel, b.targetLevel), 0);
+    QCOMPARE(qMax(a.targetLevel, b.targetLevel), 1);
+    QCOMPARE(totalSize, 5 * MB);
+
+    totalSize = QSSGBufferManager::selectStreamedTextureLevels({ &a, &b }, 8 * MB, MB / 4, 14);
+    QCOMPARE(a.targetLevel, 2);
+    QCOMPARE(b.targetLevel, 2);
+    QCOMPARE(totalSize, MB / 2);
+}
+
+void tst_BufferManager::textureMemoryBudget()
+{
+    if (qEnvironmentVariableIsSet("QT_QUICK3D_TEXTURE_MEMORY_BUDGET"))
+        QSKIP("The texture memory budget is set in the environment");
+
+    constexpr quint64 MB = 1024 * 1024;
+
+    QQuick3DTestOffscreenRenderer renderer;
+    QVERIFY(initRenderer(&renderer, QString("pathedTexturesShared.qml")));
+    auto *view3D = qobject_cast<QQuick3DViewport *>(renderer.rootItem);
+    QVERIFY(view3D);
+
+    bool readCompleted = false;
+    QRhiReadbackResult readResult;
+    QImage result;
+
+    renderNextFrame(&renderer, &readCompleted, &readResult, &result);
+    const auto &context = QQuick3DSceneManager::getOrSetWindowAttachment(*renderer.quickWindow)->rci();
+    QVERIFY(context);
+    const auto &bufferManager = context->bufferManager();
+    QVERIFY(!bufferManager->isTextureStreamingEnabled());
+
+    view3D->setTextureMemoryBudget(64);
+    renderNextFrame(&renderer, &readCompleted, &readResult, &result);
+    QCOMPARE(bufferManager->textureMemoryBudget(), 64 * MB);
+    QVERIFY(bufferManager->isTextureStreamingEnabled());
+
+    // Like the View3Ds of a window in one frame, the largest budget applies
+    bufferManager->requestTextureMemoryBudget(32 * MB);
+    bufferManager->requestTextureMemoryBudget(128 * MB);
+    bufferManager->requestTextureMemoryBudget(0);
+    QCOMPARE(bufferManager->textureMemoryBudget(), 128 * MB);
+    bufferManager->endStreamingFrame();
+    renderNextFrame(&renderer, &readCompleted, &readResult, &result);
+    QCOMPARE(bufferManager->textureMemoryBudget(), 64 * MB);
+
+    view3D->setTextureMemoryBudget(0);
+    renderNextFrame(&renderer, &readCompleted, &readResult, &result);
+    QVERIFY(!bufferManager->isTextureStreamingEnabled());
+}
+
 QTEST_MAIN(tst_BufferManager)
 #include "tst_buffermanager.moc"
@@ -0,0 +1,27 @@
+import QtQuick
+import QtQuick3D
+import QtQuick3D.Helpers
+
+Item {
+    width: 400
+    height: 400
+
+    View3D {
+        anchors.fill: parent
+
+        PerspectiveCamera {
+            id: camera
+            objectName: "camera"
+            y: 100000
+            eulerRotation.x: -90
+            clipFar: 200000
+        }
+
+        HeightFieldTerrain {
+            objectName: "terrain"
+            camera: camera
+            chunkResolution: 16
+            materials: PrincipledMaterial { }
+        }
+    }
+}
@@ -0,0 +1,143 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QtCore/qmath.h>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickView>
+
+#include <QtQuick3D/qquick3dgeometry.h>
+#include <QtQuick3D/private/qquick3dcamera_p.h>
+#include <QtQuick3D/private/qquick3dmodel_p.h>
+#include <QtQuick3D/private/qquick3dnode_p.h>
+
+#include "../shared/util.h"
+
+class tst_HeightFieldTerrain : public QQuick3DDataTest
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() override;
+    void test_selection();
+    void test_extents();
+
+private:
+    // The number of visible chunks and the area they cover on the xz plane
+    static int visibleChunks(QObject *terrain, float *area)
+    {
+        int count = 0;
+        *area = 0.0f;
+        const auto models = terrain->findChildren<QQuick3DModel *>(Qt::FindDirectChildrenOnly);
+        for (const QQuick3DModel *model : models) {
+            if (!model->visible() || !model->geometry())
+                continue;
+            const QVector3D size = model->geometry()->boundsMax() - model->geometry()->boundsMin();
+            *area += size.x() * size.z();
+            ++count;
+        }
+        return count;
+    }
+
+    // Waits for the given number of chunks to be shown. While the detail
+    // changes, the visible chunks must always cover the whole terrain.
+    static bool waitForChunks(QObject *terrain, int count, float expectedArea)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        float area = 0.0f;
+        int visible = visibleChunks(terrain, &area);
+        while (visible != count || terrain->property("loading").toBool()) {
+            if (timer.elapsed() > 10000) {
+                qWarning("Got %d chunks instead of %d", visible, count);
+                return false;
+            }
+            QTest::qWait(10);
+            visible = visibleChunks(terrain, &area);
+            if (visible > 0 && qAbs(area - expectedArea) > 0.01f * expectedArea) {
+                qWarning("The %d visible chunks cover %f instead of %f", visible, area, expectedArea);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_heightMapFile;
+};
+
+void tst_HeightFieldTerrain::initTestCase()
+{
+    QQuick3DDataTest::initTestCase();
+    if (!initialized())
+        return;
+
+    // Bumpy enough for every level to have a noticeable error. 65 samples
+    // make four chunks of 16 squares across, two levels below the root.
+    QVERIFY(m_tempDir.isValid());
+    QImage heightMap(65, 65, QImage::Format_Grayscale16);
+    for (int y = 0; y < heightMap.height(); ++y) {
+        auto *line = reinterpret_cast<quint16 *>(heightMap.scanLine(y));
+        for (int x = 0; x < heightMap.width(); ++x)
+            line[x] = quint16(32767.5 + 32767.0 * qSin(x * 0.8) * qCos(y * 0.8));
+    }
+    m_heightMapFile = m_tempDir.filePath(QStringLiteral("heightmap.png"));
+    QVERIFY(heightMap.save(m_heightMapFile));
+}
+
+void tst_HeightFieldTerrain::test_selection()
+{
+    QScopedPointer<QQuickView> view(createView(QLatin1String("heightfieldterrain.qml"), QSize(400, 400)));
+    QVERIFY(view);
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+
+    QObject *terrain = view->rootObject()->findChild<QQuick3DNode *>(QStringLiteral("terrain"));
+    QVERIFY(terrain);
+    QObject *camera = view->rootObject()->findChild<QQuick3DNode *>(QStringLiteral("camera"));
+    QVERIFY(camera);
+
+    terrain->setProperty("source", QUrl::fromLocalFile(m_heightMapFile));
+    QVERIFY(terrain->property("loading").toBool());
+    // Far away, the root chunk is enough
+    QVERIFY(waitForChunks(terrain, 1, 100.0f * 100.0f));
+    QCOMPARE(terrain->property("extents").value<QVector3D>(), QVector3D(100, 100, 100));
+
+    // Close by, the leaves everywhere
+    camera->setProperty("y", 60.0f);
+    QVERIFY(waitForChunks(terrain, 16, 100.0f * 100.0f));
+
+    // And back again, no holes while coarsening either
+    camera->setProperty("y", 100000.0f);
+    QVERIFY(waitForChunks(terrain, 1, 100.0f * 100.0f));
+    camera->setProperty("y", 60.0f);
+    QVERIFY(waitForChunks(terrain, 16, 100.0f * 100.0f));
+
+    // Without a camera, the lowest detail
+    terrain->setProperty("camera", QVariant::fromValue(static_cast<QQuick3DCamera *>(nullptr)));
+    QVERIFY(waitForChunks(terrain, 1, 100.0f * 100.0f));
+}
+
+void tst_HeightFieldTerrain::test_extents()
+{
+    QScopedPointer<QQuickView> view(createView(QLatin1String("heightfieldterrain.qml"), QSize(400, 400)));
+    QVERIFY(view);
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+
+    QObject *terrain = view->rootObject()->findChild<QQuick3DNode *>(QStringLiteral("terrain"));
+    QVERIFY(terrain);
+
+    // Changing the extents while the height map loads does not drop it
+    terrain->setProperty("source", QUrl::fromLocalFile(m_heightMapFile));
+    terrain->setProperty("extents", QVector3D(200, 50, 200));
+    QVERIFY(waitForChunks(terrain, 1, 200.0f * 200.0f));
+    QCOMPARE(terrain->property("extents").value<QVector3D>(), QVector3D(200, 50, 200));
+
+    // Once loaded, the chunks are generated again
+    terrain->setProperty("extents", QVector3D(300, 50, 100));
+    QVERIFY(waitForChunks(terrain, 1, 300.0f * 100.0f));
+}
+
+QTEST_MAIN(tst_HeightFieldTerrain)
+#include "tst_heightfieldterrain.moc"
@@ -0,0 +1,33 @@
+import QtQuick
+import QtQuick3D
+
+Item {
+    width: 400
+    height: 400
+
+    View3D {
+        anchors.fill: parent
+
+        environment: SceneEnvironment {
+            objectName: "environment"
+            backgroundMode: SceneEnvironment.Color
+            clearColor: "black"
+        }
+
+        PerspectiveCamera {
+            z: 600
+        }
+
+        Node {
+            objectName: "panel"
+            Rectangle {
+                objectName: "rect"
+                x: -100
+                y: -100
+                width: 200
+                height: 200
+                color: "red"
+            }
+        }
+    }
+}
@@ -0,0 +1,193 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickView>
+
+#include <QtQuick3D/private/qquick3dobject_p.h>
+#include <QtQuick3D/private/qquick3dsceneenvironment_p.h>
+#include <QtQuick3D/private/qquick3ditem2d_p.h>
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderitem2d_p.h>
+#include <QtQuick3DRuntimeRender/private/qssglayerrenderdata_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderclippingfrustum_p.h>
+
+#include "../shared/util.h"
+
+class tst_Item2D : public QQuick3DDataTest
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() override;
+    void test_cachedRendering();
+    void test_bounds();
+    void test_frustumCulling();
+
+private:
+    static QSSGRenderItem2D *renderItem2D(QObject *node)
+    {
+        const QQuick3DItem2D *item2D = QQuick3DObjectPrivate::get(static_cast<QQuick3DObject *>(node))->contentItem2d;
+        return item2D ? static_cast<QSSGRenderItem2D *>(QQuick3DObjectPrivate::get(item2D)->spatialNode) : nullptr;
+    }
+};
+
+void tst_Item2D::initTestCase()
+{
+    QQuick3DDataTest::initTestCase();
+    if (!initialized())
+        return;
+}
+
+const int FUZZ = 5;
+
+void tst_Item2D::test_cachedRendering()
+{
+    QScopedPointer<QQuickView> view(createView(QLatin1String("item2d.qml"), QSize(400, 400)));
+    QVERIFY(view);
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+
+    auto *environment = view->rootObject()->findChild<QQuick3DSceneEnvironment *>(QStringLiteral("environment"));
+    QVERIFY(environment);
+    QObject *panel = view->rootObject()->findChild<QQuick3DObject *>(QStringLiteral("panel"));
+    QVERIFY(panel);
+    auto *rect = view->rootObject()->findChild<QQuickItem *>(QStringLiteral("rect"));
+    QVERIFY(rect);
+
+    QImage result = grab(view.data());
+    if (result.isNull())
+        return; // was QFAIL'ed already
+    const qreal dpr = view->devicePixelRatio();
+    QVERIFY(comparePixel(result, 200, 200, dpr, Qt::red, FUZZ));
+    QVERIFY(comparePixel(result, 20, 20, dpr, Qt::black, FUZZ));
+
+    // Drawn from the cached texture, same result
+    environment->setItem2DCachingEnabled(true);
+    result = grab(view.data());
+    if (result.isNull())
+        return;
+    QVERIFY(comparePixel(result, 200, 200, dpr, Qt::red, FUZZ));
+    QVERIFY(comparePixel(result, 20, 20, dpr, Qt::black, FUZZ));
+    QSSGRenderItem2D *item2D = renderItem2D(panel);
+    QVERIFY(item2D);
+    QVERIFY(item2D->m_texture);
+
+    // Changes to the 2D content update the texture
+    rect->setProperty("color", QColor(Qt::blue));
+    result = grab(view.data());
+    if (result.isNull())
+        return;
+    QVERIFY(comparePixel(result, 200, 200, dpr, Qt::blue, FUZZ));
+
+    // The opacity of the 3D nodes applies to the cached texture
+    panel->setProperty("opacity", 0.5);
+    result = grab(view.data());
+    if (result.isNull())
+        return;
+    QVERIFY(comparePixel(result, 200, 200, dpr, QColor(0, 0, 128), FUZZ));
+
+    // Turning the caching off releases the texture
+    panel->setProperty("opacity", 1.0);
+    environment->setItem2DCachingEnabled(false);
+    result = grab(view.data());
+    if (result.isNull())
+        return;
+    QVERIFY(comparePixel(result, 200, 200, dpr, Qt::blue, FUZZ));
+    QVERIFY(!item2D->m_texture);
+}
+
+void tst_Item2D::test_bounds()
+{
+    QScopedPointer<QQuickView> view(createView(QLatin1String("item2d.qml"), QSize(400, 400)));
+    QVERIFY(view);
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+
+    QObject *panel = view->rootObject()->findChild<QQuick3DObject *>(QStringLiteral("panel"));
+    QVERIFY(panel);
+    auto *rect = view->rootObject()->findChild<QQuickItem *>(QStringLiteral("rect"));
+    QVERIFY(rect);
+
+    if (grab(view.data()).isNull())
+        return;
+    QSSGRenderItem2D *item2D = renderItem2D(panel);
+    QVERIFY(item2D);
+    QCOMPARE(item2D->bounds, QRectF(-100, -100, 200, 200));
+
+    // The bounds follow the items in the same frame
+    rect->setWidth(300);
+    if (grab(view.data()).isNull())
+        return;
+    QCOMPARE(item2D->bounds, QRectF(-100, -100, 300, 200));
+
+    // Including items added later, but not the hidden ones
+    auto *child = new QQuickItem(rect);
+    child->setPosition(QPointF(250, 150));
+    child->setSize(QSizeF(100, 100));
+    if (grab(view.data()).isNull())
+        return;
+    QCOMPARE(item2D->bounds, QRectF(-100, -100, 350, 250));
+
+    child->setVisible(false);
+    if (grab(view.data()).isNull())
+        return;
+    QCOMPARE(item2D->bounds, QRectF(-100, -100, 300, 200));
+
+    // A clipping item cuts off its children
+    child->setVisible(true);
+    rect->setClip(true);
+    rect->setHeight(201);
+    if (grab(view.data()).isNull())
+        return;
+    QCOMPARE(item2D->bounds, QRectF(-100, -100, 300, 201));
+}
+
+void tst_Item2D::test_frustumCulling()
+{
+    // Camera at the origin looking down the negative z axis
+    QMatrix4x4 projection;
+    projection.perspective(60.0f, 1.0f, 1.0f, 1000.0f);
+    QSSGClipPlane nearPlane;
+    nearPlane.normal = QVector3D(0.0f, 0.0f, -1.0f);
+    nearPlane.d = -1.0f;
+    const QSSGClippingFrustum frustum(projection, nearPlane);
+
+    QSSGRenderItem2D inFront;
+    inFront.bounds = QRectF(-50, -50, 100, 100);
+    inFront.globalTransform.translate(0.0f, 0.0f, -500.0f);
+
+    QSSGRenderItem2D behind;
+    behind.bounds = QRectF(-50, -50, 100, 100);
+    behind.globalTransform.translate(0.0f, 0.0f, 500.0f);
+
+    QSSGRenderItem2D aside;
+    aside.bounds = QRectF(-50, -50, 100, 100);
+    aside.globalTransform.translate(2000.0f, 0.0f, -500.0f);
+
+    // Only its content reaches into the view
+    QSSGRenderItem2D reaching;
+    reaching.bounds = QRectF(-2000, -50, 2100, 100);
+    reaching.globalTransform.translate(2000.0f, 0.0f, -500.0f);
+
+    // Items without bounds are never culled
+    QSSGRenderItem2D empty;
+    empty.globalTransform.translate(0.0f, 0.0f, 500.0f);
+
+    // The 2D content is in the xy plane of the item with y pointing down,
+    // these bounds would be above the view without flipping them
+    QSSGRenderItem2D flipped;
+    flipped.bounds = QRectF(-50, 300, 100, 100);
+    flipped.globalTransform.translate(0.0f, 350.0f, -500.0f);
+
+    QSSGLayerRenderData::RenderableItem2DEntries item2Ds { &behind, &inFront, &aside, &reaching, &empty, &flipped };
+    const qsizetype visibleCount = QSSGLayerRenderData::frustumCullingInline(frustum, item2Ds);
+    QCOMPARE(visibleCount, 4);
+    // The order is kept, it is the drawing order
+    QCOMPARE(item2Ds.at(0), &inFront);
+    QCOMPARE(item2Ds.at(1), &reaching);
+    QCOMPARE(item2Ds.at(2), &empty);
+    QCOMPARE(item2Ds.at(3), &flipped);
+}
+
+QTEST_MAIN(tst_Item2D)
+#include "tst_item2d.moc"
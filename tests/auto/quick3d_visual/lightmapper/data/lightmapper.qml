@@ -0,0 +1,71 @@
+import QtQuick
+import QtQuick3D
+
+Item {
+    id: root
+    width: 200
+    height: 200
+
+    // Where the lightmaps and the bake states go
+    property string outputFolder
+
+    View3D {
+        objectName: "view"
+        anchors.fill: parent
+
+        environment: SceneEnvironment {
+            backgroundMode: SceneEnvironment.Color
+            clearColor: "black"
+            lightmapper: Lightmapper {
+                samples: 32
+                bounces: 2
+                passes: 4
+                incrementalBakingEnabled: true
+            }
+        }
+
+        PerspectiveCamera {
+            y: 200
+            z: 400
+            eulerRotation.x: -20
+        }
+
+        DirectionalLight {
+            eulerRotation.x: -60
+            bakeMode: Light.BakeModeAll
+        }
+
+        Model {
+            objectName: "floor"
+            source: "#Rectangle"
+            scale: Qt.vector3d(4, 4, 1)
+            eulerRotation.x: -90
+            usedInBakedLighting: true
+            lightmapBaseResolution: 64
+            bakedLightmap: BakedLightmap {
+                enabled: true
+                key: "floor"
+                loadPrefix: root.outputFolder
+            }
+            materials: PrincipledMaterial {
+                baseColor: "white"
+            }
+        }
+
+        Model {
+            objectName: "box"
+            source: "#Cube"
+            y: 50
+            usedInBakedLighting: true
+            lightmapBaseResolution: 64
+            bakedLightmap: BakedLightmap {
+                enabled: true
+                key: "box"
+                loadPrefix: root.outputFolder
+            }
+            materials: PrincipledMaterial {
+                baseColor: "red"
+            }
+        }
+    }
+}
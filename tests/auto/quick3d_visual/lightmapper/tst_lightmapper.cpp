@@ -0,0 +1,243 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <QtCore/qmutex.h>
+#include <QtCore/qscopeguard.h>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickView>
+
+#include <QtQuick3D/private/qquick3dviewport_p.h>
+#include <QtQuick3D/private/qquick3dlightmapbaker_p.h>
+
+#include <QtQuick3DRuntimeRender/private/qssglightmapper_p.h>
+
+#include "../shared/util.h"
+
+#include <atomic>
+#include <memory>
+
+class tst_Lightmapper : public QQuick3DDataTest
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() override;
+    void test_resume();
+    void test_incremental();
+    void test_denoiseEdges_data();
+    void test_denoiseEdges();
+
+private:
+    struct BakeOutput
+    {
+        QMutex mutex;
+        QStringList messages;
+        std::atomic<int> status = -1;
+    };
+
+    // Bakes the lightmaps of the view into outputFolder, cancelling once a
+    // message starting with cancelAfter was reported
+    static std::shared_ptr<BakeOutput> bake(QQuickView *view, const QString &outputFolder,
+                                            const QString &cancelAfter = QString());
+    static bool hasMessage(const BakeOutput &output, const QString &prefix);
+    static QByteArray readFile(const QString &fileName);
+};
+
+void tst_Lightmapper::initTestCase()
+{
+    QQuick3DDataTest::initTestCase();
+    if (!initialized())
+        return;
+    if (!QSSGLightmapper::isAvailable())
+        QSKIP("Qt Quick 3D was built without the lightmapper");
+}
+
+std::shared_ptr<tst_Lightmapper::BakeOutput> tst_Lightmapper::bake(QQuickView *view, const QString &outputFolder,
+                                                                   const QString &cancelAfter)
+{
+    auto *view3D = view->rootObject()->findChild<QQuick3DViewport *>(QStringLiteral("view"));
+    if (!view3D)
+        return nullptr;
+    view->rootObject()->setProperty("outputFolder", QUrl::fromLocalFile(outputFolder).toString());
+
+    // The callback is invoked on the render thread
+    auto output = std::make_shared<BakeOutput>();
+    view3D->lightmapBaker()->bake([output, cancelAfter](QQuick3DLightmapBaker::BakingStatus status,
+                                                        std::optional<QString> msg,
+                                                        QQuick3DLightmapBaker::BakingControl *control) {
+        if (msg.has_value()) {
+            QMutexLocker locker(&output->mutex);
+            output->messages.append(msg.value());
+            if (!cancelAfter.isEmpty() && msg->startsWith(cancelAfter))
+                control->requestCancel();
+        }
+        if (status == QQuick3DLightmapBaker::BakingStatus::Complete
+                || status == QQuick3DLightmapBaker::BakingStatus::Cancelled) {
+            output->status = int(status);
+        }
+    });
+    if (!QTest::qWaitFor([&output] { return output->status >= 0; }, 120000))
+        return nullptr;
+    return output;
+}
+
+bool tst_Lightmapper::hasMessage(const BakeOutput &output, const QString &prefix)
+{
+    for (const QString &message : output.messages) {
+        if (message.startsWith(prefix))
+            return true;
+    }
+    return false;
+}
+
+QByteArray tst_Lightmapper::readFile(const QString &fileName)
+{
+    QFile f(fileName);
+    return f.open(QIODevice::ReadOnly) ? f.readAll() : QByteArray();
+}
+
+void tst_Lightmapper::test_resume()
+{
+    QScopedPointer<QQuickView> view(createView(QLatin1String("lightmapper.qml"), QSize(200, 200)));
+    QVERIFY(view);
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+
+    // The list of lightmaps goes to the current directory
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString previousDir = QDir::currentPath();
+    QVERIFY(QDir::setCurrent(tempDir.path()));
+    const auto restoreDir = qScopeGuard([&previousDir] { QDir::setCurrent(previousDir); });
+    QVERIFY(QDir(tempDir.path()).mkdir(QStringLiteral("uninterrupted")));
+    QVERIFY(QDir(tempDir.path()).mkdir(QStringLiteral("resumed")));
+    const QString uninterruptedDir = tempDir.filePath(QStringLiteral("uninterrupted"));
+    const QString resumedDir = tempDir.filePath(QStringLiteral("resumed"));
+
+    auto output = bake(view.data(), uninterruptedDir);
+    QVERIFY(output);
+    QCOMPARE(output->status.load(), int(QQuick3DLightmapBaker::BakingStatus::Complete));
+
+    // Stopped after the first of the four passes, the state of which is kept
+    output = bake(view.data(), resumedDir, QStringLiteral("Intermediate lightmaps written after pass 1"));
+    QVERIFY(output);
+    QCOMPARE(output->status.load(), int(QQuick3DLightmapBaker::BakingStatus::Cancelled));
+    QVERIFY(QFile::exists(resumedDir + QStringLiteral("/qlm_floor.state")));
+    QVERIFY(QFile::exists(resumedDir + QStringLiteral("/qlm_box.state")));
+
+    output = bake(view.data(), resumedDir);
+    QVERIFY(output);
+    QCOMPARE(output->status.load(), int(QQuick3DLightmapBaker::BakingStatus::Complete));
+    QVERIFY(hasMessage(*output, QStringLiteral("Resuming model floor from ")));
+    QVERIFY(hasMessage(*output, QStringLiteral("Resuming model box from ")));
+
+    // The samples are seeded per texel and sample, so continuing the bake
+    // gives the very same lightmaps
+    for (const QString &fileName : { QStringLiteral("/qlm_floor.exr"), QStringLiteral("/qlm_box.exr") }) {
+        const QByteArray uninterrupted = readFile(uninterruptedDir + fileName);
+        QVERIFY(!uninterrupted.isEmpty());
+        QCOMPARE(readFile(resumedDir + fileName), uninterrupted);
+    }
+}
+
+void tst_Lightmapper::test_incremental()
+{
+    QScopedPointer<QQuickView> view(createView(QLatin1String("lightmapper.qml"), QSize(200, 200)));
+    QVERIFY(view);
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+    QObject *box = view->rootObject()->findChild<QObject *>(QStringLiteral("box"));
+    QVERIFY(box);
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString previousDir = QDir::currentPath();
+    QVERIFY(QDir::setCurrent(tempDir.path()));
+    const auto restoreDir = qScopeGuard([&previousDir] { QDir::setCurrent(previousDir); });
+
+    auto output = bake(view.data(), tempDir.path());
+    QVERIFY(output);
+    QCOMPARE(output->status.load(), int(QQuick3DLightmapBaker::BakingStatus::Complete));
+    QVERIFY(hasMessage(*output, QStringLiteral("Total texels to compute for model floor")));
+    QVERIFY(hasMessage(*output, QStringLiteral("Total texels to compute for model box")));
+    const QByteArray floorLightmap = readFile(tempDir.filePath(QStringLiteral("qlm_floor.exr")));
+    QVERIFY(!floorLightmap.isEmpty());
+
+    // Nothing changed, no indirect light is computed
+    output = bake(view.data(), tempDir.path());
+    QVERIFY(output);
+    QCOMPARE(output->status.load(), int(QQuick3DLightmapBaker::BakingStatus::Complete));
+    QVERIFY(hasMessage(*output, QStringLiteral("Model floor is unchanged")));
+    QVERIFY(hasMessage(*output, QStringLiteral("Model box is unchanged")));
+    QVERIFY(!hasMessage(*output, QStringLiteral("Computing indirect lighting")));
+    QCOMPARE(readFile(tempDir.filePath(QStringLiteral("qlm_floor.exr"))), floorLightmap);
+
+    // Only the model that moved is baked again
+    box->setProperty("x", 100.0);
+    output = bake(view.data(), tempDir.path());
+    QVERIFY(output);
+    QCOMPARE(output->status.load(), int(QQuick3DLightmapBaker::BakingStatus::Complete));
+    QVERIFY(hasMessage(*output, QStringLiteral("Model box has changed")));
+    QVERIFY(hasMessage(*output, QStringLiteral("Total texels to compute for model box")));
+    QVERIFY(hasMessage(*output, QStringLiteral("Model floor is unchanged")));
+    QVERIFY(!hasMessage(*output, QStringLiteral("Total texels to compute for model floor")));
+}
+
+void tst_Lightmapper::test_denoiseEdges_data()
+{
+    QTest::addColumn<bool>("normalEdge");
+
+    QTest::newRow("normal edge") << true;
+    QTest::newRow("position edge") << false;
+}
+
+void tst_Lightmapper::test_denoiseEdges()
+{
+    QFETCH(bool, normalEdge);
+
+    // A 32x32 lightmap split into a dark left and a bright right half, which
+    // face different ways or are far apart, both with checkerboard noise. The
+    // last column is not used.
+    const int size = 32;
+    const int unusedColumn = size - 1;
+    const int edgeColumn = size / 2;
+    const float dark = 0.2f;
+    const float bright = 1.0f;
+    const float noise = 0.1f;
+
+    QVector<QVector3D> positions(size * size);
+    QVector<QVector3D> normals(size * size);
+    QVector<QVector3D> indirect(size * size);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const int idx = x + y * size;
+            if (x == unusedColumn) {
+                indirect[idx] = QVector3D(100.0f, 100.0f, 100.0f);
+                continue;
+            }
+            const bool right = x >= edgeColumn;
+            positions[idx] = QVector3D(x + 1.0f, y + 1.0f, right && !normalEdge ? 100.0f : 0.0f);
+            normals[idx] = right && normalEdge ? QVector3D(1.0f, 0.0f, 0.0f) : QVector3D(0.0f, 0.0f, 1.0f);
+            const float value = (right ? bright : dark) + ((x + y) % 2 ? noise : -noise);
+            indirect[idx] = QVector3D(value, value, value);
+        }
+    }
+
+    const QVector<QVector3D> result = QSSGLightmapper::denoiseIndirectLight(QSize(size, size), positions, normals, indirect);
+    QCOMPARE(result.size(), indirect.size());
+
+    for (int y = 0; y < size; ++y) {
+        // Unused texels are left alone and do not bleed into the others
+        QCOMPARE(result[unusedColumn + y * size], indirect[unusedColumn + y * size]);
+        for (int x = 0; x < unusedColumn; ++x) {
+            const float expected = x >= edgeColumn ? bright : dark;
+            const float value = result[x + y * size].x();
+            // The noise is gone, also right next to the edge, which stays sharp
+            QVERIFY2(qAbs(value - expected) < 0.5f * noise,
+                     qPrintable(QStringLiteral("texel (%1, %2): %3").arg(x).arg(y).arg(value)));
+        }
+    }
+}
+
+QTEST_MAIN(tst_Lightmapper)
+#include "tst_lightmapper.moc"
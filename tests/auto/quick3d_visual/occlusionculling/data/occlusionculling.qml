@@ -0,0 +1,54 @@
+import QtQuick
+import QtQuick3D
+
+Item {
+    width: 400
+    height: 400
+
+    View3D {
+        objectName: "view"
+        anchors.fill: parent
+
+        environment: SceneEnvironment {
+            backgroundMode: SceneEnvironment.Color
+            clearColor: "black"
+        }
+
+        PerspectiveCamera {
+            z: 600
+        }
+
+        DirectionalLight {
+        }
+
+        Model {
+            objectName: "wall"
+            source: "#Cube"
+            scale: Qt.vector3d(4, 4, 0.1)
+            occluder: true
+            materials: PrincipledMaterial {
+                objectName: "wallMaterial"
+                baseColor: "red"
+            }
+        }
+
+        // Entirely behind the wall
+        Model {
+            source: "#Sphere"
+            z: -300
+            materials: PrincipledMaterial {
+                baseColor: "green"
+            }
+        }
+
+        // Behind the wall as well, but beside it on screen
+        Model {
+            source: "#Sphere"
+            x: 420
+            z: -300
+            materials: PrincipledMaterial {
+                baseColor: "blue"
+            }
+        }
+    }
+}
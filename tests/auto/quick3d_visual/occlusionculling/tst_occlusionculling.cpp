@@ -0,0 +1,68 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickView>
+
+#include <QtQuick3D/private/qquick3dviewport_p.h>
+#include <QtQuick3D/private/qquick3drenderstats_p.h>
+
+#include "../shared/util.h"
+
+class tst_OcclusionCulling : public QQuick3DDataTest
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() override;
+    void test_opaqueOccluders();
+};
+
+void tst_OcclusionCulling::initTestCase()
+{
+    // The culling is done on the CPU, nothing needs to be drawn for real
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::Null);
+    QQuick3DDataTest::initTestCase();
+    if (!initialized())
+        return;
+}
+
+void tst_OcclusionCulling::test_opaqueOccluders()
+{
+    QScopedPointer<QQuickView> view(createView(QLatin1String("occlusionculling.qml"), QSize(400, 400)));
+    QVERIFY(view);
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+
+    auto *view3D = view->rootObject()->findChild<QQuick3DViewport *>(QStringLiteral("view"));
+    QVERIFY(view3D);
+    QObject *wall = view->rootObject()->findChild<QQuick3DObject *>(QStringLiteral("wall"));
+    QVERIFY(wall);
+    QObject *wallMaterial = view->rootObject()->findChild<QQuick3DObject *>(QStringLiteral("wallMaterial"));
+    QVERIFY(wallMaterial);
+
+    QQuick3DRenderStats *stats = view3D->renderStats();
+    stats->setExtendedDataCollectionEnabled(true);
+    view->update();
+
+    // Only the sphere right behind the wall is hidden
+    QTRY_COMPARE(stats->occlusionCulledObjectCount(), 1u);
+    QCOMPARE(stats->frustumCulledObjectCount(), 0u);
+
+    // What is seen through a semi-transparent occluder stays
+    wall->setProperty("opacity", 0.5);
+    QTRY_COMPARE(stats->occlusionCulledObjectCount(), 0u);
+    wall->setProperty("opacity", 1.0);
+    QTRY_COMPARE(stats->occlusionCulledObjectCount(), 1u);
+
+    wallMaterial->setProperty("opacity", 0.5);
+    QTRY_COMPARE(stats->occlusionCulledObjectCount(), 0u);
+    wallMaterial->setProperty("opacity", 1.0);
+    QTRY_COMPARE(stats->occlusionCulledObjectCount(), 1u);
+
+    wall->setProperty("occluder", false);
+    QTRY_COMPARE(stats->occlusionCulledObjectCount(), 0u);
+}
+
+QTEST_MAIN(tst_OcclusionCulling)
+#include "tst_occlusionculling.moc"
@@ -0,0 +1,45 @@
+import QtQuick
+import QtQuick3D
+
+View3D {
+    id: view
+    objectName: "view"
+    anchors.fill: parent
+    pickingMode: View3D.GpuPicking
+    environment: SceneEnvironment {
+        backgroundMode: SceneEnvironment.Color
+        clearColor: "black"
+    }
+    OrthographicCamera { z: 600 }
+    DirectionalLight { }
+    Model {
+        id: model1
+        objectName: "model1"
+        source: "#Cube"
+        pickable: true
+        materials: PrincipledMaterial {
+            baseColor: "red"
+        }
+    }
+    Model {
+        id: model2
+        objectName: "model2"
+        source: "#Cube"
+        pickable: true
+        position: Qt.vector3d(50.0, 50.0, -50.0)
+        materials: PrincipledMaterial {
+            baseColor: "green"
+        }
+    }
+    Model {
+        id: model3
+        objectName: "model3"
+        source: "#Cube"
+        // Not pickable, so picking goes through
+        pickable: false
+        position: Qt.vector3d(-100.0, -100.0, 100.0)
+        materials: PrincipledMaterial {
+            baseColor: "blue"
+        }
+    }
+}
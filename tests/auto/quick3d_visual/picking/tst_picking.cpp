@@ -128,6 +128,7 @@ private Q_SLOTS:
     void test_picking_QTBUG_111997();
     void test_picking_corner_case();
     void test_triangleIntersect();
+    void test_gpu_picking();
 
 private:
     QQuickItem *find2DChildIn3DNode(QQuickView *view, const QString &objectName, const QString &itemName);
@@ -613,5 +614,53 @@ void tst_Picking::test_triangleIntersect()
     QCOMPARE(v, 1.0f);
 }
 
+void tst_Picking::test_gpu_picking()
+{
+    QScopedPointer<QQuickView> view(createView(QLatin1String("gpupicking.qml"), QSize(400, 400)));
+    QVERIFY(view);
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+
+    if (view->rendererInterface()->graphicsApi() == QSGRendererInterface::Null)
+        QSKIP("GPU picking needs to read back what was rendered");
+
+    const qreal dpr = view->devicePixelRatio();
+    if (dpr != 1.0) {
+        QSKIP("Test uses window positions to get exact values and those assume DPR of 1.0");
+    }
+
+    QQuick3DViewport *view3d = view->findChild<QQuick3DViewport *>(QStringLiteral("view"));
+    QVERIFY(view3d);
+    QCOMPARE(view3d->pickingMode(), QQuick3DViewport::GpuPicking);
+    QQuick3DModel *model1 = view3d->findChild<QQuick3DModel *>(QStringLiteral("model1"));
+    QVERIFY(model1);
+    QQuick3DModel *model2 = view3d->findChild<QQuick3DModel *>(QStringLiteral("model2"));
+    QVERIFY(model2);
+
+    // The result of a query arrives in a later frame, so pick until the
+    // result for the position has been read back.
+
+    // Center of model1
+    QTRY_COMPARE(view3d->pick(200, 200).objectHit(), model1);
+    QCOMPARE(view3d->pick(200, 200).objectHit(), model1);
+    QVERIFY(qAbs(view3d->pick(200, 200).scenePosition().z() - 50.0f) < 1.0f);
+
+    // Only model2 is behind this position
+    QTRY_COMPARE(view3d->pick(280, 120).objectHit(), model2);
+
+    // Background
+    QTRY_COMPARE(view3d->pick(50, 50).objectHit(), nullptr);
+
+    // model3 is in front, but not pickable
+    QTRY_COMPARE(view3d->pick(100, 300).objectHit(), nullptr);
+
+    // Back to the CPU, which answers right away
+    QSignalSpy pickingModeSpy(view3d, &QQuick3DViewport::pickingModeChanged);
+    view3d->setPickingMode(QQuick3DViewport::CpuPicking);
+    QCOMPARE(pickingModeSpy.size(), 1);
+    view3d->setPickingMode(QQuick3DViewport::CpuPicking);
+    QCOMPARE(pickingModeSpy.size(), 1);
+    QCOMPARE(view3d->pick(280, 120).objectHit(), model2);
+}
+
 QTEST_MAIN(tst_Picking)
 #include "tst_picking.moc"
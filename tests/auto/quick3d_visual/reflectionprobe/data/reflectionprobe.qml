@@ -0,0 +1,41 @@
+import QtQuick
+import QtQuick3D
+
+Item {
+    width: 200
+    height: 200
+
+    View3D {
+        anchors.fill: parent
+
+        environment: SceneEnvironment {
+            backgroundMode: SceneEnvironment.Color
+            clearColor: "black"
+        }
+
+        PerspectiveCamera {
+            z: 300
+        }
+
+        DirectionalLight {
+        }
+
+        Model {
+            source: "#Sphere"
+            receivesReflections: true
+            materials: PrincipledMaterial {
+                metalness: 1.0
+                roughness: 0.0
+            }
+        }
+
+        // Nothing casts reflections, the probe sees its clear color only
+        ReflectionProbe {
+            objectName: "probe"
+            quality: ReflectionProbe.VeryLow
+            refreshMode: ReflectionProbe.FirstFrame
+            clearColor: "red"
+            boxSize: Qt.vector3d(1000, 1000, 1000)
+        }
+    }
+}
@@ -0,0 +1,100 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <QtCore/qfloat16.h>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickView>
+
+#include <QtQuick3D/private/qquick3dreflectionprobe_p.h>
+
+#include <QtQuick3DRuntimeRender/private/qssgrenderloadedtexture_p.h>
+
+#include "../shared/util.h"
+
+class tst_ReflectionProbe : public QQuick3DDataTest
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() override;
+    void test_bakeToFile();
+};
+
+void tst_ReflectionProbe::initTestCase()
+{
+    QQuick3DDataTest::initTestCase();
+    if (!initialized())
+        return;
+}
+
+void tst_ReflectionProbe::test_bakeToFile()
+{
+    QScopedPointer<QQuickView> view(createView(QLatin1String("reflectionprobe.qml"), QSize(200, 200)));
+    QVERIFY(view);
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+
+    auto *probe = view->rootObject()->findChild<QQuick3DReflectionProbe *>(QStringLiteral("probe"));
+    QVERIFY(probe);
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("probe.ktx"));
+
+    // The file is written once the readback of the rendered map completed,
+    // which is a frame or two later
+    probe->bakeToFile(QUrl::fromLocalFile(fileName));
+    for (int frame = 0; frame < 10 && !QFileInfo::exists(fileName); ++frame) {
+        if (grab(view.data()).isNull())
+            return; // was QFAIL'ed already
+    }
+    QVERIFY(QFileInfo::exists(fileName));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray header = file.read(64);
+    QCOMPARE(header.size(), 64);
+    static const char ktxIdentifier[12] = { '\xAB', 'K', 'T', 'X', ' ', '1', '1', '\xBB', '\r', '\n', '\x1A', '\n' };
+    QCOMPARE(header.left(12), QByteArray(ktxIdentifier, 12));
+    const auto field = [&header](int i) {
+        return *reinterpret_cast<const quint32 *>(header.constData() + 12 + 4 * i);
+    };
+    QCOMPARE(field(0), 0x04030201u); // endianness
+    QCOMPARE(field(1), 0x140Bu); // GL_HALF_FLOAT
+    QCOMPARE(field(4), 0x881Au); // GL_RGBA16F
+    QCOMPARE(field(6), 128u); // width, ReflectionProbe.VeryLow
+    QCOMPARE(field(7), 128u); // height
+    QCOMPARE(field(10), 6u); // faces
+    QCOMPARE(field(11), 6u); // mip levels, capped at 6 for the prefiltered map
+    file.close();
+
+    // The runtime loads it like a map from the IBL baker
+    QScopedPointer<QSSGLoadedTexture> texture(QSSGLoadedTexture::load(fileName, QSSGRenderTextureFormat::Unknown));
+    QVERIFY(texture);
+    const QTextureFileData &data = texture->textureFileData;
+    QVERIFY(data.isValid());
+    QVERIFY(data.keyValueMetadata().contains("QT_IBL_BAKER_VERSION"));
+    QCOMPARE(data.size(), QSize(128, 128));
+    QCOMPARE(data.numFaces(), 6);
+    QCOMPARE(data.numLevels(), 6);
+    for (int level = 0; level < data.numLevels(); ++level) {
+        const int side = 128 >> level;
+        for (int face = 0; face < 6; ++face)
+            QCOMPARE(data.getDataView(level, face).size(), qsizetype(side * side * 4 * sizeof(qfloat16)));
+    }
+
+    // With the clear color of the probe in every face
+    for (int face = 0; face < 6; ++face) {
+        const auto *pixel = reinterpret_cast<const qfloat16 *>(data.getDataView(0, face).constData() + 64 * 128 * 8 + 64 * 8);
+        QVERIFY2(float(pixel[0]) > 0.9f && float(pixel[1]) < 0.1f && float(pixel[2]) < 0.1f,
+                 qPrintable(QStringLiteral("face %1: %2 %3 %4").arg(face).arg(float(pixel[0])).arg(float(pixel[1])).arg(float(pixel[2]))));
+    }
+
+    // Only local files can be written
+    QTest::ignoreMessage(QtWarningMsg, "ReflectionProbe: Can only bake to local files, not qrc:/probe.ktx");
+    probe->bakeToFile(QUrl(QStringLiteral("qrc:/probe.ktx")));
+}
+
+QTEST_MAIN(tst_ReflectionProbe)
+#include "tst_reflectionprobe.moc"
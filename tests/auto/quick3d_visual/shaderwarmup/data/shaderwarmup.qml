@@ -0,0 +1,46 @@
+import QtQuick
+import QtQuick3D
+
+Item {
+    width: 200
+    height: 200
+
+    View3D {
+        objectName: "view"
+        anchors.fill: parent
+
+        environment: SceneEnvironment {
+            backgroundMode: SceneEnvironment.Color
+            clearColor: "black"
+        }
+
+        PerspectiveCamera {
+            z: 300
+        }
+
+        DirectionalLight {
+        }
+
+        PointLight {
+            y: 100
+        }
+
+        Model {
+            source: "#Cube"
+            x: -60
+            materials: PrincipledMaterial {
+                baseColor: "red"
+                metalness: 0.5
+            }
+        }
+
+        Model {
+            source: "#Sphere"
+            x: 60
+            opacity: 0.5
+            materials: DefaultMaterial {
+                diffuseColor: "green"
+            }
+        }
+    }
+}
@@ -0,0 +1,155 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtCore/qlibraryinfo.h>
+#include <QtCore/qprocess.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtQuick/QQuickItem>
+
+#include <QtQuick3D/private/qquick3dviewport_p.h>
+#include <QtQuick3D/private/qquick3dscenemanager_p.h>
+#include <QtQuick3DRuntimeRender/ssg/qssgrendercontextcore.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendershadercache_p.h>
+
+#include <QVulkanInstance>
+
+#include "../shared/util.h"
+
+static inline void renderNextFrame(QQuick3DTestOffscreenRenderer *renderer, bool *readCompleted, QRhiReadbackResult *readResult, QImage *result)
+{
+    renderer->qmlEngine->collectGarbage();
+    QGuiApplication::processEvents();
+    renderer->renderControl->polishItems();
+    renderer->renderControl->beginFrame();
+    renderer->renderControl->sync();
+    renderer->renderControl->render();
+    renderer->enqueueReadback(readCompleted, readResult, result);
+    renderer->renderControl->endFrame();
+}
+
+class tst_ShaderWarmUp : public QQuick3DDataTest
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() override;
+    void test_recordAndWarmUp();
+
+private:
+    bool initRenderer(QQuick3DTestOffscreenRenderer *renderer, const QString &filename);
+    static QSSGShaderCache *shaderCache(QQuick3DTestOffscreenRenderer *renderer);
+#if QT_CONFIG(vulkan)
+    QVulkanInstance vulkanInstance;
+#endif
+};
+
+void tst_ShaderWarmUp::initTestCase()
+{
+    // Nothing must come from the disk cache of an earlier run. This is read
+    // once, when the first shader cache is created.
+    qputenv("QT_DISABLE_SHADER_DISK_CACHE", "1");
+    qunsetenv("QT_QUICK3D_SHADER_RECORD_FILE");
+    qunsetenv("QT_QUICK3D_SHADER_WARMUP_FILE");
+
+    QQuick3DDataTest::initTestCase();
+    if (!initialized())
+        return;
+
+#if QT_CONFIG(vulkan)
+    vulkanInstance.setLayers({ "VK_LAYER_LUNARG_standard_validation" });
+    vulkanInstance.create(); // may fail, which is fine is Vulkan is not used in the first place
+#endif
+}
+
+bool tst_ShaderWarmUp::initRenderer(QQuick3DTestOffscreenRenderer *renderer, const QString &filename)
+{
+#if QT_CONFIG(vulkan)
+    return renderer->init(testFileUrl(filename), &vulkanInstance);
+#else
+    return renderer->init(testFileUrl(filename), nullptr);
+#endif
+}
+
+QSSGShaderCache *tst_ShaderWarmUp::shaderCache(QQuick3DTestOffscreenRenderer *renderer)
+{
+    const auto &context = QQuick3DSceneManager::getOrSetWindowAttachment(*renderer->quickWindow)->rci();
+    return context ? context->shaderCache().get() : nullptr;
+}
+
+void tst_ShaderWarmUp::test_recordAndWarmUp()
+{
+    const QString shadergen = QStandardPaths::findExecutable(QStringLiteral("shadergen"),
+                                                             { QLibraryInfo::path(QLibraryInfo::BinariesPath) });
+    if (shadergen.isEmpty())
+        QSKIP("shadergen is not available");
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString recording = tempDir.filePath(QStringLiteral("recorded.qsbc"));
+
+    bool readCompleted = false;
+    QRhiReadbackResult readResult;
+    QImage result;
+
+    // Record what the scene needs, the recording is written when the shader
+    // cache goes away with the window
+    qputenv("QT_QUICK3D_SHADER_RECORD_FILE", QFile::encodeName(recording));
+    {
+        QQuick3DTestOffscreenRenderer renderer;
+        QVERIFY(initRenderer(&renderer, QStringLiteral("shaderwarmup.qml")));
+        renderNextFrame(&renderer, &readCompleted, &readResult, &result);
+        QSSGShaderCache *cache = shaderCache(&renderer);
+        QVERIFY(cache);
+        if (cache->bakeCount() == 0)
+            QSKIP("This build of Qt Quick 3D cannot compile shaders at run-time");
+    }
+    qunsetenv("QT_QUICK3D_SHADER_RECORD_FILE");
+    QVERIFY(QFile::exists(recording));
+
+    // Merge it into a collection, like a build step would
+    const QString outDir = tempDir.filePath(QStringLiteral("out"));
+    QProcess process;
+    process.setProcessChannelMode(QProcess::ForwardedChannels);
+    process.start(shadergen, { QStringLiteral("-C"), tempDir.path(),
+                               QStringLiteral("-o"), outDir,
+                               QStringLiteral("--recording"), recording });
+    QVERIFY(process.waitForFinished(120000));
+    QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(process.exitCode(), 0);
+    const QString collection = outDir + QStringLiteral("/res/rhishaders/")
+            + QString::fromLatin1(QSSGShaderCache::shaderCollectionFile());
+    QVERIFY(QFile::exists(collection));
+
+    // Warmed up before the first frame, nothing is baked when the scene is
+    // first rendered
+    QQuick3DTestOffscreenRenderer renderer;
+    QVERIFY(initRenderer(&renderer, QStringLiteral("shaderwarmup.qml")));
+    auto *view3D = renderer.rootItem->findChild<QQuick3DViewport *>(QStringLiteral("view"));
+    QVERIFY(view3D);
+    QSignalSpy progressSpy(view3D, &QQuick3DViewport::shaderWarmUpProgress);
+    QSignalSpy finishedSpy(view3D, &QQuick3DViewport::shaderWarmUpFinished);
+
+    view3D->warmUpShaders(QUrl::fromLocalFile(collection));
+    renderNextFrame(&renderer, &readCompleted, &readResult, &result);
+    QSSGShaderCache *cache = shaderCache(&renderer);
+    QVERIFY(cache);
+    QCOMPARE(cache->bakeCount(), 0);
+
+    QTRY_COMPARE(finishedSpy.size(), 1);
+    const int count = finishedSpy.first().at(0).toInt();
+    QVERIFY(count > 0);
+    QVERIFY(!progressSpy.isEmpty());
+    const QList<QVariant> lastProgress = progressSpy.last();
+    QCOMPARE(lastProgress.at(0).toInt(), lastProgress.at(1).toInt());
+    QVERIFY(lastProgress.at(1).toInt() >= count);
+
+    // Rendering again does not change that
+    renderNextFrame(&renderer, &readCompleted, &readResult, &result);
+    QCOMPARE(cache->bakeCount(), 0);
+}
+
+QTEST_MAIN(tst_ShaderWarmUp)
+#include "tst_shaderwarmup.moc"
@@ -0,0 +1,178 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest>
+
+#include <QtQuick3DRuntimeRender/private/qssglayerrenderdata_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgocclusionculler_p.h>
+#include <QtQuick3DUtils/private/qssgbounds3_p.h>
+
+class BenchOcclusionCulling : public QObject
+{
+    Q_OBJECT
+
+public:
+    BenchOcclusionCulling();
+    ~BenchOcclusionCulling();
+
+private slots:
+    void initTestCase();
+    void test_occlusionCulling();
+    void bench_rasterize();
+    void bench_inline();
+
+private:
+    static void appendBox(QVector<QVector3D> &vertices, const QVector3D &minimum, const QVector3D &maximum)
+    {
+        const QVector3D c[8] = {
+            { minimum.x(), minimum.y(), minimum.z() }, { maximum.x(), minimum.y(), minimum.z() },
+            { maximum.x(), maximum.y(), minimum.z() }, { minimum.x(), maximum.y(), minimum.z() },
+            { minimum.x(), minimum.y(), maximum.z() }, { maximum.x(), minimum.y(), maximum.z() },
+            { maximum.x(), maximum.y(), maximum.z() }, { minimum.x(), maximum.y(), maximum.z() }
+        };
+        const int indices[36] = {
+            0, 2, 1, 0, 3, 2, // back
+            4, 5, 6, 4, 6, 7, // front
+            0, 4, 7, 0, 7, 3, // left
+            1, 2, 6, 1, 6, 5, // right
+            3, 7, 6, 3, 6, 2, // top
+            0, 1, 5, 0, 5, 4  // bottom
+        };
+        for (int i : indices)
+            vertices.push_back(c[i]);
+    }
+
+    // A grid of buildings in front of the camera, with streets in between
+    static QVector<QVector3D> createCity()
+    {
+        QRandomGenerator generator(42);
+        QVector<QVector3D> vertices;
+        for (int row = 0; row < 10; ++row) {
+            for (int column = 0; column < 10; ++column) {
+                const float x = -225.0f + column * 50.0f;
+                const float z = -50.0f - row * 50.0f;
+                const float height = 20.0f + float(generator.bounded(40));
+                appendBox(vertices, { x - 15.0f, 0.0f, z - 15.0f }, { x + 15.0f, height, z + 15.0f });
+            }
+        }
+        return vertices;
+    }
+
+    QMatrix4x4 viewProjection;
+    const QSize viewportSize { 800, 600 };
+};
+
+BenchOcclusionCulling::BenchOcclusionCulling()
+{
+
+}
+
+BenchOcclusionCulling::~BenchOcclusionCulling()
+{
+
+}
+
+void BenchOcclusionCulling::initTestCase()
+{
+    // Standing in the street, looking down the rows of buildings
+    QMatrix4x4 projection;
+    projection.perspective(60.0f, float(viewportSize.width()) / viewportSize.height(), 1.0f, 1000.0f);
+    QMatrix4x4 view;
+    view.lookAt({ 0.0f, 10.0f, 0.0f }, { 0.0f, 10.0f, -1.0f }, { 0.0f, 1.0f, 0.0f });
+    viewProjection = projection * view;
+}
+
+void BenchOcclusionCulling::test_occlusionCulling()
+{
+    QVector<QVector3D> wall;
+    appendBox(wall, { -20.0f, 0.0f, -52.0f }, { 20.0f, 40.0f, -50.0f });
+
+    QSSGOcclusionCuller culler;
+    QVERIFY(!culler.isOccluded({ { -5.0f, 5.0f, -105.0f }, { 5.0f, 15.0f, -95.0f } }));
+
+    culler.begin(viewProjection, viewportSize);
+    culler.addOccluder(QSSGDataView<QVector3D>(wall), QMatrix4x4());
+    culler.end();
+    QVERIFY(culler.isActive());
+    QCOMPARE(culler.occluderTriangleCount(), 12u);
+
+    // Behind the wall
+    QVERIFY(culler.isOccluded({ { -5.0f, 5.0f, -105.0f }, { 5.0f, 15.0f, -95.0f } }));
+    // Behind the wall, but reaching past its side
+    QVERIFY(!culler.isOccluded({ { 5.0f, 5.0f, -105.0f }, { 50.0f, 15.0f, -95.0f } }));
+    // Next to the wall
+    QVERIFY(!culler.isOccluded({ { 45.0f, 5.0f, -105.0f }, { 55.0f, 15.0f, -95.0f } }));
+    // In front of the wall
+    QVERIFY(!culler.isOccluded({ { -5.0f, 5.0f, -25.0f }, { 5.0f, 15.0f, -15.0f } }));
+    // Around the camera
+    QVERIFY(!culler.isOccluded({ { -5.0f, 5.0f, -5.0f }, { 5.0f, 15.0f, 5.0f } }));
+    // Outside of the view, left for frustum culling
+    QVERIFY(!culler.isOccluded({ { 500.0f, 5.0f, -105.0f }, { 510.0f, 15.0f, -95.0f } }));
+
+    culler.reset();
+    QVERIFY(!culler.isActive());
+    QVERIFY(!culler.isOccluded({ { -5.0f, 5.0f, -105.0f }, { 5.0f, 15.0f, -95.0f } }));
+}
+
+void BenchOcclusionCulling::bench_rasterize()
+{
+    const QVector<QVector3D> city = createCity();
+
+    QSSGOcclusionCuller culler;
+    QBENCHMARK {
+        culler.begin(viewProjection, viewportSize);
+        culler.addOccluder(QSSGDataView<QVector3D>(city), QMatrix4x4());
+        culler.end();
+    }
+
+    QVERIFY(culler.isActive());
+}
+
+void BenchOcclusionCulling::bench_inline()
+{
+    const QVector<QVector3D> city = createCity();
+
+    QSSGOcclusionCuller culler;
+    culler.begin(viewProjection, viewportSize);
+    culler.addOccluder(QSSGDataView<QVector3D>(city), QMatrix4x4());
+    culler.end();
+
+    // Small objects in the streets and yards of the city, all within the
+    // view so that none of them is left for frustum culling
+    constexpr quint32 objectCount = 10000;
+    QRandomGenerator generator(7);
+    const QMatrix4x4 identity;
+    QList<QSSGBounds3> bounds;
+    bounds.reserve(objectCount);
+    for (quint32 i = 0; i != objectCount; ++i) {
+        const float z = -30.0f - float(generator.bounded(490.0));
+        const float halfWidth = qMin(250.0f, -0.7f * z);
+        const QVector3D center(float(generator.bounded(2.0)) * halfWidth - halfWidth, 1.0f, z);
+        bounds.push_back({ center - QVector3D(1.0f, 1.0f, 1.0f), center + QVector3D(1.0f, 1.0f, 1.0f) });
+    }
+
+    // The base type is enough, only the global bounds are used. Particles are
+    // tested as they are, the bounds of subsets depend on their model.
+    QList<QSSGRenderableObject> renderableObjects;
+    renderableObjects.reserve(objectCount);
+    for (const QSSGBounds3 &b : std::as_const(bounds))
+        renderableObjects.push_back({ QSSGRenderableObject::Type::Particles, QSSGRenderableObjectFlags(), b.center(), identity, b, 0.0f });
+
+    QSSGRenderableObjectList renderables;
+    renderables.reserve(objectCount);
+    for (auto &ro : renderableObjects)
+        renderables.push_back({ &ro, 0.0f });
+
+    qsizetype ret;
+    QBENCHMARK {
+        ret = QSSGLayerRenderData::occlusionCullingInline(culler, renderables);
+    }
+
+    // Some are seen along the streets, most are hidden by the buildings
+    QVERIFY(ret > 0);
+    QVERIFY(ret < qsizetype(objectCount) / 2);
+}
+
+QTEST_APPLESS_MAIN(BenchOcclusionCulling)
+
+#include "tst_benchocclusionculling.moc"
@@ -0,0 +1,77 @@
+import QtQuick
+import QtQuick3D
+
+// A closed box with a few occluders and a single light. Most of the
+// lighting on the walls comes from bounces, which makes indirect light
+// computation dominate the bake time.
+Rectangle {
+    width: 320
+    height: 240
+    color: "black"
+
+    View3D {
+        id: view3D
+        objectName: "view3D"
+        anchors.fill: parent
+
+        environment: SceneEnvironment {
+            backgroundMode: SceneEnvironment.Color
+            clearColor: "black"
+            lightmapper: Lightmapper {
+                samples: 64
+                bounces: 3
+            }
+        }
+
+        PerspectiveCamera {
+            z: 300
+        }
+
+        PointLight {
+            bakeMode: Light.BakeModeAll
+            y: 80
+            brightness: 5
+            castsShadow: true
+        }
+
+        component Wall : Model {
+            id: wall
+            property string key
+            source: "#Rectangle"
+            usedInBakedLighting: true
+            lightmapBaseResolution: 128
+            bakedLightmap: BakedLightmap {
+                enabled: true
+                key: wall.key
+            }
+            materials: PrincipledMaterial { baseColor: "#c0c0c0" }
+        }
+
+        Wall { key: "floor"; y: -100; eulerRotation.x: -90; scale: Qt.vector3d(2, 2, 1) }
+        Wall { key: "ceiling"; y: 100; eulerRotation.x: 90; scale: Qt.vector3d(2, 2, 1) }
+        Wall { key: "back"; z: -100; scale: Qt.vector3d(2, 2, 1) }
+        Wall { key: "left"; x: -100; eulerRotation.y: 90; scale: Qt.vector3d(2, 2, 1)
+               materials: PrincipledMaterial { baseColor: "#c03030" } }
+        Wall { key: "right"; x: 100; eulerRotation.y: -90; scale: Qt.vector3d(2, 2, 1)
+               materials: PrincipledMaterial { baseColor: "#30c030" } }
+
+        Repeater3D {
+            model: 4
+            Model {
+                source: "#Cube"
+                usedInBakedLighting: true
+                lightmapBaseResolution: 64
+                bakedLightmap: BakedLightmap {
+                    enabled: true
+                    key: "cube" + index
+                }
+                x: -60 + index * 40
+                y: -80
+                z: -20 + (index % 2) * 40
+                scale: Qt.vector3d(0.3, 0.4, 0.3)
+                eulerRotation.y: index * 25
+                materials: PrincipledMaterial { baseColor: "#e0e0e0" }
+            }
+        }
+    }
+}
@@ -0,0 +1,96 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtTest>
+#include <QtQuick/QQuickView>
+#include <QtQuick3D/qquick3d.h>
+
+#include <QtQuick3D/private/qquick3dviewport_p.h>
+#include <QtQuick3D/private/qquick3dlightmapbaker_p.h>
+
+class lightmapper : public QObject
+{
+    Q_OBJECT
+
+public:
+    lightmapper() = default;
+    ~lightmapper() = default;
+
+private Q_SLOTS:
+    void initTestCase();
+    void bench_bake();
+};
+
+void lightmapper::initTestCase()
+{
+    if (QGuiApplication::platformName() == QLatin1String("minimal"))
+        QSKIP("The minimal platform plugin cannot render");
+}
+
+void lightmapper::bench_bake()
+{
+    // lightmaps are written to the working directory, keep them out of the source tree
+    QTemporaryDir outputDir;
+    QVERIFY(outputDir.isValid());
+    const QString oldCurrent = QDir::currentPath();
+    const QUrl sceneUrl = QUrl::fromLocalFile(QFINDTESTDATA("data/bake.qml"));
+    QDir::setCurrent(outputDir.path());
+    auto restoreCurrent = qScopeGuard([oldCurrent] { QDir::setCurrent(oldCurrent); });
+
+    QQuickView view;
+    view.setSource(sceneUrl);
+    QCOMPARE(view.status(), QQuickView::Ready);
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QQuick3DViewport *view3D = view.rootObject()->findChild<QQuick3DViewport *>(QStringLiteral("view3D"));
+    QVERIFY(view3D);
+
+    // The bake itself happens synchronously on the render thread as part of a
+    // frame, the callback may thus be invoked on a thread other than this one.
+    std::atomic_bool statusReceived = false;
+    std::atomic_bool finished = false;
+    std::atomic_bool completed = false;
+    QMutex messageLock;
+    QStringList statsMessages;
+    auto callback = [&](QQuick3DLightmapBaker::BakingStatus status,
+                        std::optional<QString> msg,
+                        QQuick3DLightmapBaker::BakingControl *) {
+        statusReceived = true;
+        if (msg.has_value() && msg->contains(QLatin1String("rays/s"))) {
+            QMutexLocker locker(&messageLock);
+            statsMessages.append(msg.value());
+        }
+        switch (status) {
+        case QQuick3DLightmapBaker::BakingStatus::Complete:
+            completed = true;
+            finished = true;
+            break;
+        case QQuick3DLightmapBaker::BakingStatus::Cancelled:
+        case QQuick3DLightmapBaker::BakingStatus::Error:
+            finished = true;
+            break;
+        default:
+            break;
+        }
+    };
+
+    QBENCHMARK_ONCE {
+        finished = false;
+        view3D->lightmapBaker()->bake(callback);
+        QSignalSpy frameSpy(&view, &QQuickWindow::frameSwapped);
+        QTRY_VERIFY_WITH_TIMEOUT(finished || (frameSpy.size() >= 2 && !statusReceived), 600000);
+    }
+
+    if (!statusReceived)
+        QSKIP("Qt Quick 3D was built without the lightmapper");
+    QVERIFY(completed);
+
+    QMutexLocker locker(&messageLock);
+    for (const QString &msg : std::as_const(statsMessages))
+        qDebug().noquote() << msg;
+}
+
+QTEST_MAIN(lightmapper)
+
+#include "tst_lightmapper.moc"
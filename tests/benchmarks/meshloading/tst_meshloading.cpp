@@ -0,0 +1,233 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtTest>
+
+#include <QtQuick3DUtils/private/qssgmesh_p.h>
+
+#include <cmath>
+
+class meshloading : public QObject
+{
+    Q_OBJECT
+
+public:
+    meshloading() = default;
+    ~meshloading() = default;
+
+private Q_SLOTS:
+    void initTestCase();
+    void test_mappedMatchesRead();
+    void test_compressedMatchesRead();
+    void bench_load_data();
+    void bench_load();
+
+private:
+    QTemporaryDir tempDir;
+    QString meshFileName;
+    QString compressedMeshFileName;
+    QString quantizedMeshFileName;
+};
+
+// 1M vertices with position, normal, uv0 and 6M 32-bit indices, roughly 56 MB
+static const quint32 GRID_SIZE = 1024;
+
+static QByteArray floatData(const QVector<float> &v)
+{
+    return QByteArray(reinterpret_cast<const char *>(v.constData()), v.size() * sizeof(float));
+}
+
+// Resident set size related values from /proc (Linux only), in bytes. -1
+// when not available.
+static qint64 procStatusValue(const char *key)
+{
+    QFile f(QStringLiteral("/proc/self/status"));
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+        return -1;
+    const QByteArray prefix = QByteArray(key) + ':';
+    while (!f.atEnd()) {
+        const QByteArray line = f.readLine();
+        if (line.startsWith(prefix))
+            return line.mid(prefix.size()).trimmed().split(' ').first().toLongLong() * 1024;
+    }
+    return -1;
+}
+
+static bool resetPeakResidentSize()
+{
+    // writing 5 to clear_refs resets VmHWM (Linux 4.0+)
+    QFile f(QStringLiteral("/proc/self/clear_refs"));
+    return f.open(QIODevice::WriteOnly) && f.write("5") == 1;
+}
+
+void meshloading::initTestCase()
+{
+    QVERIFY(tempDir.isValid());
+
+    const quint32 vertexCount = GRID_SIZE * GRID_SIZE;
+    QVector<float> positions(vertexCount * 3);
+    QVector<float> normals(vertexCount * 3);
+    QVector<float> uvs(vertexCount * 2);
+    for (quint32 y = 0; y < GRID_SIZE; ++y) {
+        for (quint32 x = 0; x < GRID_SIZE; ++x) {
+            const quint32 i = x + y * GRID_SIZE;
+            positions[i * 3] = float(x);
+            positions[i * 3 + 1] = std::sin(x * 0.1f) * std::cos(y * 0.1f);
+            positions[i * 3 + 2] = float(y);
+            normals[i * 3 + 1] = 1.0f;
+            uvs[i * 2] = x / float(GRID_SIZE - 1);
+            uvs[i * 2 + 1] = y / float(GRID_SIZE - 1);
+        }
+    }
+    QVector<quint32> indices;
+    indices.reserve((GRID_SIZE - 1) * (GRID_SIZE - 1) * 6);
+    for (quint32 y = 0; y < GRID_SIZE - 1; ++y) {
+        for (quint32 x = 0; x < GRID_SIZE - 1; ++x) {
+            const quint32 i = x + y * GRID_SIZE;
+            indices << i << i + GRID_SIZE << i + 1 << i + 1 << i + GRID_SIZE << i + GRID_SIZE + 1;
+        }
+    }
+
+    QVector<QSSGMesh::AssetVertexEntry> entries = {
+        { QSSGMesh::MeshInternal::getPositionAttrName(), floatData(positions), QSSGMesh::Mesh::ComponentType::Float32, 3 },
+        { QSSGMesh::MeshInternal::getNormalAttrName(), floatData(normals), QSSGMesh::Mesh::ComponentType::Float32, 3 },
+        { QSSGMesh::MeshInternal::getUV0AttrName(), floatData(uvs), QSSGMesh::Mesh::ComponentType::Float32, 2 }
+    };
+    QSSGMesh::AssetMeshSubset subset;
+    subset.count = indices.size();
+    subset.offset = 0;
+    subset.boundsPositionEntryIndex = 0;
+    const QByteArray indexData(reinterpret_cast<const char *>(indices.constData()), indices.size() * sizeof(quint32));
+    const QSSGMesh::Mesh mesh = QSSGMesh::Mesh::fromAssetData(entries, indexData,
+                                                              QSSGMesh::Mesh::ComponentType::UnsignedInt32,
+                                                              { subset });
+    QVERIFY(mesh.isValid());
+
+    const auto saveMesh = [&mesh](const QString &fileName, QSSGMesh::Mesh::SaveFlags flags) {
+        QFile f(fileName);
+        if (!f.open(QIODevice::WriteOnly) || mesh.save(&f, 0, flags) == 0)
+            return false;
+        qDebug("%s: %.1f MB", qPrintable(QFileInfo(fileName).fileName()), f.size() / (1024.0 * 1024.0));
+        return true;
+    };
+
+    meshFileName = tempDir.filePath(QStringLiteral("large.mesh"));
+    QVERIFY(saveMesh(meshFileName, QSSGMesh::Mesh::SaveFlag::None));
+    compressedMeshFileName = tempDir.filePath(QStringLiteral("large_compressed.mesh"));
+    QVERIFY(saveMesh(compressedMeshFileName, QSSGMesh::Mesh::SaveFlag::Compress));
+    quantizedMeshFileName = tempDir.filePath(QStringLiteral("large_quantized.mesh"));
+    QVERIFY(saveMesh(quantizedMeshFileName, QSSGMesh::Mesh::SaveFlag::Compress
+                                                | QSSGMesh::Mesh::SaveFlag::QuantizeAttributes));
+}
+
+void meshloading::test_mappedMatchesRead()
+{
+    QFile f(meshFileName);
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    const QSSGMesh::Mesh readMesh = QSSGMesh::Mesh::loadMesh(&f);
+    QVERIFY(readMesh.isValid());
+    QVERIFY(!readMesh.mappedFile());
+
+    auto mappedFile = QSharedPointer<QFile>::create(meshFileName);
+    QVERIFY(mappedFile->open(QIODevice::ReadOnly));
+    const QSSGMesh::Mesh mappedMesh = QSSGMesh::Mesh::loadMeshMapped(mappedFile);
+    QVERIFY(mappedMesh.isValid());
+    QVERIFY(mappedMesh.mappedFile());
+    mappedFile.reset();
+
+    QCOMPARE(mappedMesh.vertexBuffer().stride, readMesh.vertexBuffer().stride);
+    QCOMPARE(mappedMesh.vertexBuffer().entries.size(), readMesh.vertexBuffer().entries.size());
+    QCOMPARE(mappedMesh.vertexBuffer().data, readMesh.vertexBuffer().data);
+    QCOMPARE(mappedMesh.indexBuffer().data, readMesh.indexBuffer().data);
+    QCOMPARE(mappedMesh.subsets().size(), readMesh.subsets().size());
+    QCOMPARE(mappedMesh.subsets().first().count, readMesh.subsets().first().count);
+}
+
+void meshloading::test_compressedMatchesRead()
+{
+    QFile f(meshFileName);
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    const QSSGMesh::Mesh readMesh = QSSGMesh::Mesh::loadMesh(&f);
+    QVERIFY(readMesh.isValid());
+
+    QFile compressedFile(compressedMeshFileName);
+    QVERIFY(compressedFile.open(QIODevice::ReadOnly));
+    QVERIFY(compressedFile.size() < f.size());
+    const QSSGMesh::Mesh compressedMesh = QSSGMesh::Mesh::loadMesh(&compressedFile);
+    QVERIFY(compressedMesh.isValid());
+    QCOMPARE(compressedMesh.vertexBuffer().data, readMesh.vertexBuffer().data);
+    QCOMPARE(compressedMesh.indexBuffer().data, readMesh.indexBuffer().data);
+
+    // quantization is lossy, but leaves the positions and indices alone
+    QFile quantizedFile(quantizedMeshFileName);
+    QVERIFY(quantizedFile.open(QIODevice::ReadOnly));
+    QVERIFY(quantizedFile.size() <= compressedFile.size());
+    const QSSGMesh::Mesh quantizedMesh = QSSGMesh::Mesh::loadMesh(&quantizedFile);
+    QVERIFY(quantizedMesh.isValid());
+    QCOMPARE(quantizedMesh.vertexBuffer().data.size(), readMesh.vertexBuffer().data.size());
+    QCOMPARE(quantizedMesh.indexBuffer().data, readMesh.indexBuffer().data);
+    const quint32 stride = readMesh.vertexBuffer().stride;
+    const char *quantized = quantizedMesh.vertexBuffer().data.constData();
+    const char *original = readMesh.vertexBuffer().data.constData();
+    for (quint32 i = 0; i < GRID_SIZE * GRID_SIZE; i += 997)
+        QCOMPARE(memcmp(quantized + i * stride, original + i * stride, 3 * sizeof(float)), 0);
+}
+
+void meshloading::bench_load_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<bool>("mapped");
+    QTest::newRow("read") << meshFileName << false;
+    QTest::newRow("mapped") << meshFileName << true;
+    QTest::newRow("compressed") << compressedMeshFileName << false;
+    QTest::newRow("compressed, mapped") << compressedMeshFileName << true;
+}
+
+void meshloading::bench_load()
+{
+    QFETCH(QString, fileName);
+    QFETCH(bool, mapped);
+
+    // Load the mesh and copy the buffers somewhere, like the upload to the
+    // staging buffers does. Peak resident size is measured for one such
+    // round, the benchmark times the whole.
+    const auto loadAndUpload = [&fileName, mapped](QByteArray *staging) {
+        QSSGMesh::Mesh mesh;
+        if (mapped) {
+            auto file = QSharedPointer<QFile>::create(fileName);
+            if (file->open(QIODevice::ReadOnly))
+                mesh = QSSGMesh::Mesh::loadMeshMapped(file);
+        } else {
+            QFile file(fileName);
+            if (file.open(QIODevice::ReadOnly))
+                mesh = QSSGMesh::Mesh::loadMesh(&file);
+        }
+        const QByteArray vertexData = mesh.vertexBuffer().data;
+        const QByteArray indexData = mesh.indexBuffer().data;
+        staging->resize(vertexData.size() + indexData.size());
+        memcpy(staging->data(), vertexData.constData(), vertexData.size());
+        memcpy(staging->data() + vertexData.size(), indexData.constData(), indexData.size());
+        return mesh.isValid();
+    };
+
+    const qint64 rssBefore = procStatusValue("VmRSS");
+    const bool canMeasurePeak = resetPeakResidentSize();
+    {
+        QByteArray staging;
+        QVERIFY(loadAndUpload(&staging));
+    }
+    if (canMeasurePeak && rssBefore >= 0) {
+        const qint64 peak = procStatusValue("VmHWM");
+        qDebug("%s: peak resident size growth during load and upload: %.1f MB",
+               QTest::currentDataTag(), (peak - rssBefore) / (1024.0 * 1024.0));
+    }
+
+    QBENCHMARK {
+        QByteArray staging;
+        loadAndUpload(&staging);
+    }
+}
+
+QTEST_APPLESS_MAIN(meshloading)
+
+#include "tst_meshloading.moc"
@@ -4,6 +4,7 @@
 #include <QtTest>
 
 #include <QtCore/qvector.h>
+#include <QtCore/qmath.h>
 
 #include <ssg/qssgrendercontextcore.h>
 
@@ -15,6 +16,9 @@
 #include <QtQuick3DRuntimeRender/private/qssgrhicustommaterialsystem_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgrendershadercache_p.h>
 #include <QtQuick3DRuntimeRender/private/qssgdebugdrawsystem_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrendergeometry_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderskin_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrenderlight_p.h>
 #include <QtQuick3D/private/qquick3dscenemanager_p.h>
 
 class tst_renderer : public QObject
@@ -28,8 +32,20 @@ public:
 private Q_SLOTS:
     void initTestCase();
     void bench_prep();
+    void bench_skinning_data();
+    void bench_skinning();
+    void bench_shaderKeyLookup_data();
+    void bench_shaderKeyLookup();
+    void bench_staticScene_data();
+    void bench_staticScene();
+    void bench_drawPreparation();
 
 private:
+    void setupSkinnedScene();
+    void setupStaticScene();
+    void setupDrawScene();
+    void setRenderTarget(bool set);
+
     QRhi *rhi = nullptr;
     std::shared_ptr<QSSGRenderContextInterface> renderContext;
     QSharedPointer<QQuick3DSceneManager> sceneManager;
@@ -39,6 +55,23 @@ private:
     int modelCount = 0;
     QSSGRenderCamera camera{ QSSGRenderCamera::Type::OrthographicCamera };
     QSSGRenderLayer layer;
+
+    QSSGRenderCamera skinnedCamera{ QSSGRenderCamera::Type::OrthographicCamera };
+    QSSGRenderLayer skinnedLayer;
+    QSSGRenderGeometry skinnedGeometry;
+    QSSGRenderSkin skin;
+
+    QSSGRenderCamera staticCamera{ QSSGRenderCamera::Type::OrthographicCamera };
+    QSSGRenderLayer staticLayer;
+    QVector<QSSGRenderNode *> staticNodes;
+    QSSGRenderCamera drawCamera{ QSSGRenderCamera::Type::PerspectiveCamera };
+    QSSGRenderLayer drawLayer;
+    int drawModelCount = 0;
+
+    QRhiTexture *colorTexture = nullptr;
+    QRhiRenderBuffer *depthStencil = nullptr;
+    QRhiTextureRenderTarget *renderTarget = nullptr;
+    QRhiRenderPassDescriptor *rpDesc = nullptr;
 };
 
 tst_renderer::tst_renderer()
@@ -110,6 +143,187 @@ void tst_renderer::initTestCase()
             }
         }
     }
+
+    setupSkinnedScene();
+    setupStaticScene();
+    setupDrawScene();
+}
+
+void tst_renderer::setupSkinnedScene()
+{
+    // A grid of stand-ins for animated characters: a finely tessellated plane
+    // bound to two joints, drawn by the main pass and by a shadow map pass.
+    // Every model is skinned in each of these passes unless the skinning
+    // pre-pass is enabled.
+    const int gridSize = 64;
+    const int vertexCount = gridSize * gridSize;
+    struct Vertex {
+        float position[3];
+        float normal[3];
+        qint32 joints[4];
+        float weights[4];
+    };
+    QByteArray vertexData(vertexCount * sizeof(Vertex), Qt::Uninitialized);
+    auto *v = reinterpret_cast<Vertex *>(vertexData.data());
+    for (int y = 0; y != gridSize; ++y) {
+        for (int x = 0; x != gridSize; ++x, ++v) {
+            const float fx = float(x) / float(gridSize - 1);
+            const float fy = float(y) / float(gridSize - 1);
+            *v = { { fx * 10.0f - 5.0f, fy * 10.0f - 5.0f, 0.0f },
+                   { 0.0f, 0.0f, 1.0f },
+                   { 0, 1, 0, 0 },
+                   { 1.0f - fy, fy, 0.0f, 0.0f } };
+        }
+    }
+    QByteArray indexData((gridSize - 1) * (gridSize - 1) * 6 * sizeof(quint32), Qt::Uninitialized);
+    auto *i = reinterpret_cast<quint32 *>(indexData.data());
+    for (int y = 0; y != gridSize - 1; ++y) {
+        for (int x = 0; x != gridSize - 1; ++x) {
+            const quint32 v0 = y * gridSize + x;
+            const quint32 v1 = v0 + gridSize;
+            *i++ = v0; *i++ = v0 + 1; *i++ = v1;
+            *i++ = v1; *i++ = v0 + 1; *i++ = v1 + 1;
+        }
+    }
+
+    using Semantic = QSSGMesh::RuntimeMeshData::Attribute::Semantic;
+    using ComponentType = QSSGMesh::Mesh::ComponentType;
+    skinnedGeometry.setStride(sizeof(Vertex));
+    skinnedGeometry.setVertexData(vertexData);
+    skinnedGeometry.setIndexData(indexData);
+    skinnedGeometry.setBounds(QVector3D(-5.0f, -5.0f, 0.0f), QVector3D(5.0f, 5.0f, 0.0f));
+    skinnedGeometry.addAttribute(Semantic::PositionSemantic, offsetof(Vertex, position), ComponentType::Float32);
+    skinnedGeometry.addAttribute(Semantic::NormalSemantic, offsetof(Vertex, normal), ComponentType::Float32);
+    skinnedGeometry.addAttribute(Semantic::JointSemantic, offsetof(Vertex, joints), ComponentType::Int32);
+    skinnedGeometry.addAttribute(Semantic::WeightSemantic, offsetof(Vertex, weights), ComponentType::Float32);
+    skinnedGeometry.addAttribute(Semantic::IndexSemantic, 0, ComponentType::UnsignedInt32);
+
+    // Two joints, each with a transform and a normal transform, identity
+    const int boneCount = 2;
+    const int boneTexWidth = qCeil(qSqrt(boneCount * 4 * 2));
+    QByteArray boneData(boneTexWidth * boneTexWidth * 16, 0);
+    auto *m = reinterpret_cast<float *>(boneData.data());
+    for (int matrix = 0; matrix != boneCount * 2; ++matrix) {
+        for (int c = 0; c != 4; ++c)
+            m[matrix * 16 + c * 5] = 1.0f;
+    }
+    skin.setSize(QSize(boneTexWidth, boneTexWidth));
+    skin.setTextureData(boneData);
+    skin.boneCount = boneCount;
+
+    QSSGRenderLight *light = new QSSGRenderLight(QSSGRenderLight::Type::DirectionalLight);
+    light->m_castShadow = true;
+    skinnedLayer.addChild(*light);
+
+    bool ok = true;
+    int count = qEnvironmentVariableIntValue("tst_skinned_count", &ok);
+    if (!ok)
+        count = 10; // 10^2 = 100 skinned models
+    for (int x = 0; x != count; ++x) {
+        for (int y = 0; y != count; ++y) {
+            QSSGRenderModel *model = new QSSGRenderModel;
+            model->geometry = &skinnedGeometry;
+            model->skin = &skin;
+            model->castsShadows = true;
+            model->localTransform.translate(QVector3D(float(x - count / 2) * 12.0f,
+                                                      float(y - count / 2) * 12.0f,
+                                                      0.0f));
+            QSSGRenderDefaultMaterial *mat = new QSSGRenderDefaultMaterial;
+            model->materials.push_back(mat);
+            skinnedLayer.addChild(*model);
+        }
+    }
+    skinnedLayer.explicitCamera = &skinnedCamera;
+
+    colorTexture = rhi->newTexture(QRhiTexture::RGBA8, QSize(800, 600), 1, QRhiTexture::RenderTarget);
+    colorTexture->create();
+    depthStencil = rhi->newRenderBuffer(QRhiRenderBuffer::DepthStencil, QSize(800, 600));
+    depthStencil->create();
+    QRhiTextureRenderTargetDescription rtDesc({ colorTexture });
+    rtDesc.setDepthStencilBuffer(depthStencil);
+    renderTarget = rhi->newTextureRenderTarget(rtDesc);
+    rpDesc = renderTarget->newCompatibleRenderPassDescriptor();
+    renderTarget->setRenderPassDescriptor(rpDesc);
+    renderTarget->create();
+}
+
+void tst_renderer::setupStaticScene()
+{
+    // A large scene of which only a few nodes change per frame, mostly plain
+    // nodes with a model here and there.
+    bool ok = true;
+    int groupCount = qEnvironmentVariableIntValue("tst_static_groups", &ok);
+    if (!ok)
+        groupCount = 200; // 200 * 1000 = 200k nodes
+    const int nodesPerGroup = 1000;
+    const int nodesPerModel = 100;
+
+    QSSGRenderDefaultMaterial *mat = new QSSGRenderDefaultMaterial;
+    mat->lighting = QSSGRenderDefaultMaterial::MaterialLighting::NoLighting;
+
+    const int n = qCeil(qSqrt(qreal(groupCount)));
+    for (int g = 0; g != groupCount; ++g) {
+        QSSGRenderNode *group = new QSSGRenderNode;
+        group->localTransform.translate(QVector3D(float(g % n - n / 2) * 20.0f,
+                                                  float(g / n - n / 2) * 20.0f,
+                                                  0.0f));
+        staticLayer.addChild(*group);
+        for (int i = 0; i != nodesPerGroup; ++i) {
+            QSSGRenderNode *node = nullptr;
+            if (i % nodesPerModel == 0) {
+                QSSGRenderModel *model = new QSSGRenderModel;
+                model->meshPath = QSSGRenderPath("#Cube");
+                model->materials.push_back(mat);
+                node = model;
+            } else {
+                node = new QSSGRenderNode;
+            }
+            node->localTransform.translate(QVector3D(0.0f, 0.0f, -float(i)));
+            group->addChild(*node);
+            staticNodes.append(node);
+        }
+    }
+    staticLayer.explicitCamera = &staticCamera;
+}
+
+void tst_renderer::setupDrawScene()
+{
+    // Unlit models without shadows, so that each model is exactly one draw
+    // in the main pass, with a handful of materials between them.
+    bool ok = true;
+    drawModelCount = qEnvironmentVariableIntValue("tst_draws", &ok);
+    if (!ok)
+        drawModelCount = 50000;
+
+    QVector<QSSGRenderDefaultMaterial *> materials;
+    for (int i = 0; i != 8; ++i) {
+        QSSGRenderDefaultMaterial *mat = new QSSGRenderDefaultMaterial;
+        mat->lighting = QSSGRenderDefaultMaterial::MaterialLighting::NoLighting;
+        mat->color = QVector4D(float(i) / 8.0f, 0.5f, 0.5f, 1.0f);
+        materials.append(mat);
+    }
+
+    const int n = qCeil(qSqrt(qreal(drawModelCount)));
+    for (int i = 0; i != drawModelCount; ++i) {
+        QSSGRenderModel *model = new QSSGRenderModel;
+        model->meshPath = QSSGRenderPath("#Cube");
+        model->localTransform.translate(QVector3D(float(i % n - n / 2) * 150.0f,
+                                                  float(i / n - n / 2) * 150.0f,
+                                                  -10000.0f));
+        model->materials.push_back(materials.at(i % materials.size()));
+        drawLayer.addChild(*model);
+    }
+    drawCamera.clipFar = 100000.0f;
+    drawLayer.explicitCamera = &drawCamera;
+}
+
+void tst_renderer::setRenderTarget(bool set)
+{
+    QSSGRhiContextPrivate *rhiCtxD = QSSGRhiContextPrivate::get(renderContext->rhiContext().get());
+    rhiCtxD->setMainRenderPassDescriptor(set ? rpDesc : nullptr);
+    rhiCtxD->setRenderTarget(set ? renderTarget : nullptr);
+    if (set)
+        rhiCtxD->setMainPassSampleCount(1);
 }
 
 void tst_renderer::bench_prep()
@@ -123,6 +337,197 @@ void tst_renderer::bench_prep()
     }
 }
 
+void tst_renderer::bench_skinning_data()
+{
+    QTest::addColumn<bool>("prePass");
+    QTest::newRow("vertex shader") << false;
+    QTest::newRow("compute pre-pass") << true;
+}
+
+void tst_renderer::bench_skinning()
+{
+    QFETCH(bool, prePass);
+    if (prePass && !rhi->isFeatureSupported(QRhi::Compute))
+        QSKIP("Compute not supported");
+
+    const auto &renderer = renderContext->renderer();
+    const auto &rhiCtx = renderContext->rhiContext();
+    setRenderTarget(true);
+    QRhiCommandBuffer *cb = rhiCtx->commandBuffer();
+
+    skinnedLayer.skinningPrePassEnabled = prePass;
+
+    auto renderFrame = [&]() {
+        renderer->beginFrame(skinnedLayer);
+        renderer->prepareLayerForRender(skinnedLayer);
+        renderer->rhiPrepare(skinnedLayer);
+        cb->beginPass(renderTarget, Qt::black, { 1.0f, 0 });
+        renderer->rhiRender(skinnedLayer);
+        cb->endPass();
+        renderer->endFrame(skinnedLayer);
+    };
+
+    // Warm up the shader and pipeline caches, then record what one frame does.
+    // Note that the Null backend does not execute anything, so what is
+    // measured is the CPU side of preparing and recording the frame.
+    auto &stats = QSSGRhiContextStats::get(*rhiCtx);
+    stats.dynamicDataSources.insert(&skinnedLayer);
+    stats.start(&skinnedLayer);
+    renderFrame();
+    stats.stop(&skinnedLayer);
+    const auto &info = stats.perLayerInfo[&skinnedLayer];
+    quint64 drawCalls = QSSGRhiContextStats::totalDrawCallCountForPass(info.externalRenderPass);
+    quint64 vertices = QSSGRhiContextStats::totalVertexCountForPass(info.externalRenderPass);
+    for (const auto &pass : info.renderPasses) {
+        drawCalls += QSSGRhiContextStats::totalDrawCallCountForPass(pass);
+        vertices += QSSGRhiContextStats::totalVertexCountForPass(pass);
+    }
+    qDebug("%llu draw calls with %llu indices, %llu skinning dispatches for %llu vertices (%llu bytes uploaded)",
+           drawCalls, vertices,
+           info.skinningDispatches.callCount, info.skinningDispatches.vertexCount, info.skinningDispatches.uploadedBytes);
+    for (const auto &timing : info.passTimings) {
+        qDebug("  %s: prepare %.3f ms, render %.3f ms, %llu draw calls",
+               timing.name.constData(), timing.prepareTime / 1000000.0, timing.renderTime / 1000000.0,
+               timing.draws.callCount);
+    }
+    stats.dynamicDataSources.remove(&skinnedLayer);
+    stats.cleanupLayerInfo(&skinnedLayer);
+
+    QBENCHMARK {
+        renderFrame();
+    }
+
+    setRenderTarget(false);
+}
+
+void tst_renderer::bench_shaderKeyLookup_data()
+{
+    QTest::addColumn<bool>("binary");
+    QTest::newRow("string key") << false;
+    QTest::newRow("binary key") << true;
+}
+
+void tst_renderer::bench_shaderKeyLookup()
+{
+    // What a View3D pays for each of its materials when it first encounters
+    // them, or when they change, with the pipelines already in the window's
+    // shader cache: the string key has to be generated and hashed, the binary
+    // one only hashed.
+    QFETCH(bool, binary);
+
+    const int keyCount = 1000;
+    const QSSGShaderFeatures features;
+    const QSSGShaderDefaultMaterialKeyProperties keyProperties;
+    const auto &shaderCache = renderContext->shaderCache();
+    const auto pipeline = std::make_shared<QSSGRhiShaderPipeline>(*renderContext->rhiContext());
+
+    QVector<QSSGShaderDefaultMaterialKey> keys(keyCount);
+    for (int i = 0; i != keyCount; ++i) {
+        QSSGShaderDefaultMaterialKey &key = keys[i];
+        for (int word = 0; word != QSSGShaderDefaultMaterialKey::DataBufferSize; ++word)
+            key.m_dataBuffer[word] = quint32(i) * 2654435761u + quint32(word);
+        shaderCache->addRhiShaderPipeline(key, features, pipeline);
+    }
+
+    QByteArray keyString;
+    QBENCHMARK {
+        for (const QSSGShaderDefaultMaterialKey &key : std::as_const(keys)) {
+            if (binary) {
+                QVERIFY(shaderCache->tryGetRhiShaderPipeline(key, features));
+            } else {
+                keyString.clear();
+                key.toString(keyString, keyProperties);
+                shaderCache->tryGetRhiShaderPipeline(keyString, features);
+            }
+        }
+    }
+
+    shaderCache->releaseCachedResources();
+}
+
+void tst_renderer::bench_staticScene_data()
+{
+    QTest::addColumn<int>("movingNodes");
+    QTest::addColumn<bool>("toggleVisibility");
+    QTest::newRow("static") << 0 << false;
+    QTest::newRow("10 moving") << 10 << false;
+    QTest::newRow("10 moving, 1 shown/hidden") << 10 << true;
+}
+
+void tst_renderer::bench_staticScene()
+{
+    // Only the nodes that moved, or the visibility changes, should cost
+    // anything beyond the models that are prepared in every frame.
+    QFETCH(int, movingNodes);
+    QFETCH(bool, toggleVisibility);
+    QVERIFY(!staticNodes.isEmpty());
+
+    const auto &renderer = renderContext->renderer();
+    const auto prepareFrame = [&]() {
+        renderer->beginFrame(staticLayer);
+        renderer->prepareLayerForRender(staticLayer);
+        renderer->endFrame(staticLayer);
+    };
+    prepareFrame();
+    qDebug("%lld nodes", qlonglong(staticNodes.size()));
+
+    QSSGRenderNode *toggledNode = staticNodes.at(staticNodes.size() / 2);
+    quint32 frame = 0;
+    QBENCHMARK {
+        ++frame;
+        for (int i = 0; i != movingNodes; ++i) {
+            QSSGRenderNode *node = staticNodes.at((frame * 7919u + quint32(i) * 104729u) % quint32(staticNodes.size()));
+            node->localTransform.translate(0.0f, 0.0f, (frame % 2) ? 0.5f : -0.5f);
+            node->markDirty(QSSGRenderNode::DirtyFlag::TransformDirty);
+        }
+        if (toggleVisibility)
+            toggledNode->setState(QSSGRenderNode::LocalState::Active, (frame % 2) == 0);
+        prepareFrame();
+    }
+
+    toggledNode->setState(QSSGRenderNode::LocalState::Active, true);
+}
+
+void tst_renderer::bench_drawPreparation()
+{
+    // The per-draw bookkeeping of rhiPrepare(): finding the draw call data,
+    // the srb and the pipeline of every draw, which should all come from the
+    // previous frame once the caches are warm.
+    QVERIFY(drawModelCount > 0);
+    const auto &renderer = renderContext->renderer();
+    setRenderTarget(true);
+
+    auto prepareFrame = [&]() {
+        renderer->beginFrame(drawLayer);
+        renderer->prepareLayerForRender(drawLayer);
+        renderer->rhiPrepare(drawLayer);
+        renderer->endFrame(drawLayer);
+    };
+
+    prepareFrame(); // warm up the caches
+    prepareFrame();
+
+    const auto &globalInfo = QSSGRhiContextStats::get(*renderContext->rhiContext()).globalInfo;
+    const QSSGRhiContextStats::GlobalInfo before = globalInfo;
+    prepareFrame();
+    qDebug("%d draws: %llu pipelines and %llu srbs reused, %llu pipeline and %llu srb lookups",
+           drawModelCount,
+           globalInfo.pipelineReuses - before.pipelineReuses,
+           globalInfo.srbReuses - before.srbReuses,
+           (globalInfo.pipelineCacheHits + globalInfo.pipelineCacheMisses) - (before.pipelineCacheHits + before.pipelineCacheMisses),
+           (globalInfo.srbCacheHits + globalInfo.srbCacheMisses) - (before.srbCacheHits + before.srbCacheMisses));
+    qDebug("draw call data: %lld entries in %lld slots, srbs: %lld in %lld, pipelines: %lld in %lld",
+           qlonglong(globalInfo.drawCallDataCount), qlonglong(globalInfo.drawCallDataCapacity),
+           qlonglong(globalInfo.srbCacheCount), qlonglong(globalInfo.srbCacheCapacity),
+           qlonglong(globalInfo.pipelineCacheCount), qlonglong(globalInfo.pipelineCacheCapacity));
+
+    QBENCHMARK {
+        prepareFrame();
+    }
+
+    setRenderTarget(false);
+}
+
 QTEST_APPLESS_MAIN(tst_renderer)
 
 #include "tst_renderer.moc"
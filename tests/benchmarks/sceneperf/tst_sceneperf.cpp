@@ -0,0 +1,318 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtTest>
+
+#include <QtCore/qdiriterator.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/private/qabstractanimation_p.h>
+
+#include <QtGui/qguiapplication.h>
+
+#include <QtQuick/qquickview.h>
+#include <QtQuick/qquickitem.h>
+
+#include <ssg/qssgrendercontextcore.h>
+
+#include <QtQuick3D/private/qquick3dviewport_p.h>
+#include <QtQuick3D/private/qquick3drenderstats_p.h>
+#include <QtQuick3D/private/qquick3dscenemanager_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrhicontext_p.h>
+
+#include <algorithm>
+
+// Renders every scene of the baseline test suite, and any QML files given in
+// QT_QUICK3D_PERF_SCENES, on the Null QRhi backend and records the per-phase
+// CPU cost and the cache behavior of a number of warm frames.
+//
+// Environment variables:
+//   QT_QUICK3D_PERF_SCENES    Extra .qml files or directories, separated like PATH
+//   QT_QUICK3D_PERF_FRAMES    Number of measured frames per scene (default 20)
+//   QT_QUICK3D_PERF_BASELINE  JSON file with the results to compare against
+//   QT_QUICK3D_PERF_RESULTS   JSON file the results are written to
+//
+// The results file has the same format as the baseline file, so a run on a
+// known good build can be promoted to the baseline as-is. The baseline can
+// additionally have a "thresholds" object overriding the defaults below.
+
+static const int WarmupFrames = 5;
+
+struct Thresholds
+{
+    double relativeTime = 0.25; // CPU times may grow by this fraction...
+    double absoluteTime = 0.1; // ...plus this many milliseconds
+    double drawCalls = 0; // counts may grow by this many
+    double cacheMisses = 0;
+};
+
+static const char *TimeMetrics[] = { "syncTime", "prepareTime", "renderTime" };
+static const char *DrawMetrics[] = { "drawCalls", "drawVertices" };
+static const char *CacheMetrics[] = { "warmPipelineCacheMisses", "warmSrbCacheMisses", "warmShaderCacheMisses" };
+
+class tst_sceneperf : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_sceneperf() = default;
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void bench_scene_data();
+    void bench_scene();
+
+private:
+    bool renderFrame(QQuickView &view);
+
+    QStringList sceneFiles;
+    QString dataPath;
+    int frameCount = 20;
+    QJsonObject baselineScenes;
+    Thresholds thresholds;
+    QJsonObject results;
+};
+
+static double median(QVector<double> values)
+{
+    if (values.isEmpty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    return values.at(values.size() / 2);
+}
+
+static void collectScenes(const QString &path, const QStringList &ignored, QStringList *files)
+{
+    const QFileInfo fi(path);
+    if (fi.isFile()) {
+        files->append(fi.canonicalFilePath());
+        return;
+    }
+    const QString root = fi.canonicalFilePath();
+    QDirIterator it(root, { QStringLiteral("*.qml") }, QDir::Files, QDirIterator::Subdirectories);
+    QStringList found;
+    while (it.hasNext()) {
+        const QString filePath = it.next();
+        if (!ignored.contains(filePath.mid(root.size() + 1)))
+            found.append(filePath);
+    }
+    std::sort(found.begin(), found.end());
+    files->append(found);
+}
+
+void tst_sceneperf::initTestCase()
+{
+    QUnifiedTimer::instance()->setConsistentTiming(true);
+
+    bool ok = false;
+    const int frames = qEnvironmentVariableIntValue("QT_QUICK3D_PERF_FRAMES", &ok);
+    if (ok && frames > 0)
+        frameCount = frames;
+
+    // Same layout and Ignore list as used by tst_baseline_qquick3d
+    dataPath = QFINDTESTDATA("../../baseline/data/.");
+    if (!dataPath.isEmpty()) {
+        dataPath = QFileInfo(dataPath).canonicalFilePath();
+        QStringList ignored;
+        QFile ignoreFile(dataPath + QStringLiteral("/Ignore"));
+        if (ignoreFile.open(QIODevice::ReadOnly)) {
+            while (!ignoreFile.atEnd()) {
+                const QByteArray line = ignoreFile.readLine().trimmed();
+                if (!line.isEmpty() && !line.startsWith('#'))
+                    ignored.append(QString::fromUtf8(line));
+            }
+        }
+        collectScenes(dataPath, ignored, &sceneFiles);
+    }
+
+    const QStringList extraScenes = qEnvironmentVariable("QT_QUICK3D_PERF_SCENES").split(QDir::listSeparator(), Qt::SkipEmptyParts);
+    for (const QString &path : extraScenes)
+        collectScenes(path, {}, &sceneFiles);
+
+    if (sceneFiles.isEmpty())
+        QSKIP("No scenes found, set QT_QUICK3D_PERF_SCENES");
+
+    const QString baselineFile = qEnvironmentVariable("QT_QUICK3D_PERF_BASELINE");
+    if (!baselineFile.isEmpty()) {
+        QFile f(baselineFile);
+        QVERIFY2(f.open(QIODevice::ReadOnly), qPrintable(f.errorString()));
+        QJsonParseError error;
+        const QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &error);
+        QVERIFY2(doc.isObject(), qPrintable(error.errorString()));
+        baselineScenes = doc[QLatin1String("scenes")].toObject();
+        const QJsonObject t = doc[QLatin1String("thresholds")].toObject();
+        thresholds.relativeTime = t[QLatin1String("relativeTime")].toDouble(thresholds.relativeTime);
+        thresholds.absoluteTime = t[QLatin1String("absoluteTime")].toDouble(thresholds.absoluteTime);
+        thresholds.drawCalls = t[QLatin1String("drawCalls")].toDouble(thresholds.drawCalls);
+        thresholds.cacheMisses = t[QLatin1String("cacheMisses")].toDouble(thresholds.cacheMisses);
+    }
+}
+
+void tst_sceneperf::cleanupTestCase()
+{
+    const QString resultsFile = qEnvironmentVariable("QT_QUICK3D_PERF_RESULTS");
+    if (resultsFile.isEmpty() || results.isEmpty())
+        return;
+
+    QJsonObject root;
+    root[QLatin1String("frames")] = frameCount;
+    root[QLatin1String("scenes")] = results;
+    QFile f(resultsFile);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        qWarning("Failed to write %s: %s", qPrintable(resultsFile), qPrintable(f.errorString()));
+    else
+        f.write(QJsonDocument(root).toJson());
+}
+
+void tst_sceneperf::bench_scene_data()
+{
+    QTest::addColumn<QString>("qmlFile");
+    for (const QString &filePath : std::as_const(sceneFiles)) {
+        const QString name = (!dataPath.isEmpty() && filePath.startsWith(dataPath)) ? filePath.mid(dataPath.size() + 1)
+                                                                                   : filePath;
+        QTest::newRow(name.toUtf8().constData()) << filePath;
+    }
+}
+
+bool tst_sceneperf::renderFrame(QQuickView &view)
+{
+    QSignalSpy frameSwapped(&view, &QQuickWindow::frameSwapped);
+    view.update();
+    return frameSwapped.wait(5000);
+}
+
+void tst_sceneperf::bench_scene()
+{
+    QFETCH(QString, qmlFile);
+
+    QQuickView view;
+    view.setSource(QUrl::fromLocalFile(qmlFile));
+    if (view.status() != QQuickView::Ready) {
+        // Scenes using the types of the baseline scene grabber end up here
+        QSKIP(qPrintable(QStringLiteral("Failed to load: ") + view.errors().value(0).toString()));
+    }
+    if (view.initialSize().isEmpty())
+        view.resize(400, 400);
+
+    QList<QQuick3DViewport *> viewports = view.rootObject()->findChildren<QQuick3DViewport *>();
+    if (auto *rootViewport = qobject_cast<QQuick3DViewport *>(view.rootObject()))
+        viewports.prepend(rootViewport);
+    if (viewports.isEmpty())
+        QSKIP("No View3D in scene");
+    for (QQuick3DViewport *viewport : std::as_const(viewports))
+        viewport->renderStats()->setExtendedDataCollectionEnabled(true);
+
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QElapsedTimer coldTimer;
+    coldTimer.start();
+    for (int i = 0; i < WarmupFrames; ++i)
+        QVERIFY(renderFrame(view));
+    const double coldTime = coldTimer.nsecsElapsed() / 1000000.0;
+
+    QQuick3DWindowAttachment *wa = QQuick3DSceneManager::getOrSetWindowAttachment(view);
+    QVERIFY(wa && wa->rci());
+    QSSGRhiContext *rhiCtx = wa->rci()->rhiContext().get();
+    QSSGRhiContextStats &stats = QSSGRhiContextStats::get(*rhiCtx);
+    const QSSGRhiContextStats::GlobalInfo coldInfo = stats.globalInfo;
+
+    QVector<double> syncTimes, prepareTimes, renderTimes;
+    quint64 drawCalls = 0;
+    quint64 drawVertices = 0;
+    for (int frame = 0; frame < frameCount; ++frame) {
+        QVERIFY(renderFrame(view));
+        double syncTime = 0, prepareTime = 0, renderTime = 0;
+        for (QQuick3DViewport *viewport : std::as_const(viewports)) {
+            syncTime += viewport->renderStats()->syncTime();
+            prepareTime += viewport->renderStats()->renderPrepareTime();
+            renderTime += viewport->renderStats()->renderTime();
+        }
+        syncTimes.append(syncTime);
+        prepareTimes.append(prepareTime);
+        renderTimes.append(renderTime);
+        if (frame == frameCount - 1) {
+            for (const auto &info : std::as_const(stats.perLayerInfo)) {
+                drawCalls += QSSGRhiContextStats::totalDrawCallCountForPass(info.externalRenderPass);
+                drawVertices += QSSGRhiContextStats::totalVertexCountForPass(info.externalRenderPass);
+                for (const auto &pass : info.renderPasses) {
+                    drawCalls += QSSGRhiContextStats::totalDrawCallCountForPass(pass);
+                    drawVertices += QSSGRhiContextStats::totalVertexCountForPass(pass);
+                }
+            }
+        }
+    }
+
+    const QSSGRhiContextStats::GlobalInfo &warmInfo = stats.globalInfo;
+    const QRhiStats rhiStats = rhiCtx->rhi()->statistics();
+
+    QJsonObject result;
+    result[QLatin1String("syncTime")] = median(syncTimes);
+    result[QLatin1String("prepareTime")] = median(prepareTimes);
+    result[QLatin1String("renderTime")] = median(renderTimes);
+    result[QLatin1String("coldTime")] = coldTime;
+    result[QLatin1String("drawCalls")] = qint64(drawCalls);
+    result[QLatin1String("drawVertices")] = qint64(drawVertices);
+    result[QLatin1String("coldPipelineCacheMisses")] = qint64(coldInfo.pipelineCacheMisses);
+    result[QLatin1String("coldShaderCacheMisses")] = qint64(coldInfo.shaderCacheMisses);
+    result[QLatin1String("warmPipelineCacheMisses")] = qint64(warmInfo.pipelineCacheMisses - coldInfo.pipelineCacheMisses);
+    result[QLatin1String("warmSrbCacheMisses")] = qint64(warmInfo.srbCacheMisses - coldInfo.srbCacheMisses);
+    result[QLatin1String("warmShaderCacheMisses")] = qint64(warmInfo.shaderCacheMisses - coldInfo.shaderCacheMisses);
+    result[QLatin1String("warmShaderCacheHits")] = qint64(warmInfo.shaderCacheHits - coldInfo.shaderCacheHits);
+    // Only reported by backends with a memory allocator, such as Vulkan
+    result[QLatin1String("gpuAllocations")] = qint64(rhiStats.allocCount);
+    result[QLatin1String("gpuUsedBytes")] = qint64(rhiStats.usedBytes);
+    result[QLatin1String("imageDataSize")] = qint64(warmInfo.imageDataSize);
+    result[QLatin1String("meshDataSize")] = qint64(warmInfo.meshDataSize);
+
+    const QString tag = QString::fromUtf8(QTest::currentDataTag());
+    results[tag] = result;
+    qDebug().noquote() << QJsonDocument(result).toJson(QJsonDocument::Compact);
+
+    if (!baselineScenes.contains(tag))
+        return;
+
+    const QJsonObject baseline = baselineScenes[tag].toObject();
+    QStringList regressions;
+    auto check = [&](const char *metric, double allowed) {
+        const QLatin1String key(metric);
+        if (!baseline.contains(key))
+            return;
+        const double expected = baseline[key].toDouble();
+        const double actual = result[key].toDouble();
+        if (actual > expected + allowed)
+            regressions.append(QStringLiteral("%1: %2 (baseline %3)").arg(key).arg(actual).arg(expected));
+    };
+    for (const char *metric : TimeMetrics) {
+        const double expected = baseline[QLatin1String(metric)].toDouble();
+        check(metric, expected * thresholds.relativeTime + thresholds.absoluteTime);
+    }
+    for (const char *metric : DrawMetrics)
+        check(metric, thresholds.drawCalls);
+    for (const char *metric : CacheMetrics)
+        check(metric, thresholds.cacheMisses);
+
+    if (!regressions.isEmpty())
+        QFAIL(qPrintable(regressions.join(QLatin1String(", "))));
+}
+
+int main(int argc, char *argv[])
+{
+    // Headless, deterministic and single threaded, so that the statistics can
+    // be read between frames. Any of these can be overridden from outside, for
+    // example to profile a real backend.
+    if (!qEnvironmentVariableIsSet("QSG_RHI_BACKEND"))
+        qputenv("QSG_RHI_BACKEND", "null");
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    qputenv("QSG_RENDER_LOOP", "basic");
+    QHashSeed::setDeterministicGlobalSeed();
+
+    QGuiApplication app(argc, argv);
+    tst_sceneperf tc;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "tst_sceneperf.moc"
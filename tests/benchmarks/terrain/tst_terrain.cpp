@@ -0,0 +1,216 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtTest>
+
+#include <QtCore/qtemporarydir.h>
+#include <QtCore/private/qabstractanimation_p.h>
+
+#include <QtGui/qguiapplication.h>
+#include <QtGui/qimage.h>
+
+#include <QtQuick/qquickview.h>
+#include <QtQuick/qquickitem.h>
+
+#include <ssg/qssgrendercontextcore.h>
+
+#include <QtQuick3D/private/qquick3dnode_p.h>
+#include <QtQuick3D/private/qquick3dviewport_p.h>
+#include <QtQuick3D/private/qquick3drenderstats_p.h>
+#include <QtQuick3D/private/qquick3dscenemanager_p.h>
+#include <QtQuick3DRuntimeRender/private/qssgrhicontext_p.h>
+
+#include <algorithm>
+
+// Compares a HeightFieldGeometry with a HeightFieldTerrain of the same height
+// map on the Null QRhi backend, while flying the camera low over the surface.
+// Reports the loading time, and per frame the preparation time, the draw
+// calls and the vertices drawn.
+
+static const int FlightFrames = 60;
+
+class tst_terrain : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void bench_terrain_data();
+    void bench_terrain();
+
+private:
+    bool renderFrame(QQuickView &view);
+    QString writeHeightMap(int size);
+
+    QTemporaryDir tempDir;
+};
+
+void tst_terrain::initTestCase()
+{
+    QUnifiedTimer::instance()->setConsistentTiming(true);
+    QVERIFY(tempDir.isValid());
+}
+
+// Rolling hills with some finer detail, so that the errors differ over the map
+QString tst_terrain::writeHeightMap(int size)
+{
+    const QString fileName = tempDir.filePath(QStringLiteral("heightmap_%1.png").arg(size));
+    if (QFile::exists(fileName))
+        return fileName;
+
+    QImage image(size, size, QImage::Format_Grayscale16);
+    for (int y = 0; y < size; ++y) {
+        quint16 *line = reinterpret_cast<quint16 *>(image.scanLine(y));
+        for (int x = 0; x < size; ++x) {
+            const double u = double(x) / (size - 1);
+            const double v = double(y) / (size - 1);
+            double h = 0.35 * qSin(u * 6.0) * qCos(v * 5.0)
+                    + 0.1 * qSin(u * 41.0 + v * 13.0)
+                    + 0.03 * qSin(u * 211.0) * qSin(v * 197.0);
+            line[x] = quint16(qBound(0.0, 0.5 + h, 1.0) * 65535.0);
+        }
+    }
+    if (!image.save(fileName))
+        return QString();
+    return fileName;
+}
+
+void tst_terrain::bench_terrain_data()
+{
+    QTest::addColumn<QString>("type");
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("geometry 1025") << QStringLiteral("geometry") << 1025;
+    QTest::newRow("terrain 1025") << QStringLiteral("terrain") << 1025;
+    QTest::newRow("terrain 4097") << QStringLiteral("terrain") << 4097;
+}
+
+bool tst_terrain::renderFrame(QQuickView &view)
+{
+    QSignalSpy frameSwapped(&view, &QQuickWindow::frameSwapped);
+    view.update();
+    return frameSwapped.wait(5000);
+}
+
+void tst_terrain::bench_terrain()
+{
+    QFETCH(QString, type);
+    QFETCH(int, size);
+
+    const QString heightMap = writeHeightMap(size);
+    QVERIFY(!heightMap.isEmpty());
+
+    const QString surface = type == QLatin1String("terrain")
+            ? QStringLiteral("HeightFieldTerrain {\n"
+                             "    objectName: \"surface\"\n"
+                             "    source: \"%1\"\n"
+                             "    extents: Qt.vector3d(10000, 1000, 10000)\n"
+                             "    camera: camera\n"
+                             "    materials: PrincipledMaterial { }\n"
+                             "}\n")
+            : QStringLiteral("Model {\n"
+                             "    objectName: \"surface\"\n"
+                             "    property bool loading: false\n"
+                             "    geometry: HeightFieldGeometry {\n"
+                             "        heightMap: \"%1\"\n"
+                             "        extents: Qt.vector3d(10000, 1000, 10000)\n"
+                             "    }\n"
+                             "    materials: PrincipledMaterial { }\n"
+                             "}\n");
+    const QString qml = QStringLiteral("import QtQuick\n"
+                                       "import QtQuick3D\n"
+                                       "import QtQuick3D.Helpers\n"
+                                       "View3D {\n"
+                                       "    width: 1280; height: 720\n"
+                                       "    PerspectiveCamera {\n"
+                                       "        id: camera\n"
+                                       "        objectName: \"camera\"\n"
+                                       "        frustumCullingEnabled: true\n"
+                                       "        clipFar: 20000\n"
+                                       "        position: Qt.vector3d(-4000, 700, -4000)\n"
+                                       "        eulerRotation.y: -135\n"
+                                       "    }\n"
+                                       "    DirectionalLight { eulerRotation.x: -45 }\n"
+                                       "%1"
+                                       "}\n").arg(surface.arg(QUrl::fromLocalFile(heightMap).toString()));
+    const QString qmlFile = tempDir.filePath(QStringLiteral("%1_%2.qml").arg(type).arg(size));
+    {
+        QFile f(qmlFile);
+        QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        f.write(qml.toUtf8());
+    }
+
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+
+    QQuickView view;
+    view.setSource(QUrl::fromLocalFile(qmlFile));
+    QVERIFY2(view.status() == QQuickView::Ready, qPrintable(view.errors().value(0).toString()));
+    auto *viewport = qobject_cast<QQuick3DViewport *>(view.rootObject());
+    QVERIFY(viewport);
+    viewport->renderStats()->setExtendedDataCollectionEnabled(true);
+    auto *camera = view.rootObject()->findChild<QQuick3DNode *>(QStringLiteral("camera"));
+    QVERIFY(camera);
+
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+    QVERIFY(renderFrame(view));
+
+    // The terrain loads in the background, wait until the first view is complete
+    auto *surfaceObject = view.rootObject()->findChild<QObject *>(QStringLiteral("surface"));
+    QVERIFY(surfaceObject);
+    QTRY_VERIFY_WITH_TIMEOUT(!surfaceObject->property("loading").toBool(), 60000);
+    QVERIFY(renderFrame(view));
+    const double loadTime = loadTimer.nsecsElapsed() / 1000000.0;
+
+    QQuick3DWindowAttachment *wa = QQuick3DSceneManager::getOrSetWindowAttachment(view);
+    QVERIFY(wa && wa->rci());
+    QSSGRhiContextStats &stats = QSSGRhiContextStats::get(*wa->rci()->rhiContext());
+
+    // Fly along the diagonal, letting the background jobs catch up between frames
+    QVector<double> prepareTimes;
+    quint64 maxDrawCalls = 0;
+    quint64 maxDrawVertices = 0;
+    for (int frame = 0; frame < FlightFrames; ++frame) {
+        const float t = float(frame) / (FlightFrames - 1);
+        camera->setPosition(QVector3D(-4000 + 8000 * t, 700, -4000 + 8000 * t));
+        QCoreApplication::processEvents();
+        QVERIFY(renderFrame(view));
+        prepareTimes.append(viewport->renderStats()->renderPrepareTime());
+
+        quint64 drawCalls = 0;
+        quint64 drawVertices = 0;
+        for (const auto &info : std::as_const(stats.perLayerInfo)) {
+            drawCalls += QSSGRhiContextStats::totalDrawCallCountForPass(info.externalRenderPass);
+            drawVertices += QSSGRhiContextStats::totalVertexCountForPass(info.externalRenderPass);
+            for (const auto &pass : info.renderPasses) {
+                drawCalls += QSSGRhiContextStats::totalDrawCallCountForPass(pass);
+                drawVertices += QSSGRhiContextStats::totalVertexCountForPass(pass);
+            }
+        }
+        maxDrawCalls = qMax(maxDrawCalls, drawCalls);
+        maxDrawVertices = qMax(maxDrawVertices, drawVertices);
+    }
+    std::sort(prepareTimes.begin(), prepareTimes.end());
+
+    qDebug("%s: load %.1f ms, prepare %.3f ms (median), at most %llu draw calls and %llu vertices",
+           QTest::currentDataTag(), loadTime, prepareTimes.at(prepareTimes.size() / 2),
+           maxDrawCalls, maxDrawVertices);
+}
+
+int main(int argc, char *argv[])
+{
+    // Same setup as the sceneperf benchmark, see there
+    if (!qEnvironmentVariableIsSet("QSG_RHI_BACKEND"))
+        qputenv("QSG_RHI_BACKEND", "null");
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    qputenv("QSG_RENDER_LOOP", "basic");
+
+    QGuiApplication app(argc, argv);
+    tst_terrain tc;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "tst_terrain.moc"
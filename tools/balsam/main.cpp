@@ -7,16 +7,28 @@
 #include <QtCore/QDir>
 #include <QtCore/QVariant>
 #include <QtCore/QHash>
-
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QMutex>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QUrl>
+#include <QtCore/QWaitCondition>
+
+#include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
 
 #include <QtGui/QImageReader>
 
 #include <QtQuick3DAssetImport/private/qssgassetimportmanager_p.h>
+#include <QtQuick3DAssetUtils/private/qssgqmlutilities_p.h>
+#include <QtQuick3DAssetUtils/private/qssgscenedesc_p.h>
 #include <QtQuick3DIblBaker/private/qssgiblbaker_p.h>
 
 #include <QJsonDocument>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 class OptionsManager {
 public:
@@ -140,14 +152,16 @@ struct BuiltinConditioners
 {
     QSSGAssetImportManager::ImportState run(const QString &filename,
                                             const QDir &outputPath,
-                                            QString *error);
+                                            QString *error,
+                                            QStringList *generatedFiles = nullptr);
 
     QSSGIblBaker iblBaker;
 };
 
 QSSGAssetImportManager::ImportState BuiltinConditioners::run(const QString &filename,
                                                              const QDir &outputPath,
-                                                             QString *error)
+                                                             QString *error,
+                                                             QStringList *outGeneratedFiles)
 {
     QFileInfo fileInfo(filename);
     if (!fileInfo.exists()) {
@@ -175,10 +189,163 @@ QSSGAssetImportManager::ImportState BuiltinConditioners::run(const QString &file
 
     for (const auto &file : generatedFiles)
         qDebug() << "generated file:" << file;
+    if (outGeneratedFiles)
+        *outGeneratedFiles = generatedFiles;
 
     return result;
 }
 
+// The files a source file refers to, and which are converted with it: the
+// buffers and images of glTF files, and the material libraries of OBJ files.
+static QStringList referencedFiles(const QFileInfo &fileInfo)
+{
+    QStringList files;
+    const QString extension = fileInfo.suffix().toLower();
+    QFile file(fileInfo.absoluteFilePath());
+    if (extension == QStringLiteral("gltf")) {
+        if (!file.open(QIODevice::ReadOnly))
+            return files;
+        const QJsonObject gltf = QJsonDocument::fromJson(file.readAll()).object();
+        for (const QString &key : { QStringLiteral("buffers"), QStringLiteral("images") }) {
+            const QJsonArray items = gltf.value(key).toArray();
+            for (const QJsonValue &item : items) {
+                const QString uri = item.toObject().value(QStringLiteral("uri")).toString();
+                if (!uri.isEmpty() && !uri.startsWith(QStringLiteral("data:")))
+                    files.append(fileInfo.dir().absoluteFilePath(QUrl::fromPercentEncoding(uri.toUtf8())));
+            }
+        }
+    } else if (extension == QStringLiteral("obj")) {
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+            return files;
+        while (!file.atEnd()) {
+            const QByteArray line = file.readLine().trimmed();
+            if (line.startsWith("mtllib "))
+                files.append(fileInfo.dir().absoluteFilePath(QString::fromUtf8(line.mid(7).trimmed())));
+        }
+    }
+    return files;
+}
+
+static bool addFileData(QCryptographicHash &hash, const QString &fileName)
+{
+    QFile file(fileName);
+    return file.open(QIODevice::ReadOnly) && hash.addData(&file);
+}
+
+// Hashes everything the result of converting a file depends on: the version
+// of the converter, the options, and the contents of the file and of the
+// files it refers to.
+static QByteArray conversionHash(const QFileInfo &fileInfo, const QJsonObject &options)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(QByteArrayView(QT_VERSION_STR));
+    hash.addData(QJsonDocument(options).toJson(QJsonDocument::Compact));
+    addFileData(hash, fileInfo.absoluteFilePath());
+    const QStringList files = referencedFiles(fileInfo);
+    for (const QString &fileName : files) {
+        hash.addData(fileName.toUtf8());
+        if (!addFileData(hash, fileName))
+            hash.addData(QByteArrayView("missing"));
+    }
+    return hash.result().toHex();
+}
+
+// Remembers what each source file was last converted from, the files that
+// were generated and the ids given to the objects in them, so that the files
+// that did not change can be skipped.
+class Manifest
+{
+public:
+    void load(const QString &fileName)
+    {
+        m_fileName = fileName;
+        QFile file(fileName);
+        if (!file.exists())
+            return;
+        if (!file.open(QIODevice::ReadOnly)) {
+            std::cerr << "Could not read manifest " << qPrintable(fileName) << ", converting all files\n";
+            return;
+        }
+        const QJsonObject manifest = QJsonDocument::fromJson(file.readAll()).object();
+        if (manifest.value(QStringLiteral("version")).toInt() == version)
+            m_files = manifest.value(QStringLiteral("files")).toObject();
+    }
+
+    bool save() const
+    {
+        QSaveFile file(m_fileName);
+        if (!file.open(QIODevice::WriteOnly))
+            return false;
+        const QJsonObject manifest { { QStringLiteral("version"), version },
+                                     { QStringLiteral("files"), m_files } };
+        file.write(QJsonDocument(manifest).toJson());
+        return file.commit();
+    }
+
+    bool isUpToDate(const QString &sourceFile, const QByteArray &hash, const QDir &outputPath) const
+    {
+        const QJsonObject entry = m_files.value(sourceFile).toObject();
+        if (entry.value(QStringLiteral("hash")).toString().toLatin1() != hash)
+            return false;
+        const QJsonArray outputs = entry.value(QStringLiteral("outputs")).toArray();
+        for (const QJsonValue &output : outputs) {
+            if (!outputPath.exists(output.toString()))
+                return false;
+        }
+        return true;
+    }
+
+    QStringList ids(const QString &sourceFile) const
+    {
+        QStringList result;
+        const QJsonArray ids = m_files.value(sourceFile).toObject().value(QStringLiteral("ids")).toArray();
+        for (const QJsonValue &id : ids)
+            result.append(id.toString());
+        return result;
+    }
+
+    void update(const QString &sourceFile, const QByteArray &hash, const QStringList &outputs,
+                const QStringList &ids, const QDir &outputPath)
+    {
+        QJsonArray relativeOutputs;
+        for (const QString &output : outputs)
+            relativeOutputs.append(outputPath.relativeFilePath(output));
+        m_files.insert(sourceFile, QJsonObject { { QStringLiteral("hash"), QString::fromLatin1(hash) },
+                                                 { QStringLiteral("outputs"), relativeOutputs },
+                                                 { QStringLiteral("ids"), QJsonArray::fromStringList(ids) } });
+    }
+
+    void remove(const QString &sourceFile) { m_files.remove(sourceFile); }
+
+private:
+    static constexpr int version = 2;
+    QString m_fileName;
+    QJsonObject m_files;
+};
+
+struct Conversion
+{
+    ~Conversion()
+    {
+        if (scene)
+            scene->cleanup();
+    }
+
+    QString fileName;
+    QJsonObject options;
+    QByteArray hash;
+    bool skip = false;
+    // Whether the file is imported into a scene first, possibly on another
+    // thread, and written out after the files before it.
+    bool sceneImport = false;
+
+    // Set by importScene()
+    bool imported = false;
+    std::unique_ptr<QSSGSceneDesc::Scene> scene;
+    QSSGAssetImportManager::ImportState result = QSSGAssetImportManager::ImportState::Unsupported;
+    QString error;
+};
+
 int main(int argc, char *argv[])
 {
     QGuiApplication app(argc, argv);
@@ -206,6 +373,10 @@ int main(int argc, char *argv[])
 
     QCommandLineOption loadOptionsFromFileOption({"f","options-file"}, QStringLiteral("Load options from <file>"), QStringLiteral("file"));
     cmdLineParser.addOption(loadOptionsFromFileOption);
+    QCommandLineOption jobsOption({ "j", "jobs" }, QStringLiteral("Import up to <count> files at the same time, 0 for one per processor core. Default is 1"), QStringLiteral("count"), QStringLiteral("1"));
+    cmdLineParser.addOption(jobsOption);
+    QCommandLineOption manifestOption(QStringLiteral("manifest"), QStringLiteral("Skip the files that did not change, with the same options, since the conversion recorded in <file>, and record this conversion in it"), QStringLiteral("file"));
+    cmdLineParser.addOption(manifestOption);
 
     // Get Plugin options
     if (canUsePlugins) {
@@ -234,43 +405,155 @@ int main(int argc, char *argv[])
     if (assetFileNames.isEmpty())
         cmdLineParser.showHelp(1);
 
-    // Convert each assetFile is possible
+    QJsonObject loadedOptions;
+    QStringList sceneExtensions;
+    if (canUsePlugins) {
+        if (cmdLineParser.isSet(loadOptionsFromFileOption)) {
+            QFile optionsFile(cmdLineParser.value(loadOptionsFromFileOption));
+            if (!optionsFile.open(QIODevice::ReadOnly)) {
+                qCritical() << "Could not open options file" << optionsFile.fileName() << "for reading.";
+                return -1;
+            }
+            QByteArray optionData = optionsFile.readAll();
+            QJsonParseError error;
+            auto optionsDoc = QJsonDocument::fromJson(optionData, &error);
+            if (optionsDoc.isEmpty()) {
+                qCritical() << "Could not read options file:" << error.errorString();
+                return -1;
+            }
+            loadedOptions = optionsDoc.object();
+        }
+
+        const auto pluginInfos = assetImporter->getImporterPluginInfos();
+        for (const auto &pluginInfo : pluginInfos) {
+            if (pluginInfo.name == QStringLiteral("assimp"))
+                sceneExtensions = pluginInfo.inputExtensions;
+        }
+    }
+
+    int jobs = cmdLineParser.value(jobsOption).toInt();
+    if (jobs <= 0)
+        jobs = QThread::idealThreadCount();
+
+    const bool useManifest = cmdLineParser.isSet(manifestOption);
+    Manifest manifest;
+    if (useManifest)
+        manifest.load(cmdLineParser.value(manifestOption));
+
+    std::vector<std::unique_ptr<Conversion>> conversions;
+    conversions.reserve(assetFileNames.size());
     for (const auto &assetFileName : assetFileNames) {
-        QString errorString;
-        QSSGAssetImportManager::ImportState result = QSSGAssetImportManager::ImportState::Unsupported;
+        auto conversion = std::make_unique<Conversion>();
+        conversion->fileName = assetFileName;
+        const QFileInfo fileInfo(assetFileName);
         if (canUsePlugins) {
             QJsonObject options = assetImporter->getOptionsForFile(assetFileName);
-            QJsonObject loadedOptions;
+            conversion->options = optionsManager.processCommandLineOptions(cmdLineParser, options, loadedOptions);
+            conversion->sceneImport = fileInfo.exists() && sceneExtensions.contains(fileInfo.suffix().toLower());
+        }
+        if (useManifest && fileInfo.exists()) {
+            conversion->hash = conversionHash(fileInfo, conversion->options);
+            conversion->skip = manifest.isUpToDate(fileInfo.absoluteFilePath(), conversion->hash, outputDirectory);
+            // The ids in the generated files, which also name the meshes and
+            // textures, are unique across all the files converted together.
+            // The ones of the files that are kept are not given out again.
+            if (conversion->skip)
+                QSSGQmlUtilities::reserveIds(manifest.ids(fileInfo.absoluteFilePath()));
+        }
+        conversions.push_back(std::move(conversion));
+    }
 
-            if (cmdLineParser.isSet(loadOptionsFromFileOption)) {
-                QFile optionsFile(cmdLineParser.value(loadOptionsFromFileOption));
-                if (!optionsFile.open(QIODevice::ReadOnly)) {
-                    qCritical() << "Could not open options file" << optionsFile.fileName() << "for reading.";
-                    return -1;
-                }
-                QByteArray optionData = optionsFile.readAll();
-                QJsonParseError error;
-                auto optionsDoc = QJsonDocument::fromJson(optionData, &error);
-                if (optionsDoc.isEmpty()) {
-                    qCritical() << "Could not read options file:" << error.errorString();
-                    return -1;
-                }
-                loadedOptions = optionsDoc.object();
+    // The scenes are imported on worker threads, but written out one after
+    // the other in the order of the files, so that the output is the same as
+    // when converting them one at a time. A few scenes are imported ahead of
+    // the one being written, not all, to limit the memory used.
+    QMutex importMutex;
+    QWaitCondition importDone;
+    const auto importScene = [&](Conversion *conversion) {
+        auto scene = std::make_unique<QSSGSceneDesc::Scene>();
+        QString error;
+        const QUrl url = QUrl::fromLocalFile(QFileInfo(conversion->fileName).absoluteFilePath());
+        const auto result = assetImporter->importFile(url, *scene, conversion->options, &error);
+
+        QMutexLocker locker(&importMutex);
+        conversion->scene = std::move(scene);
+        conversion->result = result;
+        conversion->error = error;
+        conversion->imported = true;
+        importDone.wakeAll();
+    };
+
+    QThreadPool importPool;
+    importPool.setMaxThreadCount(jobs);
+    const qsizetype importAhead = 2 * jobs;
+    const qsizetype conversionCount = qsizetype(conversions.size());
+    qsizetype nextImport = 0;
+
+    int exitCode = 0;
+    for (qsizetype i = 0; i != conversionCount; ++i) {
+        if (jobs > 1) {
+            for (; nextImport < qMin(conversionCount, i + importAhead); ++nextImport) {
+                Conversion *conversion = conversions[nextImport].get();
+                if (conversion->sceneImport && !conversion->skip)
+                    importPool.start([&importScene, conversion] { importScene(conversion); });
             }
+        }
 
-            options = optionsManager.processCommandLineOptions(cmdLineParser, options, loadedOptions);
+        Conversion &conversion = *conversions[i];
+        if (conversion.skip) {
+            qDebug() << "up to date: " << conversion.fileName;
+            continue;
+        }
 
+        QString errorString;
+        QStringList generatedFiles;
+        QStringList ids;
+        QSSGAssetImportManager::ImportState result = QSSGAssetImportManager::ImportState::Unsupported;
+        if (conversion.sceneImport) {
+            if (jobs > 1) {
+                QMutexLocker locker(&importMutex);
+                while (!conversion.imported)
+                    importDone.wait(&importMutex);
+            } else {
+                importScene(&conversion);
+            }
+            result = conversion.result;
+            errorString = conversion.error;
+            if (result == QSSGAssetImportManager::ImportState::Success) {
+                errorString = QSSGQmlUtilities::writeQmlFile(*conversion.scene, conversion.fileName, outputDirectory,
+                                                             conversion.options, &generatedFiles, &ids);
+                if (!errorString.isEmpty())
+                    result = QSSGAssetImportManager::ImportState::IoError;
+            }
+            conversion.scene->cleanup();
+            conversion.scene.reset();
+        } else if (canUsePlugins) {
             // first try the plugin-based asset importer system
-            result = assetImporter->importFile(assetFileName, outputDirectory, options, &errorString);
+            result = assetImporter->importFile(conversion.fileName, outputDirectory, conversion.options, &errorString);
         }
         // if the file extension is unsupported, try the builtins
         if (result == QSSGAssetImportManager::ImportState::Unsupported)
-            result = builtins.run(assetFileName, outputDirectory, &errorString);
+            result = builtins.run(conversion.fileName, outputDirectory, &errorString, &generatedFiles);
+
+        const QString sourceFile = QFileInfo(conversion.fileName).absoluteFilePath();
         if (result != QSSGAssetImportManager::ImportState::Success) {
             std::cerr << "Failed to import file with error: " << qPrintable(errorString) << "\n";
-            return 2;
+            manifest.remove(sourceFile);
+            exitCode = 2;
+            break;
         }
+        if (useManifest && !conversion.hash.isEmpty())
+            manifest.update(sourceFile, conversion.hash, generatedFiles, ids, outputDirectory);
+    }
+
+    // Do not start the imports of the files after a failed one
+    importPool.clear();
+    importPool.waitForDone();
+
+    if (useManifest && !manifest.save()) {
+        std::cerr << "Failed to write manifest " << qPrintable(cmdLineParser.value(manifestOption)) << "\n";
+        exitCode = 2;
     }
 
-    return 0;
+    return exitCode;
 }
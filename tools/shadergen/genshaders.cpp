@@ -76,11 +76,39 @@ GenShaders::GenShaders()
 
 GenShaders::~GenShaders() = default;
 
+// Adds the pipelines recorded at runtime with QT_QUICK3D_SHADER_RECORD_FILE,
+// covering the parts of an application that cannot be found by parsing the qml.
+static bool addRecordedShaders(const QStringList &recordings, QQsbIODeviceCollection &qsbc, bool dryRun)
+{
+    for (const auto &recording : recordings) {
+        QQsbIODeviceCollection recorded(recording);
+        if (!recorded.map(QQsbIODeviceCollection::Read)) {
+            qWarning("Unable to read recorded shaders from %s", qPrintable(recording));
+            return false;
+        }
+
+        const auto entries = recorded.availableEntries();
+        for (const auto &entry : entries) {
+            QQsbCollection::EntryDesc entryDesc;
+            if (!recorded.extractEntry(entry, entryDesc))
+                continue;
+            if (dryRun)
+                printf("Recorded shader: %s\n%s\n\n", entry.key.constData(), entryDesc.materialKey.constData());
+            else
+                qsbc.addEntry(entry.key, entryDesc);
+        }
+        recorded.unmap();
+    }
+
+    return true;
+}
+
 bool GenShaders::process(const MaterialParser::SceneData &sceneData,
                          QVector<QString> &qsbcFiles,
                          const QDir &outDir,
                          bool generateMultipleLights,
-                         bool dryRun)
+                         bool dryRun,
+                         const QStringList &recordings)
 {
     Q_UNUSED(generateMultipleLights);
 
@@ -93,6 +121,20 @@ bool GenShaders::process(const MaterialParser::SceneData &sceneData,
     }
 
     const QString outputFolder = outDir.canonicalPath() + QDir::separator() + resourceFolderRelative;
+    const QString outCollectionFile = outputFolder + QString::fromLatin1(QSSGShaderCache::shaderCollectionFile());
+    const QString qsbcFile = resourceFolderRelative + QDir::separator() + QString::fromLatin1(QSSGShaderCache::shaderCollectionFile());
+
+    // Nothing to generate, only the recordings go into the collection.
+    if (!sceneData.hasData()) {
+        QQsbIODeviceCollection qsbc(outCollectionFile);
+        if (!dryRun && !qsbc.map(QQsbIODeviceCollection::Write))
+            return false;
+        const bool ok = addRecordedShaders(recordings, qsbc, dryRun);
+        if (!qsbc.availableEntries().isEmpty())
+            qsbcFiles.push_back(qsbcFile);
+        qsbc.unmap();
+        return ok;
+    }
 
     QSSGRenderLayer layer;
     renderContext->renderer()->setViewport(QRect(QPoint(), QSize(888,666)));
@@ -191,7 +233,6 @@ bool GenShaders::process(const MaterialParser::SceneData &sceneData,
 
     QQuick3DRenderLayerHelpers::updateLayerNodeHelper(*view3D, layer, aaIsDirty, temporalIsDirty, ssaaMultiplier);
 
-    const QString outCollectionFile = outputFolder + QString::fromLatin1(QSSGShaderCache::shaderCollectionFile());
     QQsbIODeviceCollection qsbc(outCollectionFile);
     if (!dryRun && !qsbc.map(QQsbIODeviceCollection::Write))
         return false;
@@ -348,8 +389,11 @@ bool GenShaders::process(const MaterialParser::SceneData &sceneData,
     for (const auto &effect : std::as_const(sceneData.effects))
         generateEffectShader(*effect);
 
+    // Entries generated above take precedence over recorded ones with the same key
+    const bool recordingsOk = addRecordedShaders(recordings, qsbc, dryRun);
+
     if (!qsbc.availableEntries().isEmpty())
-        qsbcFiles.push_back(resourceFolderRelative + QDir::separator() + QString::fromLatin1(QSSGShaderCache::shaderCollectionFile()));
+        qsbcFiles.push_back(qsbcFile);
     qsbc.unmap();
 
     auto &children = layer.children;
@@ -358,5 +402,5 @@ bool GenShaders::process(const MaterialParser::SceneData &sceneData,
 
     qDeleteAll(nodes);
 
-    return true;
+    return recordingsOk;
 }
@@ -26,13 +26,14 @@ static int generateShaders(QVector<QString> &qsbcFiles,
                            const QDir &outDir,
                            bool multilight,
                            bool verboseOutput,
-                           bool dryRun)
+                           bool dryRun,
+                           const QStringList &recordings)
 {
     MaterialParser::SceneData sceneData;
     if (MaterialParser::parseQmlFiles(filePaths, sourceDir, sceneData, verboseOutput) == 0) {
-        if (sceneData.hasData()) {
+        if (sceneData.hasData() || !recordings.isEmpty()) {
             GenShaders genShaders;
-            if (!genShaders.process(sceneData, qsbcFiles, outDir, multilight, dryRun))
+            if (!genShaders.process(sceneData, qsbcFiles, outDir, multilight, dryRun, recordings))
                 return -1;
         } else if (verboseOutput) {
             if (!sceneData.viewport)
@@ -135,6 +136,9 @@ int main(int argc, char *argv[])
     QCommandLineOption dirDepthOption(QLatin1String("depth"), QLatin1String("Override default max depth (16) value when traversing the filesystem."), QLatin1String("number"));
     cmdLineparser.addOption(dirDepthOption);
 
+    QCommandLineOption recordingOption(QLatin1String("recording"), QLatin1String("Include the shaders recorded by an application run with QT_QUICK3D_SHADER_RECORD_FILE set. Can be given multiple times."), QLatin1String("file"));
+    cmdLineparser.addOption(recordingOption);
+
     cmdLineparser.process(a);
 
     if (cmdLineparser.isSet(changeDirOption)) {
@@ -169,7 +173,9 @@ int main(int argc, char *argv[])
         filePaths.insert(args.first());
     }
 
-    if (filePaths.isEmpty()) {
+    const QStringList recordings = cmdLineparser.values(recordingOption);
+
+    if (filePaths.isEmpty() && recordings.isEmpty()) {
         qWarning("No input file(s) found!");
         a.exit(-1);
         return -1;
@@ -262,8 +268,8 @@ int main(int argc, char *argv[])
     QVector<QString> qsbcFiles;
 
     int ret = 0;
-    if (filePaths.size())
-        ret = generateShaders(qsbcFiles, filePaths.values(), QDir::currentPath(), outDir, multilight, verboseOutput, dryRun);
+    if (filePaths.size() || recordings.size())
+        ret = generateShaders(qsbcFiles, filePaths.values(), QDir::currentPath(), outDir, multilight, verboseOutput, dryRun, recordings);
 
     if (ret == 0 && !dryRun)
         writeResourceFile(resourceFile, qsbcFiles, outDir);